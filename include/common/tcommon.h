@@ -372,6 +372,14 @@ typedef struct SNonSortExecInfo {
   int32_t blkNums;
 } SNonSortExecInfo;
 
+typedef struct SHashJoinExecInfo {
+  int32_t spillPartitions;  // number of partitions of each side, 0 if the join is done in memory
+  int64_t spillRows;        // rows written to the spill buffer
+  int64_t spillBytes;       // bytes written to the spill buffer
+  int64_t writeBytes;       // write io bytes
+  int64_t readBytes;        // read io bytes
+} SHashJoinExecInfo;
+
 
 typedef struct STUidTagInfo {
   char*    name;
@@ -223,6 +223,20 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock);
 size_t blockDataGetSerialMetaSize(uint32_t numOfCols);
 
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo);
+/**
+ * @brief move the rows of data block, the row index[i] of the origin block becomes row i
+ */
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* index);
+
+typedef struct SSDataBlockSortHelper {
+  SArray*      orderInfo;  // SArray<SBlockOrderInfo>, pColData of each item must be set
+  SSDataBlock* pDataBlock;
+} SSDataBlockSortHelper;
+
+/**
+ * @brief compare two rows of the data block by the order info, param is SSDataBlockSortHelper
+ */
+int32_t dataBlockCompar(const void* p1, const void* p2, const void* param);
 /**
  * @brief find how many rows already in order start from first row
  */
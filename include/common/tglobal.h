@@ -75,6 +75,7 @@ extern int32_t tsElectInterval;
 extern int32_t tsHeartbeatInterval;
 extern int32_t tsHeartbeatTimeout;
 extern int32_t tsSnapReplMaxWaitN;
+extern int32_t tsSyncAppendEntriesNum;
 
 // vnode
 extern int64_t tsVndCommitMaxIntervalMs;
@@ -128,7 +129,12 @@ extern char *   tsSvrCrashReportUri;
 // query buffer management
 extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t tsQueryBufferSizeBytes;    // maximum allowed usage buffer size in byte for each data node
+extern int32_t tsHashJoinBufSize;         // memory in MB of the build side of a hash join before spilling to disk
+extern int32_t tsNumOfSortThreads;        // runs of an external sort sorted on the task queue at a time
 extern int32_t tsCacheLazyLoadThreshold;  // cost threshold for last/last_row loading cache as much as possible
+extern int32_t tsLastCacheShardBits;      // shard bits of the last/last_row cache, -1 means by the cache size
+extern int32_t tsLastCacheRocksBlockSize;  // block cache in MB of the rocksdb behind the last/last_row cache
+extern int32_t tsTsdbBlockCacheSize;       // cache in MB of decoded brin blocks and column data of each vnode
 
 // query client
 extern int32_t tsQueryPolicy;
@@ -158,6 +164,8 @@ extern int32_t tsTimeSeriesThreshold;
 extern int32_t tsMinSlidingTime;
 extern int32_t tsMinIntervalTime;
 extern int32_t tsMaxInsertBatchRows;
+extern int32_t tsCsvParseThreads;
+extern int32_t tsInsertShapeCacheSize;
 
 // build info
 extern char version[];
@@ -190,6 +198,7 @@ extern char tsSmlAutoChildTableNameDelimiter[];
 extern char tsSmlTagName[];
 extern bool tsSmlDot2Underline;
 extern char tsSmlTsDefaultName[];
+extern int32_t tsSmlParseThreads;
 // extern bool    tsSmlDataFormat;
 // extern int32_t tsSmlBatchSize;
 
@@ -197,6 +206,9 @@ extern int32_t tmqMaxTopicNum;
 
 // wal
 extern int64_t tsWalFsyncDataSizeLimit;
+extern int32_t tsWalGroupCommitSize;
+extern int32_t tsWalGroupCommitDelay;
+extern int32_t tsWalTailCacheSize;
 
 // internal
 extern int32_t tsTransPullupInterval;
@@ -215,6 +227,7 @@ extern int32_t tsUptimeInterval;
 extern bool    tsDisableStream;
 extern int64_t tsStreamBufferSize;
 extern int     tsStreamAggCnt;
+extern int32_t tsStreamDispatchCompressSize;
 extern bool    tsFilterScalarMode;
 extern int32_t tsMaxStreamBackendCache;
 extern int32_t tsPQSortMemThreshold;
@@ -97,6 +97,7 @@ typedef struct SParseContext {
   void*            parseSqlParam;
   int8_t           biMode;
   SArray*          pSubMetaList;
+  void*            pInsertShapeCache;  // parsed USING clauses of the connection, see qCreateInsertShapeCache
 } SParseContext;
 
 int32_t qParseSql(SParseContext* pCxt, SQuery** pQuery);
@@ -142,6 +143,9 @@ int32_t qCreateSName(SName* pName, const char* pTableName, int32_t acctId, char*
 
 void qDestroyBoundColInfo(void* pInfo);
 
+void* qCreateInsertShapeCache(int32_t capacity);
+void  qDestroyInsertShapeCache(void* pCache);
+
 SQuery*        smlInitHandle();
 int32_t        smlBuildRow(STableDataCxt* pTableCxt);
 int32_t        smlBuildCol(STableDataCxt* pTableCxt, SSchema* schema, void* kv, int32_t index);
@@ -236,6 +236,7 @@ typedef struct {
   char      stbFullName[TSDB_TABLE_FNAME_LEN];
   int32_t   waitingRspCnt;
   SUseDbRsp dbInfo;
+  SArray*   pHashRanges;  // vgroups sorted by hash range, built by the first dispatch, not serialized
 } STaskDispatcherShuffle;
 
 typedef struct {
@@ -362,6 +363,8 @@ typedef struct SDispatchMsgInfo {
   int64_t             startTs;     // dispatch start time, record total elapsed time for dispatch
   SArray*             pRetryList;  // current dispatch successfully completed node of downstream
   void*               pTimer;      // used to dispatch data after a given time duration
+  char*               pEncodeBuf;  // reused to encode the blocks to be compressed
+  int32_t             encodeBufLen;
 } SDispatchMsgInfo;
 
 typedef struct STaskQueue {
@@ -395,7 +398,9 @@ typedef struct STaskExecStatisInfo {
   int32_t       processDataBlocks;
   int64_t       processDataSize;
   int32_t       dispatch;
-  int64_t       dispatchDataSize;
+  int64_t       dispatchDataSize;    // dispatched bytes after compression
+  int64_t       dispatchEncodeSize;  // dispatched bytes before compression
+  int64_t       dispatchEncodeCost;  // us spent on encoding and compressing the dispatched blocks
   int32_t       checkpoint;
   SSinkRecorder sink;
 } STaskExecStatisInfo;
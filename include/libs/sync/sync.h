@@ -42,6 +42,8 @@ extern "C" {
 #define SYNC_MAX_RETRY_BACKOFF         5
 #define SYNC_LOG_REPL_RETRY_WAIT_MS    100
 #define SYNC_APPEND_ENTRIES_TIMEOUT_MS 10000
+#define SYNC_APPEND_ENTRIES_MAX_NUM    64
+#define SYNC_APPEND_ENTRIES_MAX_BYTES  (1024 * 1024)
 #define SYNC_HEART_TIMEOUT_MS          1000 * 15
 
 #define SYNC_HEARTBEAT_SLOW_MS       1500
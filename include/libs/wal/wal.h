@@ -43,6 +43,7 @@ extern "C" {
 #define WAL_FILE_LEN      (WAL_PATH_LEN + 32)
 #define WAL_MAGIC         0xFAFBFCFDF4F3F2F1ULL
 #define WAL_SCAN_BUF_SIZE (1024 * 1024 * 3)
+#define WAL_READ_AHEAD_SIZE (1024 * 1024)
 
 typedef enum {
   TAOS_WAL_WRITE = 1,
@@ -98,6 +99,23 @@ typedef struct {
 } SWalCkHead;
 #pragma pack(pop)
 
+typedef struct SWalWriteBuf  SWalWriteBuf;
+typedef struct SWalTailCache SWalTailCache;
+
+typedef struct {
+  int64_t numOfFlushes;
+  int64_t numOfEntries;
+  int64_t numOfBytes;
+  int32_t maxEntriesPerFlush;
+} SWalGroupCommitStat;
+
+typedef struct {
+  int64_t numOfEntries;
+  int64_t numOfBytes;
+  int64_t numOfHits;
+  int64_t numOfMisses;
+} SWalTailCacheStat;
+
 typedef struct SWal {
   // cfg
   SWalCfg cfg;
@@ -120,6 +138,12 @@ typedef struct SWal {
   SHashObj *pRefHash;  // refId -> SWalRef
   // path
   char path[WAL_PATH_LEN];
+  // group commit staging, NULL if disabled
+  SWalWriteBuf *pWriteBuf;
+  // latest appended entries shared by the readers, NULL if disabled
+  SWalTailCache *pTailCache;
+  // increased when written data is truncated from the files, readers drop their read ahead data then
+  int64_t truncateSeq;
   // reusable write head
   SWalCkHead writeHead;
 } SWal;
@@ -139,6 +163,16 @@ typedef struct {
   int8_t enableRef;
 } SWalFilterCond;
 
+typedef struct {
+  char   *pBuf;
+  int32_t cap;
+  int32_t maxSize;      // 0 if read ahead is disabled
+  int32_t window;       // bytes of the next read, 0 after a seek, started and doubled by sequential reads up to maxSize
+  int32_t pos;
+  int32_t len;
+  int64_t truncateSeq;  // of the wal when the buffer was filled
+} SWalReadAhead;
+
 typedef struct SWalReader SWalReader;
 
 // todo hide this struct
@@ -154,6 +188,8 @@ struct SWalReader {
   TdThreadMutex  mutex;
   SWalFilterCond cond;
   SWalCkHead *pHead;
+  int8_t         fromCache;  // pHead was copied from the tail cache, the log file is not positioned at curVersion
+  SWalReadAhead  readAhead;  // the log file is positioned at the end of the buffered data
 };
 
 // module initialization
@@ -179,6 +215,12 @@ int64_t walAppendLog(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo syncMet
 
 void walFsync(SWal *, bool force);
 
+// group commit statistics, all zero if group commit is disabled
+void walGetGroupCommitStat(SWal *, SWalGroupCommitStat *pStat);
+
+// tail cache statistics, all zero if the tail cache is disabled
+void walGetTailCacheStat(SWal *, SWalTailCacheStat *pStat);
+
 // apis for lifecycle management
 int32_t walCommit(SWal *, int64_t ver);
 int32_t walRollback(SWal *, int64_t ver);
@@ -204,6 +246,7 @@ int64_t     walReaderGetSkipToVersion(SWalReader *pReader);
 void        walReaderSetSkipToVersion(SWalReader *pReader, int64_t ver);
 void        walReaderValidVersionRange(SWalReader *pReader, int64_t *sver, int64_t *ever);
 void        walReaderVerifyOffset(SWalReader *pWalReader, STqOffsetVal* pOffset);
+void        walReaderSetReadAhead(SWalReader *pReader, int32_t maxSize);
 
 // only for tq usage
 int32_t walFetchHead(SWalReader *pRead, int64_t ver);
@@ -141,6 +141,9 @@ int32_t tsDecompressFloatImplAvx512(const char *const input, const int32_t nelem
 int32_t tsDecompressFloatImplAvx2(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressTimestampAvx512(const char* const input, const int32_t nelements, char *const output, bool bigEndian);
 int32_t tsDecompressTimestampAvx2(const char* const input, const int32_t nelements, char *const output, bool bigEndian);
+int32_t tsCompressINTImpAvx2(const char *const input, const int32_t nelements, char *const output, const char type);
+int32_t tsCompressTimestampAvx2(const char *const input, const int32_t nelements, char *const output);
+int32_t tsCompressDoubleImpAvx2(const char *const input, const int32_t nelements, char *const output);
 
 /*************************************************************************
  *                  STREAM COMPRESSION
@@ -34,11 +34,14 @@ typedef struct SFilePage {
 
 typedef struct SDiskbasedBufStatis {
   int64_t flushBytes;
+  int64_t rawFlushBytes;  // page bytes before compression, flushBytes/rawFlushBytes is the compression ratio
   int64_t loadBytes;
   int32_t loadPages;
   int32_t getPages;
   int32_t releasePages;
   int32_t flushPages;
+  int32_t prefetchPages;  // pages that a read-ahead has been issued for
+  int32_t prefetchHits;   // prefetched pages that are loaded afterwards
 } SDiskbasedBufStatis;
 
 /**
@@ -151,6 +154,16 @@ void setBufPageDirty(void* pPage, bool dirty);
  */
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp);
 
+/**
+ * Issue the read-ahead of the given pages that are not in memory, so the following getBufPage does not stall on
+ * the disk read. Pages that are in memory or have never been flushed are ignored.
+ * @param pBuf
+ * @param pageIds
+ * @param num
+ * @return
+ */
+int32_t dBufPrefetchPages(SDiskbasedBuf* pBuf, const int32_t* pageIds, int32_t num);
+
 /**
  * Set the pageId page buffer is not need
  * @param pBuf
@@ -165,6 +165,7 @@ typedef struct STscObj {
   SPassInfo      passInfo;
   SWhiteListInfo whiteListInfo;
   STscNotifyInfo userDroppedInfo;
+  void*          pInsertShapeCache;  // parsed USING clauses of the inserts of this connection
 } STscObj;
 
 typedef struct STscDbg {
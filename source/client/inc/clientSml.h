@@ -32,7 +32,6 @@ extern "C" {
 #include "tname.h"
 #include "ttime.h"
 #include "ttypes.h"
-#include "cJSON.h"
 #include "geosWrapper.h"
 
 #if (defined(__GNUC__) && (__GNUC__ >= 3)) || (defined(__INTEL_COMPILER) && (__INTEL_COMPILER >= 800)) || defined(__clang__)
@@ -71,6 +70,9 @@ extern "C" {
 #define OTD_JSON_FIELDS_NUM     4
 #define MAX_RETRY_TIMES 10
 
+#define SML_PARALLEL_PARSE_MIN_LINES 10000  // fewer lines are parsed on the calling thread
+#define SML_PARSE_CHUNK_LINES        1024   // lines a parse thread takes at a time
+
 #define IS_SAME_CHILD_TABLE (elements->measureTagsLen == info->preLine.measureTagsLen \
 && memcmp(elements->measure, info->preLine.measure, elements->measureTagsLen) == 0)
 
@@ -101,6 +103,26 @@ typedef enum {
   SCHEMA_ACTION_CHANGE_TAG_SIZE,
 } ESchemaAction;
 
+typedef enum {
+  SML_JSON_NULL,
+  SML_JSON_FALSE,
+  SML_JSON_TRUE,
+  SML_JSON_NUMBER,
+  SML_JSON_STRING,
+  SML_JSON_ARRAY,
+  SML_JSON_OBJECT,
+} ESmlJsonType;
+
+// a json value read in place from the payload, strings and containers are not copied
+typedef struct {
+  int8_t  type;
+  bool    escaped;  // the string has escape sequences
+  int32_t len;      // the length of the string without quotes, or of the text of the container
+  int32_t size;     // items of the container
+  double  d;        // the number
+  char   *start;    // the string without quotes, or the text of the container
+} SSmlJsonVal;
+
 typedef struct {
   char *measure;
   char *tags;
@@ -188,12 +210,9 @@ typedef struct {
   int32_t      lineNum;
   SSmlMsgBuf   msgBuf;
 
-  cJSON       *root;  // for parse json
   int8_t             offset[OTD_JSON_FIELDS_NUM];
   SSmlLineInfo      *lines; // element is SSmlLineInfo
-  bool               parseJsonByLib;
-  SArray      *tagJsonArray;
-  SArray      *valueJsonArray;
+  SArray      *jsonStrs;  // the unescaped json strings of measures, freed with the handle
 
   //
   SArray      *preLineTagKV;
@@ -233,8 +252,13 @@ void              smlDestroyTableInfo(void *para);
 
 void    freeSSmlKv(void* data);
 int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLineInfo *elements);
+int32_t smlParseInfluxStringNoTags(SSmlHandle *info, SSmlMsgBuf *msg, char *sql, char *sqlEnd, SSmlLineInfo *elements);
+int32_t smlParseInfluxTags(SSmlHandle *info, SSmlLineInfo *elements);
 int32_t smlParseTelnetString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLineInfo *elements);
 int32_t smlParseJSON(SSmlHandle *info, char *payload);
+int32_t smlJsonReadValue(char **start, SSmlJsonVal *val);
+int32_t smlJsonNextItem(char **start, int32_t index, SSmlJsonVal *key, SSmlJsonVal *val, bool *end);
+int32_t smlJsonUnescape(const char *src, int32_t len, char *dst, int32_t *dstLen);
 
 SSmlSTableMeta* smlBuildSuperTableInfo(SSmlHandle *info, SSmlLineInfo *currElement);
 bool            isSmlTagAligned(SSmlHandle *info, int cnt, SSmlKv *kv);
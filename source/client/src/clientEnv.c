@@ -272,6 +272,7 @@ void destroyTscObj(void *pObj) {
   // In any cases, we should not free app inst here. Or an race condition rises.
   /*int64_t connNum = */ atomic_sub_fetch_64(&pTscObj->pAppInfo->numOfConns, 1);
 
+  qDestroyInsertShapeCache(pTscObj->pInsertShapeCache);
   taosThreadMutexDestroy(&pTscObj->mutex);
   taosMemoryFree(pTscObj);
 
@@ -302,6 +303,9 @@ void *createTscObj(const char *user, const char *auth, const char *db, int32_t c
     tstrncpy(pObj->db, db, tListLen(pObj->db));
   }
 
+  // a connection works without the cache if it fails to be created
+  pObj->pInsertShapeCache = qCreateInsertShapeCache(tsInsertShapeCacheSize);
+
   taosThreadMutexInit(&pObj->mutex, NULL);
   pObj->id = taosAddRef(clientConnRefPool, pObj);
 
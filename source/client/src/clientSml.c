@@ -1331,26 +1331,13 @@ void smlDestroyInfo(SSmlHandle *info) {
   taosHashCleanup(info->superTables);
   taosHashCleanup(info->tableUids);
 
-  for (int i = 0; i < taosArrayGetSize(info->tagJsonArray); i++) {
-    cJSON *tags = (cJSON *)taosArrayGetP(info->tagJsonArray, i);
-    cJSON_Delete(tags);
-  }
-  taosArrayDestroy(info->tagJsonArray);
-
-  for (int i = 0; i < taosArrayGetSize(info->valueJsonArray); i++) {
-    cJSON *value = (cJSON *)taosArrayGetP(info->valueJsonArray, i);
-    cJSON_Delete(value);
-  }
-  taosArrayDestroy(info->valueJsonArray);
+  taosArrayDestroyP(info->jsonStrs, taosMemoryFree);
 
   taosArrayDestroyEx(info->preLineTagKV, freeSSmlKv);
 
   if (!info->dataFormat) {
     for (int i = 0; i < info->lineNum; i++) {
       taosArrayDestroyEx(info->lines[i].colArray, freeSSmlKv);
-      if (info->parseJsonByLib) {
-        taosMemoryFree(info->lines[i].tags);
-      }
       if (info->lines[i].measureTagsLen != 0 && info->protocol != TSDB_SML_LINE_PROTOCOL) {
         taosMemoryFree(info->lines[i].measureTag);
       }
@@ -1358,7 +1345,6 @@ void smlDestroyInfo(SSmlHandle *info) {
     taosMemoryFree(info->lines);
   }
 
-  cJSON_Delete(info->root);
   taosMemoryFreeClear(info);
 }
 
@@ -1391,8 +1377,7 @@ SSmlHandle *smlBuildSmlInfo(TAOS *taos) {
   info->pQuery = smlInitHandle();
   info->dataFormat = true;
 
-  info->tagJsonArray = taosArrayInit(8, POINTER_BYTES);
-  info->valueJsonArray = taosArrayInit(8, POINTER_BYTES);
+  info->jsonStrs = taosArrayInit(8, POINTER_BYTES);
   info->preLineTagKV = taosArrayInit(8, sizeof(SSmlKv));
 
   if (NULL == info->pVgHash || NULL == info->childTables || NULL == info->superTables || NULL == info->tableUids) {
@@ -1647,11 +1632,13 @@ static bool getLine(SSmlHandle *info, char *lines[], char **rawLine, char *rawLi
     *len = strlen(*tmp);
   } else if (*rawLine) {
     *tmp = *rawLine;
-    while (*rawLine < rawLineEnd) {
-      if (*((*rawLine)++) == '\n') {
-        break;
-      }
-      (*len)++;
+    char *end = memchr(*rawLine, '\n', rawLineEnd - *rawLine);
+    if (end != NULL) {
+      *len += end - *rawLine;
+      *rawLine = end + 1;
+    } else if (*rawLine < rawLineEnd) {
+      *len += rawLineEnd - *rawLine;
+      *rawLine = rawLineEnd;
     }
     if (info->protocol == TSDB_SML_LINE_PROTOCOL && (*tmp)[0] == '#') {  // this line is comment
       return false;
@@ -1671,9 +1658,160 @@ static bool getLine(SSmlHandle *info, char *lines[], char **rawLine, char *rawLi
   return true;
 }
 
+typedef struct {
+  SSmlHandle   *info;
+  char        **lines;
+  int32_t      *lens;
+  int32_t       numLines;
+  int32_t       numOfChunks;
+  int32_t       nextChunk;
+  tsem_t        done;
+  TdThreadMutex lock;
+  // the first line failed to parse
+  int32_t       errLine;
+  int32_t       code;
+  char          msg[ERROR_MSG_BUF_DEFAULT_SIZE];
+} SSmlParseCtx;
+
+// parse the chunks of lines not taken by other threads, all but the tags of the lines
+static int32_t smlParseLineChunks(void *param) {
+  SSmlParseCtx *pCtx = param;
+  char          buf[ERROR_MSG_BUF_DEFAULT_SIZE] = {0};
+  SSmlMsgBuf    msg = {ERROR_MSG_BUF_DEFAULT_SIZE, buf};
+
+  while (1) {
+    int32_t iChunk = atomic_fetch_add_32(&pCtx->nextChunk, 1);
+    // the chunks are taken in order, so the ones after a failed line are skipped
+    if (iChunk >= pCtx->numOfChunks || iChunk * SML_PARSE_CHUNK_LINES > atomic_load_32(&pCtx->errLine)) {
+      break;
+    }
+
+    int32_t end = TMIN((iChunk + 1) * SML_PARSE_CHUNK_LINES, pCtx->numLines);
+    for (int32_t i = iChunk * SML_PARSE_CHUNK_LINES; i < end; i++) {
+      int32_t code = smlParseInfluxStringNoTags(pCtx->info, &msg, pCtx->lines[i], pCtx->lines[i] + pCtx->lens[i],
+                                                pCtx->info->lines + i);
+      if (code != TSDB_CODE_SUCCESS) {
+        taosThreadMutexLock(&pCtx->lock);
+        if (i < pCtx->errLine) {
+          pCtx->code = code;
+          tstrncpy(pCtx->msg, buf, sizeof(pCtx->msg));
+          atomic_store_32(&pCtx->errLine, i);
+        }
+        taosThreadMutexUnlock(&pCtx->lock);
+        break;
+      }
+    }
+  }
+
+  tsem_post(&pCtx->done);
+  return TSDB_CODE_SUCCESS;
+}
+
+static void smlPrintFailedLine(SSmlHandle *info, char *line, int32_t len, int32_t i, bool isRaw) {
+  if (isRaw) {
+    char *print = taosMemoryCalloc(len + 1, 1);
+    if (print != NULL) memcpy(print, line, len);
+    uError("SML:0x%" PRIx64 " smlParseLine failed. line %d : %s", info->id, i, print);
+    taosMemoryFree(print);
+  } else {
+    uError("SML:0x%" PRIx64 " smlParseLine failed. line %d : %s", info->id, i, line);
+  }
+}
+
+// Parse the influx lines on the client task queue threads and the calling thread, all but the tags, which are parsed
+// after in the order of lines, since they decide the child tables. The lines are parsed as !info->dataFormat, so the
+// schema is checked once after parsing, instead of starting over when a line does not fit.
+static int32_t smlParseLineParallel(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines) {
+  int32_t       code = TSDB_CODE_SUCCESS;
+  int32_t       numOfTasks = 0;
+  SSmlParseCtx *pCtx = taosMemoryCalloc(1, sizeof(SSmlParseCtx));
+  if (pCtx == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  info->dataFormat = false;
+  code = smlClearForRerun(info);
+  if (code != TSDB_CODE_SUCCESS) {
+    taosMemoryFree(pCtx);
+    return code;
+  }
+
+  pCtx->info = info;
+  pCtx->numLines = numLines;
+  pCtx->errLine = numLines;
+  pCtx->lines = taosMemoryMalloc(numLines * sizeof(char *));
+  pCtx->lens = taosMemoryMalloc(numLines * sizeof(int32_t));
+  if (pCtx->lines == NULL || pCtx->lens == NULL || info->lines == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  for (int32_t i = 0; i < numLines;) {
+    char *tmp = NULL;
+    int   len = 0;
+    if (!getLine(info, lines, &rawLine, rawLineEnd, numLines, i, &tmp, &len)) {
+      continue;
+    }
+    pCtx->lines[i] = tmp;
+    pCtx->lens[i] = len;
+    i++;
+  }
+
+  pCtx->numOfChunks = (numLines + SML_PARSE_CHUNK_LINES - 1) / SML_PARSE_CHUNK_LINES;
+  tsem_init(&pCtx->done, 0, 0);
+  taosThreadMutexInit(&pCtx->lock, NULL);
+
+  for (int32_t i = 1; i < TMIN(tsSmlParseThreads, pCtx->numOfChunks); i++) {
+    if (taosAsyncExec(smlParseLineChunks, pCtx, NULL) != 0) {
+      break;
+    }
+    numOfTasks++;
+  }
+  smlParseLineChunks(pCtx);
+  for (int32_t i = 0; i < numOfTasks + 1; i++) {
+    tsem_wait(&pCtx->done);
+  }
+  tsem_destroy(&pCtx->done);
+  taosThreadMutexDestroy(&pCtx->lock);
+
+  uDebug("SML:0x%" PRIx64 " smlParseLine parsed %d lines on %d threads", info->id, numLines, numOfTasks + 1);
+
+  for (int32_t i = 0; i < TMIN(pCtx->errLine + 1, numLines); i++) {
+    SSmlLineInfo *elements = info->lines + i;
+    // the tags of the failed line come before its error, if its measure is parsed
+    if (i == pCtx->errLine && elements->tags == NULL) {
+      break;
+    }
+
+    code = smlParseInfluxTags(info, elements);
+    if (code != TSDB_CODE_SUCCESS) {
+      smlPrintFailedLine(info, pCtx->lines[i], pCtx->lens[i], i, rawLine != NULL);
+      goto _end;
+    }
+  }
+
+  if (pCtx->errLine < numLines) {
+    code = pCtx->code;
+    tstrncpy(info->msgBuf.buf, pCtx->msg, info->msgBuf.len);
+    smlPrintFailedLine(info, pCtx->lines[pCtx->errLine], pCtx->lens[pCtx->errLine], pCtx->errLine, rawLine != NULL);
+  }
+
+_end:
+  taosMemoryFree(pCtx->lines);
+  taosMemoryFree(pCtx->lens);
+  taosMemoryFree(pCtx);
+  return code;
+}
+
 static int32_t smlParseLine(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines) {
   uDebug("SML:0x%" PRIx64 " smlParseLine start", info->id);
   int32_t code = TSDB_CODE_SUCCESS;
+  if (info->protocol == TSDB_SML_LINE_PROTOCOL && tsSmlParseThreads > 1 && numLines >= SML_PARALLEL_PARSE_MIN_LINES) {
+    code = smlParseLineParallel(info, lines, rawLine, rawLineEnd, numLines);
+    uDebug("SML:0x%" PRIx64 " smlParseLine end, code:%s", info->id, tstrerror(code));
+    return code;
+  }
+
   if (info->protocol == TSDB_SML_JSON_PROTOCOL) {
     if (lines) {
       code = smlParseJSON(info, *lines);
@@ -264,29 +264,371 @@ int smlJsonParseObj(char **start, SSmlLineInfo *element, int8_t *offset) {
   return 0;
 }
 
-static inline int32_t smlParseMetricFromJSON(SSmlHandle *info, cJSON *metric, SSmlLineInfo *elements) {
-  elements->measureLen = strlen(metric->valuestring);
+#define SML_JSON_NESTING_LIMIT 1000  // as cJSON
+#define SML_JSON_NAME_LEN      32
+
+// the bytes of utf8 chars are not spaces, as the unsigned compare of cJSON
+#define SML_JSON_SKIP_SPACE(p)                    \
+  while (*(p) != '\0' && (uint8_t)*(p) <= 32) { \
+    (p)++;                                        \
+  }
+
+static int32_t smlJsonParseHex4(const char *src, uint32_t *code) {
+  *code = 0;
+  for (int32_t i = 0; i < 4; ++i) {
+    char c = src[i];
+    *code <<= 4;
+    if (c >= '0' && c <= '9') {
+      *code += c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      *code += c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      *code += c - 'A' + 10;
+    } else {
+      return TSDB_CODE_TSC_INVALID_JSON;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// decode the escape sequences of a json string as cJSON does, into dst of at least len bytes, or only check them if
+// dst is NULL
+int32_t smlJsonUnescape(const char *src, int32_t len, char *dst, int32_t *dstLen) {
+  const char *end = src + len;
+  int32_t     n = 0;
+  while (src < end) {
+    if (*src != SLASH) {
+      if (dst) dst[n] = *src;
+      n++;
+      src++;
+      continue;
+    }
+
+    uint32_t code = 0;
+    if (unlikely(end - src < 2)) return TSDB_CODE_TSC_INVALID_JSON;
+    switch (src[1]) {
+      case 'b':
+        code = '\b';
+        break;
+      case 'f':
+        code = '\f';
+        break;
+      case 'n':
+        code = '\n';
+        break;
+      case 'r':
+        code = '\r';
+        break;
+      case 't':
+        code = '\t';
+        break;
+      case '"':
+      case '\\':
+      case '/':
+        code = src[1];
+        break;
+      case 'u': {
+        if (end - src < 6 || smlJsonParseHex4(src + 2, &code) != TSDB_CODE_SUCCESS) return TSDB_CODE_TSC_INVALID_JSON;
+        if (code >= 0xDC00 && code <= 0xDFFF) return TSDB_CODE_TSC_INVALID_JSON;
+        if (code >= 0xD800 && code <= 0xDBFF) {
+          // utf16 surrogate pair
+          const char *low = src + 6;
+          uint32_t    lowCode = 0;
+          if (end - low < 6 || low[0] != SLASH || low[1] != 'u' ||
+              smlJsonParseHex4(low + 2, &lowCode) != TSDB_CODE_SUCCESS || lowCode < 0xDC00 || lowCode > 0xDFFF) {
+            return TSDB_CODE_TSC_INVALID_JSON;
+          }
+          code = 0x10000 + (((code & 0x3FF) << 10) | (lowCode & 0x3FF));
+          src += 6;
+        }
+        src += 4;
+        break;
+      }
+      default:
+        return TSDB_CODE_TSC_INVALID_JSON;
+    }
+    src += 2;
+
+    // encode in utf8
+    if (code < 0x80) {
+      if (dst) dst[n] = (char)code;
+      n += 1;
+    } else if (code < 0x800) {
+      if (dst) {
+        dst[n] = (char)(0xC0 | (code >> 6));
+        dst[n + 1] = (char)(0x80 | (code & 0x3F));
+      }
+      n += 2;
+    } else if (code < 0x10000) {
+      if (dst) {
+        dst[n] = (char)(0xE0 | (code >> 12));
+        dst[n + 1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        dst[n + 2] = (char)(0x80 | (code & 0x3F));
+      }
+      n += 3;
+    } else {
+      if (dst) {
+        dst[n] = (char)(0xF0 | (code >> 18));
+        dst[n + 1] = (char)(0x80 | ((code >> 12) & 0x3F));
+        dst[n + 2] = (char)(0x80 | ((code >> 6) & 0x3F));
+        dst[n + 3] = (char)(0x80 | (code & 0x3F));
+      }
+      n += 4;
+    }
+  }
+
+  if (dstLen) *dstLen = n;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t smlJsonReadString(char **start, SSmlJsonVal *val) {
+  char *p = *start + 1;
+  val->type = SML_JSON_STRING;
+  val->start = p;
+  val->escaped = false;
+  while (1) {
+    p += strcspn(p, "\"\\");
+    if (*p == QUOTE) break;
+    if (unlikely(*p == '\0' || p[1] == '\0')) return TSDB_CODE_TSC_INVALID_JSON;
+    val->escaped = true;
+    p += 2;
+  }
+  val->len = p - val->start;
+  *start = p + 1;
+
+  if (unlikely(val->escaped)) {
+    return smlJsonUnescape(val->start, val->len, NULL, NULL);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// the number chars are converted by strtod as cJSON does, which stops at the first char it does not take
+static int32_t smlJsonReadNumber(char **start, SSmlJsonVal *val) {
+  char    buf[64];
+  char   *p = *start;
+  int32_t i = 0;
+  for (; i < sizeof(buf) - 1; ++i) {
+    char c = p[i];
+    if (!((c >= '0' && c <= '9') || c == '+' || c == '-' || c == 'e' || c == 'E' || c == '.')) break;
+    buf[i] = c;
+  }
+  buf[i] = '\0';
+
+  char *end = NULL;
+  val->d = taosStr2Double(buf, &end);
+  if (unlikely(end == buf)) return TSDB_CODE_TSC_INVALID_JSON;
+
+  val->type = SML_JSON_NUMBER;
+  val->start = p;
+  val->len = end - buf;
+  *start = p + val->len;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t smlJsonReadValueImpl(char **start, SSmlJsonVal *val, int32_t depth);
+
+static int32_t smlJsonNextItemImpl(char **start, int32_t index, SSmlJsonVal *key, SSmlJsonVal *val, bool *end,
+                                   int32_t depth) {
+  char *p = *start;
+  SML_JSON_SKIP_SPACE(p)
+  if (*p == (key ? '}' : ']')) {
+    *end = true;
+    *start = p + 1;
+    return TSDB_CODE_SUCCESS;
+  }
+  *end = false;
+
+  if (index > 0) {
+    if (unlikely(*p != COMMA)) return TSDB_CODE_TSC_INVALID_JSON;
+    p++;
+    SML_JSON_SKIP_SPACE(p)
+  }
+
+  if (key) {
+    if (unlikely(*p != QUOTE || smlJsonReadString(&p, key) != TSDB_CODE_SUCCESS)) return TSDB_CODE_TSC_INVALID_JSON;
+    SML_JSON_SKIP_SPACE(p)
+    if (unlikely(*p != ':')) return TSDB_CODE_TSC_INVALID_JSON;
+    p++;
+  }
+
+  int32_t code = smlJsonReadValueImpl(&p, val, depth);
+  *start = p;
+  return code;
+}
+
+static int32_t smlJsonReadValueImpl(char **start, SSmlJsonVal *val, int32_t depth) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  char   *p = *start;
+  SML_JSON_SKIP_SPACE(p)
+
+  memset(val, 0, sizeof(SSmlJsonVal));
+  val->start = p;
+  switch (*p) {
+    case 'n':
+      if (unlikely(strncmp(p, "null", 4) != 0)) return TSDB_CODE_TSC_INVALID_JSON;
+      val->type = SML_JSON_NULL;
+      p += 4;
+      break;
+    case 'f':
+      if (unlikely(strncmp(p, "false", 5) != 0)) return TSDB_CODE_TSC_INVALID_JSON;
+      val->type = SML_JSON_FALSE;
+      p += 5;
+      break;
+    case 't':
+      if (unlikely(strncmp(p, "true", 4) != 0)) return TSDB_CODE_TSC_INVALID_JSON;
+      val->type = SML_JSON_TRUE;
+      p += 4;
+      break;
+    case '"':
+      code = smlJsonReadString(&p, val);
+      break;
+    case '[':
+    case '{': {
+      if (unlikely(depth >= SML_JSON_NESTING_LIMIT)) return TSDB_CODE_TSC_INVALID_JSON;
+      val->type = (*p == '{') ? SML_JSON_OBJECT : SML_JSON_ARRAY;
+      p++;
+
+      SSmlJsonVal key = {0};
+      SSmlJsonVal item = {0};
+      bool        end = false;
+      while (1) {
+        code = smlJsonNextItemImpl(&p, val->size, val->type == SML_JSON_OBJECT ? &key : NULL, &item, &end, depth + 1);
+        if (code != TSDB_CODE_SUCCESS || end) break;
+        val->size++;
+      }
+      val->len = p - val->start;
+      break;
+    }
+    default:
+      if (unlikely(*p != '-' && (*p < '0' || *p > '9'))) return TSDB_CODE_TSC_INVALID_JSON;
+      code = smlJsonReadNumber(&p, val);
+      break;
+  }
+
+  *start = p;
+  return code;
+}
+
+// read and check the json value at *start without building a tree, the containers are only skipped
+int32_t smlJsonReadValue(char **start, SSmlJsonVal *val) { return smlJsonReadValueImpl(start, val, 0); }
+
+// read the next member of an object, or the next element of an array if key is NULL, from *start which is after the
+// opening bracket or the previous item
+int32_t smlJsonNextItem(char **start, int32_t index, SSmlJsonVal *key, SSmlJsonVal *val, bool *end) {
+  return smlJsonNextItemImpl(start, index, key, val, end, 1);
+}
+
+// the string in place, or a copy without escape sequences, which the caller frees if *copied
+static int32_t smlJsonGetString(const SSmlJsonVal *str, bool copy, const char **ppStr, size_t *len, bool *copied) {
+  *copied = false;
+  if (likely(!str->escaped && !copy)) {
+    *ppStr = str->start;
+    *len = str->len;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  char *buf = (char *)taosMemoryMalloc(str->len + 1);
+  if (buf == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  int32_t n = str->len;
+  if (str->escaped) {
+    smlJsonUnescape(str->start, str->len, buf, &n);
+  } else {
+    memcpy(buf, str->start, n);
+  }
+  buf[n] = '\0';
+
+  *ppStr = buf;
+  *len = strlen(buf);  // cut at an escaped '\0' as cJSON does
+  *copied = true;
+  return TSDB_CODE_SUCCESS;
+}
+
+// a string too long for buf is cut and matches none of the names
+static void smlJsonGetName(const SSmlJsonVal *str, char *buf, int32_t size) {
+  int32_t len = TMIN(str->len, size - 1);
+  if (str->escaped && str->len < size) {
+    smlJsonUnescape(str->start, str->len, buf, &len);
+  } else {
+    memcpy(buf, str->start, len);
+  }
+  buf[len] = '\0';
+}
+
+// the keys are matched ignoring case, as cJSON_GetObjectItem does
+static bool smlJsonIsName(const SSmlJsonVal *str, const char *name) {
+  char buf[SML_JSON_NAME_LEN];
+  smlJsonGetName(str, buf, sizeof(buf));
+  return strcasecmp(buf, name) == 0;
+}
+
+// the first "value" and "type" members of a checked object, start is NULL for the missing ones
+static void smlJsonGetValueType(const SSmlJsonVal *obj, SSmlJsonVal *value, SSmlJsonVal *type) {
+  char       *p = obj->start + 1;
+  SSmlJsonVal key = {0};
+  SSmlJsonVal item = {0};
+  bool        end = false;
+
+  value->start = NULL;
+  type->start = NULL;
+  for (int32_t i = 0; smlJsonNextItem(&p, i, &key, &item, &end) == TSDB_CODE_SUCCESS && !end; ++i) {
+    if (value->start == NULL && smlJsonIsName(&key, "value")) {
+      *value = item;
+    } else if (type->start == NULL && smlJsonIsName(&key, "type")) {
+      *type = item;
+    }
+  }
+}
+
+static inline int32_t smlParseMetricFromJSON(SSmlHandle *info, SSmlJsonVal *metric, SSmlLineInfo *elements) {
+  if (unlikely(metric->type != SML_JSON_STRING)) {
+    uError("OTD:0x%" PRIx64 " Metric should be a string", info->id);
+    return TSDB_CODE_TSC_INVALID_JSON;
+  }
+
+  const char *measure = NULL;
+  size_t      measureLen = 0;
+  bool        copied = false;
+  int32_t     ret = smlJsonGetString(metric, false, &measure, &measureLen, &copied);
+  if (unlikely(ret != TSDB_CODE_SUCCESS)) {
+    return ret;
+  }
+  if (copied) {
+    taosArrayPush(info->jsonStrs, &measure);
+  }
+
+  elements->measureLen = measureLen;
   if (IS_INVALID_TABLE_LEN(elements->measureLen)) {
     uError("OTD:0x%" PRIx64 " Metric length is 0 or large than 192", info->id);
     return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
   }
 
-  elements->measure = metric->valuestring;
+  elements->measure = (char *)measure;
   return TSDB_CODE_SUCCESS;
 }
 
 const char    *jsonName[OTD_JSON_FIELDS_NUM] = {"metric", "timestamp", "value", "tags"};
-static int32_t smlGetJsonElements(cJSON *root, cJSON ***marks) {
+static int32_t smlGetJsonElements(SSmlJsonVal *root, SSmlJsonVal *marks) {
+  char       *p = root->start + 1;
+  SSmlJsonVal key = {0};
+  SSmlJsonVal item = {0};
+  bool        end = false;
+
   for (int i = 0; i < OTD_JSON_FIELDS_NUM; ++i) {
-    cJSON *child = root->child;
-    while (child != NULL) {
-      if (strcasecmp(child->string, jsonName[i]) == 0) {
-        *marks[i] = child;
+    marks[i].start = NULL;
+  }
+  for (int32_t i = 0; smlJsonNextItem(&p, i, &key, &item, &end) == TSDB_CODE_SUCCESS && !end; ++i) {
+    for (int j = 0; j < OTD_JSON_FIELDS_NUM; ++j) {
+      if (marks[j].start == NULL && smlJsonIsName(&key, jsonName[j])) {
+        marks[j] = item;
         break;
       }
-      child = child->next;
     }
-    if (*marks[i] == NULL) {
+  }
+
+  for (int i = 0; i < OTD_JSON_FIELDS_NUM; ++i) {
+    if (marks[i].start == NULL) {
       uError("smlGetJsonElements error, not find mark:%d:%s", i, jsonName[i]);
       return TSDB_CODE_TSC_INVALID_JSON;
     }
@@ -294,81 +636,81 @@ static int32_t smlGetJsonElements(cJSON *root, cJSON ***marks) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlConvertJSONBool(SSmlKv *pVal, char *typeStr, cJSON *value) {
+static int32_t smlConvertJSONBool(SSmlKv *pVal, char *typeStr, SSmlJsonVal *value) {
   if (strcasecmp(typeStr, "bool") != 0) {
     uError("OTD:invalid type(%s) for JSON Bool", typeStr);
     return TSDB_CODE_TSC_INVALID_JSON_TYPE;
   }
   pVal->type = TSDB_DATA_TYPE_BOOL;
   pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-  pVal->i = value->valueint;
+  pVal->i = (value->type == SML_JSON_TRUE);
 
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlConvertJSONNumber(SSmlKv *pVal, char *typeStr, cJSON *value) {
+static int32_t smlConvertJSONNumber(SSmlKv *pVal, char *typeStr, SSmlJsonVal *value) {
   // tinyint
   if (strcasecmp(typeStr, "i8") == 0 || strcasecmp(typeStr, "tinyint") == 0) {
-    if (!IS_VALID_TINYINT(value->valuedouble)) {
-      uError("OTD:JSON value(%f) cannot fit in type(tinyint)", value->valuedouble);
+    if (!IS_VALID_TINYINT(value->d)) {
+      uError("OTD:JSON value(%f) cannot fit in type(tinyint)", value->d);
       return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
     }
     pVal->type = TSDB_DATA_TYPE_TINYINT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->i = value->valuedouble;
+    pVal->i = value->d;
     return TSDB_CODE_SUCCESS;
   }
   // smallint
   if (strcasecmp(typeStr, "i16") == 0 || strcasecmp(typeStr, "smallint") == 0) {
-    if (!IS_VALID_SMALLINT(value->valuedouble)) {
-      uError("OTD:JSON value(%f) cannot fit in type(smallint)", value->valuedouble);
+    if (!IS_VALID_SMALLINT(value->d)) {
+      uError("OTD:JSON value(%f) cannot fit in type(smallint)", value->d);
       return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
     }
     pVal->type = TSDB_DATA_TYPE_SMALLINT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->i = value->valuedouble;
+    pVal->i = value->d;
     return TSDB_CODE_SUCCESS;
   }
   // int
   if (strcasecmp(typeStr, "i32") == 0 || strcasecmp(typeStr, "int") == 0) {
-    if (!IS_VALID_INT(value->valuedouble)) {
-      uError("OTD:JSON value(%f) cannot fit in type(int)", value->valuedouble);
+    if (!IS_VALID_INT(value->d)) {
+      uError("OTD:JSON value(%f) cannot fit in type(int)", value->d);
       return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
     }
     pVal->type = TSDB_DATA_TYPE_INT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->i = value->valuedouble;
+    pVal->i = value->d;
     return TSDB_CODE_SUCCESS;
   }
   // bigint
   if (strcasecmp(typeStr, "i64") == 0 || strcasecmp(typeStr, "bigint") == 0) {
     pVal->type = TSDB_DATA_TYPE_BIGINT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    if (value->valuedouble >= (double)INT64_MAX) {
+    if (value->d >= (double)INT64_MAX) {
       pVal->i = INT64_MAX;
-    } else if (value->valuedouble <= (double)INT64_MIN) {
+    } else if (value->d <= (double)INT64_MIN) {
       pVal->i = INT64_MIN;
     } else {
-      pVal->i = value->valuedouble;
+      pVal->i = value->d;
     }
     return TSDB_CODE_SUCCESS;
   }
   // float
   if (strcasecmp(typeStr, "f32") == 0 || strcasecmp(typeStr, "float") == 0) {
-    if (!IS_VALID_FLOAT(value->valuedouble)) {
-      uError("OTD:JSON value(%f) cannot fit in type(float)", value->valuedouble);
+    if (!IS_VALID_FLOAT(value->d)) {
+      uError("OTD:JSON value(%f) cannot fit in type(float)", value->d);
       return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
     }
     pVal->type = TSDB_DATA_TYPE_FLOAT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->f = value->valuedouble;
+    pVal->f = value->d;
     return TSDB_CODE_SUCCESS;
   }
   // double
   if (strcasecmp(typeStr, "f64") == 0 || strcasecmp(typeStr, "double") == 0) {
     pVal->type = TSDB_DATA_TYPE_DOUBLE;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->d = value->valuedouble;
+    pVal->d = value->d;
     return TSDB_CODE_SUCCESS;
   }
 
@@ -377,7 +719,7 @@ static int32_t smlConvertJSONNumber(SSmlKv *pVal, char *typeStr, cJSON *value) {
   return TSDB_CODE_TSC_INVALID_JSON_TYPE;
 }
 
-static int32_t smlConvertJSONString(SSmlKv *pVal, char *typeStr, cJSON *value) {
+static int32_t smlConvertJSONString(SSmlKv *pVal, char *typeStr, SSmlJsonVal *value) {
   if (strcasecmp(typeStr, "binary") == 0) {
     pVal->type = TSDB_DATA_TYPE_BINARY;
   } else if (strcasecmp(typeStr, "varbinary") == 0) {
@@ -388,56 +730,70 @@ static int32_t smlConvertJSONString(SSmlKv *pVal, char *typeStr, cJSON *value) {
     uError("OTD:invalid type(%s) for JSON String", typeStr);
     return TSDB_CODE_TSC_INVALID_JSON_TYPE;
   }
-  pVal->length = strlen(value->valuestring);
+
+  // a varbinary value is always freed with the kv
+  const char *str = NULL;
+  bool        copied = false;
+  int32_t     ret = smlJsonGetString(value, pVal->type == TSDB_DATA_TYPE_VARBINARY, &str, &pVal->length, &copied);
+  if (ret != TSDB_CODE_SUCCESS) {
+    return ret;
+  }
 
   if ((pVal->type == TSDB_DATA_TYPE_BINARY || pVal->type == TSDB_DATA_TYPE_VARBINARY) && pVal->length > TSDB_MAX_BINARY_LEN - VARSTR_HEADER_SIZE) {
-    return TSDB_CODE_PAR_INVALID_VAR_COLUMN_LEN;
+    ret = TSDB_CODE_PAR_INVALID_VAR_COLUMN_LEN;
   }
   if (pVal->type == TSDB_DATA_TYPE_NCHAR &&
       pVal->length > (TSDB_MAX_NCHAR_LEN - VARSTR_HEADER_SIZE) / TSDB_NCHAR_SIZE) {
-    return TSDB_CODE_PAR_INVALID_VAR_COLUMN_LEN;
+    ret = TSDB_CODE_PAR_INVALID_VAR_COLUMN_LEN;
+  }
+  if (ret != TSDB_CODE_SUCCESS) {
+    if (copied) taosMemoryFree((void *)str);
+    return ret;
   }
 
-  pVal->value = value->valuestring;
+  pVal->value = str;
+  pVal->valueEscaped = copied;
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseValueFromJSONObj(cJSON *root, SSmlKv *kv) {
+static int32_t smlParseValueFromJSONObj(SSmlJsonVal *root, SSmlKv *kv) {
   int32_t ret = TSDB_CODE_SUCCESS;
-  int32_t size = cJSON_GetArraySize(root);
 
-  if (size != OTD_JSON_SUB_FIELDS_NUM) {
+  if (root->type != SML_JSON_OBJECT || root->size != OTD_JSON_SUB_FIELDS_NUM) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  cJSON *value = cJSON_GetObjectItem(root, "value");
-  if (value == NULL) {
+  SSmlJsonVal value = {0};
+  SSmlJsonVal type = {0};
+  smlJsonGetValueType(root, &value, &type);
+  if (value.start == NULL) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  cJSON *type = cJSON_GetObjectItem(root, "type");
-  if (!cJSON_IsString(type)) {
+  if (type.start == NULL || type.type != SML_JSON_STRING) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
+  char typeStr[SML_JSON_NAME_LEN];
+  smlJsonGetName(&type, typeStr, sizeof(typeStr));
 
-  switch (value->type) {
-    case cJSON_True:
-    case cJSON_False: {
-      ret = smlConvertJSONBool(kv, type->valuestring, value);
+  switch (value.type) {
+    case SML_JSON_TRUE:
+    case SML_JSON_FALSE: {
+      ret = smlConvertJSONBool(kv, typeStr, &value);
       if (ret != TSDB_CODE_SUCCESS) {
         return ret;
       }
       break;
     }
-    case cJSON_Number: {
-      ret = smlConvertJSONNumber(kv, type->valuestring, value);
+    case SML_JSON_NUMBER: {
+      ret = smlConvertJSONNumber(kv, typeStr, &value);
       if (ret != TSDB_CODE_SUCCESS) {
         return ret;
       }
       break;
     }
-    case cJSON_String: {
-      ret = smlConvertJSONString(kv, type->valuestring, value);
+    case SML_JSON_STRING: {
+      ret = smlConvertJSONString(kv, typeStr, &value);
       if (ret != TSDB_CODE_SUCCESS) {
         return ret;
       }
@@ -450,26 +806,25 @@ static int32_t smlParseValueFromJSONObj(cJSON *root, SSmlKv *kv) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseValueFromJSON(cJSON *root, SSmlKv *kv) {
+static int32_t smlParseValueFromJSON(SSmlJsonVal *root, SSmlKv *kv) {
   switch (root->type) {
-    case cJSON_True:
-    case cJSON_False: {
+    case SML_JSON_TRUE:
+    case SML_JSON_FALSE: {
       kv->type = TSDB_DATA_TYPE_BOOL;
       kv->length = (int16_t)tDataTypes[kv->type].bytes;
-      kv->i = root->valueint;
+      kv->i = (root->type == SML_JSON_TRUE);
       break;
     }
-    case cJSON_Number: {
+    case SML_JSON_NUMBER: {
       kv->type = TSDB_DATA_TYPE_DOUBLE;
       kv->length = (int16_t)tDataTypes[kv->type].bytes;
-      kv->d = root->valuedouble;
+      kv->d = root->d;
       break;
     }
-    case cJSON_String: {
-      smlConvertJSONString(kv, "binary", root);
-      break;
+    case SML_JSON_STRING: {
+      return smlConvertJSONString(kv, "binary", root);
     }
-    case cJSON_Object: {
+    case SML_JSON_OBJECT: {
       int32_t ret = smlParseValueFromJSONObj(root, kv);
       if (ret != TSDB_CODE_SUCCESS) {
         uError("OTD:Failed to parse value from JSON Obj");
@@ -484,38 +839,47 @@ static int32_t smlParseValueFromJSON(cJSON *root, SSmlKv *kv) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlProcessTagJson(SSmlHandle *info, cJSON *tags){
+static int32_t smlProcessTagJson(SSmlHandle *info, SSmlJsonVal *tags){
   SArray *preLineKV = info->preLineTagKV;
   taosArrayClearEx(preLineKV, freeSSmlKv);
   int     cnt = 0;
 
-  int32_t tagNum = cJSON_GetArraySize(tags);
-  if (unlikely(tagNum == 0)) {
+  if (unlikely(tags->type != SML_JSON_OBJECT || tags->size == 0)) {
     uError("SML:Tag should not be empty");
     terrno = TSDB_CODE_TSC_INVALID_JSON;
     return -1;
   }
-  for (int32_t i = 0; i < tagNum; ++i) {
-    cJSON *tag = cJSON_GetArrayItem(tags, i);
-    if (unlikely(tag == NULL)) {
+
+  char       *p = tags->start + 1;
+  SSmlJsonVal key = {0};
+  SSmlJsonVal tag = {0};
+  bool        end = false;
+  for (int32_t i = 0; i < tags->size; ++i) {
+    if (unlikely(smlJsonNextItem(&p, i, &key, &tag, &end) != TSDB_CODE_SUCCESS || end)) {
       terrno = TSDB_CODE_TSC_INVALID_JSON;
       return -1;
     }
-    size_t keyLen = strlen(tag->string);
-    if (unlikely(IS_INVALID_COL_LEN(keyLen))) {
+
+    // add kv to SSmlKv
+    SSmlKv kv = {0};
+    bool   copied = false;
+    int32_t ret = smlJsonGetString(&key, false, &kv.key, &kv.keyLen, &copied);
+    if (unlikely(ret != TSDB_CODE_SUCCESS)) {
+      terrno = ret;
+      return -1;
+    }
+    kv.keyEscaped = copied;
+    if (unlikely(IS_INVALID_COL_LEN(kv.keyLen))) {
       uError("OTD:Tag key length is 0 or too large than 64");
+      freeSSmlKv(&kv);
       terrno =  TSDB_CODE_TSC_INVALID_COLUMN_LENGTH;
       return -1;
     }
 
-    // add kv to SSmlKv
-    SSmlKv kv = {0};
-    kv.key = tag->string;
-    kv.keyLen = keyLen;
-
     // value
-    int32_t ret = smlParseValueFromJSON(tag, &kv);
+    ret = smlParseValueFromJSON(&tag, &kv);
     if (unlikely(ret != TSDB_CODE_SUCCESS)) {
+      freeSSmlKv(&kv);
       terrno =  ret;
       return -1;
     }
@@ -531,7 +895,7 @@ static int32_t smlProcessTagJson(SSmlHandle *info, cJSON *tags){
   return 0;
 }
 
-static int32_t smlParseTagsFromJSON(SSmlHandle *info, cJSON *tags, SSmlLineInfo *elements) {
+static int32_t smlParseTagsFromJSON(SSmlHandle *info, SSmlJsonVal *tags, SSmlLineInfo *elements) {
   int32_t ret = 0;
   if(info->dataFormat){
     ret = smlProcessSuperTable(info, elements);
@@ -550,26 +914,28 @@ static int32_t smlParseTagsFromJSON(SSmlHandle *info, cJSON *tags, SSmlLineInfo
   return smlProcessChildTable(info, elements);
 }
 
-static int64_t smlParseTSFromJSONObj(SSmlHandle *info, cJSON *root, int32_t toPrecision) {
-  int32_t size = cJSON_GetArraySize(root);
-  if (unlikely(size != OTD_JSON_SUB_FIELDS_NUM)) {
+static int64_t smlParseTSFromJSONObj(SSmlHandle *info, SSmlJsonVal *root, int32_t toPrecision) {
+  if (unlikely(root->size != OTD_JSON_SUB_FIELDS_NUM)) {
     smlBuildInvalidDataMsg(&info->msgBuf, "invalidate json", NULL);
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  cJSON *value = cJSON_GetObjectItem(root, "value");
-  if (unlikely(!cJSON_IsNumber(value))) {
+  SSmlJsonVal value = {0};
+  SSmlJsonVal type = {0};
+  smlJsonGetValueType(root, &value, &type);
+  if (unlikely(value.start == NULL || value.type != SML_JSON_NUMBER)) {
     smlBuildInvalidDataMsg(&info->msgBuf, "invalidate json", NULL);
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  cJSON *type = cJSON_GetObjectItem(root, "type");
-  if (unlikely(!cJSON_IsString(type))) {
+  if (unlikely(type.start == NULL || type.type != SML_JSON_STRING)) {
     smlBuildInvalidDataMsg(&info->msgBuf, "invalidate json", NULL);
     return TSDB_CODE_TSC_INVALID_JSON;
   }
+  char typeStr[SML_JSON_NAME_LEN];
+  smlJsonGetName(&type, typeStr, sizeof(typeStr));
 
-  double timeDouble = value->valuedouble;
+  double timeDouble = value.d;
   if (unlikely(smlDoubleToInt64OverFlow(timeDouble))) {
     smlBuildInvalidDataMsg(&info->msgBuf, "timestamp is too large", NULL);
     return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
@@ -584,15 +950,15 @@ static int64_t smlParseTSFromJSONObj(SSmlHandle *info, cJSON *root, int32_t toPr
   }
 
   int64_t tsInt64 = timeDouble;
-  size_t  typeLen = strlen(type->valuestring);
-  if (typeLen == 1 && (type->valuestring[0] == 's' || type->valuestring[0] == 'S')) {
+  size_t  typeLen = strlen(typeStr);
+  if (typeLen == 1 && (typeStr[0] == 's' || typeStr[0] == 'S')) {
     // seconds
     if (smlFactorS[toPrecision] < INT64_MAX / tsInt64) {
       return tsInt64 * smlFactorS[toPrecision];
     }
     return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
-  } else if (typeLen == 2 && (type->valuestring[1] == 's' || type->valuestring[1] == 'S')) {
-    switch (type->valuestring[0]) {
+  } else if (typeLen == 2 && (typeStr[1] == 's' || typeStr[1] == 'S')) {
+    switch (typeStr[0]) {
       case 'm':
       case 'M':
         // milliseconds
@@ -621,12 +987,12 @@ uint8_t smlGetTimestampLen(int64_t num) {
   return len;
 }
 
-static int64_t smlParseTSFromJSON(SSmlHandle *info, cJSON *timestamp) {
+static int64_t smlParseTSFromJSON(SSmlHandle *info, SSmlJsonVal *timestamp) {
   // Timestamp must be the first KV to parse
   int32_t toPrecision = info->currSTableMeta ? info->currSTableMeta->tableInfo.precision : TSDB_TIME_PRECISION_NANO;
-  if (cJSON_IsNumber(timestamp)) {
+  if (timestamp->type == SML_JSON_NUMBER) {
     // timestamp value 0 indicates current system time
-    double timeDouble = timestamp->valuedouble;
+    double timeDouble = timestamp->d;
     if (unlikely(smlDoubleToInt64OverFlow(timeDouble))) {
       smlBuildInvalidDataMsg(&info->msgBuf, "timestamp is too large", NULL);
       return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
@@ -656,7 +1022,7 @@ static int64_t smlParseTSFromJSON(SSmlHandle *info, cJSON *timestamp) {
     } else {
       return convertTimePrecision(timeDouble, fromPrecision, toPrecision);
     }
-  } else if (cJSON_IsObject(timestamp)) {
+  } else if (timestamp->type == SML_JSON_OBJECT) {
     return smlParseTSFromJSONObj(info, timestamp, toPrecision);
   } else {
     smlBuildInvalidDataMsg(&info->msgBuf, "invalidate json", NULL);
@@ -664,26 +1030,24 @@ static int64_t smlParseTSFromJSON(SSmlHandle *info, cJSON *timestamp) {
   }
 }
 
-static int32_t smlParseJSONStringExt(SSmlHandle *info, cJSON *root, SSmlLineInfo *elements) {
+static int32_t smlParseJSONStringExt(SSmlHandle *info, SSmlJsonVal *root, SSmlLineInfo *elements) {
   int32_t ret = TSDB_CODE_SUCCESS;
 
-  cJSON *metricJson = NULL;
-  cJSON *tsJson = NULL;
-  cJSON *valueJson = NULL;
-  cJSON *tagsJson = NULL;
-
-  int32_t size = cJSON_GetArraySize(root);
   // outmost json fields has to be exactly 4
-  if (size != OTD_JSON_FIELDS_NUM) {
-    uError("OTD:0x%" PRIx64 " Invalid number of JSON fields in data point %d", info->id, size);
+  if (root->type != SML_JSON_OBJECT || root->size != OTD_JSON_FIELDS_NUM) {
+    uError("OTD:0x%" PRIx64 " Invalid number of JSON fields in data point %d", info->id, root->size);
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  cJSON **marks[OTD_JSON_FIELDS_NUM] = {&metricJson, &tsJson, &valueJson, &tagsJson};
+  SSmlJsonVal marks[OTD_JSON_FIELDS_NUM] = {0};
   ret = smlGetJsonElements(root, marks);
   if (unlikely(ret != TSDB_CODE_SUCCESS)) {
     return ret;
   }
+  SSmlJsonVal *metricJson = &marks[0];
+  SSmlJsonVal *tsJson = &marks[1];
+  SSmlJsonVal *valueJson = &marks[2];
+  SSmlJsonVal *tagsJson = &marks[3];
 
   // Parse metric
   ret = smlParseMetricFromJSON(info, metricJson, elements);
@@ -697,31 +1061,26 @@ static int32_t smlParseJSONStringExt(SSmlHandle *info, cJSON *root, SSmlLineInfo
   ret = smlParseValueFromJSON(valueJson, &kv);
   if (unlikely(ret)) {
     uError("OTD:0x%" PRIx64 " Unable to parse metric value from JSON payload", info->id);
+    freeSSmlKv(&kv);
     return ret;
   }
 
-  // Parse tags
-  bool needFree = info->dataFormat;
-  elements->tags = cJSON_PrintUnformatted(tagsJson);
-  elements->tagsLen = strlen(elements->tags);
+  // Parse tags, the text of the tags object tells the child table as the fast path does
+  elements->tags = tagsJson->start;
+  elements->tagsLen = tagsJson->len;
   if (is_same_child_table_telnet(elements, &info->preLine) != 0) {
     ret = smlParseTagsFromJSON(info, tagsJson, elements);
     if (unlikely(ret)) {
       uError("OTD:0x%" PRIx64 " Unable to parse tags from JSON payload", info->id);
-      taosMemoryFree(elements->tags);
-      elements->tags = NULL;
+      freeSSmlKv(&kv);
       return ret;
     }
   } else {
     elements->measureTag = info->preLine.measureTag;
   }
 
-  if (needFree) {
-    taosMemoryFree(elements->tags);
-    elements->tags = NULL;
-  }
-
   if (unlikely(info->reRun)) {
+    freeSSmlKv(&kv);
     return TSDB_CODE_SUCCESS;
   }
 
@@ -730,12 +1089,17 @@ static int32_t smlParseJSONStringExt(SSmlHandle *info, cJSON *root, SSmlLineInfo
   int64_t ts = smlParseTSFromJSON(info, tsJson);
   if (unlikely(ts < 0)) {
     uError("OTD:0x%" PRIx64 " Unable to parse timestamp from JSON payload", info->id);
+    freeSSmlKv(&kv);
     return TSDB_CODE_INVALID_TIMESTAMP;
   }
   SSmlKv kvTs = {0};
   smlBuildTsKv(&kvTs, ts);
 
-  return smlParseEndTelnetJson(info, elements, &kvTs, &kv);
+  ret = smlParseEndTelnetJson(info, elements, &kvTs, &kv);
+  if (info->dataFormat) {
+    freeSSmlKv(&kv);
+  }
+  return ret;
 }
 
 static int32_t smlParseJSONExt(SSmlHandle *info, char *payload) {
@@ -747,16 +1111,21 @@ static int32_t smlParseJSONExt(SSmlHandle *info, char *payload) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  info->root = cJSON_Parse(payload);
-  if (unlikely(info->root == NULL)) {
+  // the whole payload is checked before any data point is parsed, and a utf8 bom is skipped as cJSON does
+  char       *start = payload;
+  SSmlJsonVal root = {0};
+  if (strncmp(start, "\xEF\xBB\xBF", 3) == 0) {
+    start += 3;
+  }
+  if (unlikely(smlJsonReadValue(&start, &root) != TSDB_CODE_SUCCESS)) {
     uError("SML:0x%" PRIx64 " parse json failed:%s", info->id, payload);
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
   // multiple data points must be sent in JSON array
-  if (cJSON_IsArray(info->root)) {
-    payloadNum = cJSON_GetArraySize(info->root);
-  } else if (cJSON_IsObject(info->root)) {
+  if (root.type == SML_JSON_ARRAY) {
+    payloadNum = root.size;
+  } else if (root.type == SML_JSON_OBJECT) {
     payloadNum = 1;
   } else {
     uError("SML:0x%" PRIx64 " Invalid JSON Payload 3:%s", info->id, payload);
@@ -779,17 +1148,20 @@ static int32_t smlParseJSONExt(SSmlHandle *info, char *payload) {
     return ret;
   }
 
-  info->parseJsonByLib = true;
-  cJSON *head = (payloadNum == 1 && cJSON_IsObject(info->root)) ? info->root : info->root->child;
+  int         cnt = 0;
+  char       *next = root.start + 1;
+  SSmlJsonVal dataPoint = root;
+  bool        end = false;
+  while (cnt < payloadNum) {
+    if (root.type == SML_JSON_ARRAY && smlJsonNextItem(&next, cnt, NULL, &dataPoint, &end) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_TSC_INVALID_JSON;
+    }
 
-  int    cnt = 0;
-  cJSON *dataPoint = head;
-  while (dataPoint) {
     if (info->dataFormat) {
       SSmlLineInfo element = {0};
-      ret = smlParseJSONStringExt(info, dataPoint, &element);
+      ret = smlParseJSONStringExt(info, &dataPoint, &element);
     } else {
-      ret = smlParseJSONStringExt(info, dataPoint, info->lines + cnt);
+      ret = smlParseJSONStringExt(info, &dataPoint, info->lines + cnt);
     }
     if (unlikely(ret != TSDB_CODE_SUCCESS)) {
       uError("SML:0x%" PRIx64 " Invalid JSON Payload 2:%s", info->id, payload);
@@ -798,7 +1170,7 @@ static int32_t smlParseJSONExt(SSmlHandle *info, char *payload) {
 
     if (unlikely(info->reRun)) {
       cnt = 0;
-      dataPoint = head;
+      next = root.start + 1;
       info->lineNum = payloadNum;
       ret = smlClearForRerun(info);
       if (ret != TSDB_CODE_SUCCESS) {
@@ -807,7 +1179,6 @@ static int32_t smlParseJSONExt(SSmlHandle *info, char *payload) {
       continue;
     }
     cnt++;
-    dataPoint = dataPoint->next;
   }
 
   return TSDB_CODE_SUCCESS;
@@ -841,16 +1212,18 @@ static int32_t smlParseJSONString(SSmlHandle *info, char **start, SSmlLineInfo *
   } else if (unlikely(elements->cols[0] == '{')) {
     char tmp = elements->cols[elements->colsLen];
     elements->cols[elements->colsLen] = '\0';
-    cJSON *valueJson = cJSON_Parse(elements->cols);
-    if (unlikely(valueJson == NULL)) {
+    char       *valueStart = elements->cols;
+    SSmlJsonVal valueJson = {0};
+    if (unlikely(smlJsonReadValue(&valueStart, &valueJson) != TSDB_CODE_SUCCESS)) {
       uError("SML:0x%" PRIx64 " parse json cols failed:%s", info->id, elements->cols);
+      elements->cols[elements->colsLen] = tmp;
       return TSDB_CODE_TSC_INVALID_JSON;
     }
-    taosArrayPush(info->tagJsonArray, &valueJson);
-    ret = smlParseValueFromJSONObj(valueJson, &kv);
+    ret = smlParseValueFromJSONObj(&valueJson, &kv);
     if (ret != TSDB_CODE_SUCCESS) {
       uError("SML:Failed to parse value from JSON Obj:%s", elements->cols);
       elements->cols[elements->colsLen] = tmp;
+      freeSSmlKv(&kv);
       return TSDB_CODE_TSC_INVALID_VALUE;
     }
     elements->cols[elements->colsLen] = tmp;
@@ -863,17 +1236,21 @@ static int32_t smlParseJSONString(SSmlHandle *info, char **start, SSmlLineInfo *
   if (is_same_child_table_telnet(elements, &info->preLine) != 0) {
     char tmp = *(elements->tags + elements->tagsLen);
     *(elements->tags + elements->tagsLen) = 0;
-    cJSON *tagsJson = cJSON_Parse(elements->tags);
-    *(elements->tags + elements->tagsLen) = tmp;
-    if (unlikely(tagsJson == NULL)) {
+    char       *tagsStart = elements->tags;
+    SSmlJsonVal tagsJson = {0};
+    ret = smlJsonReadValue(&tagsStart, &tagsJson);
+    if (unlikely(ret != TSDB_CODE_SUCCESS)) {
       uError("SML:0x%" PRIx64 " parse json tag failed:%s", info->id, elements->tags);
+      *(elements->tags + elements->tagsLen) = tmp;
+      freeSSmlKv(&kv);
       return TSDB_CODE_TSC_INVALID_JSON;
     }
 
-    taosArrayPush(info->tagJsonArray, &tagsJson);
-    ret = smlParseTagsFromJSON(info, tagsJson, elements);
+    ret = smlParseTagsFromJSON(info, &tagsJson, elements);
+    *(elements->tags + elements->tagsLen) = tmp;
     if (unlikely(ret)) {
       uError("OTD:0x%" PRIx64 " Unable to parse tags from JSON payload", info->id);
+      freeSSmlKv(&kv);
       return ret;
     }
   } else {
@@ -881,6 +1258,7 @@ static int32_t smlParseJSONString(SSmlHandle *info, char **start, SSmlLineInfo *
   }
 
   if (unlikely(info->reRun)) {
+    freeSSmlKv(&kv);
     return TSDB_CODE_SUCCESS;
   }
 
@@ -889,31 +1267,40 @@ static int32_t smlParseJSONString(SSmlHandle *info, char **start, SSmlLineInfo *
   int64_t ts = 0;
   if (unlikely(elements->timestampLen == 0)) {
     uError("OTD:0x%" PRIx64 " elements->timestampLen == 0", info->id);
+    freeSSmlKv(&kv);
     return TSDB_CODE_INVALID_TIMESTAMP;
   } else if (elements->timestamp[0] == '{') {
     char tmp = elements->timestamp[elements->timestampLen];
     elements->timestamp[elements->timestampLen] = '\0';
-    cJSON *tsJson = cJSON_Parse(elements->timestamp);
-    ts = smlParseTSFromJSON(info, tsJson);
+    char       *tsStart = elements->timestamp;
+    SSmlJsonVal tsJson = {0};
+    if (unlikely(smlJsonReadValue(&tsStart, &tsJson) != TSDB_CODE_SUCCESS)) {
+      tsJson.type = SML_JSON_NULL;
+    }
+    ts = smlParseTSFromJSON(info, &tsJson);
     if (unlikely(ts < 0)) {
       uError("SML:0x%" PRIx64 " Unable to parse timestamp from JSON payload:%s", info->id, elements->timestamp);
       elements->timestamp[elements->timestampLen] = tmp;
-      cJSON_Delete(tsJson);
+      freeSSmlKv(&kv);
       return TSDB_CODE_INVALID_TIMESTAMP;
     }
     elements->timestamp[elements->timestampLen] = tmp;
-    cJSON_Delete(tsJson);
   } else {
     ts = smlParseOpenTsdbTime(info, elements->timestamp, elements->timestampLen);
     if (unlikely(ts < 0)) {
       uError("OTD:0x%" PRIx64 " Unable to parse timestamp from JSON payload", info->id);
+      freeSSmlKv(&kv);
       return TSDB_CODE_INVALID_TIMESTAMP;
     }
   }
   SSmlKv kvTs = {0};
   smlBuildTsKv(&kvTs, ts);
 
-  return smlParseEndTelnetJson(info, elements, &kvTs, &kv);
+  ret = smlParseEndTelnetJson(info, elements, &kvTs, &kv);
+  if (info->dataFormat) {
+    freeSSmlKv(&kv);
+  }
+  return ret;
 }
 
 int32_t smlParseJSON(SSmlHandle *info, char *payload) {
@@ -52,7 +52,7 @@ uint8_t smlPrecisionConvert[] = {TSDB_TIME_PRECISION_NANO,    TSDB_TIME_PRECISIO
                                   TSDB_TIME_PRECISION_SECONDS, TSDB_TIME_PRECISION_MILLI, TSDB_TIME_PRECISION_MICRO,
                                   TSDB_TIME_PRECISION_NANO};
 
-static int64_t smlParseInfluxTime(SSmlHandle *info, const char *data, int32_t len) {
+static int64_t smlParseInfluxTime(SSmlHandle *info, SSmlMsgBuf *msg, const char *data, int32_t len) {
   uint8_t toPrecision = info->currSTableMeta ? info->currSTableMeta->tableInfo.precision : TSDB_TIME_PRECISION_NANO;
 
   if (unlikely(len == 0 || (len == 1 && data[0] == '0'))) {
@@ -63,7 +63,7 @@ static int64_t smlParseInfluxTime(SSmlHandle *info, const char *data, int32_t le
 
   int64_t ts = smlGetTimeValue(data, len, fromPrecision, toPrecision);
   if (unlikely(ts == -1)) {
-    smlBuildInvalidDataMsg(&info->msgBuf, "invalid timestamp", data);
+    smlBuildInvalidDataMsg(msg, "invalid timestamp", data);
     return TSDB_CODE_SML_INVALID_DATA;
   }
   return ts;
@@ -323,7 +323,7 @@ static int32_t smlParseTagLine(SSmlHandle *info, char **sql, char *sqlEnd, SSmlL
   return smlProcessChildTable(info, elements);
 }
 
-static int32_t smlParseColLine(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLineInfo *currElement) {
+static int32_t smlParseColLine(SSmlHandle *info, SSmlMsgBuf *msg, char **sql, char *sqlEnd, SSmlLineInfo *currElement) {
   int cnt = 0;
   while (*sql < sqlEnd) {
     if (unlikely(IS_SPACE(*sql))) {
@@ -337,7 +337,7 @@ static int32_t smlParseColLine(SSmlHandle *info, char **sql, char *sqlEnd, SSmlL
     size_t      keyLenEscaped = 0;
     while (*sql < sqlEnd) {
       if (unlikely(IS_SPACE(*sql) || IS_COMMA(*sql))) {
-        smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", *sql);
+        smlBuildInvalidDataMsg(msg, "invalid data", *sql);
         return TSDB_CODE_SML_INVALID_DATA;
       }
       if (unlikely(IS_EQUAL(*sql))) {
@@ -353,7 +353,7 @@ static int32_t smlParseColLine(SSmlHandle *info, char **sql, char *sqlEnd, SSmlL
     }
 
     if (unlikely(IS_INVALID_COL_LEN(keyLen - keyLenEscaped))) {
-      smlBuildInvalidDataMsg(&info->msgBuf, "invalid key or key is too long than 64", key);
+      smlBuildInvalidDataMsg(msg, "invalid key or key is too long than 64", key);
       return TSDB_CODE_TSC_INVALID_COLUMN_LENGTH;
     }
 
@@ -388,18 +388,18 @@ static int32_t smlParseColLine(SSmlHandle *info, char **sql, char *sqlEnd, SSmlL
     valueLen = *sql - value;
 
     if (unlikely(quoteNum != 0 && quoteNum != 2)) {
-      smlBuildInvalidDataMsg(&info->msgBuf, "unbalanced quotes", value);
+      smlBuildInvalidDataMsg(msg, "unbalanced quotes", value);
       return TSDB_CODE_SML_INVALID_DATA;
     }
     if (unlikely(valueLen == 0)) {
-      smlBuildInvalidDataMsg(&info->msgBuf, "invalid value", value);
+      smlBuildInvalidDataMsg(msg, "invalid value", value);
       return TSDB_CODE_SML_INVALID_DATA;
     }
 
     SSmlKv  kv = {.key = key, .keyLen = keyLen, .value = value, .length = valueLen};
-    int32_t ret = smlParseValue(&kv, &info->msgBuf);
+    int32_t ret = smlParseValue(&kv, msg);
     if (ret != TSDB_CODE_SUCCESS) {
-      smlBuildInvalidDataMsg(&info->msgBuf, "smlParseValue error", value);
+      smlBuildInvalidDataMsg(msg, "smlParseValue error", value);
       return ret;
     }
 
@@ -446,8 +446,9 @@ static int32_t smlParseColLine(SSmlHandle *info, char **sql, char *sqlEnd, SSmlL
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLineInfo *elements) {
-  if (!sql) return TSDB_CODE_SML_INVALID_DATA;
+// parse the measure of a line, and locate its tags
+static int32_t smlParseInfluxMeasure(SSmlMsgBuf *msg, char **pSql, char *sqlEnd, SSmlLineInfo *elements) {
+  char *sql = *pSql;
   JUMP_SPACE(sql, sqlEnd)
   if (unlikely(*sql == COMMA)) return TSDB_CODE_SML_INVALID_DATA;
   elements->measure = sql;
@@ -471,7 +472,7 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
   }
   elements->measureLen = sql - elements->measure;
   if (unlikely(IS_INVALID_TABLE_LEN(elements->measureLen - measureLenEscaped))) {
-    smlBuildInvalidDataMsg(&info->msgBuf, "measure is empty or too large than 192", NULL);
+    smlBuildInvalidDataMsg(msg, "measure is empty or too large than 192", NULL);
     return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
   }
 
@@ -488,23 +489,21 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
   // parse tag
   if (*sql == COMMA) sql++;
   elements->tags = sql;
+  *pSql = sql;
+  return TSDB_CODE_SUCCESS;
+}
 
-  int ret = smlParseTagLine(info, &sql, sqlEnd, elements);
-  if (unlikely(ret != TSDB_CODE_SUCCESS)) {
-    return ret;
-  }
-  if (unlikely(info->reRun)) {
-    return TSDB_CODE_SUCCESS;
-  }
-
-  sql = elements->measure + elements->measureTagsLen;
+// parse the cols and timestamp of a line, after its tags
+static int32_t smlParseInfluxColsTs(SSmlHandle *info, SSmlMsgBuf *msg, char *sqlEnd, SSmlLineInfo *elements,
+                                    SSmlKv *kvTs) {
+  char *sql = elements->measure + elements->measureTagsLen;
   elements->tagsLen = sql - elements->tags;
 
   // parse cols
   JUMP_SPACE(sql, sqlEnd)
   elements->cols = sql;
 
-  ret = smlParseColLine(info, &sql, sqlEnd, elements);
+  int32_t ret = smlParseColLine(info, msg, &sql, sqlEnd, elements);
   if (unlikely(ret != TSDB_CODE_SUCCESS)) {
     return ret;
   }
@@ -515,7 +514,7 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
 
   elements->colsLen = sql - elements->cols;
   if (unlikely(elements->colsLen == 0)) {
-    smlBuildInvalidDataMsg(&info->msgBuf, "cols is empty", NULL);
+    smlBuildInvalidDataMsg(msg, "cols is empty", NULL);
     return TSDB_CODE_SML_INVALID_DATA;
   }
 
@@ -530,14 +529,68 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
   }
   elements->timestampLen = sql - elements->timestamp;
 
-  int64_t ts = smlParseInfluxTime(info, elements->timestamp, elements->timestampLen);
+  int64_t ts = smlParseInfluxTime(info, msg, elements->timestamp, elements->timestampLen);
   if (unlikely(ts <= 0)) {
     uError("SML:0x%" PRIx64 " smlParseTS error:%" PRId64, info->id, ts);
     return TSDB_CODE_INVALID_TIMESTAMP;
   }
 
+  smlBuildTsKv(kvTs, ts);
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLineInfo *elements) {
+  if (!sql) return TSDB_CODE_SML_INVALID_DATA;
+  int ret = smlParseInfluxMeasure(&info->msgBuf, &sql, sqlEnd, elements);
+  if (unlikely(ret != TSDB_CODE_SUCCESS)) {
+    return ret;
+  }
+
+  ret = smlParseTagLine(info, &sql, sqlEnd, elements);
+  if (unlikely(ret != TSDB_CODE_SUCCESS)) {
+    return ret;
+  }
+  if (unlikely(info->reRun)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
   SSmlKv kvTs = {0};
-  smlBuildTsKv(&kvTs, ts);
+  ret = smlParseInfluxColsTs(info, &info->msgBuf, sqlEnd, elements, &kvTs);
+  if (unlikely(ret != TSDB_CODE_SUCCESS || info->reRun)) {
+    return ret;
+  }
 
   return smlParseEndLine(info, elements, &kvTs);
 }
+
+// Parse a line except its tags, which are left to smlParseInfluxTags. It touches nothing but elements and msg, so the
+// lines can be parsed on several threads, only for !info->dataFormat.
+int32_t smlParseInfluxStringNoTags(SSmlHandle *info, SSmlMsgBuf *msg, char *sql, char *sqlEnd,
+                                   SSmlLineInfo *elements) {
+  if (!sql) return TSDB_CODE_SML_INVALID_DATA;
+  int32_t ret = smlParseInfluxMeasure(msg, &sql, sqlEnd, elements);
+  if (unlikely(ret != TSDB_CODE_SUCCESS)) {
+    return ret;
+  }
+
+  SSmlKv kvTs = {0};
+  ret = smlParseInfluxColsTs(info, msg, sqlEnd, elements, &kvTs);
+  if (unlikely(ret != TSDB_CODE_SUCCESS)) {
+    return ret;
+  }
+
+  taosArraySet(elements->colArray, 0, &kvTs);
+  return TSDB_CODE_SUCCESS;
+}
+
+// parse the tags of a line parsed by smlParseInfluxStringNoTags, in the order of lines as smlParseInfluxString does
+int32_t smlParseInfluxTags(SSmlHandle *info, SSmlLineInfo *elements) {
+  char   *sql = elements->tags;
+  int32_t ret = smlParseTagLine(info, &sql, elements->measure + elements->measureTagsLen, elements);
+  if (unlikely(ret != TSDB_CODE_SUCCESS)) {
+    return ret;
+  }
+
+  info->preLine = *elements;
+  return TSDB_CODE_SUCCESS;
+}
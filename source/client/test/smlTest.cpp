@@ -14,6 +14,8 @@
  */
 
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 
 #include <taoserror.h>
 #include <tglobal.h>
@@ -26,6 +28,7 @@
 #pragma GCC diagnostic ignored "-Wsign-compare"
 
 #include "../inc/clientSml.h"
+#include "cJSON.h"
 #include "taos.h"
 
 int main(int argc, char **argv) {
@@ -557,6 +560,267 @@ TEST(testCase, smlParseTelnetLine_Test) {
 //  smlDestroyInfo(info);
 //}
 
+// lines of 3 stables and 150 child tables, with escaped keys and values
+static char *buildInfluxLines(int32_t numLines, std::vector<char *> &lines, std::vector<int32_t> &lens) {
+  char   *data = (char *)taosMemoryCalloc(numLines, 160);
+  int32_t len = 0;
+  for (int32_t i = 0; i < numLines; i++) {
+    lines.push_back(data + len);
+    lens.push_back(sprintf(data + len,
+                           "st%d,t1=%d,t\\ 2=a\\,b c1=%di64,c\\=2=\"v\\\"%d\",c3=%s,c4=%d.5 %" PRId64, i % 3, i % 50,
+                           i, i * 7, (i % 2) ? "true" : "f", i, (int64_t)1626006833639000000 + i));
+    len += lens.back() + 1;
+  }
+  return data;
+}
+
+static SSmlHandle *buildInfluxInfo(int32_t numLines) {
+  SSmlHandle *info = smlBuildSmlInfo(NULL);
+  info->protocol = TSDB_SML_LINE_PROTOCOL;
+  info->dataFormat = false;
+  info->lineNum = numLines;
+  info->lines = (SSmlLineInfo *)taosMemoryCalloc(numLines, sizeof(SSmlLineInfo));
+  return info;
+}
+
+TEST(testCase, smlParseInfluxStringNoTags_Test) {
+  const int32_t        numLines = 20000;
+  const int32_t        numThreads = 4;
+  std::vector<char *>  lines;
+  std::vector<int32_t> lens;
+  char                *data = buildInfluxLines(numLines, lines, lens);
+
+  // a line of an invalid col in the middle
+  int32_t errLine = numLines / 2 + 3;
+  strstr(lines[errLine], " c1=")[4] = ',';
+
+  char        serialBuf[256] = {0};
+  SSmlHandle *serial = buildInfluxInfo(numLines);
+  serial->msgBuf = {sizeof(serialBuf), serialBuf};
+  int32_t serialCode = 0;
+  int32_t serialLine = 0;
+  for (; serialLine < numLines; serialLine++) {
+    serialCode =
+        smlParseInfluxString(serial, lines[serialLine], lines[serialLine] + lens[serialLine], serial->lines + serialLine);
+    if (serialCode != 0) break;
+  }
+  ASSERT_NE(serialCode, 0);
+  ASSERT_EQ(serialLine, errLine);
+
+  // the lines but their tags on several threads, then the tags in the order of lines
+  char                     splitBuf[256] = {0};
+  SSmlHandle              *split = buildInfluxInfo(numLines);
+  std::vector<int32_t>     codes(numLines, 0);
+  std::vector<std::thread> threads;
+  split->msgBuf = {sizeof(splitBuf), splitBuf};
+  for (int32_t t = 0; t < numThreads; t++) {
+    threads.emplace_back([&, t]() {
+      char       buf[256] = {0};
+      SSmlMsgBuf msg = {sizeof(buf), buf};
+      for (int32_t i = t; i < numLines; i += numThreads) {
+        codes[i] = smlParseInfluxStringNoTags(split, &msg, lines[i], lines[i] + lens[i], split->lines + i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  int32_t splitLine = 0;
+  int32_t splitCode = 0;
+  for (; splitLine < numLines; splitLine++) {
+    splitCode = smlParseInfluxTags(split, split->lines + splitLine);
+    if (splitCode == 0) splitCode = codes[splitLine];
+    if (splitCode != 0) break;
+  }
+  ASSERT_EQ(splitCode, serialCode);
+  ASSERT_EQ(splitLine, serialLine);
+  ASSERT_EQ(taosHashGetSize(split->childTables), taosHashGetSize(serial->childTables));
+  ASSERT_EQ(taosHashGetSize(split->childTables), 150);
+
+  for (int32_t i = 0; i < errLine; i++) {
+    SSmlLineInfo *pSerial = serial->lines + i;
+    SSmlLineInfo *pSplit = split->lines + i;
+    ASSERT_EQ(pSplit->measureLen, pSerial->measureLen);
+    ASSERT_EQ(pSplit->measureTagsLen, pSerial->measureTagsLen);
+    ASSERT_EQ(pSplit->tagsLen, pSerial->tagsLen);
+    ASSERT_EQ(pSplit->colsLen, pSerial->colsLen);
+    ASSERT_EQ(taosArrayGetSize(pSplit->colArray), taosArrayGetSize(pSerial->colArray));
+    for (int32_t j = 0; j < taosArrayGetSize(pSerial->colArray); j++) {
+      SSmlKv *kv1 = (SSmlKv *)taosArrayGet(pSerial->colArray, j);
+      SSmlKv *kv2 = (SSmlKv *)taosArrayGet(pSplit->colArray, j);
+      ASSERT_EQ(kv2->type, kv1->type);
+      ASSERT_EQ(kv2->keyLen, kv1->keyLen);
+      ASSERT_EQ(memcmp(kv2->key, kv1->key, kv1->keyLen), 0);
+      ASSERT_EQ(kv2->length, kv1->length);
+      if (IS_VAR_DATA_TYPE(kv1->type)) {
+        ASSERT_EQ(memcmp(kv2->value, kv1->value, kv1->length), 0);
+      } else {
+        ASSERT_EQ(kv2->i, kv1->i);
+      }
+    }
+  }
+
+  smlDestroyInfo(serial);
+  smlDestroyInfo(split);
+  taosMemoryFree(data);
+}
+
+// a random json value of nested containers, escaped strings, numbers and literals
+static void buildJsonValue(std::string &json, uint32_t *seed, int32_t depth) {
+  static const char *strs[] = {"",           "a",           "metric",          "Value",         "t\\\"1",
+                               "c:\\\\path", "\\/\\b\\f\\n\\r\\t", "\\u00e9t\\u00C9", "\\ud83d\\ude00", "\\u4e2d\\u6587",
+                               "sp ace,{}[]", "\\u0000cut"};
+  static const char *nums[] = {"0",    "-1",   "123456789012", "3.25", "-0.5e3", "1E-2", "1.7976931348623157e308",
+                               "1e999", "01", "-0"};
+  static const char *spaces[] = {"", " ", "\n\t ", "\r"};
+
+  json += spaces[taosRandR(seed) % 4];
+  int32_t r = taosRandR(seed) % (depth < 4 ? 8 : 5);
+  switch (r) {
+    case 0:
+      json += "null";
+      break;
+    case 1:
+      json += (taosRandR(seed) % 2) ? "true" : "false";
+      break;
+    case 2:
+    case 3:
+      json += nums[taosRandR(seed) % (sizeof(nums) / sizeof(nums[0]))];
+      break;
+    case 4:
+      json += "\"";
+      json += strs[taosRandR(seed) % (sizeof(strs) / sizeof(strs[0]))];
+      json += "\"";
+      break;
+    default: {
+      bool    isObject = (r != 5);
+      int32_t num = taosRandR(seed) % 5;
+      json += isObject ? "{" : "[";
+      for (int32_t i = 0; i < num; i++) {
+        if (i > 0) json += ",";
+        if (isObject) {
+          json += spaces[taosRandR(seed) % 4];
+          json += "\"";
+          json += strs[taosRandR(seed) % (sizeof(strs) / sizeof(strs[0]))];
+          json += "\"";
+          json += spaces[taosRandR(seed) % 4];
+          json += ":";
+        }
+        buildJsonValue(json, seed, depth + 1);
+      }
+      json += spaces[taosRandR(seed) % 4];
+      json += isObject ? "}" : "]";
+      break;
+    }
+  }
+}
+
+static void checkJsonString(const char *expected, SSmlJsonVal *str) {
+  std::vector<char> buf(str->len + 1);
+  int32_t           len = str->len;
+  ASSERT_EQ(smlJsonUnescape(str->start, str->len, buf.data(), &len), 0);
+  buf[len] = '\0';
+  ASSERT_STREQ(buf.data(), expected);
+}
+
+static void checkJsonValue(cJSON *node, SSmlJsonVal *val) {
+  switch (node->type & 0xFF) {
+    case cJSON_NULL:
+      ASSERT_EQ(val->type, SML_JSON_NULL);
+      break;
+    case cJSON_False:
+      ASSERT_EQ(val->type, SML_JSON_FALSE);
+      break;
+    case cJSON_True:
+      ASSERT_EQ(val->type, SML_JSON_TRUE);
+      break;
+    case cJSON_Number:
+      ASSERT_EQ(val->type, SML_JSON_NUMBER);
+      ASSERT_EQ(val->d, node->valuedouble);
+      break;
+    case cJSON_String:
+      ASSERT_EQ(val->type, SML_JSON_STRING);
+      ASSERT_NO_FATAL_FAILURE(checkJsonString(node->valuestring, val));
+      break;
+    default: {
+      bool isObject = ((node->type & 0xFF) == cJSON_Object);
+      ASSERT_EQ(val->type, isObject ? SML_JSON_OBJECT : SML_JSON_ARRAY);
+
+      char       *p = val->start + 1;
+      SSmlJsonVal key = {0};
+      SSmlJsonVal item = {0};
+      bool        end = false;
+      int32_t     size = 0;
+      for (cJSON *child = node->child; child != NULL; child = child->next, size++) {
+        ASSERT_EQ(smlJsonNextItem(&p, size, isObject ? &key : NULL, &item, &end), 0);
+        ASSERT_FALSE(end);
+        if (isObject) {
+          ASSERT_NO_FATAL_FAILURE(checkJsonString(child->string, &key));
+        }
+        ASSERT_NO_FATAL_FAILURE(checkJsonValue(child, &item));
+      }
+      ASSERT_EQ(smlJsonNextItem(&p, size, isObject ? &key : NULL, &item, &end), 0);
+      ASSERT_TRUE(end);
+      ASSERT_EQ(size, val->size);
+      ASSERT_EQ(p - val->start, val->len);
+      break;
+    }
+  }
+}
+
+static void checkJsonDoc(const std::string &json) {
+  std::vector<char> doc(json.begin(), json.end());
+  doc.push_back('\0');
+
+  cJSON      *root = cJSON_Parse(doc.data());
+  char       *p = doc.data();
+  SSmlJsonVal val = {0};
+  int32_t     code = smlJsonReadValue(&p, &val);
+  ASSERT_EQ(code == TSDB_CODE_SUCCESS, root != NULL) << json;
+  if (root != NULL) {
+    checkJsonValue(root, &val);
+    cJSON_Delete(root);
+  }
+}
+
+TEST(testCase, smlJsonReadValue_Test) {
+  static const char chars[] = "{}[]\",:\\u0123456789aAeE.+- tnf\x01\xC3";
+  uint32_t          seed = 100;
+
+  // random documents compared with cJSON, every other one with a random char deleted, replaced or inserted
+  for (int32_t i = 0; i < 20000; i++) {
+    std::string json;
+    buildJsonValue(json, &seed, 0);
+    if (i % 2 == 1 && !json.empty()) {
+      size_t pos = taosRandR(&seed) % json.size();
+      char   c = chars[taosRandR(&seed) % (sizeof(chars) - 1)];
+      switch (taosRandR(&seed) % 3) {
+        case 0:
+          json.erase(pos, 1);
+          break;
+        case 1:
+          json[pos] = c;
+          break;
+        default:
+          json.insert(pos, 1, c);
+          break;
+      }
+    }
+    ASSERT_NO_FATAL_FAILURE(checkJsonDoc(json));
+  }
+
+  // the nesting limit of cJSON
+  ASSERT_NO_FATAL_FAILURE(checkJsonDoc(std::string(1000, '[') + std::string(1000, ']')));
+  ASSERT_NO_FATAL_FAILURE(checkJsonDoc(std::string(1001, '[') + std::string(1001, ']')));
+
+  // the escape sequences cJSON rejects
+  const char *invalid[] = {"\"\\x\"", "\"\\u12\"", "\"\\ude00\"", "\"\\ud83d\\u0041\"", "\"\\ud83d\"", "\"abc"};
+  for (int32_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    ASSERT_NO_FATAL_FAILURE(checkJsonDoc(invalid[i]));
+  }
+}
+
 TEST(testCase, smlParseNumber_performance_Test) {
   char       msg[256] = {0};
   SSmlMsgBuf msgBuf;
@@ -889,11 +889,6 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock) {
   return rowSize;
 }
 
-typedef struct SSDataBlockSortHelper {
-  SArray*      orderInfo;  // SArray<SBlockOrderInfo>
-  SSDataBlock* pDataBlock;
-} SSDataBlockSortHelper;
-
 int32_t dataBlockCompar(const void* p1, const void* p2, const void* param) {
   const SSDataBlockSortHelper* pHelper = (const SSDataBlockSortHelper*)param;
 
@@ -1113,27 +1108,24 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
 
   int64_t p1 = taosGetTimestampUs();
 
+  int32_t code = blockDataReorder(pDataBlock, index);
+  int64_t p2 = taosGetTimestampUs();
+
+  uDebug("blockDataSort complex sort:%" PRId64 ", reorder:%" PRId64 ", rows:%d\n", p1 - p0, p2 - p1, rows);
+  destroyTupleIndex(index);
+
+  return code;
+}
+
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* index) {
   SColumnInfoData* pCols = createHelpColInfoData(pDataBlock);
   if (pCols == NULL) {
-    destroyTupleIndex(index);
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return terrno;
   }
 
-  int64_t p2 = taosGetTimestampUs();
-
   blockDataAssign(pCols, pDataBlock, index);
-
-  int64_t p3 = taosGetTimestampUs();
-
   copyBackToBlock(pDataBlock, pCols);
-  int64_t p4 = taosGetTimestampUs();
-
-  uDebug("blockDataSort complex sort:%" PRId64 ", create:%" PRId64 ", assign:%" PRId64 ", copyback:%" PRId64
-         ", rows:%d\n",
-         p1 - p0, p2 - p1, p3 - p2, p4 - p3, rows);
-  destroyTupleIndex(index);
-
   return TSDB_CODE_SUCCESS;
 }
 
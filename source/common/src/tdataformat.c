@@ -2518,67 +2518,211 @@ _exit:
   return code;
 }
 
-int32_t tColDataAddValueByBind(SColData *pColData, TAOS_MULTI_BIND *pBind, int32_t buffMaxLen) {
+// the bit of a value of state v (0: none, 1: null, 2: value) in the bitmap of flag
+static FORCE_INLINE uint8_t tColDataFlagBit(uint8_t flag, uint8_t v) {
+  switch (flag) {
+    case (HAS_NULL | HAS_NONE):
+      return v;
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      return v == 2;
+    default:
+      return v;
+  }
+}
+
+// switch pColData to the encoding of flag, which includes the current one, as the per-value appends do when a new
+// kind of value comes
+static int32_t tColDataUpgradeFlag(SColData *pColData, uint8_t flag) {
   int32_t code = 0;
 
-  if (!(pBind->num == 1 && pBind->is_null && *pBind->is_null)) {
-    ASSERT(pColData->type == pBind->buffer_type);
+  if (pColData->flag == flag) return code;
+  if (pColData->nVal == 0) {
+    pColData->flag = flag;
+    return code;
   }
 
-  if (IS_VAR_DATA_TYPE(pColData->type)) {  // var-length data type
-    for (int32_t i = 0; i < pBind->num; ++i) {
-      if (pBind->is_null && pBind->is_null[i]) {
-        code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_NULL](pColData, NULL, 0);
-        if (code) goto _exit;
-      } else if (pBind->length[i] > buffMaxLen) {
-        uError("var data length too big, len:%d, max:%d", pBind->length[i], buffMaxLen);
-        return TSDB_CODE_INVALID_PARA;
-      } else {
-        code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_VALUE](
-            pColData, (uint8_t *)pBind->buffer + pBind->buffer_length * i, pBind->length[i]);
+  // bitmap
+  uint8_t *pBitMap = NULL;
+  switch (flag) {
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      code = tRealloc(&pBitMap, BIT1_SIZE(pColData->nVal));
+      if (code) return code;
+      for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+        SET_BIT1_EX(pBitMap, iVal, tColDataFlagBit(flag, tColDataGetBitValue(pColData, iVal)));
       }
+      break;
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      code = tRealloc(&pBitMap, BIT2_SIZE(pColData->nVal));
+      if (code) return code;
+      for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+        SET_BIT2_EX(pBitMap, iVal, tColDataGetBitValue(pColData, iVal));
+      }
+      break;
+    default:
+      break;
+  }
+  tFree(pColData->pBitMap);
+  pColData->pBitMap = pBitMap;
+
+  // the rows before have no value, but a value slot each
+  if ((flag & HAS_VALUE) && !(pColData->flag & HAS_VALUE)) {
+    if (IS_VAR_DATA_TYPE(pColData->type)) {
+      int32_t nOffset = sizeof(int32_t) * pColData->nVal;
+      code = tRealloc((uint8_t **)(&pColData->aOffset), nOffset);
+      if (code) return code;
+      memset(pColData->aOffset, 0, nOffset);
+    } else {
+      pColData->nData = tDataTypes[pColData->type].bytes * pColData->nVal;
+      code = tRealloc(&pColData->pData, pColData->nData);
+      if (code) return code;
+      memset(pColData->pData, 0, pColData->nData);
     }
-  } else {  // fixed-length data type
-    bool allValue;
-    bool allNull;
-    if (pBind->is_null) {
-      bool same = (memcmp(pBind->is_null, pBind->is_null + 1, pBind->num - 1) == 0);
-      allNull = (same && pBind->is_null[0] != 0);
-      allValue = (same && pBind->is_null[0] == 0);
+  }
+
+  pColData->flag = flag;
+  return code;
+}
+
+// set the 1-bit bitmap of num rows from iStart, to !isNull[i] if isNull, or else to bit, a byte of 8 rows at a time
+static void tColDataPutBit1(uint8_t *pBitMap, int32_t iStart, int32_t num, const char *isNull, uint8_t bit) {
+  int32_t i = 0;
+
+  for (; i < num && MOD_8(iStart + i) != 0; i++) {
+    SET_BIT1(pBitMap, iStart + i, isNull ? !isNull[i] : bit);
+  }
+
+  for (; i + 8 <= num; i += 8) {
+    uint8_t *p = &pBitMap[DIV_8(iStart + i)];
+    if (isNull) {
+      // fold each byte of is_null to its lowest bit, and gather the 8 bits into one byte
+      uint64_t w;
+      memcpy(&w, isNull + i, sizeof(w));
+      w |= w >> 4;
+      w |= w >> 2;
+      w |= w >> 1;
+      w &= 0x0101010101010101ULL;
+      *p = ~(uint8_t)((w * 0x0102040810204080ULL) >> 56);
     } else {
-      allNull = false;
-      allValue = true;
+      *p = bit ? 0xFF : 0;
     }
+  }
 
-    if (allValue) {
-      // optimize (todo)
-      for (int32_t i = 0; i < pBind->num; ++i) {
-        code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_VALUE](
-            pColData, (uint8_t *)pBind->buffer + TYPE_BYTES[pColData->type] * i, pBind->buffer_length);
+  for (; i < num; i++) {
+    SET_BIT1_EX(pBitMap, iStart + i, isNull ? !isNull[i] : bit);
+  }
+}
+
+// append all values of a bind at once, with pColData already in the encoding of the bind
+static int32_t tColDataPutBind(SColData *pColData, TAOS_MULTI_BIND *pBind, int32_t numOfNull, int64_t nData) {
+  int32_t     code = 0;
+  int32_t     num = pBind->num;
+  int32_t     iStart = pColData->nVal;
+  const char *isNull = (numOfNull > 0 && numOfNull < num) ? pBind->is_null : NULL;
+
+  // bitmap
+  switch (pColData->flag) {
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      code = tRealloc(&pColData->pBitMap, BIT1_SIZE(iStart + num));
+      if (code) return code;
+      tColDataPutBit1(pColData->pBitMap, iStart, num, isNull, tColDataFlagBit(pColData->flag, numOfNull ? 1 : 2));
+      break;
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      code = tRealloc(&pColData->pBitMap, BIT2_SIZE(iStart + num));
+      if (code) return code;
+      for (int32_t i = 0; i < num; i++) {
+        SET_BIT2_EX(pColData->pBitMap, iStart + i, (isNull ? isNull[i] : numOfNull) ? 1 : 2);
       }
-    } else if (allNull) {
-      // optimize (todo)
-      for (int32_t i = 0; i < pBind->num; ++i) {
-        code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_NULL](pColData, NULL, 0);
-        if (code) goto _exit;
+      break;
+    default:
+      break;
+  }
+
+  // data
+  if (pColData->flag & HAS_VALUE) {
+    if (IS_VAR_DATA_TYPE(pColData->type)) {
+      code = tRealloc((uint8_t **)(&pColData->aOffset), ((int64_t)(iStart + num)) << 2);
+      if (code) return code;
+      code = tRealloc(&pColData->pData, pColData->nData + nData);
+      if (code) return code;
+
+      for (int32_t i = 0; i < num; i++) {
+        pColData->aOffset[iStart + i] = pColData->nData;
+        if (numOfNull == num || (isNull && isNull[i])) continue;
+
+        memcpy(pColData->pData + pColData->nData, (uint8_t *)pBind->buffer + pBind->buffer_length * i,
+               pBind->length[i]);
+        pColData->nData += pBind->length[i];
       }
     } else {
-      for (int32_t i = 0; i < pBind->num; ++i) {
-        if (pBind->is_null[i]) {
-          code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_NULL](pColData, NULL, 0);
-          if (code) goto _exit;
-        } else {
-          code = tColDataAppendValueImpl[pColData->flag][CV_FLAG_VALUE](
-              pColData, (uint8_t *)pBind->buffer + TYPE_BYTES[pColData->type] * i, pBind->buffer_length);
+      int32_t  bytes = TYPE_BYTES[pColData->type];
+      uint8_t *pData = NULL;
+
+      code = tRealloc(&pColData->pData, pColData->nData + (int64_t)bytes * num);
+      if (code) return code;
+
+      pData = pColData->pData + pColData->nData;
+      if (numOfNull == num) {
+        memset(pData, 0, (int64_t)bytes * num);
+      } else {
+        memcpy(pData, pBind->buffer, (int64_t)bytes * num);
+        for (int32_t i = 0; isNull && i < num; i++) {
+          if (isNull[i]) memset(pData + (int64_t)bytes * i, 0, bytes);
         }
       }
+      pColData->nData += bytes * num;
     }
   }
 
-_exit:
+  pColData->numOfNull += numOfNull;
+  pColData->numOfValue += num - numOfNull;
+  pColData->nVal += num;
   return code;
 }
 
+int32_t tColDataAddValueByBind(SColData *pColData, TAOS_MULTI_BIND *pBind, int32_t buffMaxLen) {
+  int32_t code = 0;
+  int32_t numOfNull = 0;
+  int64_t nData = 0;
+
+  if (!(pBind->num == 1 && pBind->is_null && *pBind->is_null)) {
+    ASSERT(pColData->type == pBind->buffer_type);
+  }
+
+  if (pBind->num <= 0) return code;
+
+  if (pBind->is_null) {
+    for (int32_t i = 0; i < pBind->num; ++i) {
+      numOfNull += (pBind->is_null[i] != 0);
+    }
+  }
+
+  // check all var-length values before any is appended
+  if (IS_VAR_DATA_TYPE(pColData->type) && numOfNull < pBind->num) {
+    for (int32_t i = 0; i < pBind->num; ++i) {
+      if (pBind->is_null && pBind->is_null[i]) continue;
+      if (pBind->length[i] > buffMaxLen) {
+        uError("var data length too big, len:%d, max:%d", pBind->length[i], buffMaxLen);
+        return TSDB_CODE_INVALID_PARA;
+      }
+      nData += pBind->length[i];
+    }
+  }
+
+  uint8_t flag = pColData->flag;
+  if (numOfNull > 0) flag |= HAS_NULL;
+  if (numOfNull < pBind->num) flag |= HAS_VALUE;
+
+  code = tColDataUpgradeFlag(pColData, flag);
+  if (code) return code;
+
+  return tColDataPutBind(pColData, pBind, numOfNull, nData);
+}
+
 #ifdef BUILD_NO_CALL
 static int32_t tColDataSwapValue(SColData *pColData, int32_t i, int32_t j) {
   int32_t code = 0;
@@ -73,6 +73,7 @@ int32_t tsElectInterval = 25 * 1000;
 int32_t tsHeartbeatInterval = 1000;
 int32_t tsHeartbeatTimeout = 20 * 1000;
 int32_t tsSnapReplMaxWaitN = 128;
+int32_t tsSyncAppendEntriesNum = 1;  // entries per append entries msg, more than 1 is not understood by old followers
 
 // mnode
 int64_t tsMndSdbWriteDelta = 200;
@@ -128,6 +129,7 @@ char tsSmlTsDefaultName[TSDB_COL_NAME_LEN] = "_ts";
 char tsSmlTagName[TSDB_COL_NAME_LEN] = "_tag_null";
 char tsSmlChildTableName[TSDB_TABLE_NAME_LEN] = "";  // user defined child table name can be specified in tag value.
 char tsSmlAutoChildTableNameDelimiter[TSDB_TABLE_NAME_LEN] = "";
+int32_t tsSmlParseThreads = 4;  // threads to parse a large batch of influx lines, 1 parses them on the calling thread
 // If set to empty system will generate table name using MD5 hash.
 // true means that the name and order of cols in each line are the same(only for influx protocol)
 // bool    tsSmlDataFormat = false;
@@ -187,6 +189,10 @@ int32_t tsMinIntervalTime = 1;
 
 // maximum batch rows numbers imported from a single csv load
 int32_t tsMaxInsertBatchRows = 1000000;
+// threads to parse the lines of a csv load into a table, 1 parses them on the calling thread
+int32_t tsCsvParseThreads = 4;
+// parsed USING ... TAGS ... clauses of inserts kept by each connection, 0 disables the cache
+int32_t tsInsertShapeCacheSize = 10000;
 
 float   tsSelectivityRatio = 1.0;
 int32_t tsTagFilterResCacheSize = 1024 * 10;
@@ -198,7 +204,12 @@ char    tsTagFilterCache = 0;
 // positive value (in MB)
 int32_t tsQueryBufferSize = -1;
 int64_t tsQueryBufferSizeBytes = -1;
+int32_t tsHashJoinBufSize = 256;  // MB, memory of the build side of a hash join before it spills to disk
+int32_t tsNumOfSortThreads = 2;   // runs of an external sort sorted on the task queue at a time, 0 means sorting in the query thread
 int32_t tsCacheLazyLoadThreshold = 500;
+int32_t tsLastCacheShardBits = -1;     // shard bits of the last/last_row cache of each vnode, -1 means by the cache size
+int32_t tsLastCacheRocksBlockSize = 5;  // MB, block cache of the rocksdb that persists the last/last_row cache
+int32_t tsTsdbBlockCacheSize = 16;      // MB, cache of decoded brin blocks and column data of each vnode, 0 to disable
 
 int32_t  tsDiskCfgNum = 0;
 SDiskCfg tsDiskCfg[TFS_MAX_DISKS] = {0};
@@ -242,6 +253,9 @@ bool    tsStartUdfd = true;
 
 // wal
 int64_t tsWalFsyncDataSizeLimit = (100 * 1024 * 1024L);
+int32_t tsWalGroupCommitSize = 0;    // bytes staged before a group flush, 0 disables group commit
+int32_t tsWalGroupCommitDelay = 10;  // ms an entry may stay staged before it is flushed
+int32_t tsWalTailCacheSize = 4 * 1024 * 1024;  // bytes of latest entries kept for readers per wal, 0 disables it
 
 // ttl
 bool    tsTtlChangeOnWrite = false;  // if true, ttl delete time changes on last write
@@ -266,6 +280,8 @@ char    tsUdfdResFuncs[512] = "";  // udfd resident funcs that teardown when udf
 char    tsUdfdLdLibPath[512] = "";
 bool    tsDisableStream = false;
 int64_t tsStreamBufferSize = 128 * 1024 * 1024;
+int32_t tsStreamDispatchCompressSize = 0;  // encoded blocks not smaller are compressed before dispatch, 0 disables it;
+                                           // enable it only when all dnodes are able to decode compressed blocks
 bool    tsFilterScalarMode = false;
 int     tsResolveFQDNRetryTime = 100;  // seconds
 int     tsStreamAggCnt = 1000;
@@ -493,6 +509,8 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddString(pCfg, "smlTagName", tsSmlTagName, CFG_SCOPE_CLIENT, CFG_DYN_CLIENT) != 0) return -1;
   if (cfgAddString(pCfg, "smlTsDefaultName", tsSmlTsDefaultName, CFG_SCOPE_CLIENT, CFG_DYN_CLIENT) != 0) return -1;
   if (cfgAddBool(pCfg, "smlDot2Underline", tsSmlDot2Underline, CFG_SCOPE_CLIENT, CFG_DYN_CLIENT) != 0) return -1;
+  if (cfgAddInt32(pCfg, "smlParseThreads", tsSmlParseThreads, 1, 1024, CFG_SCOPE_CLIENT, CFG_DYN_CLIENT) != 0)
+    return -1;
   //  if (cfgAddBool(pCfg, "smlDataFormat", tsSmlDataFormat, CFG_SCOPE_CLIENT, CFG_DYN_NONE) != 0) return -1;
   //  if (cfgAddInt32(pCfg, "smlBatchSize", tsSmlBatchSize, 1, INT32_MAX, CFG_SCOPE_CLIENT, CFG_DYN_NONE) != 0)
   //  return -1;
@@ -500,6 +518,11 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "maxInsertBatchRows", tsMaxInsertBatchRows, 1, INT32_MAX, CFG_SCOPE_CLIENT, CFG_DYN_CLIENT) !=
       0)
     return -1;
+  if (cfgAddInt32(pCfg, "csvParseThreads", tsCsvParseThreads, 1, 1024, CFG_SCOPE_CLIENT, CFG_DYN_CLIENT) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "insertShapeCacheSize", tsInsertShapeCacheSize, 0, 1000000, CFG_SCOPE_CLIENT, CFG_DYN_NONE) !=
+      0)
+    return -1;
   if (cfgAddInt32(pCfg, "maxRetryWaitTime", tsMaxRetryWaitTime, 0, 86400000, CFG_SCOPE_BOTH, CFG_DYN_CLIENT) != 0)
     return -1;
   if (cfgAddBool(pCfg, "useAdapter", tsUseAdapter, CFG_SCOPE_CLIENT, CFG_DYN_CLIENT) != 0) return -1;
@@ -601,6 +624,10 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
     return -1;
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "hashJoinBufSize", tsHashJoinBufSize, 1, 65536, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "numOfSortThreads", tsNumOfSortThreads, 0, 64, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
+    return -1;
   if (cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
 
   tsNumOfRpcThreads = tsNumOfCores / 2;
@@ -686,6 +713,8 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "syncSnapReplMaxWaitN", tsSnapReplMaxWaitN, 16,
                   (TSDB_SYNC_SNAP_BUFFER_SIZE >> 2), CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "syncAppendEntriesNum", tsSyncAppendEntriesNum, 1, 64, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
+    return -1;
 
   if (cfgAddInt64(pCfg, "mndSdbWriteDelta", tsMndSdbWriteDelta, 20, 10000, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0)
     return -1;
@@ -755,6 +784,14 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt64(pCfg, "walFsyncDataSizeLimit", tsWalFsyncDataSizeLimit, 100 * 1024 * 1024, INT64_MAX,
                   CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "walGroupCommitSize", tsWalGroupCommitSize, 0, 64 * 1024 * 1024, CFG_SCOPE_SERVER,
+                  CFG_DYN_NONE) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "walGroupCommitDelay", tsWalGroupCommitDelay, 1, 1000, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "walTailCacheSize", tsWalTailCacheSize, 0, 1024 * 1024 * 1024, CFG_SCOPE_SERVER,
+                  CFG_DYN_NONE) != 0)
+    return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddString(pCfg, "udfdResFuncs", tsUdfdResFuncs, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
@@ -765,6 +802,9 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
     return -1;
   if (cfgAddInt64(pCfg, "streamAggCnt", tsStreamAggCnt, 2, INT32_MAX, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "streamDispatchCompressSize", tsStreamDispatchCompressSize, 0, INT32_MAX, CFG_SCOPE_SERVER,
+                  CFG_DYN_NONE) != 0)
+    return -1;
 
   if (cfgAddInt32(pCfg, "checkpointInterval", tsStreamCheckpointInterval, 60, 1200, CFG_SCOPE_SERVER,
                   CFG_DYN_ENT_SERVER) != 0)
@@ -774,6 +814,13 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "cacheLazyLoadThreshold", tsCacheLazyLoadThreshold, 0, 100000, CFG_SCOPE_SERVER,
                   CFG_DYN_ENT_SERVER) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "lastCacheShardBits", tsLastCacheShardBits, -1, 10, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "lastCacheRocksBlockSize", tsLastCacheRocksBlockSize, 1, 1024, CFG_SCOPE_SERVER,
+                  CFG_DYN_NONE) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "tsdbBlockCacheSize", tsTsdbBlockCacheSize, 0, 65536, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
+    return -1;
 
   if (cfgAddString(pCfg, "lossyColumns", tsLossyColumns, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddFloat(pCfg, "fPrecision", tsFPrecision, 0.0f, 100000.0f, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
@@ -1072,10 +1119,13 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tstrncpy(tsSmlTagName, cfgGetItem(pCfg, "smlTagName")->str, TSDB_COL_NAME_LEN);
   tstrncpy(tsSmlTsDefaultName, cfgGetItem(pCfg, "smlTsDefaultName")->str, TSDB_COL_NAME_LEN);
   tsSmlDot2Underline = cfgGetItem(pCfg, "smlDot2Underline")->bval;
+  tsSmlParseThreads = cfgGetItem(pCfg, "smlParseThreads")->i32;
   //  tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
 
   //  tsSmlBatchSize = cfgGetItem(pCfg, "smlBatchSize")->i32;
   tsMaxInsertBatchRows = cfgGetItem(pCfg, "maxInsertBatchRows")->i32;
+  tsCsvParseThreads = cfgGetItem(pCfg, "csvParseThreads")->i32;
+  tsInsertShapeCacheSize = cfgGetItem(pCfg, "insertShapeCacheSize")->i32;
 
   tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
   tsCompressMsgSize = cfgGetItem(pCfg, "compressMsgSize")->i32;
@@ -1144,6 +1194,8 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMinIntervalTime = cfgGetItem(pCfg, "minIntervalTime")->i32;
   tsCountAlwaysReturnValue = cfgGetItem(pCfg, "countAlwaysReturnValue")->i32;
   tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
+  tsHashJoinBufSize = cfgGetItem(pCfg, "hashJoinBufSize")->i32;
+  tsNumOfSortThreads = cfgGetItem(pCfg, "numOfSortThreads")->i32;
 
   tsNumOfRpcThreads = cfgGetItem(pCfg, "numOfRpcThreads")->i32;
   tsNumOfRpcSessions = cfgGetItem(pCfg, "numOfRpcSessions")->i32;
@@ -1204,11 +1256,15 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsTimeSeriesThreshold = cfgGetItem(pCfg, "timeseriesThreshold")->i32;
 
   tsWalFsyncDataSizeLimit = cfgGetItem(pCfg, "walFsyncDataSizeLimit")->i64;
+  tsWalGroupCommitSize = cfgGetItem(pCfg, "walGroupCommitSize")->i32;
+  tsWalGroupCommitDelay = cfgGetItem(pCfg, "walGroupCommitDelay")->i32;
+  tsWalTailCacheSize = cfgGetItem(pCfg, "walTailCacheSize")->i32;
 
   tsElectInterval = cfgGetItem(pCfg, "syncElectInterval")->i32;
   tsHeartbeatInterval = cfgGetItem(pCfg, "syncHeartbeatInterval")->i32;
   tsHeartbeatTimeout = cfgGetItem(pCfg, "syncHeartbeatTimeout")->i32;
   tsSnapReplMaxWaitN = cfgGetItem(pCfg, "syncSnapReplMaxWaitN")->i32;
+  tsSyncAppendEntriesNum = cfgGetItem(pCfg, "syncAppendEntriesNum")->i32;
 
   tsMndSdbWriteDelta = cfgGetItem(pCfg, "mndSdbWriteDelta")->i64;
   tsMndLogRetention = cfgGetItem(pCfg, "mndLogRetention")->i64;
@@ -1224,6 +1280,9 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   }
 
   tsCacheLazyLoadThreshold = cfgGetItem(pCfg, "cacheLazyLoadThreshold")->i32;
+  tsLastCacheShardBits = cfgGetItem(pCfg, "lastCacheShardBits")->i32;
+  tsLastCacheRocksBlockSize = cfgGetItem(pCfg, "lastCacheRocksBlockSize")->i32;
+  tsTsdbBlockCacheSize = cfgGetItem(pCfg, "tsdbBlockCacheSize")->i32;
 
   tstrncpy(tsLossyColumns, cfgGetItem(pCfg, "lossyColumns")->str, sizeof(tsLossyColumns));
   tsFPrecision = cfgGetItem(pCfg, "fPrecision")->fval;
@@ -1236,6 +1295,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsDisableStream = cfgGetItem(pCfg, "disableStream")->bval;
   tsStreamBufferSize = cfgGetItem(pCfg, "streamBufferSize")->i64;
   tsStreamAggCnt = cfgGetItem(pCfg, "streamAggCnt")->i32;
+  tsStreamDispatchCompressSize = cfgGetItem(pCfg, "streamDispatchCompressSize")->i32;
   tsStreamBufferSize = cfgGetItem(pCfg, "streamBufferSize")->i64;
   tsStreamCheckpointInterval = cfgGetItem(pCfg, "checkpointInterval")->i32;
   tsSinkDataRate = cfgGetItem(pCfg, "streamSinkDataRate")->fval;
@@ -1727,6 +1787,7 @@ static int32_t taosCfgDynamicOptionsForClient(SConfig *pCfg, char *name) {
                                          {"keepAliveIdle", &tsKeepAliveIdle},
                                          {"logKeepDays", &tsLogKeepDays},
                                          {"maxInsertBatchRows", &tsMaxInsertBatchRows},
+                                         {"csvParseThreads", &tsCsvParseThreads},
                                          {"maxRetryWaitTime", &tsMaxRetryWaitTime},
                                          {"minSlidingTime", &tsMinSlidingTime},
                                          {"minIntervalTime", &tsMinIntervalTime},
@@ -1737,6 +1798,7 @@ static int32_t taosCfgDynamicOptionsForClient(SConfig *pCfg, char *name) {
                                          {"queryNodeChunkSize", &tsQueryNodeChunkSize},
                                          {"queryUseNodeAllocator", &tsQueryUseNodeAllocator},
                                          {"smlDot2Underline", &tsSmlDot2Underline},
+                                         {"smlParseThreads", &tsSmlParseThreads},
                                          {"shellActivityTimer", &tsShellActivityTimer},
                                          {"slowLogThreshold", &tsSlowLogThreshold},
                                          {"useAdapter", &tsUseAdapter},
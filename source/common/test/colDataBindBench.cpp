@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "tdataformat.h"
+
+namespace {
+
+const int32_t maxLen = 16;
+const int64_t totalRows = 4000000;
+
+// the binds of a stmt batch, with every 10th value null if withNull
+struct SBenchBind {
+  TAOS_MULTI_BIND bind;
+  char           *buffer;
+  char           *isNull;
+  int32_t        *length;
+};
+
+void initBind(SBenchBind *pBind, int8_t type, int32_t num, bool withNull) {
+  int32_t bytes = IS_VAR_DATA_TYPE(type) ? maxLen : TYPE_BYTES[type];
+  pBind->buffer = (char *)taosMemoryCalloc(num, bytes);
+  pBind->isNull = (char *)taosMemoryCalloc(num, 1);
+  pBind->length = (int32_t *)taosMemoryCalloc(num, sizeof(int32_t));
+
+  uint32_t seed = 100;
+  for (int32_t i = 0; i < num; ++i) {
+    pBind->isNull[i] = withNull && (i % 10 == 3);
+    if (IS_VAR_DATA_TYPE(type)) {
+      pBind->length[i] = snprintf(pBind->buffer + maxLen * i, maxLen, "device-%u", taosRandR(&seed) % 10000);
+    } else {
+      ((int64_t *)pBind->buffer)[i] = taosRandR(&seed);
+    }
+  }
+
+  pBind->bind = {0};
+  pBind->bind.buffer_type = type;
+  pBind->bind.buffer = pBind->buffer;
+  pBind->bind.buffer_length = bytes;
+  pBind->bind.length = pBind->length;
+  pBind->bind.is_null = withNull ? pBind->isNull : NULL;
+  pBind->bind.num = num;
+}
+
+void destroyBind(SBenchBind *pBind) {
+  taosMemoryFree(pBind->buffer);
+  taosMemoryFree(pBind->isNull);
+  taosMemoryFree(pBind->length);
+}
+
+// append the bind value by value, as the stmt did before binds were appended as a whole
+void appendByValue(SColData *pColData, TAOS_MULTI_BIND *pBind) {
+  for (int32_t i = 0; i < pBind->num; ++i) {
+    SColVal colVal;
+    if (pBind->is_null && pBind->is_null[i]) {
+      colVal = COL_VAL_NULL(pColData->cid, pColData->type);
+    } else {
+      SValue value = {0};
+      if (IS_VAR_DATA_TYPE(pColData->type)) {
+        value.nData = pBind->length[i];
+        value.pData = (uint8_t *)pBind->buffer + pBind->buffer_length * i;
+      } else {
+        memcpy(&value.val, (char *)pBind->buffer + TYPE_BYTES[pColData->type] * i, TYPE_BYTES[pColData->type]);
+      }
+      colVal = COL_VAL_VALUE(pColData->cid, pColData->type, value);
+    }
+    tColDataAppendValue(pColData, &colVal);
+  }
+}
+
+// bind totalRows rows in batches of num rows, each into a new column as a stmt batch does, and return rows/s
+double runBind(int8_t type, int32_t num, bool withNull, bool byValue) {
+  SBenchBind bind;
+  initBind(&bind, type, num, withNull);
+
+  int64_t st = taosGetTimestampUs();
+  for (int64_t rows = 0; rows < totalRows; rows += num) {
+    SColData colData = {0};
+    tColDataInit(&colData, 2, type, 0);
+    if (byValue) {
+      appendByValue(&colData, &bind.bind);
+    } else {
+      EXPECT_EQ(tColDataAddValueByBind(&colData, &bind.bind, maxLen), 0);
+    }
+    EXPECT_EQ(colData.nVal, num);
+    tColDataDestroy(&colData);
+  }
+  int64_t el = taosGetTimestampUs() - st;
+
+  destroyBind(&bind);
+  return totalRows * 1000000.0 / (el > 0 ? el : 1);
+}
+
+void runBindBench(const char *name, int8_t type, bool withNull) {
+  for (int32_t num = 1000; num <= 100000; num *= 10) {
+    double byValue = runBind(type, num, withNull, true);
+    double bulk = runBind(type, num, withNull, false);
+    printf("%-16s bind of %6d rows: by value %.1f Mrows/s, bulk %.1f Mrows/s\n", name, num, byValue / 1000000,
+           bulk / 1000000);
+  }
+}
+
+}  // namespace
+
+TEST(colDataBindBench, fixed) {
+  runBindBench("bigint", TSDB_DATA_TYPE_BIGINT, false);
+  runBindBench("bigint, null", TSDB_DATA_TYPE_BIGINT, true);
+}
+
+TEST(colDataBindBench, var) {
+  runBindBench("binary", TSDB_DATA_TYPE_BINARY, false);
+  runBindBench("binary, null", TSDB_DATA_TYPE_BINARY, true);
+}
@@ -17,6 +17,7 @@
 #include "dmMgmt.h"
 #include "audit.h"
 #include "libs/function/tudf.h"
+#include "libs/qcom/query.h"
 
 #define DM_INIT_AUDIT()              \
   do {                               \
@@ -162,6 +163,7 @@ int32_t dmInit() {
   if (dmInitSystem() != 0) return -1;
   if (dmInitMonitor() != 0) return -1;
   if (dmInitAudit() != 0) return -1;
+  if (initTaskQueue() != 0) return -1;
   if (dmInitDnode(dmInstance()) != 0) return -1;
 #if defined(USE_S3)
   if (s3Begin() != 0) return -1;
@@ -186,6 +188,7 @@ void dmCleanup() {
   dmCleanupDnode(pDnode);
   monCleanup();
   auditCleanup();
+  cleanupTaskQueue();
   syncCleanUp();
   walCleanUp();
   udfcClose();
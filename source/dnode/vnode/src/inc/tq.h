@@ -116,6 +116,9 @@ void    tqDestroyTqHandle(void* data);
 int32_t tqScanTaosx(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp* pMetaRsp, STqOffsetVal* offset);
 int32_t tqScanData(STQ* pTq, STqHandle* pHandle, SMqDataRsp* pRsp, STqOffsetVal* pOffset, const SMqPollReq* pRequest);
 int32_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, uint64_t reqId);
+int32_t tqColDataToColumn(SColData* pCol, SColumnInfoData* pColData, int32_t numOfRows);
+int32_t tqSubmitTbDataToBlocks(SSubmitTbData* pSubmitTbData, SSchemaWrapper* pSchemaWrapper, int64_t ver, int32_t vgId,
+                               SArray* blocks, SArray* schemas);
 
 // tqExec
 int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SPackedData submit, STaosxRsp* pRsp, int32_t* totalRows, int8_t sourceExcluded);
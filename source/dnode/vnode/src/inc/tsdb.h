@@ -345,6 +345,21 @@ typedef struct {
   int    flush_count;
 } SCacheFlushState;
 
+typedef struct {
+  int64_t hitKeys;       // keys found in the lru cache
+  int64_t rocksKeys;     // keys loaded from rocksdb
+  int64_t rawKeys;       // keys loaded from the data files and memtables
+  int64_t prefetchKeys;  // keys loaded from rocksdb by the batched lookup of a table list
+} SLastCacheStatis;
+
+typedef struct {
+  int64_t brinHits;    // brin blocks found in the block index cache
+  int64_t brinMisses;  // brin blocks read and decoded from the head files
+  int64_t colHits;     // keys and columns of data blocks found in the block index cache
+  int64_t colMisses;   // keys and columns of data blocks read and decompressed from the data files
+  int64_t evicts;      // entries removed from the block index cache
+} SBICacheStatis;
+
 struct STsdb {
   char                *path;
   SVnode              *pVnode;
@@ -357,8 +372,10 @@ struct STsdb {
   SLRUCache           *lruCache;
   SCacheFlushState     flushState;
   TdThreadMutex        lruMutex;
+  SLastCacheStatis     lastStatis;
   SLRUCache           *biCache;
   TdThreadMutex        biMutex;
+  SBICacheStatis       biStatis;
   SLRUCache           *bCache;
   TdThreadMutex        bMutex;
   SLRUCache           *pgCache;
@@ -376,10 +393,13 @@ struct TSDBKEY {
 
 typedef struct SMemSkipListNode SMemSkipListNode;
 struct SMemSkipListNode {
-  int8_t            level;
-  int8_t            flag;  // TSDBROW_ROW_FMT for row format, TSDBROW_COL_FMT for col format
-  int32_t           iRow;
-  int64_t           version;
+  int8_t  level;
+  int8_t  flag;  // TSDBROW_ROW_FMT for row format, TSDBROW_COL_FMT for col format
+  int32_t iRow;
+  union {
+    int64_t version;  // TSDBROW_ROW_FMT
+    int64_t nRow;     // TSDBROW_COL_FMT, the node covers rows [iRow, iRow + nRow) of the block data
+  };
   void             *pData;
   SMemSkipListNode *forwards[0];
 };
@@ -533,6 +553,7 @@ struct STbDataIter {
   STbData          *pTbData;
   int8_t            backward;
   SMemSkipListNode *pNode;
+  int32_t           iRow;  // row offset inside a TSDBROW_COL_FMT node
   TSDBROW          *pRow;
   TSDBROW           row;
 };
@@ -963,7 +984,7 @@ static FORCE_INLINE TSDBROW *tsdbTbDataIterGet(STbDataIter *pIter) {
   if (pIter->pNode->flag == TSDBROW_ROW_FMT) {
     pIter->row = tsdbRowFromTSRow(pIter->pNode->version, pIter->pNode->pData);
   } else if (pIter->pNode->flag == TSDBROW_COL_FMT) {
-    pIter->row = tsdbRowFromBlockData(pIter->pNode->pData, pIter->pNode->iRow);
+    pIter->row = tsdbRowFromBlockData(pIter->pNode->pData, pIter->pNode->iRow + pIter->iRow);
   } else {
     ASSERT(0);
   }
@@ -742,6 +742,7 @@ int32_t tqExpandTask(STQ* pTq, SStreamTask* pTask, int64_t nextProcessVer) {
   if (pTask->info.taskLevel == TASK_LEVEL__SOURCE) {
     SWalFilterCond cond = {.deleteMsg = 1};  // delete msg also extract from wal files
     pTask->exec.pWalReader = walOpenReader(pTq->pVnode->pWal, &cond, pTask->id.taskId);
+    walReaderSetReadAhead(pTask->exec.pWalReader, WAL_READ_AHEAD_SIZE);
   }
 
   streamTaskResetUpstreamStageInfo(pTask);
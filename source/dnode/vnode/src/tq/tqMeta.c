@@ -306,6 +306,7 @@ static int buildHandle(STQ* pTq, STqHandle* handle){
     }
   } else if (handle->execHandle.subType == TOPIC_SUB_TYPE__DB) {
     handle->pWalReader = walOpenReader(pVnode->pWal, NULL, 0);
+    walReaderSetReadAhead(handle->pWalReader, WAL_READ_AHEAD_SIZE);
     handle->execHandle.pTqReader = tqReaderOpen(pVnode);
 
     buildSnapContext(reader.vnode, reader.version, 0, handle->execHandle.subType, handle->fetchMeta,
@@ -313,6 +314,7 @@ static int buildHandle(STQ* pTq, STqHandle* handle){
     handle->execHandle.task = qCreateQueueExecTaskInfo(NULL, &reader, vgId, NULL, handle->consumerId);
   } else if (handle->execHandle.subType == TOPIC_SUB_TYPE__TABLE) {
     handle->pWalReader = walOpenReader(pVnode->pWal, NULL, 0);
+    walReaderSetReadAhead(handle->pWalReader, WAL_READ_AHEAD_SIZE);
 
     if(handle->execHandle.execTb.qmsg != NULL && strcmp(handle->execHandle.execTb.qmsg, "") != 0) {
       if (nodesStringToNode(handle->execHandle.execTb.qmsg, &handle->execHandle.execTb.node) != 0) {
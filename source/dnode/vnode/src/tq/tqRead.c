@@ -258,6 +258,7 @@ STqReader* tqReaderOpen(SVnode* pVnode) {
     taosMemoryFree(pReader);
     return NULL;
   }
+  walReaderSetReadAhead(pReader->pWalReader, WAL_READ_AHEAD_SIZE);
 
   pReader->pVnodeMeta = pVnode->pMeta;
   pReader->pColIdList = NULL;
@@ -597,6 +598,78 @@ static int32_t doSetVal(SColumnInfoData* pColumnInfoData, int32_t rowIndex, SCol
   return code;
 }
 
+// Convert all values of a column of a column-format submit in one pass. Fixed length values are copied as a whole,
+// since SColData keeps a slot for each row as the block does, and only the null rows are marked afterwards.
+int32_t tqColDataToColumn(SColData* pCol, SColumnInfoData* pColData, int32_t numOfRows) {
+  int32_t type = pColData->info.type;
+
+  if (!(pCol->flag & HAS_VALUE)) {
+    colDataSetNNULL(pColData, 0, numOfRows);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pCol->type != type || (!IS_VAR_DATA_TYPE(type) && pColData->info.bytes != tDataTypes[type].bytes) ||
+      (IS_VAR_DATA_TYPE(type) && !IS_STR_DATA_TYPE(type))) {
+    for (int32_t i = 0; i < numOfRows; i++) {
+      SColVal colVal;
+      tColDataGetValue(pCol, i, &colVal);
+      int32_t code = doSetVal(pColData, i, &colVal);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (!IS_VAR_DATA_TYPE(type)) {
+    memcpy(pColData->pData, pCol->pData, (int64_t)pColData->info.bytes * numOfRows);
+    memset(pColData->nullbitmap, 0, BitmapLen(numOfRows));
+    if (pCol->flag != HAS_VALUE) {
+      for (int32_t i = 0; i < numOfRows; i++) {
+        if (tColDataGetBitValue(pCol, i) != 2) {
+          colDataSetNull_f(pColData->nullbitmap, i);
+          pColData->hasNull = true;
+        }
+      }
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // all values with their var header in one allocation
+  SVarColAttr* pAttr = &pColData->varmeta;
+  int64_t      newSize = (int64_t)pAttr->length + pCol->nData + (int64_t)VARSTR_HEADER_SIZE * numOfRows;
+  if (pAttr->allocLen < newSize) {
+    if (newSize > UINT32_MAX) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    char* buf = taosMemoryRealloc(pColData->pData, newSize);
+    if (buf == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pColData->pData = buf;
+    pAttr->allocLen = newSize;
+  }
+
+  for (int32_t i = 0; i < numOfRows; i++) {
+    if (pCol->flag != HAS_VALUE && tColDataGetBitValue(pCol, i) != 2) {
+      colDataSetNull_var(pColData, i);
+      pColData->hasNull = true;
+      continue;
+    }
+
+    int32_t offset = pCol->aOffset[i];
+    int32_t len = ((i + 1 < pCol->nVal) ? pCol->aOffset[i + 1] : pCol->nData) - offset;
+    char*   pDst = pColData->pData + pAttr->length;
+    varDataSetLen(pDst, len);
+    memcpy(varDataVal(pDst), pCol->pData + offset, len);
+    pAttr->offset[i] = pAttr->length;
+    pAttr->length += len + VARSTR_HEADER_SIZE;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t tqRetrieveDataBlock(STqReader* pReader, SSDataBlock** pRes, const char* id) {
   tqTrace("tq reader retrieve data block %p, index:%d", pReader->msg.msgStr, pReader->nextBlk);
   SSubmitTbData* pSubmitTbData = taosArrayGet(pReader->submit.aSubmitTbData, pReader->nextBlk++);
@@ -677,18 +750,14 @@ int32_t tqRetrieveDataBlock(STqReader* pReader, SSDataBlock** pRes, const char*
       }
 
       SColData*        pCol = taosArrayGet(pCols, sourceIdx);
-      SColVal          colVal;
 
       tqTrace("lostdata colActual:%d, sourceIdx:%d, targetIdx:%d, numOfCols:%d, source cid:%d, dst cid:%d", colActual, sourceIdx, targetIdx, numOfCols, pCol->cid, pColData->info.colId);
       if (pCol->cid < pColData->info.colId) {
         sourceIdx++;
       } else if (pCol->cid == pColData->info.colId) {
-        for (int32_t i = 0; i < pCol->nVal; i++) {
-          tColDataGetValue(pCol, i, &colVal);
-          int32_t code = doSetVal(pColData, i, &colVal);
-          if (code != TSDB_CODE_SUCCESS) {
-            return code;
-          }
+        int32_t code = tqColDataToColumn(pCol, pColData, pCol->nVal);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
         }
         sourceIdx++;
         targetIdx++;
@@ -761,8 +830,15 @@ int32_t tqRetrieveTaosxBlock(STqReader* pReader, SArray* blocks, SArray* schemas
     return -1;
   }
 
-  SSchemaWrapper* pSchemaWrapper = pReader->pSchemaWrapper;
-  int32_t         numOfRows = 0;
+  return tqSubmitTbDataToBlocks(pSubmitTbData, pReader->pSchemaWrapper, pReader->msg.ver,
+                                pReader->pWalReader->pWal->cfg.vgId, blocks, schemas);
+}
+
+// Split the rows of a submit table data into blocks of the same assigned columns, each with its masked schema.
+int32_t tqSubmitTbDataToBlocks(SSubmitTbData* pSubmitTbData, SSchemaWrapper* pSchemaWrapper, int64_t ver, int32_t vgId,
+                               SArray* blocks, SArray* schemas) {
+  int64_t uid = pSubmitTbData->uid;
+  int32_t numOfRows = 0;
 
   if (pSubmitTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
     SArray*   pCols = pSubmitTbData->aCol;
@@ -782,7 +858,72 @@ int32_t tqRetrieveTaosxBlock(STqReader* pReader, SArray* blocks, SArray* schemas
   if (pSubmitTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
     SArray* pCols = pSubmitTbData->aCol;
     int32_t numOfCols = taosArrayGetSize(pCols);
-    for (int32_t i = 0; i < numOfRows; i++) {
+    bool    hasNone = false;
+    for (int32_t j = 0; j < numOfCols; j++) {
+      SColData* pCol = taosArrayGet(pCols, j);
+      if (pCol->flag & HAS_NONE) {
+        hasNone = true;
+        break;
+      }
+    }
+
+    // all rows assign the same columns, so they go to one block converted column by column
+    if (!hasNone && numOfRows > 0) {
+      memset(assigned, 1, TMIN(numOfCols, pSchemaWrapper->nCols));
+
+      SSDataBlock     block = {0};
+      SSchemaWrapper* pSW = taosMemoryCalloc(1, sizeof(SSchemaWrapper));
+      if (pSW == NULL) {
+        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        goto FAIL;
+      }
+
+      if (tqMaskBlock(pSW, &block, pSchemaWrapper, assigned) < 0) {
+        blockDataFreeRes(&block);
+        tDeleteSchemaWrapper(pSW);
+        goto FAIL;
+      }
+
+      block.info.id.uid = uid;
+      block.info.version = ver;
+      if (blockDataEnsureCapacity(&block, numOfRows) < 0) {
+        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        blockDataFreeRes(&block);
+        tDeleteSchemaWrapper(pSW);
+        goto FAIL;
+      }
+
+      int32_t targetIdx = 0;
+      int32_t sourceIdx = 0;
+      int32_t colActual = blockDataGetNumOfCols(&block);
+      while (targetIdx < colActual && sourceIdx < numOfCols) {
+        SColData*        pCol = taosArrayGet(pCols, sourceIdx);
+        SColumnInfoData* pColData = taosArrayGet(block.pDataBlock, targetIdx);
+
+        if (pCol->cid < pColData->info.colId) {
+          sourceIdx++;
+        } else if (pCol->cid == pColData->info.colId) {
+          terrno = tqColDataToColumn(pCol, pColData, numOfRows);
+          if (terrno != TSDB_CODE_SUCCESS) {
+            blockDataFreeRes(&block);
+            tDeleteSchemaWrapper(pSW);
+            goto FAIL;
+          }
+          sourceIdx++;
+          targetIdx++;
+        } else {
+          colDataSetNNULL(pColData, 0, numOfRows);
+          targetIdx++;
+        }
+      }
+
+      tqTrace("vgId:%d, taosx scan, build block of %d rows, col %d", vgId, numOfRows, colActual);
+      taosArrayPush(blocks, &block);
+      taosArrayPush(schemas, &pSW);
+      curRow = numOfRows;
+    }
+
+    for (int32_t i = curRow; i < numOfRows; i++) {
       bool buildNew = false;
 
       for (int32_t j = 0; j < numOfCols; j++) {
@@ -820,11 +961,10 @@ int32_t tqRetrieveTaosxBlock(STqReader* pReader, SArray* blocks, SArray* schemas
           tDeleteSchemaWrapper(pSW);
           goto FAIL;
         }
-        tqTrace("vgId:%d, build new block, col %d", pReader->pWalReader->pWal->cfg.vgId,
-                (int32_t)taosArrayGetSize(block.pDataBlock));
+        tqTrace("vgId:%d, build new block, col %d", vgId, (int32_t)taosArrayGetSize(block.pDataBlock));
 
         block.info.id.uid = uid;
-        block.info.version = pReader->msg.ver;
+        block.info.version = ver;
         if (blockDataEnsureCapacity(&block, numOfRows - curRow) < 0) {
           terrno = TSDB_CODE_OUT_OF_MEMORY;
           blockDataFreeRes(&block);
@@ -837,8 +977,7 @@ int32_t tqRetrieveTaosxBlock(STqReader* pReader, SArray* blocks, SArray* schemas
 
       SSDataBlock* pBlock = taosArrayGetLast(blocks);
 
-      tqTrace("vgId:%d, taosx scan, block num: %d", pReader->pWalReader->pWal->cfg.vgId,
-              (int32_t)taosArrayGetSize(blocks));
+      tqTrace("vgId:%d, taosx scan, block num: %d", vgId, (int32_t)taosArrayGetSize(blocks));
 
       int32_t targetIdx = 0;
       int32_t sourceIdx = 0;
@@ -863,7 +1002,7 @@ int32_t tqRetrieveTaosxBlock(STqReader* pReader, SArray* blocks, SArray* schemas
       curRow++;
     }
   } else {
-    SSchemaWrapper* pWrapper = pReader->pSchemaWrapper;
+    SSchemaWrapper* pWrapper = pSchemaWrapper;
     STSchema*       pTSchema = tBuildTSchema(pWrapper->pSchema, pWrapper->nCols, pWrapper->version);
     SArray*         pRows = pSubmitTbData->aRowP;
 
@@ -905,11 +1044,10 @@ int32_t tqRetrieveTaosxBlock(STqReader* pReader, SArray* blocks, SArray* schemas
           tDeleteSchemaWrapper(pSW);
           goto FAIL;
         }
-        tqTrace("vgId:%d, build new block, col %d", pReader->pWalReader->pWal->cfg.vgId,
-                (int32_t)taosArrayGetSize(block.pDataBlock));
+        tqTrace("vgId:%d, build new block, col %d", vgId, (int32_t)taosArrayGetSize(block.pDataBlock));
 
         block.info.id.uid = uid;
-        block.info.version = pReader->msg.ver;
+        block.info.version = ver;
         if (blockDataEnsureCapacity(&block, numOfRows - curRow) < 0) {
           terrno = TSDB_CODE_OUT_OF_MEMORY;
           blockDataFreeRes(&block);
@@ -922,8 +1060,7 @@ int32_t tqRetrieveTaosxBlock(STqReader* pReader, SArray* blocks, SArray* schemas
 
       SSDataBlock* pBlock = taosArrayGetLast(blocks);
 
-      tqTrace("vgId:%d, taosx scan, block num: %d", pReader->pWalReader->pWal->cfg.vgId,
-              (int32_t)taosArrayGetSize(blocks));
+      tqTrace("vgId:%d, taosx scan, block num: %d", vgId, (int32_t)taosArrayGetSize(blocks));
 
       int32_t targetIdx = 0;
       int32_t sourceIdx = 0;
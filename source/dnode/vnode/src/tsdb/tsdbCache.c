@@ -21,10 +21,41 @@
 
 #define ROCKS_BATCH_SIZE (4096)
 
-#if 0
+// block index cache: decoded brin blocks and decompressed column data of the data files, which are immutable once
+// written, so the entries are keyed by the commit id of the file and never updated.
+typedef enum {
+  TSDB_BI_BRIN = 1,
+  TSDB_BI_KEY,  // the disk data header, versions and timestamps of a data block
+  TSDB_BI_COL,
+} ETsdbBIType;
+
+typedef struct {
+  int8_t  type;
+  int16_t cid;  // column id for TSDB_BI_COL
+  int32_t fid;
+  int64_t commitID;
+  int64_t offset;
+} STsdbBIKey;
+
+static void getBIKey(int8_t type, int32_t fid, int64_t commitID, int64_t offset, int16_t cid, STsdbBIKey *pKey) {
+  memset(pKey, 0, sizeof(*pKey));  // the padding bytes are part of the key
+  pKey->type = type;
+  pKey->cid = cid;
+  pKey->fid = fid;
+  pKey->commitID = commitID;
+  pKey->offset = offset;
+}
+
 static int32_t tsdbOpenBICache(STsdb *pTsdb) {
-  int32_t    code = 0;
-  SLRUCache *pCache = taosLRUCacheInit(10 * 1024 * 1024, 0, .5);
+  int32_t code = 0;
+
+  taosThreadMutexInit(&pTsdb->biMutex, NULL);
+  if (tsTsdbBlockCacheSize <= 0) {
+    pTsdb->biCache = NULL;
+    return code;
+  }
+
+  SLRUCache *pCache = taosLRUCacheInit((int64_t)tsTsdbBlockCacheSize * 1024 * 1024, -1, .5);
   if (pCache == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _err;
@@ -32,8 +63,6 @@ static int32_t tsdbOpenBICache(STsdb *pTsdb) {
 
   taosLRUCacheSetStrictCapacity(pCache, false);
 
-  taosThreadMutexInit(&pTsdb->biMutex, NULL);
-
 _err:
   pTsdb->biCache = pCache;
   return code;
@@ -42,18 +71,323 @@ _err:
 static void tsdbCloseBICache(STsdb *pTsdb) {
   SLRUCache *pCache = pTsdb->biCache;
   if (pCache) {
-    int32_t elems = taosLRUCacheGetElems(pCache);
-    tsdbTrace("vgId:%d, elems: %d", TD_VID(pTsdb->pVnode), elems);
-    taosLRUCacheEraseUnrefEntries(pCache);
-    elems = taosLRUCacheGetElems(pCache);
-    tsdbTrace("vgId:%d, elems: %d", TD_VID(pTsdb->pVnode), elems);
+    SBICacheStatis *pStatis = &pTsdb->biStatis;
+    tsdbInfo("vgId:%d, block index cache statis, brin hit:%" PRId64 ", brin miss:%" PRId64 ", col hit:%" PRId64
+             ", col miss:%" PRId64 ", evict:%" PRId64,
+             TD_VID(pTsdb->pVnode), pStatis->brinHits, pStatis->brinMisses, pStatis->colHits, pStatis->colMisses,
+             pStatis->evicts);
 
+    taosLRUCacheEraseUnrefEntries(pCache);
     taosLRUCacheCleanup(pCache);
+    pTsdb->biCache = NULL;
+  }
+
+  taosThreadMutexDestroy(&pTsdb->biMutex);
+}
+
+static void deleteBICache(const void *key, size_t keyLen, void *value, void *ud) {
+  STsdb *pTsdb = (STsdb *)ud;
 
-    taosThreadMutexDestroy(&pTsdb->biMutex);
+  atomic_add_fetch_64(&pTsdb->biStatis.evicts, 1);
+  taosMemoryFree(value);
+}
+
+static void tsdbBICacheInsert(STsdb *pTsdb, const STsdbBIKey *pKey, void *pValue, size_t charge) {
+  LRUStatus status = taosLRUCacheInsert(pTsdb->biCache, pKey, sizeof(*pKey), pValue, charge, deleteBICache, NULL,
+                                        TAOS_LRU_PRIORITY_LOW, pTsdb);
+  if (status != TAOS_LRU_STATUS_OK && status != TAOS_LRU_STATUS_OK_OVERWRITTEN) {
+    // ignore cache updating if not ok, the value has been freed by the deleter
+    tsdbTrace("vgId:%d, failed to insert block index cache, status:%d", TD_VID(pTsdb->pVnode), status);
   }
 }
-#endif
+
+int32_t tsdbBICacheGetBrinBlock(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, SBrinBlock *pBrinBlock,
+                                bool *hit) {
+  int32_t    code = 0;
+  STsdbBIKey key;
+
+  *hit = false;
+  if (pTsdb->biCache == NULL) {
+    return code;
+  }
+
+  getBIKey(TSDB_BI_BRIN, fid, commitID, offset, 0, &key);
+  LRUHandle *h = taosLRUCacheLookup(pTsdb->biCache, &key, sizeof(key));
+  if (h == NULL) {
+    atomic_add_fetch_64(&pTsdb->biStatis.brinMisses, 1);
+    return code;
+  }
+
+  // value: numRec, followed by the int64 arrays and the int32 arrays of the brin block
+  uint8_t *pValue = taosLRUCacheValue(pTsdb->biCache, h);
+  int32_t  numRec = *(int32_t *)pValue;
+  int32_t  size = sizeof(int64_t);
+
+  tBrinBlockClear(pBrinBlock);
+  for (int32_t i = 0; i < ARRAY_SIZE(pBrinBlock->dataArr1); i++) {
+    code = TARRAY2_APPEND_BATCH(&pBrinBlock->dataArr1[i], (int64_t *)(pValue + size), numRec);
+    if (code) goto _exit;
+    size += numRec * sizeof(int64_t);
+  }
+
+  for (int32_t i = 0; i < ARRAY_SIZE(pBrinBlock->dataArr2); i++) {
+    code = TARRAY2_APPEND_BATCH(&pBrinBlock->dataArr2[i], (int32_t *)(pValue + size), numRec);
+    if (code) goto _exit;
+    size += numRec * sizeof(int32_t);
+  }
+
+  *hit = true;
+  atomic_add_fetch_64(&pTsdb->biStatis.brinHits, 1);
+
+_exit:
+  taosLRUCacheRelease(pTsdb->biCache, h, false);
+  return code;
+}
+
+void tsdbBICachePutBrinBlock(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset,
+                             const SBrinBlock *pBrinBlock) {
+  if (pTsdb->biCache == NULL) {
+    return;
+  }
+
+  int32_t numRec = TARRAY2_SIZE(pBrinBlock->suid);
+  size_t  charge = sizeof(int64_t) + (sizeof(int64_t) * ARRAY_SIZE(pBrinBlock->dataArr1) +
+                                     sizeof(int32_t) * ARRAY_SIZE(pBrinBlock->dataArr2)) * numRec;
+  uint8_t *pValue = taosMemoryMalloc(charge);
+  if (pValue == NULL) {
+    return;
+  }
+
+  *(int32_t *)pValue = numRec;
+  int32_t size = sizeof(int64_t);
+  for (int32_t i = 0; i < ARRAY_SIZE(pBrinBlock->dataArr1); i++) {
+    memcpy(pValue + size, TARRAY2_DATA(pBrinBlock->dataArr1 + i), numRec * sizeof(int64_t));
+    size += numRec * sizeof(int64_t);
+  }
+
+  for (int32_t i = 0; i < ARRAY_SIZE(pBrinBlock->dataArr2); i++) {
+    memcpy(pValue + size, TARRAY2_DATA(pBrinBlock->dataArr2 + i), numRec * sizeof(int32_t));
+    size += numRec * sizeof(int32_t);
+  }
+
+  STsdbBIKey key;
+  getBIKey(TSDB_BI_BRIN, fid, commitID, offset, 0, &key);
+  tsdbBICacheInsert(pTsdb, &key, pValue, charge);
+}
+
+int32_t tsdbBICacheGetBlockKey(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, SDiskDataHdr *pHdr,
+                               SBlockData *pBlockData, bool *hit) {
+  int32_t    code = 0;
+  STsdbBIKey key;
+
+  *hit = false;
+  if (pTsdb->biCache == NULL) {
+    return code;
+  }
+
+  getBIKey(TSDB_BI_KEY, fid, commitID, offset, 0, &key);
+  LRUHandle *h = taosLRUCacheLookup(pTsdb->biCache, &key, sizeof(key));
+  if (h == NULL) {
+    atomic_add_fetch_64(&pTsdb->biStatis.colMisses, 1);
+    return code;
+  }
+
+  // value: the disk data header, followed by the versions and the timestamps
+  uint8_t *pValue = taosLRUCacheValue(pTsdb->biCache, h);
+  memcpy(pHdr, pValue, sizeof(SDiskDataHdr));
+
+  int32_t size = sizeof(int64_t) * pHdr->nRow;
+  code = tRealloc((uint8_t **)&pBlockData->aVersion, size);
+  if (code) goto _exit;
+  code = tRealloc((uint8_t **)&pBlockData->aTSKEY, size);
+  if (code) goto _exit;
+
+  memcpy(pBlockData->aVersion, pValue + sizeof(SDiskDataHdr), size);
+  memcpy(pBlockData->aTSKEY, pValue + sizeof(SDiskDataHdr) + size, size);
+  pBlockData->nRow = pHdr->nRow;
+
+  *hit = true;
+  atomic_add_fetch_64(&pTsdb->biStatis.colHits, 1);
+
+_exit:
+  taosLRUCacheRelease(pTsdb->biCache, h, false);
+  return code;
+}
+
+void tsdbBICachePutBlockKey(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, const SDiskDataHdr *pHdr,
+                            const SBlockData *pBlockData) {
+  if (pTsdb->biCache == NULL) {
+    return;
+  }
+
+  int32_t  size = sizeof(int64_t) * pHdr->nRow;
+  size_t   charge = sizeof(SDiskDataHdr) + size * 2;
+  uint8_t *pValue = taosMemoryMalloc(charge);
+  if (pValue == NULL) {
+    return;
+  }
+
+  memcpy(pValue, pHdr, sizeof(SDiskDataHdr));
+  memcpy(pValue + sizeof(SDiskDataHdr), pBlockData->aVersion, size);
+  memcpy(pValue + sizeof(SDiskDataHdr) + size, pBlockData->aTSKEY, size);
+
+  STsdbBIKey key;
+  getBIKey(TSDB_BI_KEY, fid, commitID, offset, 0, &key);
+  tsdbBICacheInsert(pTsdb, &key, pValue, charge);
+}
+
+static int32_t tsdbBIColDataBitmapSize(const SColData *pColData) {
+  switch (pColData->flag) {
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      return BIT1_SIZE(pColData->nVal);
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      return BIT2_SIZE(pColData->nVal);
+    default:
+      return 0;
+  }
+}
+
+static int32_t tsdbBIColDataOffsetSize(const SColData *pColData) {
+  return (IS_VAR_DATA_TYPE(pColData->type) && (pColData->flag & HAS_VALUE)) ? (pColData->nVal << 2) : 0;
+}
+
+int32_t tsdbBICacheGetColData(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, SColData *pColData,
+                              bool *hit) {
+  int32_t    code = 0;
+  STsdbBIKey key;
+
+  *hit = false;
+  if (pTsdb->biCache == NULL) {
+    return code;
+  }
+
+  getBIKey(TSDB_BI_COL, fid, commitID, offset, pColData->cid, &key);
+  LRUHandle *h = taosLRUCacheLookup(pTsdb->biCache, &key, sizeof(key));
+  if (h == NULL) {
+    atomic_add_fetch_64(&pTsdb->biStatis.colMisses, 1);
+    return code;
+  }
+
+  // value: the column data, whose buffers follow it in the same allocation
+  SColData *pCached = taosLRUCacheValue(pTsdb->biCache, h);
+  if (pCached->type != pColData->type) {  // not the same column any more, e.g. the column is dropped and added again
+    taosLRUCacheRelease(pTsdb->biCache, h, false);
+    atomic_add_fetch_64(&pTsdb->biStatis.colMisses, 1);
+    return code;
+  }
+
+  int32_t szBitmap = tsdbBIColDataBitmapSize(pCached);
+  int32_t szOffset = tsdbBIColDataOffsetSize(pCached);
+
+  if (szBitmap > 0) {
+    code = tRealloc(&pColData->pBitMap, szBitmap);
+    if (code) goto _exit;
+    memcpy(pColData->pBitMap, pCached->pBitMap, szBitmap);
+  }
+
+  if (szOffset > 0) {
+    code = tRealloc((uint8_t **)&pColData->aOffset, szOffset);
+    if (code) goto _exit;
+    memcpy(pColData->aOffset, pCached->aOffset, szOffset);
+  }
+
+  if (pCached->nData > 0) {
+    code = tRealloc(&pColData->pData, pCached->nData);
+    if (code) goto _exit;
+    memcpy(pColData->pData, pCached->pData, pCached->nData);
+  }
+
+  pColData->smaOn = pCached->smaOn;
+  pColData->numOfNone = pCached->numOfNone;
+  pColData->numOfNull = pCached->numOfNull;
+  pColData->numOfValue = pCached->numOfValue;
+  pColData->nVal = pCached->nVal;
+  pColData->flag = pCached->flag;
+  pColData->nData = pCached->nData;
+
+  *hit = true;
+  atomic_add_fetch_64(&pTsdb->biStatis.colHits, 1);
+
+_exit:
+  taosLRUCacheRelease(pTsdb->biCache, h, false);
+  return code;
+}
+
+void tsdbBICachePutColData(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, const SColData *pColData) {
+  if (pTsdb->biCache == NULL) {
+    return;
+  }
+
+  int32_t   szBitmap = tsdbBIColDataBitmapSize(pColData);
+  int32_t   szOffset = tsdbBIColDataOffsetSize(pColData);
+  size_t    charge = sizeof(SColData) + szBitmap + szOffset + pColData->nData;
+  SColData *pCached = taosMemoryMalloc(charge);
+  if (pCached == NULL) {
+    return;
+  }
+
+  *pCached = *pColData;
+
+  uint8_t *p = (uint8_t *)&pCached[1];
+  pCached->pBitMap = szBitmap > 0 ? p : NULL;
+  memcpy(p, pColData->pBitMap, szBitmap);
+  p += szBitmap;
+
+  pCached->aOffset = szOffset > 0 ? (int32_t *)p : NULL;
+  memcpy(p, pColData->aOffset, szOffset);
+  p += szOffset;
+
+  pCached->pData = pColData->nData > 0 ? p : NULL;
+  memcpy(p, pColData->pData, pColData->nData);
+
+  STsdbBIKey key;
+  getBIKey(TSDB_BI_COL, fid, commitID, offset, pColData->cid, &key);
+  tsdbBICacheInsert(pTsdb, &key, pCached, charge);
+}
+
+typedef struct {
+  int32_t fid;
+  int64_t headCommitID;  // commit id of the head file of the file set that is still alive
+  int64_t dataCommitID;  // commit id of the data file of the file set that is still alive
+  SArray *pKeys;
+} SBIInvalidateArg;
+
+static int tsdbBICacheCollectStale(const void *key, size_t keyLen, void *value, void *ud) {
+  SBIInvalidateArg *pArg = (SBIInvalidateArg *)ud;
+  STsdbBIKey       *pKey = (STsdbBIKey *)key;
+
+  // the brin blocks are of the head file, the block keys and column data of the data file
+  int64_t commitID = (pKey->type == TSDB_BI_BRIN) ? pArg->headCommitID : pArg->dataCommitID;
+  if (keyLen == sizeof(STsdbBIKey) && pKey->fid == pArg->fid && pKey->commitID != commitID) {
+    taosArrayPush(pArg->pKeys, pKey);
+  }
+
+  return 0;
+}
+
+void tsdbBICacheInvalidate(STsdb *pTsdb, int32_t fid, int64_t headCommitID, int64_t dataCommitID) {
+  if (pTsdb->biCache == NULL) {
+    return;
+  }
+
+  SBIInvalidateArg arg = {.fid = fid, .headCommitID = headCommitID, .dataCommitID = dataCommitID};
+  arg.pKeys = taosArrayInit(16, sizeof(STsdbBIKey));
+  if (arg.pKeys == NULL) {
+    return;
+  }
+
+  // entries can not be erased while the cache shard is being iterated, since the shard is locked
+  taosLRUCacheApply(pTsdb->biCache, tsdbBICacheCollectStale, &arg);
+  for (int32_t i = 0; i < taosArrayGetSize(arg.pKeys); ++i) {
+    taosLRUCacheErase(pTsdb->biCache, taosArrayGet(arg.pKeys, i), sizeof(STsdbBIKey));
+  }
+
+  tsdbDebug("vgId:%d, fid:%d, %d block index cache entries invalidated", TD_VID(pTsdb->pVnode), fid,
+            (int32_t)taosArrayGetSize(arg.pKeys));
+  taosArrayDestroy(arg.pKeys);
+}
 
 static int32_t tsdbOpenBCache(STsdb *pTsdb) {
   int32_t    code = 0;
@@ -185,7 +519,7 @@ static int32_t tsdbOpenRocksCache(STsdb *pTsdb) {
     return code;
   }
 
-  rocksdb_cache_t *cache = rocksdb_cache_create_lru(5 * 1024 * 1024);
+  rocksdb_cache_t *cache = rocksdb_cache_create_lru((size_t)tsLastCacheRocksBlockSize * 1024 * 1024);
   pTsdb->rCache.blockcache = cache;
 
   rocksdb_block_based_table_options_t *tableoptions = rocksdb_block_based_options_create();
@@ -1229,6 +1563,8 @@ static int32_t tsdbCacheLoadFromRaw(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArr
   int      num_keys = TARRAY_SIZE(remainCols);
   int16_t *slotIds = taosMemoryMalloc(num_keys * sizeof(int16_t));
 
+  atomic_add_fetch_64(&pTsdb->lastStatis.rawKeys, num_keys);
+
   int16_t *lastColIds = taosMemoryMalloc(num_keys * sizeof(int16_t));
   int16_t *lastSlotIds = taosMemoryMalloc(num_keys * sizeof(int16_t));
   int16_t *lastrowColIds = taosMemoryMalloc(num_keys * sizeof(int16_t));
@@ -1407,6 +1743,7 @@ static int32_t tsdbCacheLoadFromRocks(STsdb *pTsdb, tb_uid_t uid, SArray *pLastA
       reallocVarData(&lastCol.colVal);
       taosArraySet(pLastArray, idxKey->idx, &lastCol);
       taosArrayRemove(remainCols, j);
+      atomic_add_fetch_64(&pTsdb->lastStatis.rocksKeys, 1);
 
       taosMemoryFree(values_list[i]);
     } else {
@@ -1425,26 +1762,150 @@ static int32_t tsdbCacheLoadFromRocks(STsdb *pTsdb, tb_uid_t uid, SArray *pLastA
   return code;
 }
 
+static void tsdbCacheGetReaderKey(SCacheRowsReader *pr, int i, tb_uid_t uid, int8_t ltype, SLastKey *key) {
+  *key = (SLastKey){.ltype = ltype, .uid = uid, .cid = ((int16_t *)TARRAY_DATA(pr->pCidList))[i]};
+
+  // for select last_row, last case
+  int32_t funcType = FUNCTION_TYPE_CACHE_LAST;
+  if (pr->pFuncTypeList != NULL && taosArrayGetSize(pr->pFuncTypeList) > i) {
+    funcType = ((int32_t *)TARRAY_DATA(pr->pFuncTypeList))[i];
+  }
+  if (((pr->type & CACHESCAN_RETRIEVE_LAST) == CACHESCAN_RETRIEVE_LAST) && FUNCTION_TYPE_CACHE_LAST_ROW == funcType) {
+    int8_t tempType = CACHESCAN_RETRIEVE_LAST_ROW | (pr->type ^ CACHESCAN_RETRIEVE_LAST);
+    key->ltype = (tempType & CACHESCAN_RETRIEVE_LAST) >> 3;
+  }
+}
+
+int32_t tsdbCachePrefetchBatch(STsdb *pTsdb, SCacheRowsReader *pr, const STableKeyInfo *pTableList, int32_t numOfTables,
+                               int8_t ltype) {
+  int32_t    code = 0;
+  SLRUCache *pCache = pTsdb->lruCache;
+  int        numOfCols = TARRAY_SIZE(pr->pCidList);
+  SArray    *pKeys = NULL;
+
+  // only the keys that are not in the lru cache are looked up in rocksdb, with one multi get for all tables
+  for (int32_t t = 0; t < numOfTables; ++t) {
+    for (int i = 0; i < numOfCols; ++i) {
+      SLastKey key = {0};
+      tsdbCacheGetReaderKey(pr, i, pTableList[t].uid, ltype, &key);
+
+      LRUHandle *h = taosLRUCacheLookup(pCache, &key, ROCKS_KEY_LEN);
+      if (h) {
+        taosLRUCacheRelease(pCache, h, false);
+        continue;
+      }
+
+      if (pKeys == NULL) {
+        pKeys = taosArrayInit(numOfTables * numOfCols, sizeof(SLastKey));
+        if (pKeys == NULL) {
+          return TSDB_CODE_OUT_OF_MEMORY;
+        }
+      }
+      taosArrayPush(pKeys, &key);
+    }
+  }
+
+  int num_keys = (pKeys == NULL) ? 0 : TARRAY_SIZE(pKeys);
+  if (num_keys == 0) {
+    taosArrayDestroy(pKeys);
+    return code;
+  }
+
+  char  **keys_list = taosMemoryMalloc(num_keys * sizeof(char *));
+  size_t *keys_list_sizes = taosMemoryMalloc(num_keys * sizeof(size_t));
+  char  **values_list = taosMemoryCalloc(num_keys, sizeof(char *));
+  size_t *values_list_sizes = taosMemoryCalloc(num_keys, sizeof(size_t));
+  char  **errs = taosMemoryCalloc(num_keys, sizeof(char *));
+  if (keys_list == NULL || keys_list_sizes == NULL || values_list == NULL || values_list_sizes == NULL ||
+      errs == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  for (int i = 0; i < num_keys; ++i) {
+    keys_list[i] = (char *)taosArrayGet(pKeys, i);
+    keys_list_sizes[i] = ROCKS_KEY_LEN;
+  }
+
+  taosThreadMutexLock(&pTsdb->lruMutex);
+
+  rocksdb_multi_get(pTsdb->rCache.db, pTsdb->rCache.readoptions, num_keys, (const char *const *)keys_list,
+                    keys_list_sizes, values_list, values_list_sizes, errs);
+
+  int64_t loaded = 0;
+  for (int i = 0; i < num_keys; ++i) {
+    if (errs[i]) {
+      rocksdb_free(errs[i]);
+    }
+
+    SLastCol *pLastCol = tsdbCacheDeserialize(values_list[i]);
+    if (pLastCol == NULL) {
+      continue;
+    }
+
+    // the key may be put into the cache by a write after the lookup above, which is newer
+    LRUHandle *h = taosLRUCacheLookup(pCache, keys_list[i], ROCKS_KEY_LEN);
+    if (h) {
+      taosLRUCacheRelease(pCache, h, false);
+      rocksdb_free(values_list[i]);
+      continue;
+    }
+
+    SLastCol *pTmpLastCol = taosMemoryCalloc(1, sizeof(SLastCol));
+    *pTmpLastCol = *pLastCol;
+    pLastCol = pTmpLastCol;
+
+    reallocVarData(&pLastCol->colVal);
+    size_t charge = sizeof(*pLastCol);
+    if (IS_VAR_DATA_TYPE(pLastCol->colVal.type)) {
+      charge += pLastCol->colVal.value.nData;
+    }
+
+    LRUStatus status = taosLRUCacheInsert(pCache, keys_list[i], ROCKS_KEY_LEN, pLastCol, charge, tsdbCacheDeleter,
+                                          NULL, TAOS_LRU_PRIORITY_LOW, &pTsdb->flushState);
+    rocksdb_free(values_list[i]);
+    if (status == TAOS_LRU_STATUS_FAIL) {
+      // the cache entry is not created, so the value is still owned here
+      if (IS_VAR_DATA_TYPE(pLastCol->colVal.type)) {
+        taosMemoryFree(pLastCol->colVal.value.pData);
+      }
+      taosMemoryFree(pLastCol);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      continue;
+    }
+
+    ++loaded;
+  }
+
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+
+  atomic_add_fetch_64(&pTsdb->lastStatis.prefetchKeys, loaded);
+  tsdbTrace("vgId:%d, %s tables:%d, keys:%d, loaded:%" PRId64, TD_VID(pTsdb->pVnode), __func__, numOfTables, num_keys,
+            loaded);
+
+_exit:
+  taosMemoryFree(keys_list);
+  taosMemoryFree(keys_list_sizes);
+  taosMemoryFree(values_list);
+  taosMemoryFree(values_list_sizes);
+  taosMemoryFree(errs);
+  taosArrayDestroy(pKeys);
+  return code;
+}
+
 int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCacheRowsReader *pr, int8_t ltype) {
   int32_t    code = 0;
   SArray    *remainCols = NULL;
   SLRUCache *pCache = pTsdb->lruCache;
   SArray    *pCidList = pr->pCidList;
   int        num_keys = TARRAY_SIZE(pCidList);
+  int64_t    hits = 0;
 
   for (int i = 0; i < num_keys; ++i) {
     int16_t cid = ((int16_t *)TARRAY_DATA(pCidList))[i];
 
-    SLastKey *key = &(SLastKey){.ltype = ltype, .uid = uid, .cid = cid};
-    // for select last_row, last case
-    int32_t funcType = FUNCTION_TYPE_CACHE_LAST;
-    if (pr->pFuncTypeList != NULL && taosArrayGetSize(pr->pFuncTypeList) > i) {
-      funcType = ((int32_t *)TARRAY_DATA(pr->pFuncTypeList))[i];
-    }
-    if (((pr->type & CACHESCAN_RETRIEVE_LAST) == CACHESCAN_RETRIEVE_LAST) && FUNCTION_TYPE_CACHE_LAST_ROW == funcType) {
-      int8_t tempType = CACHESCAN_RETRIEVE_LAST_ROW | (pr->type ^ CACHESCAN_RETRIEVE_LAST);
-      key->ltype = (tempType & CACHESCAN_RETRIEVE_LAST) >> 3;
-    }
+    SLastKey *key = &(SLastKey){0};
+    tsdbCacheGetReaderKey(pr, i, uid, ltype, key);
 
     LRUHandle *h = taosLRUCacheLookup(pCache, key, ROCKS_KEY_LEN);
     if (h) {
@@ -1455,6 +1916,7 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
       taosArrayPush(pLastArray, &lastCol);
 
       taosLRUCacheRelease(pCache, h, false);
+      ++hits;
     } else {
       SLastCol noneCol = {.ts = TSKEY_MIN, .colVal = COL_VAL_NONE(cid, pr->pSchema->columns[pr->pSlotIds[i]].type)};
 
@@ -1482,6 +1944,7 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
         taosLRUCacheRelease(pCache, h, false);
 
         taosArrayRemove(remainCols, i);
+        ++hits;
       } else {
         ++i;
       }
@@ -1497,6 +1960,7 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
     }
   }
 
+  atomic_add_fetch_64(&pTsdb->lastStatis.hitKeys, hits);
   return code;
 }
 
@@ -1623,19 +2087,17 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
   SLRUCache *pCache = NULL;
   size_t     cfgCapacity = pTsdb->pVnode->config.cacheLastSize * 1024 * 1024;
 
-  pCache = taosLRUCacheInit(cfgCapacity, 0, .5);
+  pCache = taosLRUCacheInit(cfgCapacity, tsLastCacheShardBits, .5);
   if (pCache == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _err;
   }
 
-#if 0
   code = tsdbOpenBICache(pTsdb);
   if (code != TSDB_CODE_SUCCESS) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _err;
   }
-#endif
 
   code = tsdbOpenBCache(pTsdb);
   if (code != TSDB_CODE_SUCCESS) {
@@ -1670,6 +2132,10 @@ _err:
 void tsdbCloseCache(STsdb *pTsdb) {
   SLRUCache *pCache = pTsdb->lruCache;
   if (pCache) {
+    SLastCacheStatis *pStatis = &pTsdb->lastStatis;
+    tsdbInfo("vgId:%d, last cache statis, hit:%" PRId64 ", rocks:%" PRId64 ", prefetch:%" PRId64 ", raw:%" PRId64,
+             TD_VID(pTsdb->pVnode), pStatis->hitKeys, pStatis->rocksKeys, pStatis->prefetchKeys, pStatis->rawKeys);
+
     taosLRUCacheEraseUnrefEntries(pCache);
 
     taosLRUCacheCleanup(pCache);
@@ -1677,9 +2143,7 @@ void tsdbCloseCache(STsdb *pTsdb) {
     taosThreadMutexDestroy(&pTsdb->lruMutex);
   }
 
-#if 0
   tsdbCloseBICache(pTsdb);
-#endif
   tsdbCloseBCache(pTsdb);
   tsdbClosePgCache(pTsdb);
   tsdbCloseRocksCache(pTsdb);
@@ -23,6 +23,9 @@
 
 #define HASTYPE(_type, _t) (((_type) & (_t)) == (_t))
 
+// number of tables whose cached keys are looked up in rocksdb by one batch
+#define CACHE_PREFETCH_TABLES 256
+
 static void setFirstLastResColToNull(SColumnInfoData* pCol, int32_t row) {
   char *buf = taosMemoryCalloc(1, pCol->info.bytes);
   SFirstLastRes* pRes = (SFirstLastRes*)((char*)buf + VARSTR_HEADER_SIZE);
@@ -341,6 +344,17 @@ static int32_t tsdbCacheQueryReseek(void* pQHandle) {
   }
 }
 
+// The prefetch only loads the keys of a batch of tables from rocksdb into the lru cache. If it fails, the keys it has
+// not loaded are loaded table by table by tsdbCacheGetBatch, so the query goes on.
+static void tsdbCacheRowsPrefetch(SCacheRowsReader* pr, const STableKeyInfo* pTableList, int32_t numOfTables,
+                                  int8_t ltype) {
+  int32_t code = tsdbCachePrefetchBatch(pr->pTsdb, pr, pTableList, numOfTables, ltype);
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbWarn("failed to prefetch last cache of %d tables since %s, load them by table, %s", numOfTables,
+             tstrerror(code), pr->idstr);
+  }
+}
+
 int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32_t* slotIds, const int32_t* dstSlotIds,
                               SArray* pTableUidList) {
   if (pReader == NULL || pResBlock == NULL) {
@@ -408,6 +422,10 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
     for (int32_t i = 0; i < pr->numOfTables; ++i) {
       tb_uid_t uid = pTableList[i].uid;
 
+      if (i % CACHE_PREFETCH_TABLES == 0) {
+        tsdbCacheRowsPrefetch(pr, pTableList + i, TMIN(CACHE_PREFETCH_TABLES, pr->numOfTables - i), ltype);
+      }
+
       tsdbCacheGetBatch(pr->pTsdb, uid, pRow, pr, ltype);
       if (TARRAY_SIZE(pRow) <= 0 || COL_VAL_IS_NONE(&((SLastCol*)TARRAY_DATA(pRow))[0].colVal)) {
         taosArrayClearEx(pRow, freeItem);
@@ -485,6 +503,10 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
     for (int32_t i = pr->tableIndex; i < pr->numOfTables; ++i) {
       tb_uid_t uid = pTableList[i].uid;
 
+      if ((i - pr->tableIndex) % CACHE_PREFETCH_TABLES == 0) {
+        tsdbCacheRowsPrefetch(pr, pTableList + i, TMIN(CACHE_PREFETCH_TABLES, pr->numOfTables - i), ltype);
+      }
+
       tsdbCacheGetBatch(pr->pTsdb, uid, pRow, pr, ltype);
       if (TARRAY_SIZE(pRow) <= 0 || COL_VAL_IS_NONE(&((SLastCol*)TARRAY_DATA(pRow))[0].colVal)) {
         taosArrayClearEx(pRow, freeItem);
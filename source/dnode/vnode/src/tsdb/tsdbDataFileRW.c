@@ -187,6 +187,12 @@ _exit:
 int32_t tsdbDataFileReadBrinBlock(SDataFileReader *reader, const SBrinBlk *brinBlk, SBrinBlock *brinBlock) {
   int32_t code = 0;
   int32_t lino = 0;
+  bool    hit = false;
+
+  const STFile *file = &reader->config->files[TSDB_FTYPE_HEAD].file;
+  code = tsdbBICacheGetBrinBlock(reader->config->tsdb, file->fid, file->cid, brinBlk->dp->offset, brinBlock, &hit);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  if (hit) goto _exit;
 
   code = tRealloc(&reader->config->bufArr[0], brinBlk->dp->size);
   TSDB_CHECK_CODE(code, lino, _exit);
@@ -219,6 +225,8 @@ int32_t tsdbDataFileReadBrinBlock(SDataFileReader *reader, const SBrinBlk *brinB
     size += brinBlk->size[j];
   }
 
+  tsdbBICachePutBrinBlock(reader->config->tsdb, file->fid, file->cid, brinBlk->dp->offset, brinBlock);
+
 _exit:
   if (code) {
     TSDB_ERROR_LOG(TD_VID(reader->config->tsdb->pVnode), lino, code);
@@ -251,48 +259,71 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
                                           STSchema *pTSchema, int16_t cids[], int32_t ncid) {
   int32_t code = 0;
   int32_t lino = 0;
+  bool    hit = false;
+  STsdb  *tsdb = reader->config->tsdb;
+
+  const STFile *file = &reader->config->files[TSDB_FTYPE_DATA].file;
 
   code = tBlockDataInit(bData, (TABLEID *)record, pTSchema, cids, ncid);
   TSDB_CHECK_CODE(code, lino, _exit);
 
   // uid + version + tskey
-  code = tRealloc(&reader->config->bufArr[0], record->blockKeySize);
-  TSDB_CHECK_CODE(code, lino, _exit);
+  SDiskDataHdr hdr[1];
+  int32_t      size = 0;
 
-  code = tsdbReadFile(reader->fd[TSDB_FTYPE_DATA], record->blockOffset, reader->config->bufArr[0], record->blockKeySize,
-                      0);
+  code = tsdbBICacheGetBlockKey(tsdb, file->fid, file->cid, record->blockOffset, hdr, bData, &hit);
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  // hdr
-  SDiskDataHdr hdr[1];
-  int32_t      size = 0;
+  if (!hit) {
+    code = tRealloc(&reader->config->bufArr[0], record->blockKeySize);
+    TSDB_CHECK_CODE(code, lino, _exit);
 
-  size += tGetDiskDataHdr(reader->config->bufArr[0] + size, hdr);
+    code = tsdbReadFile(reader->fd[TSDB_FTYPE_DATA], record->blockOffset, reader->config->bufArr[0],
+                        record->blockKeySize, 0);
+    TSDB_CHECK_CODE(code, lino, _exit);
 
-  ASSERT(hdr->delimiter == TSDB_FILE_DLMT);
-  ASSERT(record->uid == hdr->uid);
+    // hdr
+    size += tGetDiskDataHdr(reader->config->bufArr[0] + size, hdr);
 
-  bData->nRow = hdr->nRow;
+    ASSERT(hdr->delimiter == TSDB_FILE_DLMT);
+    ASSERT(record->uid == hdr->uid);
 
-  // uid
-  ASSERT(hdr->uid);
+    bData->nRow = hdr->nRow;
 
-  // version
-  code = tsdbDecmprData(reader->config->bufArr[0] + size, hdr->szVer, TSDB_DATA_TYPE_BIGINT, hdr->cmprAlg,
-                        (uint8_t **)&bData->aVersion, sizeof(int64_t) * hdr->nRow, &reader->config->bufArr[1]);
-  TSDB_CHECK_CODE(code, lino, _exit);
-  size += hdr->szVer;
+    // uid
+    ASSERT(hdr->uid);
 
-  // ts
-  code = tsdbDecmprData(reader->config->bufArr[0] + size, hdr->szKey, TSDB_DATA_TYPE_TIMESTAMP, hdr->cmprAlg,
-                        (uint8_t **)&bData->aTSKEY, sizeof(TSKEY) * hdr->nRow, &reader->config->bufArr[1]);
-  TSDB_CHECK_CODE(code, lino, _exit);
-  size += hdr->szKey;
+    // version
+    code = tsdbDecmprData(reader->config->bufArr[0] + size, hdr->szVer, TSDB_DATA_TYPE_BIGINT, hdr->cmprAlg,
+                          (uint8_t **)&bData->aVersion, sizeof(int64_t) * hdr->nRow, &reader->config->bufArr[1]);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    size += hdr->szVer;
+
+    // ts
+    code = tsdbDecmprData(reader->config->bufArr[0] + size, hdr->szKey, TSDB_DATA_TYPE_TIMESTAMP, hdr->cmprAlg,
+                          (uint8_t **)&bData->aTSKEY, sizeof(TSKEY) * hdr->nRow, &reader->config->bufArr[1]);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    size += hdr->szKey;
+
+    ASSERT(size == record->blockKeySize);
+
+    tsdbBICachePutBlockKey(tsdb, file->fid, file->cid, record->blockOffset, hdr, bData);
+  }
 
-  ASSERT(size == record->blockKeySize);
+  // columns found in the cache have a non-zero flag, and are skipped in reading the file
+  int32_t nMissCol = 0;
+  for (int32_t i = 0; i < bData->nColData; i++) {
+    code = tsdbBICacheGetColData(tsdb, file->fid, file->cid, record->blockOffset, tBlockDataGetColDataByIdx(bData, i),
+                                 &hit);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (!hit) {
+      nMissCol++;
+    }
+  }
 
   // other columns
-  if (bData->nColData > 0) {
+  if (nMissCol > 0) {
     if (hdr->szBlkCol > 0) {
       code = tRealloc(&reader->config->bufArr[0], hdr->szBlkCol);
       TSDB_CHECK_CODE(code, lino, _exit);
@@ -344,6 +375,9 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
     size = 0;
     for (int32_t i = 0; i < bData->nColData; i++) {
       SColData *colData = tBlockDataGetColDataByIdx(bData, i);
+      if (colData->flag) {
+        continue;
+      }
 
       while (blockCol && blockCol->cid < colData->cid) {
         if (size < hdr->szBlkCol) {
@@ -384,6 +418,8 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
           TSDB_CHECK_CODE(code, lino, _exit);
         }
       }
+
+      tsdbBICachePutColData(tsdb, file->fid, file->cid, record->blockOffset, colData);
     }
   }
 
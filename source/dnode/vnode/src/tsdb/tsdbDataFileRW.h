@@ -68,6 +68,20 @@ int32_t tsdbDataFileReadBlockSma(SDataFileReader *reader, const SBrinRecord *rec
 int32_t tsdbDataFileReadTombBlk(SDataFileReader *reader, const TTombBlkArray **tombBlkArray);
 int32_t tsdbDataFileReadTombBlock(SDataFileReader *reader, const STombBlk *tombBlk, STombBlock *tData);
 
+// block index cache of the decoded brin blocks and column data (tsdbCache.c)
+int32_t tsdbBICacheGetBrinBlock(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, SBrinBlock *pBrinBlock,
+                                bool *hit);
+void    tsdbBICachePutBrinBlock(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset,
+                                const SBrinBlock *pBrinBlock);
+int32_t tsdbBICacheGetBlockKey(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, SDiskDataHdr *pHdr,
+                               SBlockData *pBlockData, bool *hit);
+void    tsdbBICachePutBlockKey(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, const SDiskDataHdr *pHdr,
+                               const SBlockData *pBlockData);
+int32_t tsdbBICacheGetColData(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, SColData *pColData,
+                              bool *hit);
+void    tsdbBICachePutColData(STsdb *pTsdb, int32_t fid, int64_t commitID, int64_t offset, const SColData *pColData);
+void    tsdbBICacheInvalidate(STsdb *pTsdb, int32_t fid, int64_t headCommitID, int64_t dataCommitID);
+
 // SDataFileWriter =============================================
 typedef struct SDataFileWriter SDataFileWriter;
 typedef struct SDataFileWriterConfig {
@@ -235,6 +235,20 @@ _exit:
   return code;
 }
 
+// drop the cached brin blocks and column data of the files that are not in the file set any more
+static void tsdbFSInvalidateBICache(STsdb *pTsdb, const STFileSet *fset) {
+  int64_t headCid = -1, dataCid = -1;
+
+  if (fset->farr[TSDB_FTYPE_HEAD] != NULL) {
+    headCid = fset->farr[TSDB_FTYPE_HEAD]->f->cid;
+  }
+  if (fset->farr[TSDB_FTYPE_DATA] != NULL) {
+    dataCid = fset->farr[TSDB_FTYPE_DATA]->f->cid;
+  }
+
+  tsdbBICacheInvalidate(pTsdb, fset->fid, headCid, dataCid);
+}
+
 static int32_t apply_commit(STFileSystem *fs) {
   int32_t        code = 0;
   TFileSetArray *fsetArray1 = fs->fSetArr;
@@ -248,6 +262,7 @@ static int32_t apply_commit(STFileSystem *fs) {
     if (fset1 && fset2) {
       if (fset1->fid < fset2->fid) {
         // delete fset1
+        tsdbBICacheInvalidate(fs->tsdb, fset1->fid, -1, -1);
         tsdbTFileSetRemove(fset1);
         i1++;
       } else if (fset1->fid > fset2->fid) {
@@ -262,11 +277,13 @@ static int32_t apply_commit(STFileSystem *fs) {
         // edit
         code = tsdbTFileSetApplyEdit(fs->tsdb, fset2, fset1);
         if (code) return code;
+        tsdbFSInvalidateBICache(fs->tsdb, fset1);
         i1++;
         i2++;
       }
     } else if (fset1) {
       // delete fset1
+      tsdbBICacheInvalidate(fs->tsdb, fset1->fid, -1, -1);
       tsdbTFileSetRemove(fset1);
       i1++;
     } else {
@@ -31,7 +31,28 @@
 #define SL_MOVE_BACKWARD 0x1
 #define SL_MOVE_FROM_POS 0x2
 
+// number of rows covered by a node, a TSDBROW_COL_FMT node may cover a run of in-order rows
+#define SL_NODE_NROW(n) (((n)->flag == TSDBROW_COL_FMT) ? (int32_t)atomic_load_64(&(n)->nRow) : 1)
+
+#define MEM_ALIGN8(s)      (((s) + 7) & ~((int64_t)7))
+#define MEM_ROW_BATCH_SIZE 256
+
+// nodes of a batch of submitted rows, allocated from the buffer pool at once and handed out in order
+typedef struct {
+  int8_t  aLevel[MEM_ROW_BATCH_SIZE];
+  char   *pBuf;
+  int32_t iNode;
+  int32_t nNode;
+} SMemRowBatch;
+
+// a chunk of the buffer pool that the copy of a submitted block is carved from
+typedef struct {
+  char   *pBuf;
+  int64_t size;
+} SMemArena;
+
 static void    tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *pKey, int32_t flags);
+static int32_t tbDataRunSearch(SMemSkipListNode *pNode, TSDBKEY *pKey, int8_t upper);
 static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid, STbData **ppTbData);
 static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
@@ -251,21 +272,36 @@ void tsdbTbDataIterOpen(STbData *pTbData, TSDBKEY *pFrom, int8_t backward, STbDa
   pIter->pTbData = pTbData;
   pIter->backward = backward;
   pIter->pRow = NULL;
+  pIter->iRow = 0;
   if (pFrom == NULL) {
     // create from head or tail
     if (backward) {
       pIter->pNode = SL_GET_NODE_BACKWARD(pTbData->sl.pTail, 0);
+      if (pIter->pNode != pHead) pIter->iRow = SL_NODE_NROW(pIter->pNode) - 1;
     } else {
       pIter->pNode = SL_GET_NODE_FORWARD(pTbData->sl.pHead, 0);
     }
   } else {
-    // create from a key
+    // create from a key, the key may fall inside the run of pos[0]
     if (backward) {
+      int32_t iRow = 0;
       tbDataMovePosTo(pTbData, pos, pFrom, SL_MOVE_BACKWARD);
-      pIter->pNode = SL_GET_NODE_BACKWARD(pos[0], 0);
+      if (pos[0] != pTail && (iRow = tbDataRunSearch(pos[0], pFrom, 1)) > 0) {
+        pIter->pNode = pos[0];
+        pIter->iRow = iRow - 1;
+      } else {
+        pIter->pNode = SL_GET_NODE_BACKWARD(pos[0], 0);
+        if (pIter->pNode != pHead) pIter->iRow = SL_NODE_NROW(pIter->pNode) - 1;
+      }
     } else {
+      int32_t iRow = 0;
       tbDataMovePosTo(pTbData, pos, pFrom, 0);
-      pIter->pNode = SL_GET_NODE_FORWARD(pos[0], 0);
+      if (pos[0] != pHead && (iRow = tbDataRunSearch(pos[0], pFrom, 0)) < SL_NODE_NROW(pos[0])) {
+        pIter->pNode = pos[0];
+        pIter->iRow = iRow;
+      } else {
+        pIter->pNode = SL_GET_NODE_FORWARD(pos[0], 0);
+      }
     }
   }
 }
@@ -279,10 +315,16 @@ bool tsdbTbDataIterNext(STbDataIter *pIter) {
       return false;
     }
 
+    if (pIter->iRow > 0) {
+      pIter->iRow--;
+      return true;
+    }
+
     pIter->pNode = SL_GET_NODE_BACKWARD(pIter->pNode, 0);
     if (pIter->pNode == pIter->pTbData->sl.pHead) {
       return false;
     }
+    pIter->iRow = SL_NODE_NROW(pIter->pNode) - 1;
   } else {
     ASSERT(pIter->pNode != pIter->pTbData->sl.pHead);
 
@@ -290,7 +332,13 @@ bool tsdbTbDataIterNext(STbDataIter *pIter) {
       return false;
     }
 
+    if (pIter->iRow + 1 < SL_NODE_NROW(pIter->pNode)) {
+      pIter->iRow++;
+      return true;
+    }
+
     pIter->pNode = SL_GET_NODE_FORWARD(pIter->pNode, 0);
+    pIter->iRow = 0;
     if (pIter->pNode == pIter->pTbData->sl.pTail) {
       return false;
     }
@@ -309,7 +357,7 @@ int64_t tsdbCountTbDataRows(STbData *pTbData) {
       return rowsNum;
     }
 
-    rowsNum++;
+    rowsNum += SL_NODE_NROW(pNode);
   }
 
   return rowsNum;
@@ -433,6 +481,40 @@ _err:
   return code;
 }
 
+static FORCE_INLINE void tbDataNodeKey(SMemSkipListNode *pNode, int32_t offset, TSDBKEY *pKey) {
+  if (pNode->flag == TSDBROW_ROW_FMT) {
+    pKey->version = pNode->version;
+    pKey->ts = ((SRow *)pNode->pData)->ts;
+  } else if (pNode->flag == TSDBROW_COL_FMT) {
+    pKey->version = ((SBlockData *)pNode->pData)->aVersion[pNode->iRow + offset];
+    pKey->ts = ((SBlockData *)pNode->pData)->aTSKEY[pNode->iRow + offset];
+  }
+}
+
+// return the first row offset in the node whose key is >= pKey (or > pKey if upper), nRow if there is none
+static int32_t tbDataRunSearch(SMemSkipListNode *pNode, TSDBKEY *pKey, int8_t upper) {
+  int32_t lidx = 0;
+  int32_t ridx = SL_NODE_NROW(pNode);
+  TSDBKEY tKey;
+
+  while (lidx < ridx) {
+    int32_t midx = lidx + ((ridx - lidx) >> 1);
+    tbDataNodeKey(pNode, midx, &tKey);
+
+    int32_t c = tsdbKeyCmprFn(&tKey, pKey);
+    if (c < 0 || (upper && c == 0)) {
+      lidx = midx + 1;
+    } else {
+      ridx = midx;
+    }
+  }
+
+  return lidx;
+}
+
+// Forward moving compares the first key of each node and backward moving compares the last one, so after a forward
+// move pos[0] is the last node whose first key is less than pKey, and after a backward move pos[0] is the first node
+// whose last key is greater than pKey. In both cases pKey may fall inside the run of pos[0].
 static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *pKey, int32_t flags) {
   SMemSkipListNode *px;
   SMemSkipListNode *pn;
@@ -455,13 +537,7 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
       for (int8_t iLevel = pTbData->sl.level - 1; iLevel >= 0; iLevel--) {
         pn = SL_GET_NODE_BACKWARD(px, iLevel);
         while (pn != pTbData->sl.pHead) {
-          if (pn->flag == TSDBROW_ROW_FMT) {
-            tKey.version = pn->version;
-            tKey.ts = ((SRow *)pn->pData)->ts;
-          } else if (pn->flag == TSDBROW_COL_FMT) {
-            tKey.version = ((SBlockData *)pn->pData)->aVersion[pn->iRow];
-            tKey.ts = ((SBlockData *)pn->pData)->aTSKEY[pn->iRow];
-          }
+          tbDataNodeKey(pn, SL_NODE_NROW(pn) - 1, &tKey);
 
           int32_t c = tsdbKeyCmprFn(&tKey, pKey);
           if (c <= 0) {
@@ -490,13 +566,7 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
       for (int8_t iLevel = pTbData->sl.level - 1; iLevel >= 0; iLevel--) {
         pn = SL_GET_NODE_FORWARD(px, iLevel);
         while (pn != pTbData->sl.pTail) {
-          if (pn->flag == TSDBROW_ROW_FMT) {
-            tKey.version = pn->version;
-            tKey.ts = ((SRow *)pn->pData)->ts;
-          } else if (pn->flag == TSDBROW_COL_FMT) {
-            tKey.version = ((SBlockData *)pn->pData)->aVersion[pn->iRow];
-            tKey.ts = ((SBlockData *)pn->pData)->aTSKEY[pn->iRow];
-          }
+          tbDataNodeKey(pn, 0, &tKey);
 
           int32_t c = tsdbKeyCmprFn(&tKey, pKey);
           if (c >= 0) {
@@ -523,8 +593,38 @@ static FORCE_INLINE int8_t tsdbMemSkipListRandLevel(SMemSkipList *pSl) {
 
   return level;
 }
+// Draw the levels of the nodes of rows [iRow, iRow + MEM_ROW_BATCH_SIZE), and allocate all of them with one buffer pool
+// call, instead of taking the pool lock for each row.
+static int32_t tbDataPrepareRowBatch(SMemTable *pMemTable, STbData *pTbData, SRow **aRow, int32_t iRow, int32_t nRow,
+                                     SMemRowBatch *pBatch) {
+  SVBufPool *pPool = pMemTable->pTsdb->pVnode->inUse;
+  int8_t     slLevel = pTbData->sl.level;
+  int64_t    size = 0;
+
+  pBatch->iNode = 0;
+  pBatch->nNode = TMIN(nRow - iRow, MEM_ROW_BATCH_SIZE);
+  for (int32_t i = 0; i < pBatch->nNode; i++) {
+    // the same as tsdbMemSkipListRandLevel, with the level of the skiplist after putting the previous nodes
+    int8_t level = 1;
+    int8_t tlevel = TMIN(pTbData->sl.maxLevel, slLevel + 1);
+    while ((taosRandR(&pTbData->sl.seed) & 0x3) == 0 && level < tlevel) {
+      level++;
+    }
+    slLevel = TMAX(slLevel, level);
+
+    pBatch->aLevel[i] = level;
+    size += MEM_ALIGN8(SL_NODE_SIZE(level) + aRow[iRow + i]->len);
+  }
+
+  pBatch->pBuf = vnodeBufPoolMallocAligned(pPool, size);
+  if (pBatch->pBuf == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return 0;
+}
+
 static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode **pos, TSDBROW *pRow,
-                           int8_t forward) {
+                           int32_t nRow, int8_t forward, SMemRowBatch *pBatch) {
   int32_t           code = 0;
   int8_t            level;
   SMemSkipListNode *pNode = NULL;
@@ -532,9 +632,20 @@ static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListN
   int64_t           nSize;
 
   // create node
-  level = tsdbMemSkipListRandLevel(&pTbData->sl);
-  nSize = SL_NODE_SIZE(level);
-  if (pRow->type == TSDBROW_ROW_FMT) {
+  if (pBatch) {
+    ASSERT(pRow->type == TSDBROW_ROW_FMT && pBatch->iNode < pBatch->nNode);
+    level = pBatch->aLevel[pBatch->iNode++];
+    nSize = SL_NODE_SIZE(level);
+    pNode = (SMemSkipListNode *)pBatch->pBuf;
+    pBatch->pBuf += MEM_ALIGN8(nSize + pRow->pTSRow->len);
+  } else {
+    level = tsdbMemSkipListRandLevel(&pTbData->sl);
+    nSize = SL_NODE_SIZE(level);
+  }
+
+  if (pNode) {
+    // allocated by the batch
+  } else if (pRow->type == TSDBROW_ROW_FMT) {
     pNode = (SMemSkipListNode *)vnodeBufPoolMallocAligned(pPool, nSize + pRow->pTSRow->len);
   } else if (pRow->type == TSDBROW_COL_FMT) {
     pNode = (SMemSkipListNode *)vnodeBufPoolMallocAligned(pPool, nSize);
@@ -554,6 +665,7 @@ static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListN
     memcpy(pNode->pData, pRow->pTSRow, pRow->pTSRow->len);
   } else if (pRow->type == TSDBROW_COL_FMT) {
     pNode->iRow = pRow->iRow;
+    pNode->nRow = nRow;
     pNode->pData = pRow->pBlockData;
   } else {
     ASSERT(0);
@@ -593,7 +705,7 @@ static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListN
     }
   }
 
-  pTbData->sl.size++;
+  pTbData->sl.size += nRow;
   if (pTbData->sl.level < pNode->level) {
     pTbData->sl.level = pNode->level;
   }
@@ -602,6 +714,136 @@ _exit:
   return code;
 }
 
+// Move rows [iSplit, nRow) of the run of pNode to a new node linked right after it. The new node is linked before
+// pNode is shrunk, so a concurrent reader may visit the moved rows twice (same key, merged by the reader) but never
+// misses them.
+static int32_t tbDataSplitRun(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode *pNode, int32_t iSplit) {
+  int32_t           code = 0;
+  SMemSkipListNode *pos[SL_MAX_LEVEL];
+  int32_t           nRow = SL_NODE_NROW(pNode);
+  TSDBROW           tRow = tsdbRowFromBlockData(pNode->pData, pNode->iRow + iSplit);
+  TSDBKEY           key = TSDBROW_KEY(&tRow);
+
+  ASSERT(iSplit > 0 && iSplit < nRow);
+
+  tbDataMovePosTo(pTbData, pos, &key, 0);
+  ASSERT(pos[0] == pNode);
+
+  code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, nRow - iSplit, 1, NULL);
+  if (code) return code;
+
+  atomic_store_64(&pNode->nRow, iSplit);
+  pTbData->sl.size -= (nRow - iSplit);
+  return code;
+}
+
+// after a backward move, make sure pKey can be put right before pos[0]
+static int32_t tbDataSplitBackwardPos(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *pKey) {
+  int32_t code = 0;
+
+  if (pos[0] == pTbData->sl.pTail || SL_NODE_NROW(pos[0]) <= 1) return code;
+
+  int32_t iSplit = tbDataRunSearch(pos[0], pKey, 1);
+  if (iSplit == 0) return code;
+
+  code = tbDataSplitRun(pMemTable, pTbData, pos[0], iSplit);
+  if (code) return code;
+
+  tbDataMovePosTo(pTbData, pos, pKey, SL_MOVE_BACKWARD);
+  return code;
+}
+
+// after a forward move, make sure pKey can be put right after pos[0]
+static int32_t tbDataSplitForwardPos(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *pKey) {
+  int32_t code = 0;
+
+  if (pos[0] == pTbData->sl.pHead || SL_NODE_NROW(pos[0]) <= 1) return code;
+
+  int32_t iSplit = tbDataRunSearch(pos[0], pKey, 0);
+  if (iSplit >= SL_NODE_NROW(pos[0])) return code;
+
+  code = tbDataSplitRun(pMemTable, pTbData, pos[0], iSplit);
+  if (code) return code;
+
+  tbDataMovePosTo(pTbData, pos, pKey, 0);
+  return code;
+}
+
+// put the whole block as one run if its keys are strictly increasing and no existing node falls inside its range
+static int32_t tbDataTryPutRun(SMemTable *pMemTable, STbData *pTbData, SBlockData *pBlockData, bool *put) {
+  int32_t           code = 0;
+  SMemSkipListNode *pos[SL_MAX_LEVEL];
+  TSKEY            *aTSKEY = pBlockData->aTSKEY;
+
+  *put = false;
+  if (pBlockData->nRow <= 1) return code;
+
+  for (int32_t iRow = 1; iRow < pBlockData->nRow; iRow++) {
+    if (aTSKEY[iRow] <= aTSKEY[iRow - 1]) return code;
+  }
+
+  TSDBROW tRow = tsdbRowFromBlockData(pBlockData, 0);
+  TSDBROW lRow = tsdbRowFromBlockData(pBlockData, pBlockData->nRow - 1);
+  TSDBKEY sKey = TSDBROW_KEY(&tRow);
+  TSDBKEY eKey = TSDBROW_KEY(&lRow);
+  TSDBKEY tKey;
+
+  tbDataMovePosTo(pTbData, pos, &sKey, SL_MOVE_BACKWARD);
+  if (pos[0] != pTbData->sl.pTail) {
+    tbDataNodeKey(pos[0], 0, &tKey);
+    if (tsdbKeyCmprFn(&tKey, &eKey) < 0) return code;
+  }
+
+  code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, pBlockData->nRow, 0, NULL);
+  if (code) return code;
+
+  *put = true;
+  return code;
+}
+
+static void *tsdbMemArenaMalloc(void *arg, int32_t size) {
+  SMemArena *pArena = (SMemArena *)arg;
+  int64_t    nSize = MEM_ALIGN8(size);
+
+  if (pArena->size < nSize) {
+    ASSERT(0);
+    return NULL;
+  }
+
+  void *p = pArena->pBuf;
+  pArena->pBuf += nSize;
+  pArena->size -= nSize;
+  return p;
+}
+
+// the buffer pool bytes that tColDataCopy takes for a copy of pColData
+static int64_t tsdbColDataCopySize(const SColData *pColData) {
+  int64_t size = 0;
+
+  switch (pColData->flag) {
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      size += MEM_ALIGN8(BIT1_SIZE(pColData->nVal));
+      break;
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      size += MEM_ALIGN8(BIT2_SIZE(pColData->nVal));
+      break;
+    default:
+      break;
+  }
+
+  if (IS_VAR_DATA_TYPE(pColData->type) && (pColData->flag & HAS_VALUE)) {
+    size += MEM_ALIGN8(pColData->nVal << 2);
+  }
+
+  if (pColData->nData) {
+    size += MEM_ALIGN8(pColData->nData);
+  }
+
+  return size;
+}
+
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
   int32_t code = 0;
@@ -609,59 +851,67 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
   SVBufPool *pPool = pMemTable->pTsdb->pVnode->inUse;
   int32_t    nColData = TARRAY_SIZE(pSubmitTbData->aCol);
   SColData  *aColData = (SColData *)TARRAY_DATA(pSubmitTbData->aCol);
+  SMemArena  arena = {0};
 
   ASSERT(aColData[0].cid == PRIMARYKEY_TIMESTAMP_COL_ID);
   ASSERT(aColData[0].type == TSDB_DATA_TYPE_TIMESTAMP);
   ASSERT(aColData[0].flag == HAS_VALUE);
 
-  // copy and construct block data
-  SBlockData *pBlockData = vnodeBufPoolMalloc(pPool, sizeof(*pBlockData));
-  if (pBlockData == NULL) {
+  // the block data and all of its columns are copied into one chunk of the buffer pool
+  arena.size = MEM_ALIGN8(sizeof(SBlockData)) + MEM_ALIGN8(aColData[0].nData) * 2 +
+               MEM_ALIGN8(sizeof(SColData) * (nColData - 1));
+  for (int32_t iColData = 1; iColData < nColData; ++iColData) {
+    arena.size += tsdbColDataCopySize(&aColData[iColData]);
+  }
+  arena.pBuf = vnodeBufPoolMallocAligned(pPool, arena.size);
+  if (arena.pBuf == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _exit;
   }
 
+  // copy and construct block data
+  SBlockData *pBlockData = tsdbMemArenaMalloc(&arena, sizeof(*pBlockData));
+
   pBlockData->suid = pTbData->suid;
   pBlockData->uid = pTbData->uid;
   pBlockData->nRow = aColData[0].nVal;
   pBlockData->aUid = NULL;
-  pBlockData->aVersion = vnodeBufPoolMalloc(pPool, aColData[0].nData);
-  if (pBlockData->aVersion == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto _exit;
-  }
-  for (int32_t i = 0; i < pBlockData->nRow; i++) {  // todo: here can be optimized
+  pBlockData->aVersion = tsdbMemArenaMalloc(&arena, aColData[0].nData);
+  for (int32_t i = 0; i < pBlockData->nRow; i++) {
     pBlockData->aVersion[i] = version;
   }
 
-  pBlockData->aTSKEY = vnodeBufPoolMalloc(pPool, aColData[0].nData);
-  if (pBlockData->aTSKEY == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto _exit;
-  }
+  pBlockData->aTSKEY = tsdbMemArenaMalloc(&arena, aColData[0].nData);
   memcpy(pBlockData->aTSKEY, aColData[0].pData, aColData[0].nData);
 
   pBlockData->nColData = nColData - 1;
-  pBlockData->aColData = vnodeBufPoolMalloc(pPool, sizeof(SColData) * pBlockData->nColData);
-  if (pBlockData->aColData == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto _exit;
-  }
+  pBlockData->aColData = tsdbMemArenaMalloc(&arena, sizeof(SColData) * pBlockData->nColData);
 
   for (int32_t iColData = 0; iColData < pBlockData->nColData; ++iColData) {
-    code = tColDataCopy(&aColData[iColData + 1], &pBlockData->aColData[iColData], (xMallocFn)vnodeBufPoolMalloc, pPool);
+    code = tColDataCopy(&aColData[iColData + 1], &pBlockData->aColData[iColData], tsdbMemArenaMalloc, &arena);
     if (code) goto _exit;
   }
 
-  // loop to add each row to the skiplist
+  // in-order block, one node for all rows
   SMemSkipListNode *pos[SL_MAX_LEVEL];
   TSDBROW           tRow = tsdbRowFromBlockData(pBlockData, 0);
   TSDBKEY           key = {.version = version, .ts = pBlockData->aTSKEY[0]};
   TSDBROW           lRow;  // last row
+  bool              put = false;
+
+  if ((code = tbDataTryPutRun(pMemTable, pTbData, pBlockData, &put))) goto _exit;
+  if (put) {
+    pTbData->minKey = TMIN(pTbData->minKey, key.ts);
+    lRow = tsdbRowFromBlockData(pBlockData, pBlockData->nRow - 1);
+    key.ts = pBlockData->aTSKEY[pBlockData->nRow - 1];
+    goto _update;
+  }
 
+  // loop to add each row to the skiplist
   // first row
   tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0))) goto _exit;
+  if ((code = tbDataSplitBackwardPos(pMemTable, pTbData, pos, &key))) goto _exit;
+  if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1, 0, NULL))) goto _exit;
   pTbData->minKey = TMIN(pTbData->minKey, key.ts);
   lRow = tRow;
 
@@ -677,15 +927,17 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
 
       if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
         tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
+        if ((code = tbDataSplitForwardPos(pMemTable, pTbData, pos, &key))) goto _exit;
       }
 
-      if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1))) goto _exit;
+      if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1, 1, NULL))) goto _exit;
       lRow = tRow;
 
       ++tRow.iRow;
     }
   }
 
+_update:
   if (key.ts >= pTbData->maxKey) {
     pTbData->maxKey = key.ts;
   }
@@ -716,13 +968,19 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
   TSDBROW           tRow = {.type = TSDBROW_ROW_FMT, .version = version};
   int32_t           iRow = 0;
   TSDBROW           lRow;
+  SMemRowBatch      batch;
 
   // backward put first data
-  tRow.pTSRow = aRow[iRow++];
+  tRow.pTSRow = aRow[iRow];
   key.ts = tRow.pTSRow->ts;
   tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0);
+  code = tbDataSplitBackwardPos(pMemTable, pTbData, pos, &key);
+  if (code) goto _exit;
+  code = tbDataPrepareRowBatch(pMemTable, pTbData, aRow, iRow, nRow, &batch);
   if (code) goto _exit;
+  code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1, 0, &batch);
+  if (code) goto _exit;
+  iRow++;
   lRow = tRow;
 
   pTbData->minKey = TMIN(pTbData->minKey, key.ts);
@@ -739,9 +997,16 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
 
       if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
         tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
+        code = tbDataSplitForwardPos(pMemTable, pTbData, pos, &key);
+        if (code) goto _exit;
+      }
+
+      if (batch.iNode == batch.nNode) {
+        code = tbDataPrepareRowBatch(pMemTable, pTbData, aRow, iRow, nRow, &batch);
+        if (code) goto _exit;
       }
 
-      code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1);
+      code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1, 1, &batch);
       if (code) goto _exit;
 
       lRow = tRow;
@@ -198,6 +198,7 @@ static int32_t filesetIteratorNext(SFilesetIter* pIter, STsdbReader* pReader, bo
 
   while (1) {
     if (pReader->pFileReader != NULL) {
+      tsdbPrefetcherReset(&pReader->prefetcher);
       tsdbDataFileReaderClose(&pReader->pFileReader);
     }
 
@@ -234,6 +235,7 @@ static int32_t filesetIteratorNext(SFilesetIter* pIter, STsdbReader* pReader, bo
         goto _err;
       }
 
+      tsdbPrefetcherSetFiles(&pReader->prefetcher, filesName, &conf);
       pReader->cost.headFileLoad += 1;
     }
 
@@ -423,6 +425,12 @@ static int32_t tsdbReaderCreate(SVnode* pVnode, SQueryTableDataCond* pCond, void
     goto _end;
   }
 
+  code = tsdbPrefetcherInit(&pReader->prefetcher, pReader->idStr);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    goto _end;
+  }
+
   if (pReader->suppInfo.colId[0] != PRIMARYKEY_TIMESTAMP_COL_ID) {
     tsdbError("the first column isn't primary timestamp, %d, %s", pReader->suppInfo.colId[0], pReader->idStr);
     code = TSDB_CODE_INVALID_PARA;
@@ -1095,6 +1103,35 @@ static FORCE_INLINE STSchema* getTableSchemaImpl(STsdbReader* pReader, uint64_t
   return pReader->info.pSchema;
 }
 
+// issue the prefetch of the blocks following the current one in the block iterator
+static void doPrefetchFileBlocks(STsdbReader* pReader, SDataBlockIter* pBlockIter, STSchema* pSchema) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SBlockPrefetchReq   req[TSDB_PREFETCH_BLOCKS];
+  int32_t             numOfReq = 0;
+  int32_t             step = ASCENDING_TRAVERSE(pBlockIter->order) ? 1 : -1;
+
+  for (int32_t i = 1; i <= TSDB_PREFETCH_BLOCKS; ++i) {
+    int32_t index = pBlockIter->index + i * step;
+    if (index < 0 || index >= pBlockIter->numOfBlocks) {
+      break;
+    }
+
+    SFileDataBlockInfo* pBlockInfo = taosArrayGet(pBlockIter->blockList, index);
+    blockInfoToRecord(&req[numOfReq].record, pBlockInfo);
+    req[numOfReq].size = (int64_t)pBlockInfo->numRow * pSchema->tlen + pBlockInfo->blockSize;
+    numOfReq += 1;
+  }
+
+  int32_t numOfIssued = 0;
+  int32_t code = tsdbPrefetchBlocks(&pReader->prefetcher, pSchema, &pSup->colId[1], pSup->numOfCols - 1, req,
+                                    numOfReq, &numOfIssued);
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbDebug("%p failed to prefetch file blocks, code:%s, %s", pReader, tstrerror(code), pReader->idStr);
+  }
+
+  pReader->cost.prefetchBlocks += numOfIssued;
+}
+
 static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
                                    uint64_t uid) {
   int32_t   code = 0;
@@ -1118,8 +1155,17 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   SBrinRecord tmp;
   blockInfoToRecord(&tmp, pBlockInfo);
   SBrinRecord* pRecord = &tmp;
-  code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, &pSup->colId[1],
-                                           pSup->numOfCols - 1);
+
+  bool hit = false;
+  code = tsdbPrefetchGetBlock(&pReader->prefetcher, pRecord, pBlockData, &hit, &pReader->cost.prefetchLoadTime,
+                              &pReader->cost.prefetchWaitTime);
+  if (code == TSDB_CODE_SUCCESS && hit) {
+    pReader->cost.prefetchHits += 1;
+  } else {
+    code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, &pSup->colId[1],
+                                             pSup->numOfCols - 1);
+  }
+
   if (code != TSDB_CODE_SUCCESS) {
     tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
               ", rows:%d, code:%s %s",
@@ -1131,13 +1177,16 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   double elapsedTime = (taosGetTimestampUs() - st) / 1000.0;
 
   tsdbDebug("%p load file block into buffer, global index:%d, index in table block list:%d, brange:%" PRId64 "-%" PRId64
-            ", rows:%d, minVer:%" PRId64 ", maxVer:%" PRId64 ", elapsed time:%.2f ms, %s",
+            ", rows:%d, minVer:%" PRId64 ", maxVer:%" PRId64 ", prefetched:%d, elapsed time:%.2f ms, %s",
             pReader, pBlockIter->index, pBlockInfo->tbBlockIdx, pRecord->firstKey, pRecord->lastKey, pRecord->numRow,
-            pRecord->minVer, pRecord->maxVer, elapsedTime, pReader->idStr);
+            pRecord->minVer, pRecord->maxVer, hit, elapsedTime, pReader->idStr);
 
   pReader->cost.blockLoadTime += elapsedTime;
   pDumpInfo->allDumped = false;
 
+  // blocks are prefetched only once the query starts to load blocks, so queries answered by SMA do not read blocks
+  doPrefetchFileBlocks(pReader, pBlockIter, pSchema);
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -4150,6 +4199,7 @@ void tsdbReaderClose2(STsdbReader* pReader) {
   }
   clearBlockScanInfoBuf(&pReader->blockInfoBuf);
 
+  tsdbPrefetcherDestroy(&pReader->prefetcher);
   if (pReader->pFileReader != NULL) {
     tsdbDataFileReaderClose(&pReader->pFileReader);
   }
@@ -4182,12 +4232,14 @@ void tsdbReaderClose2(STsdbReader* pReader) {
       "build in-memory-block-time:%.2f ms, sttBlocks:%" PRId64 ", sttBlocks-time:%.2f ms, sttStatisBlock:%" PRId64
       ", stt-statis-Block-time:%.2f ms, composed-blocks:%" PRId64
       ", composed-blocks-time:%.2fms, STableBlockScanInfo size:%.2f Kb, createTime:%.2f ms,createSkylineIterTime:%.2f "
-      "ms, initSttBlockReader:%.2fms, %s",
+      "ms, initSttBlockReader:%.2fms, prefetch-blocks:%" PRId64 ", prefetch-hits:%" PRId64
+      ", prefetch-load-time:%.2f ms, prefetch-wait-time:%.2f ms, %s",
       pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime, pCost->numOfBlocks,
       pCost->blockLoadTime, pCost->buildmemBlock, pCost->sttCost.loadBlocks, pCost->sttCost.blockElapsedTime,
       pCost->sttCost.loadStatisBlocks, pCost->sttCost.statisElapsedTime, pCost->composedBlocks,
       pCost->buildComposedBlockTime, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
-      pCost->createSkylineIterTime, pCost->initSttBlockReader, pReader->idStr);
+      pCost->createSkylineIterTime, pCost->initSttBlockReader, pCost->prefetchBlocks, pCost->prefetchHits,
+      pCost->prefetchLoadTime, pCost->prefetchWaitTime, pReader->idStr);
 
   taosMemoryFree(pReader->idStr);
 
@@ -4202,6 +4254,7 @@ static int32_t doSuspendCurrentReader(STsdbReader* pCurrentReader) {
   SReaderStatus* pStatus = &pCurrentReader->status;
 
   if (pStatus->loadFromFile) {
+    tsdbPrefetcherReset(&pCurrentReader->prefetcher);
     tsdbDataFileReaderClose(&pCurrentReader->pFileReader);
 
     SReadCostSummary* pCost = &pCurrentReader->cost;
@@ -4805,6 +4858,7 @@ int32_t tsdbReaderReset2(STsdbReader* pReader, SQueryTableDataCond* pCond) {
   memset(&pReader->suppInfo.tsColAgg, 0, sizeof(SColumnDataAgg));
 
   pReader->suppInfo.tsColAgg.colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+  tsdbPrefetcherReset(&pReader->prefetcher);
   tsdbDataFileReaderClose(&pReader->pFileReader);
 
   int32_t numOfTables = tSimpleHashGetSize(pStatus->pTableMap);
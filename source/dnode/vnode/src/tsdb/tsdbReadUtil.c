@@ -21,6 +21,7 @@
 #include "tsdbMerge.h"
 #include "tsdbUtil2.h"
 #include "tsimplehash.h"
+#include "vnd.h"
 
 static bool overlapWithDelSkylineWithoutVer(STableBlockScanInfo* pBlockScanInfo, const SBrinRecord* pRecord,
                                             int32_t order);
@@ -1072,4 +1073,337 @@ bool overlapWithDelSkylineWithoutVer(STableBlockScanInfo* pBlockScanInfo, const
 
     return doCheckDatablockOverlapWithoutVersion(pBlockScanInfo, pRecord, index);
   }
-}
\ No newline at end of file
+}
+
+// file blocks prefetcher =====================================================
+typedef struct SPrefetchTaskArg {
+  SBlockPrefetcher* pPrefetcher;
+  bool              executed;
+} SPrefetchTaskArg;
+
+static SBlockPrefetchSlot* prefetcherFindSlot(SBlockPrefetcher* pPrefetcher, const SBrinRecord* pRecord) {
+  for (int32_t i = 0; i < TSDB_PREFETCH_BLOCKS; ++i) {
+    SBlockPrefetchSlot* pSlot = &pPrefetcher->slots[i];
+    if (pSlot->state != BLK_PREFETCH_EMPTY && pSlot->record.blockOffset == pRecord->blockOffset &&
+        pSlot->record.uid == pRecord->uid) {
+      return pSlot;
+    }
+  }
+
+  return NULL;
+}
+
+static void prefetcherClearSlot(SBlockPrefetcher* pPrefetcher, SBlockPrefetchSlot* pSlot) {
+  tBlockDataReset(&pSlot->data);
+  pPrefetcher->memUsed -= pSlot->size;
+  pSlot->state = BLK_PREFETCH_EMPTY;
+  pSlot->size = 0;
+  pSlot->code = 0;
+  pSlot->elapsed = 0;
+}
+
+// drop the blocks that are not loaded yet, invoked with the mutex locked
+static void prefetcherDropPendingSlots(SBlockPrefetcher* pPrefetcher) {
+  for (int32_t i = 0; i < TSDB_PREFETCH_BLOCKS; ++i) {
+    if (pPrefetcher->slots[i].state == BLK_PREFETCH_PENDING) {
+      prefetcherClearSlot(pPrefetcher, &pPrefetcher->slots[i]);
+    }
+  }
+}
+
+static int32_t prefetcherLoadBlocks(void* param) {
+  SPrefetchTaskArg* pArg = param;
+  SBlockPrefetcher* pPrefetcher = pArg->pPrefetcher;
+  pArg->executed = true;
+
+  taosThreadMutexLock(&pPrefetcher->mutex);
+  while (1) {
+    SBlockPrefetchSlot* pSlot = NULL;
+    for (int32_t i = 0; i < TSDB_PREFETCH_BLOCKS; ++i) {
+      SBlockPrefetchSlot* p = &pPrefetcher->slots[i];
+      if (p->state == BLK_PREFETCH_PENDING && (pSlot == NULL || p->seq < pSlot->seq)) {
+        pSlot = p;
+      }
+    }
+
+    if (pSlot == NULL) {
+      // the prefetcher may be destroyed once running is cleared, it should not be accessed any more after unlock
+      pPrefetcher->running = false;
+      taosThreadCondBroadcast(&pPrefetcher->cond);
+      taosThreadMutexUnlock(&pPrefetcher->mutex);
+      break;
+    }
+
+    pSlot->state = BLK_PREFETCH_LOADING;
+    taosThreadMutexUnlock(&pPrefetcher->mutex);
+
+    // the slot in loading state is not touched by the query thread, so load it without the lock
+    int32_t code = 0;
+    int64_t st = taosGetTimestampUs();
+    if (pPrefetcher->pFileReader == NULL) {
+      code = tsdbDataFileReaderOpen(pPrefetcher->filesName, &pPrefetcher->conf, &pPrefetcher->pFileReader);
+    }
+
+    if (code == TSDB_CODE_SUCCESS) {
+      tBlockDataReset(&pSlot->data);
+      code = tsdbDataFileReadBlockDataByColumn(pPrefetcher->pFileReader, &pSlot->record, &pSlot->data,
+                                               pPrefetcher->pSchema, pPrefetcher->colId, pPrefetcher->numOfCols);
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbWarn("failed to prefetch file block, offset:%" PRId64 ", uid:%" PRId64 ", code:%s, %s",
+               pSlot->record.blockOffset, pSlot->record.uid, tstrerror(code), pPrefetcher->idStr);
+    }
+
+    taosThreadMutexLock(&pPrefetcher->mutex);
+    pSlot->code = code;
+    pSlot->elapsed = (taosGetTimestampUs() - st) / 1000.0;
+    pSlot->state = BLK_PREFETCH_READY;
+    taosThreadCondBroadcast(&pPrefetcher->cond);
+  }
+
+  return 0;
+}
+
+static void prefetcherLoadBlocksDone(void* param) {
+  SPrefetchTaskArg* pArg = param;
+
+  // the task is cancelled before being executed, e.g. the vnode read pool is stopped
+  if (!pArg->executed) {
+    SBlockPrefetcher* pPrefetcher = pArg->pPrefetcher;
+    taosThreadMutexLock(&pPrefetcher->mutex);
+    prefetcherDropPendingSlots(pPrefetcher);
+    pPrefetcher->running = false;
+    taosThreadCondBroadcast(&pPrefetcher->cond);
+    taosThreadMutexUnlock(&pPrefetcher->mutex);
+  }
+
+  taosMemoryFree(pArg);
+}
+
+int32_t tsdbPrefetcherInit(SBlockPrefetcher* pPrefetcher, const char* idStr) {
+  memset(pPrefetcher, 0, sizeof(*pPrefetcher));
+
+  taosThreadMutexInit(&pPrefetcher->mutex, NULL);
+  taosThreadCondInit(&pPrefetcher->cond, NULL);
+  pPrefetcher->memBudget = TSDB_PREFETCH_MEM_BUDGET;
+  pPrefetcher->idStr = idStr;
+
+  for (int32_t i = 0; i < TSDB_PREFETCH_BLOCKS; ++i) {
+    int32_t code = tBlockDataCreate(&pPrefetcher->slots[i].data);
+    if (code != TSDB_CODE_SUCCESS) {
+      // the slots not created are zeroed, which are safe to be destroyed
+      for (int32_t j = 0; j < TSDB_PREFETCH_BLOCKS; ++j) {
+        tBlockDataDestroy(&pPrefetcher->slots[j].data);
+      }
+      taosThreadCondDestroy(&pPrefetcher->cond);
+      taosThreadMutexDestroy(&pPrefetcher->mutex);
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+void tsdbPrefetcherReset(SBlockPrefetcher* pPrefetcher) {
+  taosThreadMutexLock(&pPrefetcher->mutex);
+  prefetcherDropPendingSlots(pPrefetcher);
+  bool running = pPrefetcher->running;
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+
+  // the task still in the queue of the vnode read pool is cancelled, whose completion callback clears running. It is
+  // invoked without the lock of prefetcher, since the callback acquires it within the lock of the vnode read pool.
+  // The cancellation fails if the task is being executed, which is waited below.
+  if (running) {
+    vnodeACancel(vnodeAsyncHandle[2], pPrefetcher->taskId);
+  }
+
+  taosThreadMutexLock(&pPrefetcher->mutex);
+  while (pPrefetcher->running) {
+    taosThreadCondWait(&pPrefetcher->cond, &pPrefetcher->mutex);
+  }
+
+  for (int32_t i = 0; i < TSDB_PREFETCH_BLOCKS; ++i) {
+    if (pPrefetcher->slots[i].state != BLK_PREFETCH_EMPTY) {
+      prefetcherClearSlot(pPrefetcher, &pPrefetcher->slots[i]);
+    }
+  }
+  pPrefetcher->hasFiles = false;
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+
+  if (pPrefetcher->pFileReader != NULL) {
+    tsdbDataFileReaderClose(&pPrefetcher->pFileReader);
+  }
+}
+
+void tsdbPrefetcherDestroy(SBlockPrefetcher* pPrefetcher) {
+  tsdbPrefetcherReset(pPrefetcher);
+
+  for (int32_t i = 0; i < TSDB_PREFETCH_BLOCKS; ++i) {
+    tBlockDataDestroy(&pPrefetcher->slots[i].data);
+  }
+
+  taosThreadCondDestroy(&pPrefetcher->cond);
+  taosThreadMutexDestroy(&pPrefetcher->mutex);
+}
+
+void tsdbPrefetcherSetFiles(SBlockPrefetcher* pPrefetcher, const char* filesName[], const SDataFileReaderConfig* pConf) {
+  tsdbPrefetcherReset(pPrefetcher);
+
+  // the file names are kept by the file set of the read snapshot, which outlives the prefetcher of current file set
+  pPrefetcher->conf = *pConf;
+  for (int32_t i = 0; i < TSDB_FTYPE_MAX; ++i) {
+    pPrefetcher->filesName[i] = filesName[i];
+  }
+  pPrefetcher->hasFiles = true;
+}
+
+int32_t tsdbPrefetchBlocks(SBlockPrefetcher* pPrefetcher, STSchema* pSchema, int16_t* colId, int32_t numOfCols,
+                           const SBlockPrefetchReq* pReq, int32_t numOfReq, int32_t* numOfIssued) {
+  bool launch = false;
+  *numOfIssued = 0;
+
+  if (!pPrefetcher->hasFiles) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  taosThreadMutexLock(&pPrefetcher->mutex);
+
+  // the schema and columns are identical for all blocks of a reader, and not changed during the loading of blocks
+  if (!pPrefetcher->running) {
+    pPrefetcher->pSchema = pSchema;
+    pPrefetcher->colId = colId;
+    pPrefetcher->numOfCols = numOfCols;
+  }
+
+  // blocks that are not the following ones of the block iterator any more are skipped by the query, release them
+  for (int32_t i = 0; i < TSDB_PREFETCH_BLOCKS; ++i) {
+    SBlockPrefetchSlot* pSlot = &pPrefetcher->slots[i];
+    if (pSlot->state == BLK_PREFETCH_EMPTY || pSlot->state == BLK_PREFETCH_LOADING) {
+      continue;
+    }
+
+    bool wanted = false;
+    for (int32_t j = 0; j < numOfReq; ++j) {
+      if (pReq[j].record.blockOffset == pSlot->record.blockOffset && pReq[j].record.uid == pSlot->record.uid) {
+        wanted = true;
+        break;
+      }
+    }
+
+    if (!wanted) {
+      prefetcherClearSlot(pPrefetcher, pSlot);
+    }
+  }
+
+  for (int32_t j = 0; j < numOfReq; ++j) {
+    if (prefetcherFindSlot(pPrefetcher, &pReq[j].record) != NULL) {
+      continue;
+    }
+
+    // at least one block is allowed to be prefetched, even if it is larger than the budget
+    if (pPrefetcher->memUsed > 0 && pPrefetcher->memUsed + pReq[j].size > pPrefetcher->memBudget) {
+      break;
+    }
+
+    SBlockPrefetchSlot* pSlot = NULL;
+    for (int32_t i = 0; i < TSDB_PREFETCH_BLOCKS; ++i) {
+      if (pPrefetcher->slots[i].state == BLK_PREFETCH_EMPTY) {
+        pSlot = &pPrefetcher->slots[i];
+        break;
+      }
+    }
+
+    if (pSlot == NULL) {
+      break;
+    }
+
+    pSlot->state = BLK_PREFETCH_PENDING;
+    pSlot->seq = ++pPrefetcher->seq;
+    pSlot->size = pReq[j].size;
+    pSlot->record = pReq[j].record;
+    pPrefetcher->memUsed += pSlot->size;
+    (*numOfIssued) += 1;
+  }
+
+  if ((*numOfIssued) > 0 && !pPrefetcher->running) {
+    pPrefetcher->running = true;
+    launch = true;
+  }
+
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+
+  if (!launch) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // the task is scheduled without the lock of prefetcher, since the completion callback acquires it within the lock of
+  // the vnode read pool
+  int32_t           code = TSDB_CODE_OUT_OF_MEMORY;
+  SPrefetchTaskArg* pArg = taosMemoryCalloc(1, sizeof(SPrefetchTaskArg));
+  if (pArg != NULL) {
+    pArg->pPrefetcher = pPrefetcher;
+    code = vnodeAsyncC(vnodeAsyncHandle[2], 0, EVA_PRIORITY_NORMAL, prefetcherLoadBlocks, prefetcherLoadBlocksDone,
+                       pArg, &pPrefetcher->taskId);
+    if (code != TSDB_CODE_SUCCESS) {
+      taosMemoryFree(pArg);
+    }
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    taosThreadMutexLock(&pPrefetcher->mutex);
+    prefetcherDropPendingSlots(pPrefetcher);
+    pPrefetcher->running = false;
+    taosThreadMutexUnlock(&pPrefetcher->mutex);
+    *numOfIssued = 0;
+  }
+
+  return code;
+}
+
+int32_t tsdbPrefetchGetBlock(SBlockPrefetcher* pPrefetcher, const SBrinRecord* pRecord, SBlockData* pBlockData,
+                             bool* pHit, double* pLoadTime, double* pWaitTime) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  *pHit = false;
+
+  if (!pPrefetcher->hasFiles) {
+    return code;
+  }
+
+  taosThreadMutexLock(&pPrefetcher->mutex);
+
+  SBlockPrefetchSlot* pSlot = prefetcherFindSlot(pPrefetcher, pRecord);
+  if (pSlot == NULL) {
+    taosThreadMutexUnlock(&pPrefetcher->mutex);
+    return code;
+  }
+
+  if (pSlot->state == BLK_PREFETCH_PENDING) {
+    // not started yet, loading it in current thread is not slower than waiting for it
+    prefetcherClearSlot(pPrefetcher, pSlot);
+    taosThreadMutexUnlock(&pPrefetcher->mutex);
+    return code;
+  }
+
+  if (pSlot->state == BLK_PREFETCH_LOADING) {
+    int64_t st = taosGetTimestampUs();
+    while (pSlot->state == BLK_PREFETCH_LOADING) {
+      taosThreadCondWait(&pPrefetcher->cond, &pPrefetcher->mutex);
+    }
+    (*pWaitTime) += (taosGetTimestampUs() - st) / 1000.0;
+  }
+
+  // a failed prefetch is retried in current thread, to report the error in the query
+  if (pSlot->code == TSDB_CODE_SUCCESS) {
+    SBlockData tmp = *pBlockData;
+    *pBlockData = pSlot->data;
+    pSlot->data = tmp;
+
+    (*pLoadTime) += pSlot->elapsed;
+    *pHit = true;
+  }
+
+  prefetcherClearSlot(pPrefetcher, pSlot);
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+  return code;
+}
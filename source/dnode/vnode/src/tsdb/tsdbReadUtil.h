@@ -126,6 +126,10 @@ typedef struct SReadCostSummary {
   double  createScanInfoList;
   double  createSkylineIterTime;
   double  initSttBlockReader;
+  int64_t prefetchBlocks;    // file blocks issued to the prefetcher
+  int64_t prefetchHits;      // loaded file blocks that have been found in the prefetcher
+  double  prefetchLoadTime;  // time spent by the I/O worker in loading the hit blocks
+  double  prefetchWaitTime;  // time spent in waiting for the blocks that are still being loaded by the I/O worker
 } SReadCostSummary;
 
 typedef struct STableUidList {
@@ -215,6 +219,52 @@ typedef struct SFileBlockDumpInfo {
   bool    allDumped;
 } SFileBlockDumpInfo;
 
+#define TSDB_PREFETCH_BLOCKS     4
+#define TSDB_PREFETCH_MEM_BUDGET (32 * 1024 * 1024L)
+
+typedef enum {
+  BLK_PREFETCH_EMPTY = 0,
+  BLK_PREFETCH_PENDING,
+  BLK_PREFETCH_LOADING,
+  BLK_PREFETCH_READY,
+} EBlockPrefetchState;
+
+typedef struct SBlockPrefetchReq {
+  SBrinRecord record;
+  int64_t     size;  // estimated memory of the block after being loaded
+} SBlockPrefetchReq;
+
+typedef struct SBlockPrefetchSlot {
+  int8_t      state;
+  int32_t     code;
+  int64_t     seq;  // the order of issue, blocks are loaded in the order they will be consumed
+  int64_t     size;
+  double      elapsed;
+  SBrinRecord record;
+  SBlockData  data;
+} SBlockPrefetchSlot;
+
+// load the next file blocks of the block iterator in the vnode read pool, so the I/O and decompression of them are
+// overlapped with the consumption of the current block.
+typedef struct SBlockPrefetcher {
+  TdThreadMutex         mutex;
+  TdThreadCond          cond;
+  bool                  running;  // a load task is scheduled or running in the vnode read pool
+  int64_t               taskId;   // the load task, only accessed by the query thread
+  bool                  hasFiles;
+  int64_t               seq;
+  int64_t               memUsed;
+  int64_t               memBudget;
+  SDataFileReaderConfig conf;
+  const char*           filesName[TSDB_FTYPE_MAX];
+  SDataFileReader*      pFileReader;  // owned by the I/O worker, since SDataFileReader is not thread-safe
+  STSchema*             pSchema;
+  int16_t*              colId;
+  int32_t               numOfCols;
+  const char*           idStr;
+  SBlockPrefetchSlot    slots[TSDB_PREFETCH_BLOCKS];
+} SBlockPrefetcher;
+
 typedef struct SReaderStatus {
   bool                  suspendInvoked;
   bool                  loadFromFile;       // check file stage
@@ -261,6 +311,7 @@ struct STsdbReader {
   SHashObj**         pIgnoreTables;
   SSHashObj*         pSchemaMap;   // keep the retrieved schema info, to avoid the overhead by repeatly load schema
   SDataFileReader*   pFileReader;  // the file reader
+  SBlockPrefetcher   prefetcher;   // the file blocks prefetcher of pFileReader
   SBlockInfoBuf      blockInfoBuf;
   EContentData       step;
   STsdbReader*       innerReader[2];
@@ -351,7 +402,19 @@ typedef struct SCacheRowsReader {
   SArray*                 pFuncTypeList;
 } SCacheRowsReader;
 
+// file blocks prefetcher
+int32_t tsdbPrefetcherInit(SBlockPrefetcher* pPrefetcher, const char* idStr);
+void    tsdbPrefetcherDestroy(SBlockPrefetcher* pPrefetcher);
+void    tsdbPrefetcherReset(SBlockPrefetcher* pPrefetcher);
+void    tsdbPrefetcherSetFiles(SBlockPrefetcher* pPrefetcher, const char* filesName[], const SDataFileReaderConfig* pConf);
+int32_t tsdbPrefetchBlocks(SBlockPrefetcher* pPrefetcher, STSchema* pSchema, int16_t* colId, int32_t numOfCols,
+                           const SBlockPrefetchReq* pReq, int32_t numOfReq, int32_t* numOfIssued);
+int32_t tsdbPrefetchGetBlock(SBlockPrefetcher* pPrefetcher, const SBrinRecord* pRecord, SBlockData* pBlockData,
+                             bool* pHit, double* pLoadTime, double* pWaitTime);
+
 int32_t tsdbCacheGetBatch(STsdb* pTsdb, tb_uid_t uid, SArray* pLastArray, SCacheRowsReader* pr, int8_t ltype);
+int32_t tsdbCachePrefetchBatch(STsdb* pTsdb, SCacheRowsReader* pr, const STableKeyInfo* pTableList, int32_t numOfTables,
+                               int8_t ltype);
 
 #ifdef __cplusplus
 }
@@ -265,6 +265,66 @@ _exit:
   return code;
 }
 
+#define TSDB_READ_PAGE_RUN 64
+
+// Read the content of the whole pages [pgno, pgno + nPage) into pBuf with one scatter read. The page trailers go aside
+// and the checksums are verified in place. If the content of the last page is not wholly needed, which is nLast bytes,
+// that page is read into pFD->pBuf and becomes the cached page.
+static int32_t tsdbReadFilePageRun(STsdbFD *pFD, int64_t pgno, int32_t nPage, uint8_t *pBuf, int64_t nLast) {
+  int32_t code = 0;
+  int32_t szPgCont = PAGE_CONTENT_SIZE(pFD->szPage);
+  TdIoVec iov[TSDB_READ_PAGE_RUN * 2];
+  TSCKSUM aCksum[TSDB_READ_PAGE_RUN];
+  int32_t nVec = 0;
+  bool    partial = (nLast < szPgCont);
+
+  ASSERT(nPage > 0 && nPage <= TSDB_READ_PAGE_RUN);
+
+  for (int32_t i = 0; i < nPage; i++) {
+    if (i == nPage - 1 && partial) {
+      iov[nVec++] = (TdIoVec){.buf = pFD->pBuf, .len = pFD->szPage};
+    } else {
+      iov[nVec++] = (TdIoVec){.buf = pBuf + (int64_t)i * szPgCont, .len = szPgCont};
+      iov[nVec++] = (TdIoVec){.buf = &aCksum[i], .len = sizeof(TSCKSUM)};
+    }
+  }
+
+  int64_t n = taosPReadvFile(pFD->pFD, iov, nVec, PAGE_OFFSET(pgno, pFD->szPage));
+  if (n < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  } else if (n < (int64_t)nPage * pFD->szPage) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    goto _exit;
+  }
+
+  // check
+  for (int32_t i = 0; i < nPage; i++) {
+    if (pgno + i <= 1) continue;
+
+    if (i == nPage - 1 && partial) {
+      if (!taosCheckChecksumWhole(pFD->pBuf, pFD->szPage)) {
+        code = TSDB_CODE_FILE_CORRUPTED;
+        goto _exit;
+      }
+    } else if (aCksum[i] != taosCalcChecksum(0, pBuf + (int64_t)i * szPgCont, szPgCont)) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+  }
+
+  if (partial) {
+    memcpy(pBuf + (int64_t)(nPage - 1) * szPgCont, pFD->pBuf, nLast);
+    pFD->pgno = pgno + nPage - 1;
+  }
+
+_exit:
+  if (code && partial) {
+    pFD->pgno = 0;
+  }
+  return code;
+}
+
 static int32_t tsdbReadFileImp(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t size) {
   int32_t code = 0;
   int64_t n = 0;
@@ -277,6 +337,25 @@ static int32_t tsdbReadFileImp(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int6
   ASSERT(bOffset < szPgCont);
 
   while (n < size) {
+    // the rest starts at a page boundary and spans more than one page, read pages of it at once
+    if (bOffset == 0 && !pFD->s3File && size - n > szPgCont && pFD->pgno != pgno) {
+      int32_t nPage = (int32_t)TMIN((size - n + szPgCont - 1) / szPgCont, TSDB_READ_PAGE_RUN);
+      int64_t nRead = TMIN((int64_t)nPage * szPgCont, size - n);
+
+      // the cached page may be newer than the one on disk
+      if (pFD->pgno > pgno && pFD->pgno < pgno + nPage) {
+        nPage = (int32_t)(pFD->pgno - pgno);
+        nRead = (int64_t)nPage * szPgCont;
+      }
+
+      code = tsdbReadFilePageRun(pFD, pgno, nPage, pBuf + n, nRead - (int64_t)(nPage - 1) * szPgCont);
+      if (code) goto _exit;
+
+      n += nRead;
+      pgno += nPage;
+      continue;
+    }
+
     if (pFD->pgno != pgno) {
       code = tsdbReadFilePage(pFD, pgno);
       if (code) goto _exit;
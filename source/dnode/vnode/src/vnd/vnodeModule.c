@@ -18,7 +18,7 @@
 
 static volatile int32_t VINIT = 0;
 
-SVAsync* vnodeAsyncHandle[2];
+SVAsync* vnodeAsyncHandle[3];
 
 int vnodeInit(int nthreads) {
   int32_t init;
@@ -36,6 +36,10 @@ int vnodeInit(int nthreads) {
   vnodeAsyncInit(&vnodeAsyncHandle[1], "vnode-merge");
   vnodeAsyncSetWorkers(vnodeAsyncHandle[1], nthreads);
 
+  // vnode-read
+  vnodeAsyncInit(&vnodeAsyncHandle[2], "vnode-read");
+  vnodeAsyncSetWorkers(vnodeAsyncHandle[2], nthreads);
+
   if (walInit() < 0) {
     return -1;
   }
@@ -50,6 +54,7 @@ void vnodeCleanup() {
   // set stop
   vnodeAsyncDestroy(&vnodeAsyncHandle[0]);
   vnodeAsyncDestroy(&vnodeAsyncHandle[1]);
+  vnodeAsyncDestroy(&vnodeAsyncHandle[2]);
 
   walCleanUp();
   smaCleanUp();
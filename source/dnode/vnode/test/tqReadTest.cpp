@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "tq.h"
+
+namespace {
+
+enum { ROW_VALUE = 0, ROW_NULL, ROW_NONE };
+
+// the kinds of rows of a column: every row is the first kind of the list that its index is a multiple of the step of
+typedef struct {
+  const char *name;
+  int32_t     nullStep;  // 0 for no null rows
+  int32_t     noneStep;  // 0 for no none rows
+  bool        hasValue;
+  uint8_t     flag;
+} SRowPattern;
+
+const SRowPattern patterns[] = {
+    {"value", 0, 0, true, HAS_VALUE},
+    {"value|null", 3, 0, true, HAS_VALUE | HAS_NULL},
+    {"value|none", 0, 4, true, HAS_VALUE | HAS_NONE},
+    {"value|null|none", 3, 4, true, HAS_VALUE | HAS_NULL | HAS_NONE},
+    {"null", 1, 0, false, HAS_NULL},
+    {"none", 0, 1, false, HAS_NONE},
+    {"null|none", 2, 1, false, HAS_NULL | HAS_NONE},
+};
+
+const int32_t rowsList[] = {1, 9, 200};
+
+int32_t getRowKind(const SRowPattern *pPattern, int32_t i) {
+  if (pPattern->nullStep > 0 && i % pPattern->nullStep == 0) return ROW_NULL;
+  if (pPattern->noneStep > 0 && i % pPattern->noneStep == 0) return ROW_NONE;
+  return pPattern->hasValue ? ROW_VALUE : ROW_NULL;
+}
+
+int32_t getTypeBytes(int8_t type) { return IS_VAR_DATA_TYPE(type) ? 64 + VARSTR_HEADER_SIZE : tDataTypes[type].bytes; }
+
+// append the value of row i, the var data are of different lengths including the empty one
+void appendValue(SColData *pCol, int16_t cid, int8_t type, int32_t kind, int32_t i) {
+  SColVal colVal;
+  if (kind == ROW_NULL) {
+    colVal = COL_VAL_NULL(cid, type);
+  } else if (kind == ROW_NONE) {
+    colVal = COL_VAL_NONE(cid, type);
+  } else if (IS_VAR_DATA_TYPE(type)) {
+    static char buf[64];
+    int32_t     len = (type == TSDB_DATA_TYPE_NCHAR) ? (i % 9) * TSDB_NCHAR_SIZE : i % 33;
+    for (int32_t k = 0; k < len; ++k) buf[k] = 'a' + (i + k) % 26;
+    SValue value = {0};
+    value.nData = len;
+    value.pData = (uint8_t *)buf;
+    colVal = COL_VAL_VALUE(cid, type, value);
+  } else {
+    SValue  value = {0};
+    int64_t v = (int64_t)i * 7919 - 100000;
+    if (type == TSDB_DATA_TYPE_DOUBLE) {
+      double d = v / 3.0;
+      memcpy(&value.val, &d, sizeof(double));
+    } else if (type == TSDB_DATA_TYPE_INT) {
+      int32_t n = (int32_t)v;
+      memcpy(&value.val, &n, sizeof(int32_t));
+    } else {
+      value.val = v;
+    }
+    colVal = COL_VAL_VALUE(cid, type, value);
+  }
+
+  ASSERT_EQ(tColDataAppendValue(pCol, &colVal), 0);
+}
+
+void createColData(SColData *pCol, int16_t cid, int8_t type, const SRowPattern *pPattern, int32_t rows) {
+  tColDataInit(pCol, cid, type, 0);
+  for (int32_t i = 0; i < rows; ++i) {
+    appendValue(pCol, cid, type, getRowKind(pPattern, i), i);
+  }
+}
+
+// the conversion before tqColDataToColumn: each value taken by tColDataGetValue and set as doSetVal of tqRead.c does
+void setValByColVal(SColumnInfoData *pColData, int32_t rowIndex, SColVal *pColVal) {
+  if (IS_STR_DATA_TYPE(pColVal->type)) {
+    char val[65535 + 2] = {0};
+    if (COL_VAL_IS_VALUE(pColVal)) {
+      if (pColVal->value.pData != NULL) {
+        memcpy(varDataVal(val), pColVal->value.pData, pColVal->value.nData);
+      }
+      varDataSetLen(val, pColVal->value.nData);
+      ASSERT_EQ(colDataSetVal(pColData, rowIndex, val, false), 0);
+    } else {
+      colDataSetNULL(pColData, rowIndex);
+    }
+  } else {
+    ASSERT_EQ(colDataSetVal(pColData, rowIndex, (const char *)&pColVal->value.val, !COL_VAL_IS_VALUE(pColVal)), 0);
+  }
+}
+
+// check the rows [start, start + rows) of the column data are converted to the column as the row by row path does
+void checkColumn(SColData *pCol, int32_t start, SColumnInfoData *pColData, int32_t rows) {
+  SColumnInfoData expect = createColumnInfoData(pColData->info.type, pColData->info.bytes, pColData->info.colId);
+  ASSERT_EQ(colInfoDataEnsureCapacity(&expect, rows, true), 0);
+  for (int32_t i = 0; i < rows; ++i) {
+    SColVal colVal;
+    tColDataGetValue(pCol, start + i, &colVal);
+    setValByColVal(&expect, i, &colVal);
+  }
+
+  for (int32_t i = 0; i < rows; ++i) {
+    bool isNull = colDataIsNull_s(&expect, i);
+    ASSERT_EQ(colDataIsNull_s(pColData, i), isNull) << "row:" << i;
+    if (isNull) {
+      continue;
+    }
+
+    char   *v1 = colDataGetData(&expect, i);
+    char   *v2 = colDataGetData(pColData, i);
+    int32_t len = IS_VAR_DATA_TYPE(expect.info.type) ? varDataTLen(v1) : expect.info.bytes;
+    if (IS_VAR_DATA_TYPE(expect.info.type)) {
+      ASSERT_EQ(varDataTLen(v2), len) << "row:" << i;
+    }
+    ASSERT_EQ(memcmp(v1, v2, len), 0) << "row:" << i;
+  }
+
+  colDataDestroy(&expect);
+}
+
+void checkColDataToColumn(int8_t colType, int8_t type) {
+  for (const SRowPattern &pattern : patterns) {
+    for (int32_t rows : rowsList) {
+      SColData col = {0};
+      createColData(&col, 2, colType, &pattern, rows);
+      if (rows >= 9) {
+        ASSERT_EQ(col.flag, pattern.flag) << pattern.name;
+      }
+
+      SColumnInfoData colData = createColumnInfoData(type, getTypeBytes(type), 2);
+      ASSERT_EQ(colInfoDataEnsureCapacity(&colData, rows, true), 0);
+      ASSERT_EQ(tqColDataToColumn(&col, &colData, rows), 0);
+      checkColumn(&col, 0, &colData, rows);
+
+      // the var data of all rows are kept in one allocation sized up front
+      if (IS_STR_DATA_TYPE(type) && (col.flag & HAS_VALUE)) {
+        ASSERT_EQ(colData.varmeta.allocLen, col.nData + (int64_t)VARSTR_HEADER_SIZE * rows) << pattern.name;
+      }
+
+      colDataDestroy(&colData);
+      tColDataDestroy(&col);
+    }
+  }
+}
+
+SSchema createSchema(int8_t type, int16_t colId) {
+  SSchema schema = {0};
+  schema.type = type;
+  schema.colId = colId;
+  schema.bytes = getTypeBytes(type);
+  snprintf(schema.name, sizeof(schema.name), "c%d", colId);
+  return schema;
+}
+
+void destroyBlocks(SArray *blocks, SArray *schemas) {
+  for (int32_t i = 0; i < taosArrayGetSize(blocks); ++i) {
+    blockDataFreeRes((SSDataBlock *)taosArrayGet(blocks, i));
+  }
+  for (int32_t i = 0; i < taosArrayGetSize(schemas); ++i) {
+    tDeleteSchemaWrapper(*(SSchemaWrapper **)taosArrayGet(schemas, i));
+  }
+  taosArrayDestroy(blocks);
+  taosArrayDestroy(schemas);
+}
+
+class TqSubmitTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    schemas[0] = createSchema(TSDB_DATA_TYPE_TIMESTAMP, PRIMARYKEY_TIMESTAMP_COL_ID);
+    schemas[1] = createSchema(TSDB_DATA_TYPE_INT, 2);
+    schemas[2] = createSchema(TSDB_DATA_TYPE_BINARY, 3);
+    schemas[3] = createSchema(TSDB_DATA_TYPE_DOUBLE, 4);
+    schemaWrapper.nCols = 4;
+    schemaWrapper.version = 1;
+    schemaWrapper.pSchema = schemas;
+
+    submitTbData.flags = SUBMIT_REQ_COLUMN_DATA_FORMAT;
+    submitTbData.uid = 100;
+    submitTbData.aCol = taosArrayInit(4, sizeof(SColData));
+  }
+
+  void TearDown() override { taosArrayDestroyEx(submitTbData.aCol, tColDataDestroy); }
+
+  // a column of the submit, the column with cid noneCid has the rows of [noneStart, noneEnd) none
+  void addColumn(int32_t idx, int32_t rows, int16_t noneCid, int32_t noneStart, int32_t noneEnd) {
+    SColData      col = {0};
+    const SSchema *pSchema = &schemas[idx];
+    tColDataInit(&col, pSchema->colId, pSchema->type, 0);
+    for (int32_t i = 0; i < rows; ++i) {
+      int32_t kind = (idx > 0 && i % 5 == idx) ? ROW_NULL : ROW_VALUE;
+      if (pSchema->colId == noneCid && i >= noneStart && i < noneEnd) {
+        kind = ROW_NONE;
+      }
+      appendValue(&col, pSchema->colId, pSchema->type, kind, i);
+    }
+    taosArrayPush(submitTbData.aCol, &col);
+  }
+
+  SSchema        schemas[4];
+  SSchemaWrapper schemaWrapper = {0};
+  SSubmitTbData  submitTbData = {0};
+};
+
+}  // namespace
+
+TEST(tqReadTest, colDataToColumnFixed) {
+  checkColDataToColumn(TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_TIMESTAMP);
+  checkColDataToColumn(TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_INT);
+  checkColDataToColumn(TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_BIGINT);
+  checkColDataToColumn(TSDB_DATA_TYPE_DOUBLE, TSDB_DATA_TYPE_DOUBLE);
+}
+
+TEST(tqReadTest, colDataToColumnVar) {
+  checkColDataToColumn(TSDB_DATA_TYPE_BINARY, TSDB_DATA_TYPE_BINARY);
+  checkColDataToColumn(TSDB_DATA_TYPE_NCHAR, TSDB_DATA_TYPE_NCHAR);
+}
+
+// the column data of a type other than the column, or of var data not kept as strings, take the row by row path
+TEST(tqReadTest, colDataToColumnFallback) {
+  checkColDataToColumn(TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT);
+  checkColDataToColumn(TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_TIMESTAMP);
+  checkColDataToColumn(TSDB_DATA_TYPE_VARBINARY, TSDB_DATA_TYPE_VARBINARY);
+}
+
+// without none values, all rows of a submit go to one block converted column by column
+TEST_F(TqSubmitTest, submitToOneBlock) {
+  const int32_t rows = 100;
+  for (int32_t idx = 0; idx < 4; ++idx) {
+    addColumn(idx, rows, 0, 0, 0);
+  }
+
+  SArray *blocks = taosArrayInit(1, sizeof(SSDataBlock));
+  SArray *schemaList = taosArrayInit(1, POINTER_BYTES);
+  ASSERT_EQ(tqSubmitTbDataToBlocks(&submitTbData, &schemaWrapper, 10, 2, blocks, schemaList), 0);
+  ASSERT_EQ(taosArrayGetSize(blocks), 1);
+  ASSERT_EQ(taosArrayGetSize(schemaList), 1);
+
+  SSDataBlock    *pBlock = (SSDataBlock *)taosArrayGet(blocks, 0);
+  SSchemaWrapper *pSW = *(SSchemaWrapper **)taosArrayGet(schemaList, 0);
+  ASSERT_EQ(pBlock->info.rows, rows);
+  ASSERT_EQ(pBlock->info.id.uid, 100);
+  ASSERT_EQ(pBlock->info.version, 10);
+  ASSERT_EQ(pSW->nCols, 4);
+  ASSERT_EQ(blockDataGetNumOfCols(pBlock), 4);
+  for (int32_t idx = 0; idx < 4; ++idx) {
+    ASSERT_EQ(pSW->pSchema[idx].colId, schemas[idx].colId);
+    checkColumn((SColData *)taosArrayGet(submitTbData.aCol, idx), 0,
+                (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, idx), rows);
+  }
+
+  destroyBlocks(blocks, schemaList);
+}
+
+// none values split the rows into blocks of the same assigned columns as before
+TEST_F(TqSubmitTest, submitWithNoneSplits) {
+  const int32_t rows = 20;
+  for (int32_t idx = 0; idx < 4; ++idx) {
+    addColumn(idx, rows, 3, 6, 13);
+  }
+
+  SArray *blocks = taosArrayInit(1, sizeof(SSDataBlock));
+  SArray *schemaList = taosArrayInit(1, POINTER_BYTES);
+  ASSERT_EQ(tqSubmitTbDataToBlocks(&submitTbData, &schemaWrapper, 10, 2, blocks, schemaList), 0);
+  ASSERT_EQ(taosArrayGetSize(blocks), 3);
+  ASSERT_EQ(taosArrayGetSize(schemaList), 3);
+
+  // rows [0, 6) and [13, 20) have all columns, rows [6, 13) have no column 3
+  const int32_t starts[] = {0, 6, 13};
+  const int32_t ends[] = {6, 13, 20};
+  for (int32_t b = 0; b < 3; ++b) {
+    SSDataBlock    *pBlock = (SSDataBlock *)taosArrayGet(blocks, b);
+    SSchemaWrapper *pSW = *(SSchemaWrapper **)taosArrayGet(schemaList, b);
+    ASSERT_EQ(pBlock->info.rows, ends[b] - starts[b]);
+    ASSERT_EQ(pSW->nCols, (b == 1) ? 3 : 4);
+    ASSERT_EQ(blockDataGetNumOfCols(pBlock), pSW->nCols);
+
+    int32_t target = 0;
+    for (int32_t idx = 0; idx < 4; ++idx) {
+      if (b == 1 && schemas[idx].colId == 3) {
+        continue;
+      }
+      ASSERT_EQ(pSW->pSchema[target].colId, schemas[idx].colId);
+      checkColumn((SColData *)taosArrayGet(submitTbData.aCol, idx), starts[b],
+                  (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, target), ends[b] - starts[b]);
+      target += 1;
+    }
+  }
+
+  destroyBlocks(blocks, schemaList);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Repeated short-range queries over the same blocks of a data file, with the column data decompressed by each query
+// and taken from the block index cache.
+
+#include "tsdb.h"
+#include "tsdbDataFileRW.h"
+
+#define BENCH_ROWS    4096
+#define BENCH_BLOCKS  64
+#define BENCH_COLS    4
+#define BENCH_QUERIES 2000
+#define BENCH_RANGE   8  // blocks of a query
+
+typedef struct {
+  SBlockCol blockCol;
+  uint8_t  *pData;  // compressed column data
+} SBenchCol;
+
+static const int8_t colTypes[BENCH_COLS] = {TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_DOUBLE, TSDB_DATA_TYPE_INT,
+                                            TSDB_DATA_TYPE_VARCHAR};
+
+static int32_t buildBlocks(SBenchCol *pCols) {
+  int32_t  code = 0;
+  uint32_t seed = 100;
+  uint8_t *pBuf = NULL;
+  char     str[32];
+
+  for (int32_t iBlock = 0; iBlock < BENCH_BLOCKS && code == 0; ++iBlock) {
+    for (int32_t iCol = 0; iCol < BENCH_COLS && code == 0; ++iCol) {
+      SColData colData = {0};
+      int16_t  cid = iCol + 2;
+      int8_t   type = colTypes[iCol];
+
+      tColDataInit(&colData, cid, type, 1);
+      for (int32_t iRow = 0; iRow < BENCH_ROWS && code == 0; ++iRow) {
+        SValue value = {0};
+        if (IS_VAR_DATA_TYPE(type)) {
+          value.nData = snprintf(str, sizeof(str), "device-%d", taosRandR(&seed) % 100);
+          value.pData = (uint8_t *)str;
+        } else if (type == TSDB_DATA_TYPE_DOUBLE) {
+          double v = iRow * 0.25 + taosRandR(&seed) % 10;
+          memcpy(&value.val, &v, sizeof(v));
+        } else {
+          value.val = iBlock * BENCH_ROWS + iRow + taosRandR(&seed) % 10;
+        }
+
+        if (iRow % 100 == 7) {
+          code = tColDataAppendValue(&colData, &COL_VAL_NULL(cid, type));
+        } else {
+          code = tColDataAppendValue(&colData, &COL_VAL_VALUE(cid, type, value));
+        }
+      }
+
+      SBenchCol *pCol = &pCols[iBlock * BENCH_COLS + iCol];
+      pCol->blockCol = (SBlockCol){.cid = cid, .type = type, .smaOn = 1, .flag = colData.flag};
+      pCol->blockCol.szOrigin = colData.nData;
+      if (code == 0) {
+        code = tsdbCmprColData(&colData, TWO_STAGE_COMP, &pCol->blockCol, &pCol->pData, 0, &pBuf);
+      }
+
+      tColDataDestroy(&colData);
+    }
+  }
+
+  tFree(pBuf);
+  return code;
+}
+
+// a query loads all columns of BENCH_RANGE consecutive blocks, and checks the loaded data with the expected one
+static int32_t runQueries(STsdb *pTsdb, SBenchCol *pCols, bool useCache, int64_t *cost) {
+  int32_t  code = 0;
+  uint32_t seed = 200;
+  uint8_t *pBuf = NULL;
+  SColData colData = {0};
+  SColData expected = {0};
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t q = 0; q < BENCH_QUERIES && code == 0; ++q) {
+    // dashboards mostly query the recent blocks
+    int32_t start = BENCH_BLOCKS - BENCH_RANGE - taosRandR(&seed) % (BENCH_RANGE * 2);
+
+    for (int32_t iBlock = start; iBlock < start + BENCH_RANGE && code == 0; ++iBlock) {
+      for (int32_t iCol = 0; iCol < BENCH_COLS && code == 0; ++iCol) {
+        SBenchCol *pCol = &pCols[iBlock * BENCH_COLS + iCol];
+        int64_t    offset = (int64_t)iBlock * 1024 * 1024;
+        bool       hit = false;
+
+        tColDataInit(&colData, pCol->blockCol.cid, pCol->blockCol.type, 1);
+        if (useCache) {
+          code = tsdbBICacheGetColData(pTsdb, 1, 1, offset, &colData, &hit);
+        }
+
+        if (code == 0 && !hit) {
+          code = tsdbDecmprColData(pCol->pData, &pCol->blockCol, TWO_STAGE_COMP, BENCH_ROWS, &colData, &pBuf);
+          if (code == 0 && useCache) {
+            tsdbBICachePutColData(pTsdb, 1, 1, offset, &colData);
+          }
+        }
+
+        if (code == 0 && q == BENCH_QUERIES - 1) {
+          tColDataInit(&expected, pCol->blockCol.cid, pCol->blockCol.type, 1);
+          code = tsdbDecmprColData(pCol->pData, &pCol->blockCol, TWO_STAGE_COMP, BENCH_ROWS, &expected, &pBuf);
+          if (code == 0 && (colData.flag != expected.flag || colData.nVal != expected.nVal ||
+                            colData.nData != expected.nData ||
+                            memcmp(colData.pData, expected.pData, expected.nData) != 0)) {
+            code = TSDB_CODE_FILE_CORRUPTED;
+          }
+        }
+      }
+    }
+  }
+  *cost = taosGetTimestampUs() - st;
+
+  tColDataDestroy(&colData);
+  tColDataDestroy(&expected);
+  tFree(pBuf);
+  return code;
+}
+
+int main(int argc, char *argv[]) {
+  SVnode    *pVnode = taosMemoryCalloc(1, sizeof(SVnode));
+  STsdb     *pTsdb = taosMemoryCalloc(1, sizeof(STsdb));
+  SBenchCol *pCols = taosMemoryCalloc(BENCH_BLOCKS * BENCH_COLS, sizeof(SBenchCol));
+  int64_t    decmprCost = 0, cacheCost = 0;
+
+  pTsdb->pVnode = pVnode;
+  pTsdb->biCache = taosLRUCacheInit(64 * 1024 * 1024, -1, .5);
+  taosLRUCacheSetStrictCapacity(pTsdb->biCache, false);
+
+  int32_t code = buildBlocks(pCols);
+  if (code == 0) code = runQueries(pTsdb, pCols, false, &decmprCost);
+  if (code == 0) code = runQueries(pTsdb, pCols, true, &cacheCost);
+
+  if (code == 0) {
+    SBICacheStatis *pStatis = &pTsdb->biStatis;
+    printf("%d queries of %d blocks x %d columns x %d rows: decompress %" PRId64 "us, cache %" PRId64
+           "us (hit:%" PRId64 ", miss:%" PRId64 ", evict:%" PRId64 ")\n",
+           BENCH_QUERIES, BENCH_RANGE, BENCH_COLS, BENCH_ROWS, decmprCost, cacheCost, pStatis->colHits,
+           pStatis->colMisses, pStatis->evicts);
+  } else {
+    printf("failed to run queries since %s\n", tstrerror(code));
+  }
+
+  taosLRUCacheCleanup(pTsdb->biCache);
+  for (int32_t i = 0; i < BENCH_BLOCKS * BENCH_COLS; ++i) {
+    tFree(pCols[i].pData);
+  }
+  taosMemoryFree(pCols);
+  taosMemoryFree(pTsdb);
+  taosMemoryFree(pVnode);
+  return code == 0 ? 0 : 1;
+}
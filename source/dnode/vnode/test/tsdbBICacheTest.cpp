@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "tsdbDataFileRW.h"
+#include "tsdbFS2.h"
+#include "vnd.h"
+
+namespace {
+
+const char    *TEST_DIR = "/tmp/tsdbBICacheTest";
+const char    *TEST_TSDB_PATH = "vnode2/tsdb";  // relative to the disk of the tfs
+const int64_t  TEST_SUID = 10;
+const tb_uid_t TEST_UIDS[] = {100, 101};
+const int32_t  TEST_BLOCKS = 3;  // blocks of each table
+const int32_t  TEST_ROWS = 200;  // rows of each block
+const int16_t  TEST_CIDS[] = {2, 3, 4, 5};
+
+// what a read of all blocks of a data file gives: the brin records and the rows of the block data
+typedef struct {
+  std::string brin;
+  std::string data;
+  int64_t     brinOffset;   // offset of the first brin block in the head file
+  int64_t     blockOffset;  // offset of the first block in the data file
+} SReadResult;
+
+void appendBytes(std::string &s, const void *p, size_t size) { s.append((const char *)p, size); }
+
+void appendBlockData(std::string &s, SBlockData *bData) {
+  appendBytes(s, &bData->nRow, sizeof(bData->nRow));
+  appendBytes(s, bData->aVersion, sizeof(int64_t) * bData->nRow);
+  appendBytes(s, bData->aTSKEY, sizeof(TSKEY) * bData->nRow);
+
+  for (int32_t i = 0; i < bData->nColData; ++i) {
+    SColData *pColData = tBlockDataGetColDataByIdx(bData, i);
+    appendBytes(s, &pColData->cid, sizeof(pColData->cid));
+    appendBytes(s, &pColData->type, sizeof(pColData->type));
+    appendBytes(s, &pColData->flag, sizeof(pColData->flag));
+    appendBytes(s, &pColData->nVal, sizeof(pColData->nVal));
+
+    for (int32_t iRow = 0; iRow < pColData->nVal; ++iRow) {
+      SColVal colVal;
+      memset(&colVal, 0, sizeof(colVal));
+      tColDataGetValue(pColData, iRow, &colVal);
+      appendBytes(s, &colVal.flag, sizeof(colVal.flag));
+      if (!COL_VAL_IS_VALUE(&colVal)) {
+        continue;
+      }
+
+      if (IS_VAR_DATA_TYPE(colVal.type)) {
+        appendBytes(s, &colVal.value.nData, sizeof(colVal.value.nData));
+        appendBytes(s, colVal.value.pData, colVal.value.nData);
+      } else {
+        appendBytes(s, &colVal.value.val, tDataTypes[colVal.type].bytes);
+      }
+    }
+  }
+}
+
+class TsdbBICacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[TSDB_FILENAME_LEN];
+    taosRemoveDir(TEST_DIR);
+    snprintf(path, sizeof(path), "%s%s%s", TEST_DIR, TD_DIRSEP, TEST_TSDB_PATH);
+    ASSERT_EQ(taosMulMkDir(path), 0);
+
+    SDiskCfg diskCfg = {0};
+    tstrncpy(diskCfg.dir, TEST_DIR, sizeof(diskCfg.dir));
+    diskCfg.level = 0;
+    diskCfg.primary = 1;
+    pTfs = tfsOpen(&diskCfg, 1);
+    ASSERT_NE(pTfs, nullptr);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->pTfs = pTfs;
+    pVnode->config.vgId = 2;
+    pVnode->config.tsdbPageSize = 4096;
+    pVnode->config.sttTrigger = 1;
+
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pTsdb->pVnode = pVnode;
+    pTsdb->path = (char *)TEST_TSDB_PATH;
+    taosThreadMutexInit(&pTsdb->mutex, NULL);
+    pTsdb->biCache = taosLRUCacheInit(16 * 1024 * 1024, -1, .5);
+    taosLRUCacheSetStrictCapacity(pTsdb->biCache, false);
+
+    SSchema schema[5] = {0};
+    const int8_t types[5] = {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_DOUBLE,
+                             TSDB_DATA_TYPE_VARCHAR, TSDB_DATA_TYPE_BIGINT};
+    for (int32_t i = 0; i < 5; ++i) {
+      schema[i].type = types[i];
+      schema[i].colId = PRIMARYKEY_TIMESTAMP_COL_ID + i;
+      schema[i].bytes = IS_VAR_DATA_TYPE(types[i]) ? 32 + VARSTR_HEADER_SIZE : TYPE_BYTES[types[i]];
+    }
+    pSchema = tBuildTSchema(schema, 5, 1);
+    ASSERT_NE(pSchema, nullptr);
+
+    // all tables are of one super table, so the writer takes the schema without the meta
+    skmTb.suid = TEST_SUID;
+    skmTb.pTSchema = pSchema;
+  }
+
+  void TearDown() override {
+    taosLRUCacheEraseUnrefEntries(pTsdb->biCache);
+    taosLRUCacheCleanup(pTsdb->biCache);
+    taosThreadMutexDestroy(&pTsdb->mutex);
+    taosMemoryFree(pSchema);
+    taosMemoryFree(pTsdb);
+    taosMemoryFree(pVnode);
+    tfsClose(pTfs);
+    taosRemoveDir(TEST_DIR);
+  }
+
+  // rows of a block, with nulls in the int and varchar columns, and the bigint column all null
+  void buildBlockData(tb_uid_t uid, int32_t iBlock, int32_t seed, SBlockData *bData) {
+    TABLEID tbid = {.suid = TEST_SUID, .uid = uid};
+    SArray *aColVal = taosArrayInit(5, sizeof(SColVal));
+    char    str[32];
+
+    ASSERT_EQ(tBlockDataInit(bData, &tbid, pSchema, NULL, 0), 0);
+    for (int32_t i = 0; i < TEST_ROWS; ++i) {
+      int32_t row = iBlock * TEST_ROWS + i;
+      int32_t v = row * 31 + seed;
+      double  d = v / 4.0;
+      SValue  value = {0};
+
+      taosArrayClear(aColVal);
+      value.val = 1700000000000 + row * 1000;
+      taosArrayPush(aColVal, &COL_VAL_VALUE(1, TSDB_DATA_TYPE_TIMESTAMP, value));
+
+      value.val = 0;
+      memcpy(&value.val, &v, sizeof(v));
+      if (i % 7 == 3) {
+        taosArrayPush(aColVal, &COL_VAL_NULL(2, TSDB_DATA_TYPE_INT));
+      } else {
+        taosArrayPush(aColVal, &COL_VAL_VALUE(2, TSDB_DATA_TYPE_INT, value));
+      }
+
+      memcpy(&value.val, &d, sizeof(d));
+      taosArrayPush(aColVal, &COL_VAL_VALUE(3, TSDB_DATA_TYPE_DOUBLE, value));
+
+      value.nData = snprintf(str, sizeof(str), "device-%d", v % 1000);
+      value.pData = (uint8_t *)str;
+      if (i % 5 == 1) {
+        taosArrayPush(aColVal, &COL_VAL_NULL(4, TSDB_DATA_TYPE_VARCHAR));
+      } else {
+        taosArrayPush(aColVal, &COL_VAL_VALUE(4, TSDB_DATA_TYPE_VARCHAR, value));
+      }
+
+      taosArrayPush(aColVal, &COL_VAL_NULL(5, TSDB_DATA_TYPE_BIGINT));
+
+      SRow *pRow = NULL;
+      ASSERT_EQ(tRowBuild(aColVal, pSchema, &pRow), 0);
+      TSDBROW tsdbRow = tsdbRowFromTSRow(1, pRow);
+      ASSERT_EQ(tBlockDataAppendRow(bData, &tsdbRow, pSchema, uid), 0);
+      taosMemoryFree(pRow);
+    }
+
+    taosArrayDestroy(aColVal);
+  }
+
+  // write a data file of the file set fid, and give the ops of the created files
+  void writeFile(int32_t fid, int64_t cid, int32_t seed, TFileOpArray *opArr) {
+    SDataFileWriterConfig config = {0};
+    config.tsdb = pTsdb;
+    config.cmprAlg = TWO_STAGE_COMP;
+    config.maxRow = 4096;
+    config.szPage = pVnode->config.tsdbPageSize;
+    config.fid = fid;
+    config.cid = cid;
+    config.compactVersion = INT64_MAX;
+    config.skmTb = &skmTb;
+
+    SDataFileWriter *writer = NULL;
+    SBlockData       bData = {0};
+    ASSERT_EQ(tsdbDataFileWriterOpen(&config, &writer), 0);
+    ASSERT_EQ(tBlockDataCreate(&bData), 0);
+    for (tb_uid_t uid : TEST_UIDS) {
+      for (int32_t iBlock = 0; iBlock < TEST_BLOCKS; ++iBlock) {
+        buildBlockData(uid, iBlock, seed, &bData);
+        ASSERT_EQ(tsdbDataFileWriteBlockData(writer, &bData), 0);
+      }
+    }
+    ASSERT_EQ(tsdbDataFileWriterClose(&writer, false, opArr), 0);
+    tBlockDataDestroy(&bData);
+  }
+
+  // read the brin blocks and the given columns of all blocks of the files, decoded or taken from the cache
+  void readFile(const STFile *files, const int16_t *cids, int32_t ncid, bool useCache, SReadResult *pRes) {
+    SLRUCache *pCache = pTsdb->biCache;
+    if (!useCache) {
+      pTsdb->biCache = NULL;
+    }
+
+    SDataFileReaderConfig config = {0};
+    config.tsdb = pTsdb;
+    config.szPage = pVnode->config.tsdbPageSize;
+    for (int32_t ftype = TSDB_FTYPE_HEAD; ftype <= TSDB_FTYPE_SMA; ++ftype) {
+      config.files[ftype].exist = true;
+      config.files[ftype].file = files[ftype];
+    }
+
+    SDataFileReader     *reader = NULL;
+    const TBrinBlkArray *brinBlkArray = NULL;
+    SBrinBlock           brinBlock;
+    SBlockData           bData = {0};
+    ASSERT_EQ(tsdbDataFileReaderOpen(NULL, &config, &reader), 0);
+    ASSERT_EQ(tsdbDataFileReadBrinBlk(reader, &brinBlkArray), 0);
+    ASSERT_GT(TARRAY2_SIZE(brinBlkArray), 0);
+    ASSERT_EQ(tBrinBlockInit(&brinBlock), 0);
+    ASSERT_EQ(tBlockDataCreate(&bData), 0);
+
+    pRes->brin.clear();
+    pRes->data.clear();
+    pRes->brinOffset = TARRAY2_GET_PTR(brinBlkArray, 0)->dp->offset;
+    for (int32_t i = 0; i < TARRAY2_SIZE(brinBlkArray); ++i) {
+      ASSERT_EQ(tsdbDataFileReadBrinBlock(reader, TARRAY2_GET_PTR(brinBlkArray, i), &brinBlock), 0);
+
+      for (int32_t j = 0; j < BRIN_BLOCK_SIZE(&brinBlock); ++j) {
+        SBrinRecord record;
+        ASSERT_EQ(tBrinBlockGet(&brinBlock, j, &record), 0);
+        appendBytes(pRes->brin, record.dataArr1, sizeof(record.dataArr1));
+        appendBytes(pRes->brin, record.dataArr2, sizeof(record.dataArr2));
+        if (i == 0 && j == 0) {
+          pRes->blockOffset = record.blockOffset;
+        }
+
+        ASSERT_EQ(tsdbDataFileReadBlockDataByColumn(reader, &record, &bData, pSchema, (int16_t *)cids, ncid), 0);
+        appendBlockData(pRes->data, &bData);
+      }
+    }
+    ASSERT_EQ(pRes->data.empty(), false);
+
+    tBlockDataDestroy(&bData);
+    tBrinBlockDestroy(&brinBlock);
+    tsdbDataFileReaderClose(&reader);
+    pTsdb->biCache = pCache;
+  }
+
+  // the files of the file set fid after the ops
+  void getFiles(const TFileOpArray *opArr, int32_t fid, STFile *files) {
+    for (int32_t i = 0; i < TARRAY2_SIZE(opArr); ++i) {
+      const STFileOp *op = TARRAY2_GET_PTR(opArr, i);
+      if (op->fid == fid && (op->optype == TSDB_FOP_CREATE || op->optype == TSDB_FOP_MODIFY)) {
+        files[op->nf.type] = op->nf;
+      }
+    }
+  }
+
+  void commit(const TFileOpArray *opArr) {
+    ASSERT_EQ(tsdbFSEditBegin(pTsdb->pFS, opArr, TSDB_FEDIT_COMMIT), 0);
+    taosThreadMutexLock(&pTsdb->mutex);
+    int32_t code = tsdbFSEditCommit(pTsdb->pFS);
+    taosThreadMutexUnlock(&pTsdb->mutex);
+    ASSERT_EQ(code, 0);
+  }
+
+  bool hasBrinBlock(int32_t fid, int64_t cid, int64_t offset) {
+    SBrinBlock brinBlock;
+    bool       hit = false;
+    tBrinBlockInit(&brinBlock);
+    EXPECT_EQ(tsdbBICacheGetBrinBlock(pTsdb, fid, cid, offset, &brinBlock, &hit), 0);
+    tBrinBlockDestroy(&brinBlock);
+    return hit;
+  }
+
+  bool hasColData(int32_t fid, int64_t cid, int64_t offset, int16_t colId, int8_t type) {
+    SColData colData = {0};
+    bool     hit = false;
+    tColDataInit(&colData, colId, type, 1);
+    EXPECT_EQ(tsdbBICacheGetColData(pTsdb, fid, cid, offset, &colData, &hit), 0);
+    tColDataDestroy(&colData);
+    return hit;
+  }
+
+  STfs     *pTfs;
+  SVnode   *pVnode;
+  STsdb    *pTsdb;
+  STSchema *pSchema;
+  SSkmInfo  skmTb = {0};
+};
+
+}  // namespace
+
+// the brin blocks, keys and column data taken from the cache are the same as the decoded ones
+TEST_F(TsdbBICacheTest, hitSameAsDecode) {
+  TFileOpArray opArr[1];
+  STFile       files[TSDB_FTYPE_MAX] = {0};
+  SReadResult  expect, miss, hit, part, partExpect;
+  TARRAY2_INIT(opArr);
+  writeFile(1, 1, 0, opArr);
+  getFiles(opArr, 1, files);
+
+  readFile(files, TEST_CIDS, 4, false, &expect);
+  ASSERT_EQ(taosLRUCacheGetElems(pTsdb->biCache), 0);
+
+  SBICacheStatis statis = pTsdb->biStatis;
+  readFile(files, TEST_CIDS, 4, true, &miss);
+  ASSERT_EQ(pTsdb->biStatis.brinHits, statis.brinHits);
+  ASSERT_EQ(pTsdb->biStatis.colHits, statis.colHits);
+  ASSERT_GT(pTsdb->biStatis.colMisses, statis.colMisses);
+
+  statis = pTsdb->biStatis;
+  readFile(files, TEST_CIDS, 4, true, &hit);
+  ASSERT_GT(pTsdb->biStatis.brinHits, statis.brinHits);
+  ASSERT_GT(pTsdb->biStatis.colHits, statis.colHits);
+  ASSERT_EQ(pTsdb->biStatis.brinMisses, statis.brinMisses);
+  ASSERT_EQ(pTsdb->biStatis.colMisses, statis.colMisses);
+
+  ASSERT_EQ(miss.brin, expect.brin);
+  ASSERT_EQ(miss.data, expect.data);
+  ASSERT_EQ(hit.brin, expect.brin);
+  ASSERT_EQ(hit.data, expect.data);
+
+  // a column of the cached ones, alone
+  const int16_t cids[] = {4};
+  readFile(files, cids, 1, false, &partExpect);
+  readFile(files, cids, 1, true, &part);
+  ASSERT_EQ(part.data, partExpect.data);
+
+  TARRAY2_DESTROY(opArr, NULL);
+}
+
+// a commit drops the entries of the files removed from the file set, and of the removed file sets
+TEST_F(TsdbBICacheTest, invalidateOnCommit) {
+  TFileOpArray  opArr[1];
+  STFile        files1[TSDB_FTYPE_MAX] = {0};
+  STFile        files2[TSDB_FTYPE_MAX] = {0};
+  SReadResult   res1, res2, res;
+  TARRAY2_INIT(opArr);
+
+  ASSERT_EQ(tsdbOpenFS(pTsdb, &pTsdb->pFS, 0), 0);
+  writeFile(1, 1, 0, opArr);
+  writeFile(2, 2, 0, opArr);
+  commit(opArr);
+  getFiles(opArr, 1, files1);
+  getFiles(opArr, 2, files2);
+
+  readFile(files2, TEST_CIDS, 4, true, &res2);
+  int32_t elems2 = taosLRUCacheGetElems(pTsdb->biCache);
+  readFile(files1, TEST_CIDS, 4, true, &res1);
+  int32_t elems1 = taosLRUCacheGetElems(pTsdb->biCache) - elems2;
+  ASSERT_GT(elems2, 0);
+  ASSERT_EQ(elems1, elems2);
+
+  // a new head file of the file set 1, the blocks in its data file stay the same
+  STFile head = files1[TSDB_FTYPE_HEAD];
+  head.cid = 3;
+  char from[TSDB_FILENAME_LEN], to[TSDB_FILENAME_LEN];
+  tsdbTFileName(pTsdb, &files1[TSDB_FTYPE_HEAD], from);
+  tsdbTFileName(pTsdb, &head, to);
+  ASSERT_GE(taosCopyFile(from, to), 0);
+
+  TARRAY2_CLEAR(opArr, NULL);
+  TARRAY2_APPEND(opArr, ((STFileOp){.optype = TSDB_FOP_REMOVE, .fid = 1, .of = files1[TSDB_FTYPE_HEAD]}));
+  TARRAY2_APPEND(opArr, ((STFileOp){.optype = TSDB_FOP_CREATE, .fid = 1, .nf = head}));
+  commit(opArr);
+
+  ASSERT_FALSE(hasBrinBlock(1, 1, res1.brinOffset));
+  ASSERT_TRUE(hasColData(1, 1, res1.blockOffset, 4, TSDB_DATA_TYPE_VARCHAR));
+  ASSERT_TRUE(hasBrinBlock(2, 2, res2.brinOffset));
+  ASSERT_EQ(taosLRUCacheGetElems(pTsdb->biCache), elems2 + elems1 - 1);
+
+  // the brin block is decoded from the new head file, and the column data still taken from the cache
+  SBICacheStatis statis = pTsdb->biStatis;
+  files1[TSDB_FTYPE_HEAD] = head;
+  readFile(files1, TEST_CIDS, 4, true, &res);
+  ASSERT_EQ(pTsdb->biStatis.brinMisses, statis.brinMisses + 1);
+  ASSERT_EQ(pTsdb->biStatis.colMisses, statis.colMisses);
+  ASSERT_EQ(res.brin, res1.brin);
+  ASSERT_EQ(res.data, res1.data);
+
+  // the file set 1 removed
+  TARRAY2_CLEAR(opArr, NULL);
+  for (int32_t ftype = TSDB_FTYPE_HEAD; ftype <= TSDB_FTYPE_SMA; ++ftype) {
+    TARRAY2_APPEND(opArr, ((STFileOp){.optype = TSDB_FOP_REMOVE, .fid = 1, .of = files1[ftype]}));
+  }
+  commit(opArr);
+
+  ASSERT_FALSE(hasBrinBlock(1, 3, res1.brinOffset));
+  ASSERT_FALSE(hasColData(1, 1, res1.blockOffset, 4, TSDB_DATA_TYPE_VARCHAR));
+  ASSERT_TRUE(hasBrinBlock(2, 2, res2.brinOffset));
+  ASSERT_TRUE(hasColData(2, 2, res2.blockOffset, 4, TSDB_DATA_TYPE_VARCHAR));
+  ASSERT_EQ(taosLRUCacheGetElems(pTsdb->biCache), elems2);
+
+  // the last file set removed
+  TARRAY2_CLEAR(opArr, NULL);
+  for (int32_t ftype = TSDB_FTYPE_HEAD; ftype <= TSDB_FTYPE_SMA; ++ftype) {
+    TARRAY2_APPEND(opArr, ((STFileOp){.optype = TSDB_FOP_REMOVE, .fid = 2, .of = files2[ftype]}));
+  }
+  commit(opArr);
+  ASSERT_EQ(taosLRUCacheGetElems(pTsdb->biCache), 0);
+
+  tsdbCloseFS(&pTsdb->pFS);
+  TARRAY2_DESTROY(opArr, NULL);
+}
+
+// the entries of a file are not taken for a file of the same file set with another commit id
+TEST_F(TsdbBICacheTest, staleCommitId) {
+  TFileOpArray opArr[1];
+  STFile       oldFiles[TSDB_FTYPE_MAX] = {0};
+  STFile       newFiles[TSDB_FTYPE_MAX] = {0};
+  SReadResult  oldRes, newExpect, newRes;
+  TARRAY2_INIT(opArr);
+
+  writeFile(1, 1, 0, opArr);
+  getFiles(opArr, 1, oldFiles);
+  readFile(oldFiles, TEST_CIDS, 4, true, &oldRes);
+
+  // the same layout with other values, at the same offsets of the first blocks
+  TARRAY2_CLEAR(opArr, NULL);
+  writeFile(1, 2, 7, opArr);
+  getFiles(opArr, 1, newFiles);
+  ASSERT_TRUE(hasBrinBlock(1, 1, oldRes.brinOffset));
+  ASSERT_TRUE(hasColData(1, 1, oldRes.blockOffset, 4, TSDB_DATA_TYPE_VARCHAR));
+  ASSERT_FALSE(hasColData(1, 2, oldRes.blockOffset, 4, TSDB_DATA_TYPE_VARCHAR));
+
+  SBICacheStatis statis = pTsdb->biStatis;
+  readFile(newFiles, TEST_CIDS, 4, false, &newExpect);
+  readFile(newFiles, TEST_CIDS, 4, true, &newRes);
+  ASSERT_EQ(pTsdb->biStatis.colHits, statis.colHits);
+  ASSERT_NE(newExpect.data, oldRes.data);
+  ASSERT_EQ(newRes.brin, newExpect.brin);
+  ASSERT_EQ(newRes.data, newExpect.data);
+
+  TARRAY2_DESTROY(opArr, NULL);
+}
+
+#pragma GCC diagnostic pop
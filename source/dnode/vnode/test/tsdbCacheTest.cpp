@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "tsdbReadUtil.h"
+#include "vnd.h"
+
+namespace {
+
+// the key of the last cache, in lru and rocksdb
+typedef struct {
+  tb_uid_t uid;
+  int16_t  cid;
+  int8_t   ltype;
+} STestLastKey;
+
+const size_t  TEST_KEY_LEN = sizeof(tb_uid_t) + sizeof(int16_t) + sizeof(int8_t);
+const int16_t TEST_CIDS[] = {PRIMARYKEY_TIMESTAMP_COL_ID, PRIMARYKEY_TIMESTAMP_COL_ID + 1};
+
+SLastCol testLastCol(tb_uid_t uid, int16_t cid, int64_t val) {
+  SLastCol lastCol = {0};
+  lastCol.ts = 1700000000000 + uid;
+  lastCol.colVal = COL_VAL_VALUE(cid, TSDB_DATA_TYPE_BIGINT, (SValue){.val = val});
+  return lastCol;
+}
+
+void freeLastCol(const void *key, size_t klen, void *value, void *ud) { taosMemoryFree(value); }
+
+class TsdbCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(TEST_PATH);
+    ASSERT_EQ(taosMulMkDir(TEST_PATH), 0);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pTsdb->pVnode = pVnode;
+    pTsdb->path = (char *)TEST_PATH;
+    pVnode->config.cacheLastSize = 1;
+    pVnode->config.tsdbPageSize = 4096;
+    ASSERT_EQ(tsdbOpenCache(pTsdb), 0);
+
+    SSchema schema[2] = {0};
+    schema[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+    schema[0].colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+    schema[0].bytes = TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP];
+    schema[1].type = TSDB_DATA_TYPE_BIGINT;
+    schema[1].colId = PRIMARYKEY_TIMESTAMP_COL_ID + 1;
+    schema[1].bytes = TYPE_BYTES[TSDB_DATA_TYPE_BIGINT];
+
+    // a reader of the last row of both columns
+    reader.pTsdb = pTsdb;
+    reader.pSchema = tBuildTSchema(schema, 2, 1);
+    reader.pSlotIds = slotIds;
+    reader.numOfCols = 2;
+    reader.type = CACHESCAN_RETRIEVE_TYPE_ALL | CACHESCAN_RETRIEVE_LAST_ROW;
+    reader.pCidList = taosArrayInit(2, sizeof(int16_t));
+    taosArrayPush(reader.pCidList, &TEST_CIDS[0]);
+    taosArrayPush(reader.pCidList, &TEST_CIDS[1]);
+  }
+
+  void TearDown() override {
+    tsdbCloseCache(pTsdb);
+    taosArrayDestroy(reader.pCidList);
+    taosMemoryFree(reader.pSchema);
+    taosMemoryFree(pTsdb);
+    taosMemoryFree(pVnode);
+    taosRemoveDir(TEST_PATH);
+  }
+
+  void putRocks(tb_uid_t uid, int16_t cid, int64_t val) {
+    STestLastKey key = {.uid = uid, .cid = cid, .ltype = 0};
+    SLastCol     lastCol = testLastCol(uid, cid, val);
+    char        *err = NULL;
+    rocksdb_put(pTsdb->rCache.db, pTsdb->rCache.writeoptions, (const char *)&key, TEST_KEY_LEN,
+                (const char *)&lastCol, sizeof(lastCol), &err);
+    ASSERT_EQ(err, nullptr);
+  }
+
+  void putLru(tb_uid_t uid, int16_t cid, int64_t val) {
+    STestLastKey key = {.uid = uid, .cid = cid, .ltype = 0};
+    SLastCol    *pLastCol = (SLastCol *)taosMemoryCalloc(1, sizeof(SLastCol));
+    *pLastCol = testLastCol(uid, cid, val);
+    ASSERT_EQ(taosLRUCacheInsert(pTsdb->lruCache, &key, TEST_KEY_LEN, pLastCol, sizeof(SLastCol), freeLastCol, NULL,
+                                 TAOS_LRU_PRIORITY_LOW, NULL),
+              TAOS_LRU_STATUS_OK);
+  }
+
+  // the value in the lru cache, or -1 if the key is not in it
+  int64_t lruValue(tb_uid_t uid, int16_t cid) {
+    STestLastKey key = {.uid = uid, .cid = cid, .ltype = 0};
+    LRUHandle   *h = taosLRUCacheLookup(pTsdb->lruCache, &key, TEST_KEY_LEN);
+    if (h == NULL) return -1;
+
+    SLastCol *pLastCol = (SLastCol *)taosLRUCacheValue(pTsdb->lruCache, h);
+    int64_t   val = pLastCol->colVal.value.val;
+    EXPECT_EQ(pLastCol->ts, 1700000000000 + uid);
+    taosLRUCacheRelease(pTsdb->lruCache, h, false);
+    return val;
+  }
+
+  const char      *TEST_PATH = "/tmp/tsdbCacheTest";
+  SVnode          *pVnode;
+  STsdb           *pTsdb;
+  SCacheRowsReader reader = {0};
+  int32_t          slotIds[2] = {0, 1};
+};
+
+}  // namespace
+
+TEST_F(TsdbCacheTest, prefetchBatch) {
+  // tables 1 to 4 have the last rows of both columns in rocksdb, table 5 has none
+  for (tb_uid_t uid = 1; uid <= 4; ++uid) {
+    for (int16_t cid : TEST_CIDS) {
+      putRocks(uid, cid, uid * 100 + cid);
+    }
+  }
+
+  // a key already in the lru cache may be newer than the one in rocksdb, it is not overwritten
+  putLru(1, TEST_CIDS[0], 999);
+
+  STableKeyInfo tables[5] = {0};
+  for (int32_t i = 0; i < 5; ++i) {
+    tables[i].uid = i + 1;
+  }
+
+  ASSERT_EQ(tsdbCachePrefetchBatch(pTsdb, &reader, tables, 5, 0), 0);
+  EXPECT_EQ(pTsdb->lastStatis.prefetchKeys, 7);
+  EXPECT_EQ(lruValue(1, TEST_CIDS[0]), 999);
+  EXPECT_EQ(lruValue(1, TEST_CIDS[1]), 100 + TEST_CIDS[1]);
+  for (tb_uid_t uid = 2; uid <= 4; ++uid) {
+    for (int16_t cid : TEST_CIDS) {
+      EXPECT_EQ(lruValue(uid, cid), uid * 100 + cid);
+    }
+  }
+  EXPECT_EQ(lruValue(5, TEST_CIDS[0]), -1);
+  EXPECT_EQ(lruValue(5, TEST_CIDS[1]), -1);
+
+  // only the keys of table 5 are looked up again, and there is nothing to load
+  ASSERT_EQ(tsdbCachePrefetchBatch(pTsdb, &reader, tables, 5, 0), 0);
+  EXPECT_EQ(pTsdb->lastStatis.prefetchKeys, 7);
+
+  // the prefetched tables are then resolved from the lru cache without going to rocksdb
+  SArray *pRow = taosArrayInit(2, sizeof(SLastCol));
+  for (tb_uid_t uid = 2; uid <= 4; ++uid) {
+    taosArrayClear(pRow);
+    ASSERT_EQ(tsdbCacheGetBatch(pTsdb, uid, pRow, &reader, 0), 0);
+    ASSERT_EQ(taosArrayGetSize(pRow), 2);
+    for (int32_t i = 0; i < 2; ++i) {
+      SLastCol *pLastCol = (SLastCol *)taosArrayGet(pRow, i);
+      EXPECT_EQ(pLastCol->ts, 1700000000000 + uid);
+      EXPECT_EQ(pLastCol->colVal.value.val, uid * 100 + TEST_CIDS[i]);
+    }
+  }
+  EXPECT_EQ(pTsdb->lastStatis.hitKeys, 6);
+  EXPECT_EQ(pTsdb->lastStatis.rocksKeys, 0);
+  taosArrayDestroy(pRow);
+}
+
+#pragma GCC diagnostic pop
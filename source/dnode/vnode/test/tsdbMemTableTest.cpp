@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "tsdb.h"
+#include "vnd.h"
+
+namespace {
+
+const tb_uid_t TEST_UID = 100;
+
+typedef struct {
+  TSKEY   ts;
+  int64_t version;
+  int64_t val;
+} STestRow;
+
+bool operator==(const STestRow &r1, const STestRow &r2) {
+  return r1.ts == r2.ts && r1.version == r2.version && r1.val == r2.val;
+}
+
+bool operator<(const STestRow &r1, const STestRow &r2) {
+  return r1.ts < r2.ts || (r1.ts == r2.ts && r1.version < r2.version);
+}
+
+// the value column keeps both the key and the version, so a row moved by a split is checked against its own data
+int64_t testValue(TSKEY ts, int64_t version) { return version * 1000000 + ts; }
+
+class TsdbMemTableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pTsdb->pVnode = pVnode;
+    pVnode->config.szBuf = VNODE_BUFPOOL_SEGMENTS * 1024 * 1024;
+    pVnode->config.tsdbCfg.slLevel = 5;
+    pVnode->config.cacheLast = 0;
+
+    ASSERT_EQ(vnodeOpenBufPool(pVnode), 0);
+    pVnode->inUse = pVnode->freeList;
+    pVnode->inUse->nRef = 1;
+    pVnode->freeList = pVnode->inUse->freeNext;
+    pVnode->inUse->freeNext = NULL;
+    ASSERT_EQ(tsdbMemTableCreate(pTsdb, &pTsdb->mem), 0);
+
+    SSchema schema[2] = {0};
+    schema[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+    schema[0].colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+    schema[0].bytes = TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP];
+    schema[1].type = TSDB_DATA_TYPE_BIGINT;
+    schema[1].colId = PRIMARYKEY_TIMESTAMP_COL_ID + 1;
+    schema[1].bytes = TYPE_BYTES[TSDB_DATA_TYPE_BIGINT];
+    pSchema = tBuildTSchema(schema, 2, 1);
+    ASSERT_NE(pSchema, nullptr);
+  }
+
+  void TearDown() override {
+    tsdbMemTableDestroy(pTsdb->mem, false);
+    vnodeCloseBufPool(pVnode);
+    taosMemoryFree(pSchema);
+    taosMemoryFree(pTsdb);
+    taosMemoryFree(pVnode);
+  }
+
+  // insert a column format block, whose keys are put as one run if they are in order and not overlapped
+  void insertCols(int64_t version, const std::vector<TSKEY> &keys) {
+    SSubmitTbData submitTbData = {0};
+    submitTbData.flags = SUBMIT_REQ_COLUMN_DATA_FORMAT;
+    submitTbData.uid = TEST_UID;
+    submitTbData.aCol = taosArrayInit(2, sizeof(SColData));
+
+    SColData *pTsCol = (SColData *)taosArrayReserve(submitTbData.aCol, 1);
+    SColData *pValCol = (SColData *)taosArrayReserve(submitTbData.aCol, 1);
+    tColDataInit(pTsCol, PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, 0);
+    tColDataInit(pValCol, PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_BIGINT, 0);
+    for (TSKEY ts : keys) {
+      SColVal tsVal = COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, (SValue){.val = ts});
+      SColVal valVal = COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_BIGINT,
+                                     (SValue){.val = testValue(ts, version)});
+      ASSERT_EQ(tColDataAppendValue(pTsCol, &tsVal), 0);
+      ASSERT_EQ(tColDataAppendValue(pValCol, &valVal), 0);
+      expected.push_back({ts, version, testValue(ts, version)});
+    }
+
+    int32_t affectedRows = 0;
+    ASSERT_EQ(tsdbInsertTableData(pTsdb, version, &submitTbData, &affectedRows), 0);
+    EXPECT_EQ(affectedRows, keys.size());
+    taosArrayDestroyEx(submitTbData.aCol, tColDataDestroy);
+  }
+
+  // insert a row format submit, each row is put as one node
+  void insertRows(int64_t version, const std::vector<TSKEY> &keys) {
+    SSubmitTbData submitTbData = {0};
+    submitTbData.uid = TEST_UID;
+    submitTbData.aRowP = taosArrayInit(keys.size(), POINTER_BYTES);
+
+    SArray *aColVal = taosArrayInit(2, sizeof(SColVal));
+    for (TSKEY ts : keys) {
+      SColVal tsVal = COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, (SValue){.val = ts});
+      SColVal valVal = COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_BIGINT,
+                                     (SValue){.val = testValue(ts, version)});
+      taosArrayClear(aColVal);
+      taosArrayPush(aColVal, &tsVal);
+      taosArrayPush(aColVal, &valVal);
+
+      SRow *pRow = NULL;
+      ASSERT_EQ(tRowBuild(aColVal, pSchema, &pRow), 0);
+      taosArrayPush(submitTbData.aRowP, &pRow);
+      expected.push_back({ts, version, testValue(ts, version)});
+    }
+    taosArrayDestroy(aColVal);
+
+    int32_t affectedRows = 0;
+    ASSERT_EQ(tsdbInsertTableData(pTsdb, version, &submitTbData, &affectedRows), 0);
+    EXPECT_EQ(affectedRows, keys.size());
+    taosArrayDestroyP(submitTbData.aRowP, (FDelete)tRowDestroy);
+  }
+
+  STbData *tbData() { return tsdbGetTbDataFromMemTable(pTsdb->mem, 0, TEST_UID); }
+
+  // the number of rows covered by each node of the skiplist, from head to tail
+  std::vector<int32_t> nodeRows() {
+    std::vector<int32_t> rows;
+    STbData             *pTbData = tbData();
+    for (SMemSkipListNode *pNode = pTbData->sl.pHead->forwards[0]; pNode != pTbData->sl.pTail;
+         pNode = pNode->forwards[0]) {
+      rows.push_back(pNode->flag == TSDBROW_COL_FMT ? (int32_t)pNode->nRow : 1);
+    }
+    return rows;
+  }
+
+  std::vector<STestRow> scan(TSDBKEY *pFrom, int8_t backward) {
+    std::vector<STestRow> rows;
+    STbDataIter           iter = {0};
+
+    tsdbTbDataIterOpen(tbData(), pFrom, backward, &iter);
+    for (TSDBROW *pRow = tsdbTbDataIterGet(&iter); pRow != NULL; pRow = tsdbTbDataIterGet(&iter)) {
+      SColVal colVal;
+      tsdbRowGetColVal(pRow, pSchema, 1, &colVal);
+      rows.push_back({TSDBROW_TS(pRow), TSDBROW_VERSION(pRow), colVal.value.val});
+      tsdbTbDataIterNext(&iter);
+    }
+    return rows;
+  }
+
+  // all the rows in key order, scanned forward and backward from the ends
+  void checkScan() {
+    std::vector<STestRow> rows = expected;
+    std::sort(rows.begin(), rows.end());
+    EXPECT_EQ(scan(NULL, 0), rows);
+    std::reverse(rows.begin(), rows.end());
+    EXPECT_EQ(scan(NULL, 1), rows);
+    std::vector<int32_t> nRows = nodeRows();
+    EXPECT_EQ(tbData()->sl.size, expected.size());
+    EXPECT_EQ(std::accumulate(nRows.begin(), nRows.end(), 0), expected.size());
+  }
+
+  // the rows with key >= pFrom forward, or <= pFrom backward, in scan order
+  std::vector<STestRow> expectFrom(TSDBKEY from, int8_t backward) {
+    std::vector<STestRow> rows;
+    STestRow              fromRow = {from.ts, from.version, 0};
+    for (const STestRow &row : expected) {
+      if (backward ? !(fromRow < row) : !(row < fromRow)) rows.push_back(row);
+    }
+    std::sort(rows.begin(), rows.end());
+    if (backward) std::reverse(rows.begin(), rows.end());
+    return rows;
+  }
+
+  SVnode               *pVnode;
+  STsdb                *pTsdb;
+  STSchema             *pSchema;
+  std::vector<STestRow> expected;
+};
+
+}  // namespace
+
+TEST_F(TsdbMemTableTest, splitRun) {
+  insertCols(1, {10, 20, 30, 40, 50, 60, 70, 80, 90, 100});
+  EXPECT_EQ(nodeRows(), std::vector<int32_t>({10}));
+  checkScan();
+
+  // a row falling inside the run splits it before being put
+  insertRows(2, {35});
+  EXPECT_EQ(nodeRows(), std::vector<int32_t>({3, 1, 7}));
+  checkScan();
+
+  // a single row column block is put by the per-row path and splits the run as well
+  insertCols(3, {75});
+  EXPECT_EQ(nodeRows(), std::vector<int32_t>({3, 1, 4, 1, 3}));
+  checkScan();
+
+  // an in-order block overlapping existing runs is put row by row, the first row splits the run backward and the
+  // following ones forward
+  insertCols(4, {15, 65, 95});
+  EXPECT_EQ(nodeRows(), std::vector<int32_t>({1, 1, 2, 1, 3, 1, 1, 1, 2, 1, 1}));
+  checkScan();
+
+  // an in-order block falling in a gap is still put as one run
+  insertCols(5, {101, 102, 103});
+  EXPECT_EQ(nodeRows().back(), 3);
+  checkScan();
+}
+
+TEST_F(TsdbMemTableTest, iterateAcrossRuns) {
+  insertCols(1, {1, 2, 3, 4, 5});
+  insertCols(2, {11, 12, 13, 14, 15});
+  insertRows(3, {8});
+  insertCols(4, {21, 22, 23});
+  EXPECT_EQ(nodeRows(), std::vector<int32_t>({5, 1, 5, 3}));
+  checkScan();
+
+  // the start key at the beginning, inside and at the end of a run, equal to a row, in the gap between runs and out
+  // of range
+  TSDBKEY keys[] = {{VERSION_MIN, 1},  {VERSION_MIN, 3},  {1, 3},           {VERSION_MIN, 5},  {VERSION_MAX, 5},
+                    {VERSION_MIN, 8},  {VERSION_MAX, 8},  {VERSION_MIN, 10}, {VERSION_MIN, 11}, {2, 13},
+                    {VERSION_MAX, 15}, {VERSION_MIN, 21}, {VERSION_MAX, 23}, {VERSION_MIN, 0},  {VERSION_MAX, 30}};
+  for (TSDBKEY &key : keys) {
+    EXPECT_EQ(scan(&key, 0), expectFrom(key, 0)) << "forward from ts:" << key.ts << " version:" << key.version;
+    EXPECT_EQ(scan(&key, 1), expectFrom(key, 1)) << "backward from ts:" << key.ts << " version:" << key.version;
+  }
+
+  // the iterator may turn around in the middle of a run
+  TSDBKEY     from = {.version = VERSION_MIN, .ts = 12};
+  STbDataIter iter = {0};
+  tsdbTbDataIterOpen(tbData(), &from, 0, &iter);
+  ASSERT_TRUE(tsdbTbDataIterNext(&iter));
+  EXPECT_EQ(TSDBROW_TS(tsdbTbDataIterGet(&iter)), 13);
+  iter.backward = 1;
+  ASSERT_TRUE(tsdbTbDataIterNext(&iter));
+  EXPECT_EQ(TSDBROW_TS(tsdbTbDataIterGet(&iter)), 12);
+  ASSERT_TRUE(tsdbTbDataIterNext(&iter));
+  ASSERT_TRUE(tsdbTbDataIterNext(&iter));
+  EXPECT_EQ(TSDBROW_TS(tsdbTbDataIterGet(&iter)), 8);
+  ASSERT_TRUE(tsdbTbDataIterNext(&iter));
+  EXPECT_EQ(TSDBROW_TS(tsdbTbDataIterGet(&iter)), 5);
+}
+
+TEST_F(TsdbMemTableTest, duplicateKeysAcrossRuns) {
+  insertCols(1, {1, 2, 3, 4, 5});
+  insertCols(2, {10, 11, 12, 13, 14});
+
+  // the same keys with a newer version are put right after the old ones, splitting the runs they fall in
+  insertCols(3, {3, 4, 5, 6, 7});
+  insertCols(4, {10, 11, 12, 13, 14});
+  insertRows(5, {12});
+  checkScan();
+
+  // all the versions of a key are visited from either side
+  TSDBKEY keys[] = {{VERSION_MIN, 3},  {VERSION_MAX, 3},  {4, 12},
+                    {VERSION_MIN, 12}, {VERSION_MAX, 12}, {VERSION_MAX, 14}};
+  for (TSDBKEY &key : keys) {
+    EXPECT_EQ(scan(&key, 0), expectFrom(key, 0)) << "forward from ts:" << key.ts << " version:" << key.version;
+    EXPECT_EQ(scan(&key, 1), expectFrom(key, 1)) << "backward from ts:" << key.ts << " version:" << key.version;
+  }
+
+  // a block with the same key twice is not a run, both rows are kept
+  insertCols(6, {20, 20});
+  checkScan();
+}
+
+#pragma GCC diagnostic pop
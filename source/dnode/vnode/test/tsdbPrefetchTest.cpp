@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "tsdbReadUtil.h"
+#include "vnd.h"
+
+namespace {
+
+// a task occupying the only worker of the vnode read pool, so the tasks scheduled later stay in the queue
+typedef struct {
+  tsem_t  started;
+  tsem_t  release;
+  int64_t taskId;
+} SBlockerArg;
+
+int32_t blockWorker(void *param) {
+  SBlockerArg *pArg = (SBlockerArg *)param;
+  tsem_post(&pArg->started);
+  tsem_wait(&pArg->release);
+  return 0;
+}
+
+class TsdbPrefetchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(vnodeAsyncInit(&vnodeAsyncHandle[2], "vnode-read"), 0);
+    ASSERT_EQ(vnodeAsyncSetWorkers(vnodeAsyncHandle[2], 1), 0);
+    ASSERT_EQ(tsdbPrefetcherInit(&prefetcher, "test"), 0);
+
+    // the files are not existed, so the load task fails after opening them
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pTsdb->pVnode = pVnode;
+    pVnode->config.tsdbPageSize = 4096;
+
+    SSchema schema[2] = {0};
+    schema[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+    schema[0].colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+    schema[0].bytes = TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP];
+    schema[1].type = TSDB_DATA_TYPE_INT;
+    schema[1].colId = PRIMARYKEY_TIMESTAMP_COL_ID + 1;
+    schema[1].bytes = TYPE_BYTES[TSDB_DATA_TYPE_INT];
+    pSchema = tBuildTSchema(schema, 2, 1);
+    ASSERT_NE(pSchema, nullptr);
+
+    SDataFileReaderConfig conf = {0};
+    conf.tsdb = pTsdb;
+    conf.szPage = 4096;
+    const char *filesName[TSDB_FTYPE_MAX] = {0};
+    filesName[TSDB_FTYPE_HEAD] = "/tmp/tsdbPrefetchTest/v1f100ver1.head";
+    filesName[TSDB_FTYPE_DATA] = "/tmp/tsdbPrefetchTest/v1f100ver1.data";
+    tsdbPrefetcherSetFiles(&prefetcher, filesName, &conf);
+  }
+
+  void TearDown() override {
+    tsdbPrefetcherDestroy(&prefetcher);
+    vnodeAsyncDestroy(&vnodeAsyncHandle[2]);
+    taosMemoryFree(pSchema);
+    taosMemoryFree(pTsdb);
+    taosMemoryFree(pVnode);
+  }
+
+  void blockReadPool(SBlockerArg *pArg) {
+    tsem_init(&pArg->started, 0, 0);
+    tsem_init(&pArg->release, 0, 0);
+    ASSERT_EQ(vnodeAsyncC(vnodeAsyncHandle[2], 0, EVA_PRIORITY_HIGH, blockWorker, NULL, pArg, &pArg->taskId), 0);
+    tsem_wait(&pArg->started);
+  }
+
+  void unblockReadPool(SBlockerArg *pArg) {
+    tsem_post(&pArg->release);
+    vnodeAWait(vnodeAsyncHandle[2], pArg->taskId);
+    tsem_destroy(&pArg->started);
+    tsem_destroy(&pArg->release);
+  }
+
+  int32_t numOfSlots(int8_t state) {
+    int32_t num = 0;
+    for (int32_t i = 0; i < TSDB_PREFETCH_BLOCKS; ++i) {
+      num += (prefetcher.slots[i].state == state);
+    }
+    return num;
+  }
+
+  SBlockPrefetcher prefetcher;
+  SVnode          *pVnode;
+  STsdb           *pTsdb;
+  STSchema        *pSchema;
+  int16_t          colId[1] = {PRIMARYKEY_TIMESTAMP_COL_ID + 1};
+};
+
+SBlockPrefetchReq buildReq(int64_t offset, int64_t size) {
+  SBlockPrefetchReq req = {0};
+  req.record.uid = 1;
+  req.record.blockOffset = offset;
+  req.record.blockSize = 128;
+  req.record.numRow = 10;
+  req.size = size;
+  return req;
+}
+
+}  // namespace
+
+TEST_F(TsdbPrefetchTest, noFiles) {
+  tsdbPrefetcherReset(&prefetcher);
+
+  SBlockPrefetchReq req = buildReq(0, 100);
+  int32_t           numOfIssued = -1;
+  ASSERT_EQ(tsdbPrefetchBlocks(&prefetcher, pSchema, colId, 1, &req, 1, &numOfIssued), 0);
+  EXPECT_EQ(numOfIssued, 0);
+  EXPECT_FALSE(prefetcher.running);
+
+  SBlockData data = {0};
+  bool       hit = true;
+  double     loadTime = 0, waitTime = 0;
+  ASSERT_EQ(tsdbPrefetchGetBlock(&prefetcher, &req.record, &data, &hit, &loadTime, &waitTime), 0);
+  EXPECT_FALSE(hit);
+}
+
+TEST_F(TsdbPrefetchTest, issueWithinBudget) {
+  SBlockerArg blocker;
+  blockReadPool(&blocker);
+
+  prefetcher.memBudget = 100;
+  SBlockPrefetchReq reqs[] = {buildReq(0, 80), buildReq(1000, 80), buildReq(2000, 10)};
+  int32_t           numOfIssued = 0;
+
+  // at least one block is issued even if it is larger than the budget, and the issue stops at the first one exceeding
+  ASSERT_EQ(tsdbPrefetchBlocks(&prefetcher, pSchema, colId, 1, reqs, 3, &numOfIssued), 0);
+  EXPECT_EQ(numOfIssued, 1);
+  EXPECT_EQ(prefetcher.memUsed, 80);
+  EXPECT_TRUE(prefetcher.running);
+
+  // the blocks not wanted any more are released before the issue
+  ASSERT_EQ(tsdbPrefetchBlocks(&prefetcher, pSchema, colId, 1, &reqs[1], 2, &numOfIssued), 0);
+  EXPECT_EQ(numOfIssued, 2);
+  EXPECT_EQ(prefetcher.memUsed, 90);
+  EXPECT_EQ(numOfSlots(BLK_PREFETCH_PENDING), 2);
+
+  // a block not started yet is loaded by the query thread
+  SBlockData data = {0};
+  bool       hit = true;
+  double     loadTime = 0, waitTime = 0;
+  ASSERT_EQ(tsdbPrefetchGetBlock(&prefetcher, &reqs[1].record, &data, &hit, &loadTime, &waitTime), 0);
+  EXPECT_FALSE(hit);
+  EXPECT_EQ(prefetcher.memUsed, 10);
+
+  tsdbPrefetcherReset(&prefetcher);
+  EXPECT_EQ(prefetcher.memUsed, 0);
+  unblockReadPool(&blocker);
+}
+
+TEST_F(TsdbPrefetchTest, resetCancelsQueuedTask) {
+  SBlockerArg blocker;
+  blockReadPool(&blocker);
+
+  SBlockPrefetchReq reqs[] = {buildReq(0, 100), buildReq(1000, 100)};
+  int32_t           numOfIssued = 0;
+  ASSERT_EQ(tsdbPrefetchBlocks(&prefetcher, pSchema, colId, 1, reqs, 2, &numOfIssued), 0);
+  EXPECT_EQ(numOfIssued, 2);
+  EXPECT_TRUE(prefetcher.running);
+
+  // the load task is still in the queue, since the only worker is blocked, the reset returns without waiting for it
+  tsdbPrefetcherReset(&prefetcher);
+  EXPECT_FALSE(prefetcher.running);
+  EXPECT_FALSE(prefetcher.hasFiles);
+  EXPECT_EQ(prefetcher.memUsed, 0);
+  EXPECT_EQ(numOfSlots(BLK_PREFETCH_EMPTY), TSDB_PREFETCH_BLOCKS);
+
+  unblockReadPool(&blocker);
+}
+
+TEST_F(TsdbPrefetchTest, waitRunningTask) {
+  SBlockPrefetchReq req = buildReq(0, 100);
+  int32_t           numOfIssued = 0;
+  ASSERT_EQ(tsdbPrefetchBlocks(&prefetcher, pSchema, colId, 1, &req, 1, &numOfIssued), 0);
+  EXPECT_EQ(numOfIssued, 1);
+
+  // the block is loaded by the worker and fails, it is retried by the query thread
+  taosThreadMutexLock(&prefetcher.mutex);
+  while (prefetcher.running) {
+    taosThreadCondWait(&prefetcher.cond, &prefetcher.mutex);
+  }
+  EXPECT_EQ(numOfSlots(BLK_PREFETCH_READY), 1);
+  taosThreadMutexUnlock(&prefetcher.mutex);
+
+  SBlockData data = {0};
+  bool       hit = true;
+  double     loadTime = 0, waitTime = 0;
+  ASSERT_EQ(tsdbPrefetchGetBlock(&prefetcher, &req.record, &data, &hit, &loadTime, &waitTime), 0);
+  EXPECT_FALSE(hit);
+  EXPECT_EQ(numOfSlots(BLK_PREFETCH_EMPTY), TSDB_PREFETCH_BLOCKS);
+  EXPECT_EQ(prefetcher.memUsed, 0);
+
+  // the reset after the task is done has nothing to cancel
+  tsdbPrefetcherReset(&prefetcher);
+  EXPECT_FALSE(prefetcher.running);
+}
+
+#pragma GCC diagnostic pop
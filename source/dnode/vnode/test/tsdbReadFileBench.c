@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Block load throughput of a TSDB data file, read at once as a page run and read page by page.
+
+#include "tsdb.h"
+#include "tsdbDef.h"
+
+#define BENCH_PAGE_SIZE 4096
+#define BENCH_BLOCK_SIZE (1024 * 1024)
+#define BENCH_BLOCKS    64
+
+static const char *fileName = "/tmp/tsdbReadFileBench.data";
+
+static int32_t writeFile(STsdb *pTsdb, const uint8_t *pData, int64_t size) {
+  STsdbFD *pFD = NULL;
+  int32_t  code = tsdbOpenFile(fileName, pTsdb, TD_FILE_READ | TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC, &pFD);
+  if (code) return code;
+
+  code = tsdbWriteFile(pFD, 0, pData, size);
+  if (code == 0) code = tsdbFsyncFile(pFD);
+
+  tsdbCloseFile(&pFD);
+  return code;
+}
+
+// read the blocks at unaligned offsets, with one call for each block or with one call for each page
+static int32_t loadBlocks(STsdb *pTsdb, const uint8_t *pData, uint8_t *pBuf, bool byPage, int64_t *cost) {
+  STsdbFD *pFD = NULL;
+  int32_t  szPgCont = PAGE_CONTENT_SIZE(BENCH_PAGE_SIZE);
+  int32_t  code = tsdbOpenFile(fileName, pTsdb, TD_FILE_READ, &pFD);
+  if (code) return code;
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < BENCH_BLOCKS - 1; ++i) {
+    int64_t offset = (int64_t)i * BENCH_BLOCK_SIZE + i * 97;
+
+    if (byPage) {
+      for (int64_t n = 0; n < BENCH_BLOCK_SIZE && code == 0;) {
+        int64_t nRead = TMIN(szPgCont - (offset + n) % szPgCont, BENCH_BLOCK_SIZE - n);
+        code = tsdbReadFile(pFD, offset + n, pBuf + n, nRead, 0);
+        n += nRead;
+      }
+    } else {
+      code = tsdbReadFile(pFD, offset, pBuf, BENCH_BLOCK_SIZE, 0);
+    }
+
+    if (code) break;
+    if (memcmp(pBuf, pData + offset, BENCH_BLOCK_SIZE) != 0) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      break;
+    }
+  }
+  *cost = taosGetTimestampUs() - st;
+
+  tsdbCloseFile(&pFD);
+  return code;
+}
+
+int main(int argc, char *argv[]) {
+  SVnode  *pVnode = taosMemoryCalloc(1, sizeof(SVnode));
+  STsdb   *pTsdb = taosMemoryCalloc(1, sizeof(STsdb));
+  int64_t  size = (int64_t)BENCH_BLOCK_SIZE * BENCH_BLOCKS;
+  uint8_t *pData = taosMemoryMalloc(size);
+  uint8_t *pBuf = taosMemoryMalloc(BENCH_BLOCK_SIZE);
+  uint32_t seed = 100;
+  int64_t  runCost = 0, pageCost = 0;
+  int32_t  code = 0;
+
+  pVnode->config.tsdbPageSize = BENCH_PAGE_SIZE;
+  pTsdb->pVnode = pVnode;
+  for (int64_t i = 0; i < size; ++i) {
+    pData[i] = (uint8_t)taosRandR(&seed);
+  }
+
+  code = writeFile(pTsdb, pData, size);
+  if (code == 0) code = loadBlocks(pTsdb, pData, pBuf, false, &runCost);
+  if (code == 0) code = loadBlocks(pTsdb, pData, pBuf, true, &pageCost);
+
+  if (code == 0) {
+    double mb = (double)BENCH_BLOCK_SIZE * (BENCH_BLOCKS - 1);
+    printf("%d blocks of %d bytes, page size %d: page run %" PRId64 "us (%.1f MB/s), page by page %" PRId64
+           "us (%.1f MB/s)\n",
+           BENCH_BLOCKS - 1, BENCH_BLOCK_SIZE, BENCH_PAGE_SIZE, runCost, mb / runCost, pageCost, mb / pageCost);
+  } else {
+    printf("failed to load blocks since %s\n", tstrerror(code));
+  }
+
+  taosRemoveFile(fileName);
+  taosMemoryFree(pBuf);
+  taosMemoryFree(pData);
+  taosMemoryFree(pTsdb);
+  taosMemoryFree(pVnode);
+  return code == 0 ? 0 : 1;
+}
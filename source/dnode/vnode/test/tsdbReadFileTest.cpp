@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "tsdbDef.h"
+
+namespace {
+
+const char   *TEST_FILE = "/tmp/tsdbReadFileTest.data";
+const int32_t TEST_PAGE_SIZE = 4096;
+const int32_t TEST_PAGES = 150;  // more than two runs of TSDB_READ_PAGE_RUN pages
+
+class TsdbReadFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pVnode->config.tsdbPageSize = TEST_PAGE_SIZE;
+    pTsdb->pVnode = pVnode;
+
+    // the last page is not full
+    szPgCont = PAGE_CONTENT_SIZE(TEST_PAGE_SIZE);
+    data.resize((int64_t)szPgCont * (TEST_PAGES - 1) + szPgCont / 3);
+    uint32_t seed = 100;
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = (uint8_t)taosRandR(&seed);
+    }
+
+    STsdbFD *pFD = NULL;
+    ASSERT_EQ(tsdbOpenFile(TEST_FILE, pTsdb, TD_FILE_READ | TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC, &pFD), 0);
+    ASSERT_EQ(tsdbWriteFile(pFD, 0, data.data(), data.size()), 0);
+    ASSERT_EQ(tsdbFsyncFile(pFD), 0);
+    tsdbCloseFile(&pFD);
+  }
+
+  void TearDown() override {
+    taosRemoveFile(TEST_FILE);
+    taosMemoryFree(pTsdb);
+    taosMemoryFree(pVnode);
+  }
+
+  // read [offset, offset + size) with calls of no more than the content of one page, which never make a page run
+  int32_t readByPage(int64_t offset, uint8_t *pBuf, int64_t size) {
+    STsdbFD *pFD = NULL;
+    int32_t  code = tsdbOpenFile(TEST_FILE, pTsdb, TD_FILE_READ, &pFD);
+    for (int64_t n = 0; code == 0 && n < size;) {
+      int64_t nRead = TMIN(szPgCont - (offset + n) % szPgCont, size - n);
+      code = tsdbReadFile(pFD, offset + n, pBuf + n, nRead, 0);
+      n += nRead;
+    }
+    tsdbCloseFile(&pFD);
+    return code;
+  }
+
+  // flip a byte of the file at the file offset
+  void corruptFile(int64_t fOffset) {
+    TdFilePtr pFile = taosOpenFile(TEST_FILE, TD_FILE_READ | TD_FILE_WRITE);
+    ASSERT_NE(pFile, nullptr);
+    uint8_t c = 0;
+    ASSERT_EQ(taosLSeekFile(pFile, fOffset, SEEK_SET), fOffset);
+    ASSERT_EQ(taosReadFile(pFile, &c, 1), 1);
+    c ^= 0x5a;
+    ASSERT_EQ(taosLSeekFile(pFile, fOffset, SEEK_SET), fOffset);
+    ASSERT_EQ(taosWriteFile(pFile, &c, 1), 1);
+    taosCloseFile(&pFile);
+  }
+
+  SVnode              *pVnode = NULL;
+  STsdb               *pTsdb = NULL;
+  int32_t              szPgCont = 0;
+  std::vector<uint8_t> data;
+};
+
+TEST_F(TsdbReadFileTest, sameAsByPage) {
+  STsdbFD *pFD = NULL;
+  ASSERT_EQ(tsdbOpenFile(TEST_FILE, pTsdb, TD_FILE_READ, &pFD), 0);
+
+  // reads at page boundaries and inside pages, of less than a page, of whole pages, of more than one run, and up to
+  // the end of the content
+  int64_t size = data.size();
+  int64_t offsets[] = {0, 1, szPgCont - 1, szPgCont, 2 * szPgCont, 7 * szPgCont + 13, 64 * szPgCont, 100 * szPgCont};
+  int64_t sizes[] = {1, szPgCont - 1, szPgCont, szPgCont + 1, 3 * szPgCont, 64 * szPgCont, 64 * szPgCont + 5,
+                     130 * szPgCont};
+
+  std::vector<uint8_t> buf(size), expect(size);
+  for (int64_t offset : offsets) {
+    for (int64_t sz : sizes) {
+      sz = TMIN(sz, size - offset);
+      memset(buf.data(), 0, sz);
+      ASSERT_EQ(tsdbReadFile(pFD, offset, buf.data(), sz, 0), 0) << "offset:" << offset << " size:" << sz;
+      ASSERT_EQ(readByPage(offset, expect.data(), sz), 0);
+      ASSERT_EQ(memcmp(expect.data(), data.data() + offset, sz), 0);
+      ASSERT_EQ(memcmp(buf.data(), expect.data(), sz), 0) << "offset:" << offset << " size:" << sz;
+    }
+  }
+
+  tsdbCloseFile(&pFD);
+}
+
+TEST_F(TsdbReadFileTest, partialLastPageCached) {
+  STsdbFD *pFD = NULL;
+  ASSERT_EQ(tsdbOpenFile(TEST_FILE, pTsdb, TD_FILE_READ, &pFD), 0);
+
+  // 4 pages and a part of the 5th page from page 3, the 7th page of the file is read into the cached page
+  int64_t              offset = 2 * szPgCont;
+  int64_t              size = 4 * szPgCont + 100;
+  std::vector<uint8_t> buf(size);
+  ASSERT_EQ(tsdbReadFile(pFD, offset, buf.data(), size, 0), 0);
+  ASSERT_EQ(memcmp(buf.data(), data.data() + offset, size), 0);
+  ASSERT_EQ(pFD->pgno, 7);
+  ASSERT_EQ(memcmp(pFD->pBuf, data.data() + 6 * szPgCont, szPgCont), 0);
+  ASSERT_TRUE(taosCheckChecksumWhole(pFD->pBuf, TEST_PAGE_SIZE));
+
+  // the rest of the page comes from the cached page
+  ASSERT_EQ(tsdbReadFile(pFD, offset + size, buf.data(), szPgCont - 100, 0), 0);
+  ASSERT_EQ(memcmp(buf.data(), data.data() + offset + size, szPgCont - 100), 0);
+
+  // a read of whole pages keeps the cached page
+  ASSERT_EQ(tsdbReadFile(pFD, 0, buf.data(), 3 * szPgCont, 0), 0);
+  ASSERT_EQ(memcmp(buf.data(), data.data(), 3 * szPgCont), 0);
+  ASSERT_EQ(pFD->pgno, 7);
+
+  tsdbCloseFile(&pFD);
+}
+
+TEST_F(TsdbReadFileTest, runCutAtCachedPage) {
+  STsdbFD *pFD = NULL;
+  ASSERT_EQ(tsdbOpenFile(TEST_FILE, pTsdb, TD_FILE_READ | TD_FILE_WRITE, &pFD), 0);
+
+  // the write stays in the cached page 11 and is not on disk yet
+  std::vector<uint8_t> update(200, 0xa5);
+  int64_t              updateOffset = 10 * szPgCont + 50;
+  ASSERT_EQ(tsdbWriteFile(pFD, updateOffset, update.data(), update.size()), 0);
+  ASSERT_EQ(pFD->pgno, 11);
+  memcpy(data.data() + updateOffset, update.data(), update.size());
+
+  // runs from page 1 and page 5 stop before page 11 and the rest is read after it
+  int64_t              size = 30 * szPgCont;
+  std::vector<uint8_t> buf(size);
+  for (int64_t offset : {(int64_t)0, 4 * (int64_t)szPgCont}) {
+    ASSERT_EQ(tsdbReadFile(pFD, offset, buf.data(), size, 0), 0);
+    ASSERT_EQ(memcmp(buf.data(), data.data() + offset, size), 0) << "offset:" << offset;
+    ASSERT_EQ(pFD->pgno, 11);
+  }
+
+  ASSERT_EQ(tsdbFsyncFile(pFD), 0);
+  tsdbCloseFile(&pFD);
+
+  // and the page on disk is the one written
+  ASSERT_EQ(readByPage(0, buf.data(), size), 0);
+  ASSERT_EQ(memcmp(buf.data(), data.data(), size), 0);
+}
+
+TEST_F(TsdbReadFileTest, shortReadAtEnd) {
+  STsdbFD *pFD = NULL;
+  ASSERT_EQ(tsdbOpenFile(TEST_FILE, pTsdb, TD_FILE_READ, &pFD), 0);
+
+  // the run goes beyond the last page of the file
+  int64_t              offset = (TEST_PAGES - 3) * (int64_t)szPgCont;
+  int64_t              size = 5 * szPgCont;
+  std::vector<uint8_t> buf(size);
+  ASSERT_EQ(tsdbReadFile(pFD, offset, buf.data(), size, 0), TSDB_CODE_FILE_CORRUPTED);
+  ASSERT_EQ(pFD->pgno, 0);
+
+  // also when the page beyond it is partly read and the cached page before the read is a valid one
+  ASSERT_EQ(tsdbReadFile(pFD, 4 * szPgCont, buf.data(), szPgCont + 10, 0), 0);
+  ASSERT_EQ(pFD->pgno, 6);
+  ASSERT_EQ(tsdbReadFile(pFD, offset, buf.data(), 3 * szPgCont + 10, 0), TSDB_CODE_FILE_CORRUPTED);
+  ASSERT_EQ(pFD->pgno, 0);
+
+  // and the run up to the end of the content is read
+  size = data.size() - offset;
+  ASSERT_EQ(tsdbReadFile(pFD, offset, buf.data(), size, 0), 0);
+  ASSERT_EQ(memcmp(buf.data(), data.data() + offset, size), 0);
+  ASSERT_EQ(pFD->pgno, TEST_PAGES);
+
+  tsdbCloseFile(&pFD);
+}
+
+TEST_F(TsdbReadFileTest, corruptedTrailer) {
+  // the trailers of page 20, a whole page of the run, and of page 40, the last page of the run which is partly read
+  corruptFile(20 * (int64_t)TEST_PAGE_SIZE - 1);
+  corruptFile(40 * (int64_t)TEST_PAGE_SIZE - 2);
+
+  STsdbFD *pFD = NULL;
+  ASSERT_EQ(tsdbOpenFile(TEST_FILE, pTsdb, TD_FILE_READ, &pFD), 0);
+
+  std::vector<uint8_t> buf(64 * szPgCont);
+  ASSERT_EQ(tsdbReadFile(pFD, 0, buf.data(), 30 * szPgCont, 0), TSDB_CODE_FILE_CORRUPTED);
+
+  // the cached page is dropped when the corrupted page is read into it
+  ASSERT_EQ(tsdbReadFile(pFD, 4 * szPgCont, buf.data(), szPgCont + 10, 0), 0);
+  ASSERT_EQ(pFD->pgno, 6);
+  ASSERT_EQ(tsdbReadFile(pFD, 30 * szPgCont, buf.data(), 9 * szPgCont + 10, 0), TSDB_CODE_FILE_CORRUPTED);
+  ASSERT_EQ(pFD->pgno, 0);
+  ASSERT_EQ(tsdbReadFile(pFD, 5 * szPgCont, buf.data(), szPgCont, 0), 0);
+  ASSERT_EQ(memcmp(buf.data(), data.data() + 5 * szPgCont, szPgCont), 0);
+
+  // the same as the reads page by page
+  ASSERT_EQ(readByPage(0, buf.data(), 30 * szPgCont), TSDB_CODE_FILE_CORRUPTED);
+  ASSERT_EQ(readByPage(30 * szPgCont, buf.data(), 9 * szPgCont + 10), TSDB_CODE_FILE_CORRUPTED);
+
+  // and the pages around them are read
+  ASSERT_EQ(tsdbReadFile(pFD, 20 * szPgCont, buf.data(), 19 * szPgCont, 0), 0);
+  ASSERT_EQ(memcmp(buf.data(), data.data() + 20 * szPgCont, 19 * szPgCont), 0);
+
+  tsdbCloseFile(&pFD);
+}
+
+}  // namespace
+
+#pragma GCC diagnostic pop
@@ -73,6 +73,7 @@ extern "C" {
 #define EXPLAIN_COUNT_INFO_FORMAT "Window Count Info"
 #define EXPLAIN_COUNT_NUM_FORMAT "Window Count=%" PRId64
 #define EXPLAIN_COUNT_SLIDING_FORMAT "Window Sliding=%" PRId64
+#define EXPLAIN_HJOIN_SPILL_FORMAT "Spill: partitions=%d rows=%" PRId64
 
 #define EXPLAIN_PLANNING_TIME_FORMAT "Planning Time: %.3f ms"
 #define EXPLAIN_EXEC_TIME_FORMAT "Execution Time: %.3f ms"
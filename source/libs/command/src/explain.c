@@ -1591,6 +1591,22 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
       EXPLAIN_ROW_END();
       QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level));
 
+      if (EXPLAIN_MODE_ANALYZE == ctx->mode && pResNode->pExecInfo) {
+        SExplainExecInfo  *execInfo = taosArrayGet(pResNode->pExecInfo, 0);
+        SHashJoinExecInfo *pExecInfo = (SHashJoinExecInfo *)execInfo->verboseInfo;
+        if (pExecInfo != NULL && pExecInfo->spillPartitions > 0) {
+          EXPLAIN_ROW_NEW(level + 1, EXPLAIN_HJOIN_SPILL_FORMAT, pExecInfo->spillPartitions, pExecInfo->spillRows);
+          if (pExecInfo->spillBytes > 1024 * 1024) {
+            EXPLAIN_ROW_APPEND("  Buffers:%.2f Mb", pExecInfo->spillBytes / (1024 * 1024.0));
+          } else {
+            EXPLAIN_ROW_APPEND("  Buffers:%.2f Kb", pExecInfo->spillBytes / (1024.0));
+          }
+          EXPLAIN_ROW_APPEND("  write:%" PRId64 " b  read:%" PRId64 " b", pExecInfo->writeBytes, pExecInfo->readBytes);
+          EXPLAIN_ROW_END();
+          QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level));
+        }
+      }
+
       if (verbose) {
         EXPLAIN_ROW_NEW(level + 1, EXPLAIN_OUTPUT_FORMAT);
         EXPLAIN_ROW_APPEND(EXPLAIN_COLUMNS_FORMAT,
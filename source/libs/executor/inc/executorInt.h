@@ -94,6 +94,21 @@ typedef struct {
   int32_t bytes;
 } SGroupKeys, SStateKeys;
 
+// group keys of a whole data block, resolved to block local group slots in one pass
+typedef struct SGroupKeyBatch {
+  char*      pKeys;        // one key per row, same layout as the per-row group key, fixed stride
+  int32_t*   pKeyLen;      // actual key length of each row
+  int32_t*   pSlot;        // group slot of each row
+  int32_t*   pSlotRow;     // first row of each slot
+  int32_t*   pSlotOffset;  // start position of each slot in pSelect, numOfSlots + 1 items
+  int32_t*   pSelect;      // row index of the block, ordered by slot and then by row
+  int32_t    numOfSlots;
+  int32_t    numOfRuns;    // number of runs of adjacent rows sharing the same key
+  int32_t    keyStride;
+  int32_t    capacity;
+  SSHashObj* pSlotMap;     // key -> slot
+} SGroupKeyBatch;
+
 typedef struct {
   char*           tablename;
   char*           dbname;
@@ -810,6 +825,10 @@ bool applyLimitOffset(SLimitInfo* pLimitInfo, SSDataBlock* pBlock, SExecTaskInfo
 void applyAggFunctionOnPartialTuples(SExecTaskInfo* taskInfo, SqlFunctionCtx* pCtx, SColumnInfoData* pTimeWindowData,
                                      int32_t offset, int32_t forwardStep, int32_t numOfTotal, int32_t numOfOutput);
 
+int32_t initGroupKeyBatch(SGroupKeyBatch* pBatch, int32_t keyLen);
+void    cleanupGroupKeyBatch(SGroupKeyBatch* pBatch);
+int32_t buildGroupKeyBatch(SGroupKeyBatch* pBatch, SArray* pGroupCols, SSDataBlock* pBlock);
+
 int32_t extractDataBlockFromFetchRsp(SSDataBlock* pRes, char* pData, SArray* pColList, char** pNextStart);
 void    updateLoadRemoteInfo(SLoadRemoteDataInfo* pInfo, int64_t numOfRows, int32_t dataLen, int64_t startTs,
                              struct SOperatorInfo* pOperator);
@@ -20,6 +20,9 @@ extern "C" {
 #endif
 
 #define HASH_JOIN_DEFAULT_PAGE_SIZE 10485760
+#define HASH_JOIN_SPILL_PAGE_SIZE    65536
+#define HASH_JOIN_SPILL_MIN_PART_NUM 8
+#define HASH_JOIN_SPILL_MAX_PART_NUM 256
 
 #pragma pack(push, 1) 
 typedef struct SBufRowInfo {
@@ -83,6 +86,26 @@ typedef struct SHJoinTableInfo {
   bool           valColExist;
 } SHJoinTableInfo;
 
+typedef struct SHJoinPartition {
+  SArray*      pBuildPages;  // SArray<int32_t>, spill buffer pages of the build rows
+  SArray*      pProbePages;  // SArray<int32_t>, spill buffer pages of the probe rows
+  SSDataBlock* pBuildBlk;    // build rows not flushed to the spill buffer yet
+  SSDataBlock* pProbeBlk;    // probe rows not flushed to the spill buffer yet
+} SHJoinPartition;
+
+typedef struct SHJoinSpillCtx {
+  SDiskbasedBuf*   pBuf;
+  int32_t          pageSize;
+  int32_t          partNum;
+  SHJoinPartition* pParts;
+  SSDataBlock*     pBuildBlk;    // build block restored from the spill buffer
+  SSDataBlock*     pProbeBlk;    // probe block restored from the spill buffer
+  int32_t          buildBlkCap;  // max build rows in one page
+  int32_t          probeBlkCap;  // max probe rows in one page
+  int32_t          partIdx;      // partition being joined
+  int32_t          pageIdx;      // next probe page of the partition being joined
+} SHJoinSpillCtx;
+
 typedef struct SHJoinExecInfo {
   int64_t buildBlkNum;
   int64_t buildBlkRows;
@@ -90,6 +113,9 @@ typedef struct SHJoinExecInfo {
   int64_t probeBlkRows;
   int64_t resRows;
   int64_t expectRows;
+  int64_t buildMemSize;
+  int64_t spillRows;
+  int64_t spillBytes;
 } SHJoinExecInfo;
 
 
@@ -107,6 +133,9 @@ typedef struct SHJoinOperatorInfo {
   bool             keyHashBuilt;
   SHJoinCtx        ctx;
   SHJoinExecInfo   execInfo;
+  int64_t          memLimit;  // max memory of the build side before both sides are spilled
+  bool             spilled;
+  SHJoinSpillCtx   spill;
 } SHJoinOperatorInfo;
 
 #ifdef __cplusplus
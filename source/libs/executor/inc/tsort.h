@@ -47,6 +47,8 @@ typedef struct SSortSource {
   };
   int64_t fetchUs;
   int64_t fetchNum;
+  char*   pNormKeys;    // normalized sort keys of the rows in src.pBlock
+  int32_t normKeyRows;  // capacity of pNormKeys in rows
 } SSortSource;
 
 typedef struct SMsortComparParam {
@@ -60,6 +62,10 @@ typedef struct SMsortComparParam {
   int32_t tsSlotId;
   int32_t order;
   __compar_fn_t cmpFn;
+
+  // length of the normalized sort key of each row, 0 if the sources are compared column by column
+  int32_t normKeyLen;
+  bool    normKeyComplete;  // all the sort columns are encoded in the normalized key
 } SMsortComparParam;
 
 typedef struct SSortHandle  SSortHandle;
@@ -179,6 +185,37 @@ SSDataBlock* tsortGetSortedDataBlock(const SSortHandle* pSortHandle);
  */
 SSortExecInfo tsortGetSortExecInfo(SSortHandle* pHandle);
 
+/**
+ * Get the length of the normalized key of the sort columns. The normalized keys of two rows are compared with memcmp,
+ * and give the same order as comparing the sort columns one by one, except that the rows with the same normalized
+ * key still need to be compared by the columns if the key is not complete.
+ * @param pSortInfo
+ * @param pBlock
+ * @param complete set to true if all the sort columns are encoded in the normalized key
+ * @return 0 if the first sort column can not be normalized
+ */
+int32_t tsortGetNormKeyLen(const SArray* pSortInfo, const SSDataBlock* pBlock, bool* complete);
+
+/**
+ * Build the normalized keys of all rows in the block, the key of row i starts at pKeys + i * stride.
+ * @param pSortInfo
+ * @param pBlock
+ * @param keyLen the length returned by tsortGetNormKeyLen
+ * @param stride
+ * @param pKeys
+ */
+void tsortBuildNormKeys(const SArray* pSortInfo, const SSDataBlock* pBlock, int32_t keyLen, int32_t stride,
+                        char* pKeys);
+
+/**
+ * Sort the rows of the block by radix sort on the normalized keys, or by blockDataSort if the normalized key is not
+ * applicable.
+ * @param pSortInfo
+ * @param pBlock
+ * @return
+ */
+int32_t tsortSortBlock(SArray* pSortInfo, SSDataBlock* pBlock);
+
 /**
  * get proper sort buffer pages according to the row size
  * @param rowSize
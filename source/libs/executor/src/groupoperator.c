@@ -28,6 +28,9 @@
 #include "thash.h"
 #include "ttypes.h"
 
+#define GROUPBY_BATCH_MIN_ROWS    64  // blocks smaller than this always go through the per-row path
+#define GROUPBY_BATCH_MAX_RUN_LEN 4   // average run length of identical keys below which the batch path is used
+
 typedef struct SGroupbyOperatorInfo {
   SOptrBasicInfo binfo;
   SAggSupporter  aggSup;
@@ -38,6 +41,10 @@ typedef struct SGroupbyOperatorInfo {
   int32_t        groupKeyLen;    // total group by column width
   SGroupResInfo  groupResInfo;
   SExprSupp      scalarSup;
+  SGroupKeyBatch keyBatch;       // group keys of the whole input block, used by the batch path
+  SSDataBlock*   pGatherBlock;   // rows of the input block gathered by group slot
+  int32_t        lastRows;       // rows of the previous input block
+  int32_t        lastRuns;       // runs of identical group keys in the previous input block
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -87,6 +94,8 @@ static void destroyGroupOperatorInfo(void* param) {
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   cleanupAggSup(&pInfo->aggSup);
+  cleanupGroupKeyBatch(&pInfo->keyBatch);
+  blockDataDestroy(pInfo->pGatherBlock);
   taosMemoryFreeClear(param);
 }
 
@@ -287,6 +296,7 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   terrno = TSDB_CODE_SUCCESS;
 
   int32_t num = 0;
+  int32_t numOfRuns = 0;
   for (int32_t j = 0; j < pBlock->info.rows; ++j) {
     // Compare with the previous row of this column, and do not set the output buffer again if they are identical.
     if (!pInfo->isInit) {
@@ -330,6 +340,7 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
     doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
     recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
     num = 1;
+    numOfRuns += 1;
   }
 
   if (num > 0) {
@@ -344,7 +355,314 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
     applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows,
                                     pOperator->exprSupp.numOfExprs);
     doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
+    numOfRuns += 1;
+  }
+
+  pInfo->lastRows = pBlock->info.rows;
+  pInfo->lastRuns = numOfRuns;
+}
+
+int32_t initGroupKeyBatch(SGroupKeyBatch* pBatch, int32_t keyLen) {
+  memset(pBatch, 0, sizeof(SGroupKeyBatch));
+  pBatch->keyStride = keyLen;
+  pBatch->pSlotMap = tSimpleHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  if (pBatch->pSlotMap == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+void cleanupGroupKeyBatch(SGroupKeyBatch* pBatch) {
+  taosMemoryFreeClear(pBatch->pKeys);
+  taosMemoryFreeClear(pBatch->pKeyLen);
+  taosMemoryFreeClear(pBatch->pSlot);
+  taosMemoryFreeClear(pBatch->pSlotRow);
+  taosMemoryFreeClear(pBatch->pSlotOffset);
+  taosMemoryFreeClear(pBatch->pSelect);
+  tSimpleHashCleanup(pBatch->pSlotMap);
+  pBatch->pSlotMap = NULL;
+  pBatch->capacity = 0;
+}
+
+static int32_t ensureGroupKeyBatchCapacity(SGroupKeyBatch* pBatch, int32_t rows) {
+  if (pBatch->capacity >= rows) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  char* pKeys = taosMemoryRealloc(pBatch->pKeys, (int64_t)rows * pBatch->keyStride);
+  if (pKeys == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pBatch->pKeys = pKeys;
+
+  int32_t** pArrays[] = {&pBatch->pKeyLen, &pBatch->pSlot, &pBatch->pSlotRow, &pBatch->pSlotOffset, &pBatch->pSelect};
+  for (int32_t i = 0; i < tListLen(pArrays); ++i) {
+    int32_t* p = taosMemoryRealloc(*pArrays[i], sizeof(int32_t) * (rows + 1));
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    *pArrays[i] = p;
+  }
+
+  pBatch->capacity = rows;
+  return TSDB_CODE_SUCCESS;
+}
+
+// Fixed length column without null value, which is the common case of the group by key.
+static void appendFixedGroupKeyCol(SGroupKeyBatch* pBatch, int32_t index, const SColumnInfoData* pColData,
+                                   int32_t bytes, int32_t rows) {
+  const char* pData = pColData->pData;
+  int32_t     width = pColData->info.bytes;
+
+#define APPEND_FIXED_KEY(_n)                                             \
+  for (int32_t r = 0; r < rows; ++r) {                                   \
+    char* pKey = pBatch->pKeys + (int64_t)r * pBatch->keyStride;         \
+    pKey[index] = 0;                                                     \
+    memcpy(pKey + pBatch->pKeyLen[r], pData + (int64_t)r * width, (_n)); \
+    pBatch->pKeyLen[r] += (_n);                                          \
+  }
+
+  switch (bytes) {
+    case 1:
+      APPEND_FIXED_KEY(1);
+      break;
+    case 2:
+      APPEND_FIXED_KEY(2);
+      break;
+    case 4:
+      APPEND_FIXED_KEY(4);
+      break;
+    case 8:
+      APPEND_FIXED_KEY(8);
+      break;
+    default:
+      APPEND_FIXED_KEY(bytes);
+      break;
+  }
+
+#undef APPEND_FIXED_KEY
+}
+
+static int32_t appendGroupKeyCol(SGroupKeyBatch* pBatch, int32_t index, const SColumn* pCol,
+                                 const SColumnInfoData* pColData, int32_t rows) {
+  for (int32_t r = 0; r < rows; ++r) {
+    char* pKey = pBatch->pKeys + (int64_t)r * pBatch->keyStride;
+    if (colDataIsNull_s(pColData, r)) {
+      pKey[index] = 1;
+      continue;
+    }
+
+    pKey[index] = 0;
+
+    char*   val = colDataGetData(pColData, r);
+    int32_t dataLen = 0;
+    if (pCol->type == TSDB_DATA_TYPE_JSON) {
+      if (tTagIsJson(val)) {
+        return TSDB_CODE_QRY_JSON_IN_GROUP_ERROR;
+      }
+      dataLen = getJsonValueLen(val);
+    } else if (IS_VAR_DATA_TYPE(pCol->type)) {
+      dataLen = varDataTLen(val);
+      ASSERT(dataLen <= pCol->bytes);
+    } else {
+      dataLen = pCol->bytes;
+    }
+
+    memcpy(pKey + pBatch->pKeyLen[r], val, dataLen);
+    pBatch->pKeyLen[r] += dataLen;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * Build the group keys of all rows in the block column by column, with the same layout as buildGroupKeys, and resolve
+ * each row into a block local group slot. Rows are then ordered by slot in pSelect, so that the rows of one group can
+ * be aggregated in a single call.
+ */
+int32_t buildGroupKeyBatch(SGroupKeyBatch* pBatch, SArray* pGroupCols, SSDataBlock* pBlock) {
+  int32_t rows = pBlock->info.rows;
+  int32_t numOfGroupCols = taosArrayGetSize(pGroupCols);
+
+  int32_t code = ensureGroupKeyBatchCapacity(pBatch, rows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // the null flags of all group columns come first, followed by the data of the non-null columns
+  for (int32_t r = 0; r < rows; ++r) {
+    pBatch->pKeyLen[r] = sizeof(int8_t) * numOfGroupCols;
+  }
+
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pGroupCols, i);
+    SColumnInfoData* pColData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+
+    if (!IS_VAR_DATA_TYPE(pCol->type) && !pColData->hasNull) {
+      appendFixedGroupKeyCol(pBatch, i, pColData, pCol->bytes, rows);
+      continue;
+    }
+
+    code = appendGroupKeyCol(pBatch, i, pCol, pColData, rows);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  tSimpleHashClear(pBatch->pSlotMap);
+  pBatch->numOfSlots = 0;
+  pBatch->numOfRuns = 0;
+
+  for (int32_t r = 0; r < rows; ++r) {
+    char*   pKey = pBatch->pKeys + (int64_t)r * pBatch->keyStride;
+    int32_t keyLen = pBatch->pKeyLen[r];
+
+    // adjacent rows with the same key share the slot without probing the hash table
+    if (r > 0 && keyLen == pBatch->pKeyLen[r - 1] && memcmp(pKey, pKey - pBatch->keyStride, keyLen) == 0) {
+      pBatch->pSlot[r] = pBatch->pSlot[r - 1];
+      continue;
+    }
+
+    pBatch->numOfRuns += 1;
+
+    int32_t* pSlot = tSimpleHashGet(pBatch->pSlotMap, pKey, keyLen);
+    if (pSlot != NULL) {
+      pBatch->pSlot[r] = *pSlot;
+      continue;
+    }
+
+    int32_t slot = pBatch->numOfSlots++;
+    code = tSimpleHashPut(pBatch->pSlotMap, pKey, keyLen, &slot, sizeof(int32_t));
+    if (code != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pBatch->pSlotRow[slot] = r;
+    pBatch->pSlot[r] = slot;
+  }
+
+  // counting sort of the rows by slot, the original order of rows within one slot is kept
+  int32_t* pOffset = pBatch->pSlotOffset;
+  memset(pOffset, 0, sizeof(int32_t) * (pBatch->numOfSlots + 1));
+  for (int32_t r = 0; r < rows; ++r) {
+    pOffset[pBatch->pSlot[r]] += 1;
+  }
+
+  for (int32_t i = 1; i < pBatch->numOfSlots; ++i) {
+    pOffset[i] += pOffset[i - 1];
+  }
+
+  for (int32_t r = rows - 1; r >= 0; --r) {
+    pBatch->pSelect[--pOffset[pBatch->pSlot[r]]] = r;
+  }
+
+  pOffset[pBatch->numOfSlots] = rows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t gatherGroupRows(SSDataBlock* pDst, const SSDataBlock* pSrc, const int32_t* pSelect) {
+  int32_t rows = pSrc->info.rows;
+
+  blockDataCleanup(pDst);
+  int32_t code = blockDataEnsureCapacity(pDst, rows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  size_t numOfCols = taosArrayGetSize(pSrc->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, i);
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+
+    if (!IS_VAR_DATA_TYPE(pSrcCol->info.type) && !pSrcCol->hasNull) {
+      int32_t bytes = pSrcCol->info.bytes;
+      for (int32_t j = 0; j < rows; ++j) {
+        memcpy(pDstCol->pData + (int64_t)j * bytes, pSrcCol->pData + (int64_t)pSelect[j] * bytes, bytes);
+      }
+      continue;
+    }
+
+    for (int32_t j = 0; j < rows; ++j) {
+      if (colDataIsNull_s(pSrcCol, pSelect[j])) {
+        colDataSetNULL(pDstCol, j);
+        continue;
+      }
+
+      code = colDataSetVal(pDstCol, j, colDataGetData(pSrcCol, pSelect[j]), false);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
   }
+
+  pDst->info.rows = rows;
+  pDst->info.id = pSrc->info.id;
+  pDst->info.window = pSrc->info.window;
+  pDst->info.scanFlag = pSrc->info.scanFlag;
+  pDst->info.version = pSrc->info.version;
+  pDst->info.dataLoad = pSrc->info.dataLoad;
+  return TSDB_CODE_SUCCESS;
+}
+
+// Use the batch path when the previous block had short runs of identical keys, i.e. the input is not sorted by the
+// group keys, so that each group of a block costs one hash probe and one aggregate call instead of one per run.
+static bool isGroupbyBatchPreferred(SGroupbyOperatorInfo* pInfo, const SSDataBlock* pBlock) {
+  if (pBlock->pBlockAgg != NULL || pBlock->info.rows < GROUPBY_BATCH_MIN_ROWS) {
+    return false;
+  }
+
+  return pInfo->lastRows < (int64_t)pInfo->lastRuns * GROUPBY_BATCH_MAX_RUN_LEN;
+}
+
+static void doHashGroupbyAggBatch(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupKeyBatch*       pBatch = &pInfo->keyBatch;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+
+  int32_t code = buildGroupKeyBatch(pBatch, pInfo->pGroupCols, pBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  if (pInfo->pGatherBlock == NULL ||
+      taosArrayGetSize(pInfo->pGatherBlock->pDataBlock) != taosArrayGetSize(pBlock->pDataBlock)) {
+    blockDataDestroy(pInfo->pGatherBlock);
+    pInfo->pGatherBlock = createOneDataBlock(pBlock, false);
+    if (pInfo->pGatherBlock == NULL) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+    }
+  }
+
+  SSDataBlock* pGather = pInfo->pGatherBlock;
+  code = gatherGroupRows(pGather, pBlock, pBatch->pSelect);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  setInputDataBlock(&pOperator->exprSupp, pGather, pInfo->binfo.inputTsOrder, pGather->info.scanFlag, true);
+
+  int32_t rows = pGather->info.rows;
+  for (int32_t i = 0; i < pBatch->numOfSlots; ++i) {
+    char*   pKey = pBatch->pKeys + (int64_t)pBatch->pSlotRow[i] * pBatch->keyStride;
+    int32_t len = pBatch->pKeyLen[pBatch->pSlotRow[i]];
+    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pKey, len,
+                                          pGather->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+    if (ret != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+    }
+
+    int32_t rowIndex = pBatch->pSlotOffset[i];
+    int32_t num = pBatch->pSlotOffset[i + 1] - rowIndex;
+    applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, rows, pOperator->exprSupp.numOfExprs);
+    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, rows, rowIndex);
+  }
+
+  // the saved keys of the per-row path do not describe the last row of this block any more
+  pInfo->isInit = false;
+  pInfo->lastRows = pBlock->info.rows;
+  pInfo->lastRuns = pBatch->numOfRuns;
 }
 
 static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
@@ -472,7 +790,11 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
       }
     }
 
-    doHashGroupbyAgg(pOperator, pBlock);
+    if (isGroupbyBatchPreferred(pInfo, pBlock)) {
+      doHashGroupbyAggBatch(pOperator, pBlock);
+    } else {
+      doHashGroupbyAgg(pOperator, pBlock);
+    }
   }
 
   pOperator->status = OP_RES_TO_RETURN;
@@ -525,6 +847,11 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode*
     goto _error;
   }
 
+  code = initGroupKeyBatch(&pInfo->keyBatch, pInfo->groupKeyLen);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
   int32_t    num = 0;
   SExprInfo* pExprInfo = createExprInfo(pAggNode->pAggFuncs, pAggNode->pGroupKeys, &num);
   code = initAggSup(&pOperator->exprSupp, &pInfo->aggSup, pExprInfo, num, pInfo->groupKeyLen, pTaskInfo->id.str,
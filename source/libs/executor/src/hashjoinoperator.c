@@ -22,6 +22,7 @@
 #include "querytask.h"
 #include "tcompare.h"
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "thash.h"
 #include "tmsg.h"
 #include "ttypes.h"
@@ -297,6 +298,26 @@ static void destroyHJoinKeyHash(SSHashObj** ppHash) {
   *ppHash = NULL;
 }
 
+static void destroyHJoinSpillCtx(SHJoinSpillCtx* pSpill) {
+  if (pSpill->pParts) {
+    for (int32_t i = 0; i < pSpill->partNum; ++i) {
+      SHJoinPartition* pPart = &pSpill->pParts[i];
+      taosArrayDestroy(pPart->pBuildPages);
+      taosArrayDestroy(pPart->pProbePages);
+      blockDataDestroy(pPart->pBuildBlk);
+      blockDataDestroy(pPart->pProbeBlk);
+    }
+    taosMemoryFreeClear(pSpill->pParts);
+  }
+
+  pSpill->pBuildBlk = blockDataDestroy(pSpill->pBuildBlk);
+  pSpill->pProbeBlk = blockDataDestroy(pSpill->pProbeBlk);
+  if (pSpill->pBuf) {
+    destroyDiskbasedBuf(pSpill->pBuf);
+    pSpill->pBuf = NULL;
+  }
+}
+
 static void destroyHashJoinOperator(void* param) {
   SHJoinOperatorInfo* pJoinOperator = (SHJoinOperatorInfo*)param;
   qError("hashJoin exec info, buildBlk:%" PRId64 ", buildRows:%" PRId64 ", probeBlk:%" PRId64 ", probeRows:%" PRId64 ", resRows:%" PRId64, 
@@ -310,6 +331,7 @@ static void destroyHashJoinOperator(void* param) {
   pJoinOperator->pRes = blockDataDestroy(pJoinOperator->pRes);
   taosMemoryFreeClear(pJoinOperator->pResColMap);
   taosArrayDestroyEx(pJoinOperator->pRowBufs, freeHJoinBufPage);
+  destroyHJoinSpillCtx(&pJoinOperator->spill);
   nodesDestroyNode(pJoinOperator->pCond);
 
   taosMemoryFreeClear(param);
@@ -609,6 +631,9 @@ static FORCE_INLINE int32_t getHJoinValBufSize(SHJoinTableInfo* pTable, int32_t
   int32_t varColNum = taosArrayGetSize(pTable->valVarCols);
   for (int32_t i = 0; i < varColNum; ++i) {
     varColIdx = taosArrayGet(pTable->valVarCols, i);
+    if (-1 == pTable->valCols[*varColIdx].offset[rowIdx]) {
+      continue;
+    }
     char* pData = pTable->valCols[*varColIdx].data + pTable->valCols[*varColIdx].offset[rowIdx];
     bufLen += varDataTLen(pData);
   }
@@ -634,7 +659,8 @@ static int32_t addRowToHashImpl(SHJoinOperatorInfo* pJoin, SGroupData* pGroup, S
     }
   }
 
-  int32_t code = getValBufFromPages(pJoin->pRowBufs, getHJoinValBufSize(pTable, rowIdx), &pTable->valData, pRow);
+  int32_t bufSize = getHJoinValBufSize(pTable, rowIdx);
+  int32_t code = getValBufFromPages(pJoin->pRowBufs, bufSize, &pTable->valData, pRow);
   if (code) {
     taosMemoryFree(pRow);
     return code;
@@ -646,11 +672,13 @@ static int32_t addRowToHashImpl(SHJoinOperatorInfo* pJoin, SGroupData* pGroup, S
       taosMemoryFree(pRow);
       return TSDB_CODE_OUT_OF_MEMORY;
     }
+    pJoin->execInfo.buildMemSize += keyLen + sizeof(SGroupData);
   } else {
     pRow->next = pGroup->rows;
     pGroup->rows = pRow;
   }
 
+  pJoin->execInfo.buildMemSize += sizeof(SBufRowInfo) + bufSize;
   return TSDB_CODE_SUCCESS;
 }
 
@@ -691,6 +719,283 @@ static int32_t addBlockRowsToHash(SSDataBlock* pBlock, SHJoinOperatorInfo* pJoin
   return code;
 }
 
+static int32_t resetHJoinKeyHash(SHJoinOperatorInfo* pJoin) {
+  destroyHJoinKeyHash(&pJoin->pKeyHash);
+  pJoin->pKeyHash = tSimpleHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  if (NULL == pJoin->pKeyHash) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // keep the first row page for the next round
+  while (taosArrayGetSize(pJoin->pRowBufs) > 1) {
+    freeHJoinBufPage(taosArrayPop(pJoin->pRowBufs));
+  }
+  SBufPageInfo* pPage = taosArrayGet(pJoin->pRowBufs, 0);
+  pPage->offset = 0;
+
+  pJoin->execInfo.buildMemSize = 0;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t getHJoinSpillPageSize(SHashJoinPhysiNode* pJoinNode) {
+  int32_t pageSize = HASH_JOIN_SPILL_PAGE_SIZE;
+  SNode*  pNode = NULL;
+  FOREACH(pNode, pJoinNode->node.pChildren) {
+    SDataBlockDescNode* pDesc = ((SPhysiNode*)pNode)->pOutputDataBlockDesc;
+    int32_t size = pDesc->totalRowSize * 4 + blockDataGetSerialMetaSize(LIST_LENGTH(pDesc->pSlots));
+    pageSize = TMAX(pageSize, size);
+  }
+
+  return pageSize;
+}
+
+static int32_t getHJoinSpillPartNum(SHJoinOperatorInfo* pJoin) {
+  // estimate the memory of the whole build side by the rows loaded so far
+  int64_t rows = TMAX(pJoin->execInfo.buildBlkRows, 1);
+  int64_t memSize = pJoin->execInfo.buildMemSize;
+  if (pJoin->pBuild->inputStat.inputRowNum > rows) {
+    memSize = memSize / rows * pJoin->pBuild->inputStat.inputRowNum;
+  }
+
+  int32_t partNum = HASH_JOIN_SPILL_MIN_PART_NUM;
+  while (partNum < HASH_JOIN_SPILL_MAX_PART_NUM && memSize / partNum > pJoin->memLimit / 2) {
+    partNum *= 2;
+  }
+
+  return partNum;
+}
+
+static FORCE_INLINE int32_t getHJoinPartIdx(SHJoinSpillCtx* pSpill, const char* pKey, size_t keyLen) {
+  // the low bits of the hash value locate the slot in the key hash, so the high bits are used for partitions
+  return (MurmurHash3_32(pKey, keyLen) >> 16) % pSpill->partNum;
+}
+
+static int32_t initHJoinSpillCtx(SHJoinOperatorInfo* pJoin, SSDataBlock* pBuildBlk) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+
+  if (!osTempSpaceAvailable()) {
+    qError("hash join spill failed since %s, tempDir:%s", tstrerror(TSDB_CODE_NO_DISKSPACE), tsTempDir);
+    return TSDB_CODE_NO_DISKSPACE;
+  }
+
+  pSpill->pBuildBlk = createOneDataBlock(pBuildBlk, false);
+  if (NULL == pSpill->pBuildBlk) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pSpill->buildBlkCap = blockDataGetCapacityInRow(pSpill->pBuildBlk, pSpill->pageSize,
+                                                  blockDataGetSerialMetaSize(taosArrayGetSize(pBuildBlk->pDataBlock)));
+
+  pSpill->partNum = getHJoinSpillPartNum(pJoin);
+  pSpill->pParts = taosMemoryCalloc(pSpill->partNum, sizeof(SHJoinPartition));
+  if (NULL == pSpill->pParts) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < pSpill->partNum; ++i) {
+    pSpill->pParts[i].pBuildPages = taosArrayInit(4, sizeof(int32_t));
+    pSpill->pParts[i].pProbePages = taosArrayInit(4, sizeof(int32_t));
+    if (NULL == pSpill->pParts[i].pBuildPages || NULL == pSpill->pParts[i].pProbePages) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  int32_t inMemSize = (int32_t)TMIN(TMAX(pJoin->memLimit / 4, pSpill->pageSize * 4), INT32_MAX);
+  int32_t code = createDiskbasedBuf(&pSpill->pBuf, pSpill->pageSize, inMemSize, "hashJoinSpillBuf", tsTempDir);
+  if (code) {
+    return code;
+  }
+  dBufSetPrintInfo(pSpill->pBuf);
+
+  pSpill->partIdx = -1;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t flushHJoinPartBlock(SHJoinOperatorInfo* pJoin, SSDataBlock* pBlock, SArray* pPages) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  if (NULL == pBlock || pBlock->info.rows <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t pageId = -1;
+  void*   pPage = getNewBufPage(pSpill->pBuf, &pageId);
+  if (NULL == pPage) {
+    return terrno;
+  }
+
+  int32_t size = blockDataGetSize(pBlock) + sizeof(int32_t) + taosArrayGetSize(pBlock->pDataBlock) * sizeof(int32_t);
+  ASSERT(size <= getBufPageSize(pSpill->pBuf));
+
+  blockDataToBuf(pPage, pBlock);
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pSpill->pBuf, pPage);
+
+  if (NULL == taosArrayPush(pPages, &pageId)) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pJoin->execInfo.spillRows += pBlock->info.rows;
+  pJoin->execInfo.spillBytes += size;
+  blockDataCleanup(pBlock);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t flushHJoinPartitions(SHJoinOperatorInfo* pJoin, bool build) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  for (int32_t i = 0; i < pSpill->partNum; ++i) {
+    SHJoinPartition* pPart = &pSpill->pParts[i];
+    SSDataBlock**    ppBlock = build ? &pPart->pBuildBlk : &pPart->pProbeBlk;
+    int32_t          code = flushHJoinPartBlock(pJoin, *ppBlock, build ? pPart->pBuildPages : pPart->pProbePages);
+    if (code) {
+      return code;
+    }
+
+    *ppBlock = blockDataDestroy(*ppBlock);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t getHJoinPartBlock(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, bool build, SSDataBlock** ppBlock) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  SSDataBlock**   ppPartBlk = build ? &pPart->pBuildBlk : &pPart->pProbeBlk;
+  int32_t         capacity = build ? pSpill->buildBlkCap : pSpill->probeBlkCap;
+  int32_t         code = TSDB_CODE_SUCCESS;
+
+  if (NULL == *ppPartBlk) {
+    *ppPartBlk = createOneDataBlock(build ? pSpill->pBuildBlk : pSpill->pProbeBlk, false);
+    if (NULL == *ppPartBlk) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    code = blockDataEnsureCapacity(*ppPartBlk, capacity);
+  } else if ((*ppPartBlk)->info.rows >= capacity) {
+    code = flushHJoinPartBlock(pJoin, *ppPartBlk, build ? pPart->pBuildPages : pPart->pProbePages);
+  }
+
+  *ppBlock = *ppPartBlk;
+  return code;
+}
+
+static int32_t appendHJoinPartRow(SSDataBlock* pDst, SSDataBlock* pSrc, int32_t rowIdx) {
+  int32_t r = pDst->info.rows;
+  size_t  numOfCols = taosArrayGetSize(pDst->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, i);
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+    bool             isNull = colDataIsNull_s(pSrcCol, rowIdx);
+    int32_t          code = colDataSetVal(pDstCol, r, isNull ? NULL : colDataGetData(pSrcCol, rowIdx), isNull);
+    if (code) {
+      return code;
+    }
+  }
+
+  pDst->info.rows++;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t partitionHJoinBlock(SHJoinOperatorInfo* pJoin, SHJoinTableInfo* pTable, SSDataBlock* pBlock) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  bool            build = (pTable == pJoin->pBuild);
+  int32_t         code = setKeyColsData(pBlock, pTable);
+  if (code) {
+    return code;
+  }
+
+  size_t       keyLen = 0;
+  SSDataBlock* pPartBlk = NULL;
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    copyKeyColsDataToBuf(pTable, i, &keyLen);
+    SHJoinPartition* pPart = &pSpill->pParts[getHJoinPartIdx(pSpill, pTable->keyData, keyLen)];
+
+    code = getHJoinPartBlock(pJoin, pPart, build, &pPartBlk);
+    if (code) {
+      return code;
+    }
+    code = appendHJoinPartRow(pPartBlk, pBlock, i);
+    if (code) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// restore a build row in the key hash to the build block layout, columns not used by the join are set to NULL
+static int32_t restoreHJoinBuildRow(SHJoinOperatorInfo* pJoin, SSDataBlock* pDst, const char* pKey, SBufRowInfo* pRow) {
+  SHJoinTableInfo* pBuild = pJoin->pBuild;
+  int32_t          r = pDst->info.rows;
+  int32_t          code = TSDB_CODE_SUCCESS;
+
+  size_t numOfCols = taosArrayGetSize(pDst->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    colDataSetNULL(taosArrayGet(pDst->pDataBlock, i), r);
+  }
+
+  const char* pData = pKey;
+  for (int32_t i = 0; i < pBuild->keyNum; ++i) {
+    code = colDataSetVal(taosArrayGet(pDst->pDataBlock, pBuild->keyCols[i].srcSlot), r, pData, false);
+    if (code) {
+      return code;
+    }
+    pData += pBuild->keyCols[i].vardata ? varDataTLen(pData) : pBuild->keyCols[i].bytes;
+  }
+
+  if (pBuild->valColExist) {
+    char* pBitMap = retrieveColDataFromRowBufs(pJoin->pRowBufs, pRow);
+    pData = pBitMap + pBuild->valBitMapSize;
+    for (int32_t i = 0, m = 0; i < pBuild->valNum; ++i) {
+      if (pBuild->valCols[i].keyCol) {
+        continue;
+      }
+      if (!colDataIsNull_f(pBitMap, m)) {
+        code = colDataSetVal(taosArrayGet(pDst->pDataBlock, pBuild->valCols[i].srcSlot), r, pData, false);
+        if (code) {
+          return code;
+        }
+        pData += pBuild->valCols[i].vardata ? varDataTLen(pData) : pBuild->valCols[i].bytes;
+      }
+      m++;
+    }
+  }
+
+  pDst->info.rows++;
+  return TSDB_CODE_SUCCESS;
+}
+
+// move the rows already in the key hash to the build partitions, and release the memory of the key hash
+static int32_t spillHJoinKeyHash(SHJoinOperatorInfo* pJoin, SSDataBlock* pBlock) {
+  int32_t code = initHJoinSpillCtx(pJoin, pBlock);
+  if (code) {
+    return code;
+  }
+
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  SSDataBlock*    pPartBlk = NULL;
+  SGroupData*     pGroup = NULL;
+  int32_t         iter = 0;
+  while (NULL != (pGroup = tSimpleHashIterate(pJoin->pKeyHash, pGroup, &iter))) {
+    size_t           keyLen = 0;
+    char*            pKey = tSimpleHashGetKey(pGroup, &keyLen);
+    SHJoinPartition* pPart = &pSpill->pParts[getHJoinPartIdx(pSpill, pKey, keyLen)];
+    for (SBufRowInfo* pRow = pGroup->rows; pRow; pRow = pRow->next) {
+      code = getHJoinPartBlock(pJoin, pPart, true, &pPartBlk);
+      if (code) {
+        return code;
+      }
+      code = restoreHJoinBuildRow(pJoin, pPartBlk, pKey, pRow);
+      if (code) {
+        return code;
+      }
+    }
+  }
+
+  qInfo("hash join build side exceeds %" PRId64 " bytes after %" PRId64 " rows, spill to %d partitions",
+        pJoin->memLimit, pJoin->execInfo.buildBlkRows, pSpill->partNum);
+
+  pJoin->spilled = true;
+  return resetHJoinKeyHash(pJoin);
+}
+
 static int32_t buildHJoinKeyHash(struct SOperatorInfo* pOperator) {
   SHJoinOperatorInfo* pJoin = pOperator->info;
   SSDataBlock* pBlock = NULL;
@@ -705,15 +1010,167 @@ static int32_t buildHJoinKeyHash(struct SOperatorInfo* pOperator) {
     pJoin->execInfo.buildBlkNum++;
     pJoin->execInfo.buildBlkRows += pBlock->info.rows;
 
-    code = addBlockRowsToHash(pBlock, pJoin);
+    if (pJoin->spilled) {
+      code = partitionHJoinBlock(pJoin, pJoin->pBuild, pBlock);
+    } else {
+      code = addBlockRowsToHash(pBlock, pJoin);
+      if (TSDB_CODE_SUCCESS == code && pJoin->execInfo.buildMemSize > pJoin->memLimit) {
+        code = spillHJoinKeyHash(pJoin, pBlock);
+      }
+    }
+    if (code) {
+      return code;
+    }
+  }
+
+  if (pJoin->spilled) {
+    return flushHJoinPartitions(pJoin, true);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t partitionHJoinProbeTable(struct SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pJoin = pOperator->info;
+  SHJoinSpillCtx*     pSpill = &pJoin->spill;
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  while (true) {
+    SSDataBlock* pBlock = getNextBlockFromDownstream(pOperator, pJoin->pProbe->downStreamIdx);
+    if (NULL == pBlock) {
+      break;
+    }
+
+    pJoin->execInfo.probeBlkNum++;
+    pJoin->execInfo.probeBlkRows += pBlock->info.rows;
+
+    if (NULL == pSpill->pProbeBlk) {
+      pSpill->pProbeBlk = createOneDataBlock(pBlock, false);
+      if (NULL == pSpill->pProbeBlk) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      pSpill->probeBlkCap = blockDataGetCapacityInRow(pSpill->pProbeBlk, pSpill->pageSize,
+                                                      blockDataGetSerialMetaSize(taosArrayGetSize(pBlock->pDataBlock)));
+    }
+
+    code = partitionHJoinBlock(pJoin, pJoin->pProbe, pBlock);
     if (code) {
       return code;
     }
   }
 
+  return flushHJoinPartitions(pJoin, false);
+}
+
+static int32_t loadHJoinSpillPage(SHJoinSpillCtx* pSpill, SArray* pPages, int32_t idx, SSDataBlock* pBlock) {
+  int32_t* pageId = taosArrayGet(pPages, idx);
+  void*    pPage = getBufPage(pSpill->pBuf, *pageId);
+  if (NULL == pPage) {
+    return terrno;
+  }
+
+  int32_t code = blockDataFromBuf(pBlock, pPage);
+  releaseBufPage(pSpill->pBuf, pPage);
+  if (code) {
+    return code;
+  }
+
+  // the null flags are not kept in the page, the null bitmaps are checked instead
+  size_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    pCol->hasNull = true;
+  }
+
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t loadHJoinSpillPartition(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  int32_t         code = resetHJoinKeyHash(pJoin);
+  if (code) {
+    return code;
+  }
+
+  int32_t pageNum = taosArrayGetSize(pPart->pBuildPages);
+  for (int32_t i = 0; i < pageNum; ++i) {
+    code = loadHJoinSpillPage(pSpill, pPart->pBuildPages, i, pSpill->pBuildBlk);
+    if (code) {
+      return code;
+    }
+    code = addBlockRowsToHash(pSpill->pBuildBlk, pJoin);
+    if (code) {
+      return code;
+    }
+  }
+
+  if (pJoin->execInfo.buildMemSize > pJoin->memLimit) {
+    qWarn("hash join partition %d still exceeds memory limit, size:%" PRId64 ", limit:%" PRId64, pSpill->partIdx,
+          pJoin->execInfo.buildMemSize, pJoin->memLimit);
+  }
+
+  pSpill->pageIdx = 0;
+  return TSDB_CODE_SUCCESS;
+}
+
+// get the next probe block of the spilled partitions, switching to the next partition pair when needed
+static int32_t getNextHJoinSpillProbeBlock(SHJoinOperatorInfo* pJoin, SSDataBlock** ppBlock) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  int32_t         code = TSDB_CODE_SUCCESS;
+
+  *ppBlock = NULL;
+  while (true) {
+    if (pSpill->partIdx >= 0) {
+      SHJoinPartition* pPart = &pSpill->pParts[pSpill->partIdx];
+      if (pSpill->pageIdx < taosArrayGetSize(pPart->pProbePages)) {
+        code = loadHJoinSpillPage(pSpill, pPart->pProbePages, pSpill->pageIdx++, pSpill->pProbeBlk);
+        if (code) {
+          return code;
+        }
+
+        *ppBlock = pSpill->pProbeBlk;
+        return TSDB_CODE_SUCCESS;
+      }
+    }
+
+    if (++pSpill->partIdx >= pSpill->partNum) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    SHJoinPartition* pPart = &pSpill->pParts[pSpill->partIdx];
+    if (taosArrayGetSize(pPart->pBuildPages) <= 0 || taosArrayGetSize(pPart->pProbePages) <= 0) {
+      continue;
+    }
+
+    code = loadHJoinSpillPartition(pJoin, pPart);
+    if (code) {
+      return code;
+    }
+  }
+}
+
+static SSDataBlock* getNextHJoinProbeBlock(struct SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pJoin = pOperator->info;
+  SSDataBlock*        pBlock = NULL;
+
+  if (pJoin->spilled) {
+    int32_t code = getNextHJoinSpillProbeBlock(pJoin, &pBlock);
+    if (code) {
+      pOperator->pTaskInfo->code = code;
+      T_LONG_JMP(pOperator->pTaskInfo->env, code);
+    }
+    return pBlock;
+  }
+
+  pBlock = getNextBlockFromDownstream(pOperator, pJoin->pProbe->downStreamIdx);
+  if (pBlock) {
+    pJoin->execInfo.probeBlkNum++;
+    pJoin->execInfo.probeBlkRows += pBlock->info.rows;
+  }
+
+  return pBlock;
+}
+
 static int32_t launchBlockHashJoin(struct SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   SHJoinOperatorInfo* pJoin = pOperator->info;
   SHJoinTableInfo* pProbe = pJoin->pProbe;
@@ -765,12 +1222,15 @@ static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
     pJoin->keyHashBuilt = true;
     
     code = buildHJoinKeyHash(pOperator);
+    if (TSDB_CODE_SUCCESS == code && pJoin->spilled) {
+      code = partitionHJoinProbeTable(pOperator);
+    }
     if (code) {
       pTaskInfo->code = code;
       T_LONG_JMP(pTaskInfo->env, code);
     }
 
-    if (tSimpleHashGetSize(pJoin->pKeyHash) <= 0) {
+    if (!pJoin->spilled && tSimpleHashGetSize(pJoin->pKeyHash) <= 0) {
       setHJoinDone(pOperator);
       goto _return;
     }
@@ -790,15 +1250,12 @@ static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
   }
 
   while (true) {
-    SSDataBlock* pBlock = getNextBlockFromDownstream(pOperator, pJoin->pProbe->downStreamIdx);
+    SSDataBlock* pBlock = getNextHJoinProbeBlock(pOperator);
     if (NULL == pBlock) {
       setHJoinDone(pOperator);
       break;
     }
 
-    pJoin->execInfo.probeBlkNum++;
-    pJoin->execInfo.probeBlkRows += pBlock->info.rows;
-    
     code = launchBlockHashJoin(pOperator, pBlock);
     if (code) {
       pTaskInfo->code = code;
@@ -826,6 +1283,29 @@ _return:
   return (pRes->info.rows > 0) ? pRes : NULL;
 }
 
+static int32_t getHashJoinExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain, uint32_t* len) {
+  SHJoinOperatorInfo* pJoin = pOptr->info;
+  SHashJoinExecInfo*  pInfo = taosMemoryCalloc(1, sizeof(SHashJoinExecInfo));
+  if (NULL == pInfo) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  if (pJoin->spilled) {
+    pInfo->spillPartitions = pJoin->spill.partNum;
+    pInfo->spillRows = pJoin->execInfo.spillRows;
+    pInfo->spillBytes = pJoin->execInfo.spillBytes;
+    if (pJoin->spill.pBuf) {
+      SDiskbasedBufStatis stat = getDBufStatis(pJoin->spill.pBuf);
+      pInfo->writeBytes = stat.flushBytes;
+      pInfo->readBytes = stat.loadBytes;
+    }
+  }
+
+  *pOptrExplain = pInfo;
+  *len = sizeof(SHashJoinExecInfo);
+  return TSDB_CODE_SUCCESS;
+}
+
 SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                            SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
   SHJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SHJoinOperatorInfo));
@@ -858,7 +1338,12 @@ SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t n
     goto _error;
   }
 
+  pInfo->memLimit = (int64_t)tsHashJoinBufSize * 1048576;
+  pInfo->spill.pageSize = getHJoinSpillPageSize(pJoinNode);
+
   size_t hashCap = pInfo->pBuild->inputStat.inputRowNum > 0 ? (pInfo->pBuild->inputStat.inputRowNum * 1.5) : 1024;
+  // the build side may be spilled, do not let the bucket array alone exceed the memory limit
+  hashCap = TMIN(hashCap, pInfo->memLimit / 64);
   pInfo->pKeyHash = tSimpleHashInit(hashCap, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
   if (pInfo->pKeyHash == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
@@ -900,7 +1385,8 @@ SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t n
     goto _error;
   }
 
-  pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, doHashJoin, NULL, destroyHashJoinOperator, optrDefaultBufFn, NULL, optrDefaultGetNextExtFn, NULL);
+  pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, doHashJoin, NULL, destroyHashJoinOperator, optrDefaultBufFn,
+                                         getHashJoinExplainExecInfo, optrDefaultGetNextExtFn, NULL);
 
   qError("create hash Join operator done");
 
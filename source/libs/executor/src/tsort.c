@@ -26,6 +26,7 @@
 #include "tutil.h"
 #include "tsimplehash.h"
 #include "executil.h"
+#include "tglobal.h"
 
 struct STupleHandle {
   SSDataBlock* pBlock;
@@ -78,6 +79,8 @@ struct SSortHandle {
 
   void (*mergeLimitReachedFn)(uint64_t tableUid, void* param);
   void* mergeLimitReachedParam;
+
+  SArray* pSortRuns;  // SArray<SSortRunTask*>, the runs sorted on the task queue, in the order of creation
 };
 
 void tsortSetSingleTableMerge(SSortHandle* pHandle) {
@@ -134,6 +137,9 @@ SSDataBlock* tsortGetSortedDataBlock(const SSortHandle* pSortHandle) {
   return createOneDataBlock(pSortHandle->pDataBlock, false);
 }
 
+// number of the following pages of a merge source that are read ahead when it moves to a new page
+#define SORT_PREFETCH_PAGES 2
+
 #define AllocatedTupleType 0
 #define ReferencedTupleType 1 // tuple references to one row in pDataBlock
 typedef struct TupleDesc {
@@ -189,6 +195,409 @@ void destroyTuple(void* t) {
   }
 }
 
+// max length of the normalized sort key of each row
+#define SORT_NORM_KEY_MAX_LEN 32
+
+static int32_t getNormKeyValLen(const SColumnInfoData* pCol) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      return 1;
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      return 2;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+      return 4;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return 8;
+    default:
+      // float/double values within FLT_EQUAL are equal to compareFloatVal/compareDoubleVal, which no bytes keep
+      return -1;
+  }
+}
+
+/*
+ * The normalized key of a row is the concatenation of the sort columns, each of which is a flag byte followed by the
+ * value in big endian. The flag orders null before or after all values, and the sign bit of integers is flipped. A
+ * varchar column is encoded as a prefix of the string up to the first '\0', as strncmp does, and it is always the last
+ * encoded column. The key stops before a float/double column, so the rows of the same key are always compared by the
+ * columns. For descending order, the value bytes are inverted.
+ */
+int32_t tsortGetNormKeyLen(const SArray* pSortInfo, const SSDataBlock* pBlock, bool* complete) {
+  int32_t len = 0;
+  *complete = false;
+
+  size_t num = taosArrayGetSize(pSortInfo);
+  for (int32_t i = 0; i < num; ++i) {
+    const SBlockOrderInfo* pOrder = taosArrayGet(pSortInfo, i);
+    const SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    if (pCol == NULL) {
+      return 0;
+    }
+
+    if (pCol->info.type == TSDB_DATA_TYPE_BINARY) {
+      return (SORT_NORM_KEY_MAX_LEN - len >= 2) ? SORT_NORM_KEY_MAX_LEN : len;
+    }
+
+    int32_t valLen = getNormKeyValLen(pCol);
+    if (valLen < 0 || len + 1 + valLen > SORT_NORM_KEY_MAX_LEN) {
+      return len;
+    }
+
+    len += 1 + valLen;
+  }
+
+  *complete = (len > 0);
+  return len;
+}
+
+static FORCE_INLINE void putNormKeyVal(char* p, uint64_t v, int32_t len) {
+  for (int32_t i = len - 1; i >= 0; --i) {
+    p[i] = (char)(v & 0xFF);
+    v >>= 8;
+  }
+}
+
+static void encodeNormKeyVal(const SColumnInfoData* pCol, int32_t row, char* p, int32_t len) {
+  const char* pData = colDataGetData(pCol, row);
+
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      putNormKeyVal(p, (uint8_t)(*(int8_t*)pData) ^ 0x80u, 1);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      putNormKeyVal(p, *(uint8_t*)pData, 1);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      putNormKeyVal(p, (uint16_t)(*(int16_t*)pData) ^ 0x8000u, 2);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      putNormKeyVal(p, *(uint16_t*)pData, 2);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      putNormKeyVal(p, (uint32_t)(*(int32_t*)pData) ^ 0x80000000u, 4);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      putNormKeyVal(p, *(uint32_t*)pData, 4);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      putNormKeyVal(p, (uint64_t)(*(int64_t*)pData) ^ 0x8000000000000000ull, 8);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      putNormKeyVal(p, *(uint64_t*)pData, 8);
+      break;
+    case TSDB_DATA_TYPE_BINARY: {
+      int32_t     n = varDataLen(pData);
+      const char* z = memchr(varDataVal(pData), 0, n);
+      if (z != NULL) {
+        n = (int32_t)(z - varDataVal(pData));
+      }
+      memcpy(p, varDataVal(pData), TMIN(n, len));
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+static FORCE_INLINE bool isNormKeyNull(const SSDataBlock* pBlock, const SColumnInfoData* pCol, int32_t i, int32_t row) {
+  if (pBlock->pBlockAgg != NULL) {
+    return colDataIsNull(pCol, pBlock->info.rows, row, pBlock->pBlockAgg[i]);
+  }
+
+  if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+    return pCol->varmeta.offset[row] == -1;
+  }
+  return colDataIsNull_f(pCol->nullbitmap, row);
+}
+
+void tsortBuildNormKeys(const SArray* pSortInfo, const SSDataBlock* pBlock, int32_t keyLen, int32_t stride,
+                        char* pKeys) {
+  int32_t rows = pBlock->info.rows;
+  for (int32_t j = 0; j < rows; ++j) {
+    memset(pKeys + (int64_t)j * stride, 0, keyLen);
+  }
+
+  int32_t offset = 0;
+  size_t  num = taosArrayGetSize(pSortInfo);
+  for (int32_t i = 0; i < num && offset < keyLen; ++i) {
+    const SBlockOrderInfo* pOrder = taosArrayGet(pSortInfo, i);
+    const SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+
+    int32_t valLen = IS_VAR_DATA_TYPE(pCol->info.type) ? (keyLen - offset - 1) : getNormKeyValLen(pCol);
+    char    nullFlag = pOrder->nullFirst ? 0 : 2;
+    bool    desc = (pOrder->order == TSDB_ORDER_DESC);
+
+    for (int32_t j = 0; j < rows; ++j) {
+      char* p = pKeys + (int64_t)j * stride + offset;
+      if (isNormKeyNull(pBlock, pCol, i, j)) {
+        p[0] = nullFlag;  // the value of null is left zero, so two nulls are compared by the next column
+        continue;
+      }
+
+      p[0] = 1;
+      encodeNormKeyVal(pCol, j, p + 1, valLen);
+      if (desc) {
+        for (int32_t k = 1; k <= valLen; ++k) {
+          p[k] = ~p[k];
+        }
+      }
+    }
+
+    offset += 1 + valLen;
+  }
+}
+
+// LSD radix sort of the records of stride bytes, by the first keyLen bytes. Return the buffer of the sorted records.
+static char* radixSortNormKeys(char* pSrc, char* pDst, int32_t rows, int32_t stride, int32_t keyLen) {
+  int32_t count[256];
+
+  for (int32_t b = keyLen - 1; b >= 0; --b) {
+    memset(count, 0, sizeof(count));
+    for (int32_t j = 0; j < rows; ++j) {
+      count[(uint8_t)pSrc[(int64_t)j * stride + b]] += 1;
+    }
+
+    // all rows have the same byte, e.g. the flag byte of a column without null
+    if (count[(uint8_t)pSrc[b]] == rows) {
+      continue;
+    }
+
+    int32_t pos = 0;
+    for (int32_t k = 0; k < 256; ++k) {
+      int32_t c = count[k];
+      count[k] = pos;
+      pos += c;
+    }
+
+    for (int32_t j = 0; j < rows; ++j) {
+      char* p = pSrc + (int64_t)j * stride;
+      memcpy(pDst + (int64_t)(count[(uint8_t)p[b]]++) * stride, p, stride);
+    }
+
+    TSWAP(pSrc, pDst);
+  }
+
+  return pSrc;
+}
+
+int32_t tsortSortBlock(SArray* pSortInfo, SSDataBlock* pBlock) {
+  int32_t rows = pBlock->info.rows;
+  if (rows <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  bool    complete = false;
+  int32_t keyLen = tsortGetNormKeyLen(pSortInfo, pBlock, &complete);
+  if (keyLen == 0) {
+    return blockDataSort(pBlock, pSortInfo);
+  }
+
+  // each record is the normalized key followed by the row index
+  int32_t  stride = keyLen + sizeof(int32_t);
+  char*    pBuf = taosMemoryMalloc((int64_t)rows * stride * 2);
+  int32_t* index = taosMemoryMalloc(rows * sizeof(int32_t));
+  if (pBuf == NULL || index == NULL) {
+    taosMemoryFree(pBuf);
+    taosMemoryFree(index);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int64_t st = taosGetTimestampUs();
+  tsortBuildNormKeys(pSortInfo, pBlock, keyLen, stride, pBuf);
+  for (int32_t j = 0; j < rows; ++j) {
+    memcpy(pBuf + (int64_t)j * stride + keyLen, &j, sizeof(int32_t));
+  }
+
+  char* pSorted = radixSortNormKeys(pBuf, pBuf + (int64_t)rows * stride, rows, stride, keyLen);
+  for (int32_t j = 0; j < rows; ++j) {
+    memcpy(&index[j], pSorted + (int64_t)j * stride + keyLen, sizeof(int32_t));
+  }
+
+  // the rows with the same prefix are ordered by the sort columns
+  terrno = 0;
+  if (!complete) {
+    SSDataBlockSortHelper helper = {.pDataBlock = pBlock, .orderInfo = pSortInfo};
+    for (int32_t i = 0; i < taosArrayGetSize(pSortInfo); ++i) {
+      SBlockOrderInfo* pInfo = taosArrayGet(pSortInfo, i);
+      pInfo->pColData = taosArrayGet(pBlock->pDataBlock, pInfo->slotId);
+      pInfo->compFn = getKeyComparFunc(pInfo->pColData->info.type, pInfo->order);
+    }
+
+    int32_t start = 0;
+    for (int32_t j = 1; j <= rows; ++j) {
+      if (j < rows && memcmp(pSorted + (int64_t)j * stride, pSorted + (int64_t)start * stride, keyLen) == 0) {
+        continue;
+      }
+
+      if (j - start > 1) {
+        taosqsort(index + start, j - start, sizeof(int32_t), &helper, dataBlockCompar);
+      }
+      start = j;
+    }
+  }
+
+  int32_t code = terrno;
+  int64_t el = taosGetTimestampUs() - st;
+  if (code == TSDB_CODE_SUCCESS) {
+    code = blockDataReorder(pBlock, index);
+  }
+
+  qDebug("sort block by normalized key, rows:%d, keyLen:%d, complete:%d, sort:%" PRId64 "us, total:%" PRId64 "us",
+         rows, keyLen, complete, el, taosGetTimestampUs() - st);
+
+  taosMemoryFree(pBuf);
+  taosMemoryFree(index);
+  return code;
+}
+
+static void initSortNormKey(SSortHandle* pHandle) {
+  SMsortComparParam* pParam = &pHandle->cmpParam;
+  pParam->normKeyLen = 0;
+  pParam->normKeyComplete = false;
+
+  if (pParam->sortType == SORT_BLOCK_TS_MERGE || pHandle->comparFn != msortComparFn || pHandle->pDataBlock == NULL) {
+    return;
+  }
+
+  pParam->normKeyLen = tsortGetNormKeyLen(pParam->orderInfo, pHandle->pDataBlock, &pParam->normKeyComplete);
+}
+
+// the normalized keys are built once for each block of a merge source, and compared in the loser tree
+static int32_t buildSourceNormKeys(const SMsortComparParam* pParam, SSortSource* pSource) {
+  if (pParam->normKeyLen == 0 || pSource->src.pBlock == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t rows = pSource->src.pBlock->info.rows;
+  if (rows > pSource->normKeyRows) {
+    char* p = taosMemoryRealloc(pSource->pNormKeys, (int64_t)rows * pParam->normKeyLen);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pSource->pNormKeys = p;
+    pSource->normKeyRows = rows;
+  }
+
+  tsortBuildNormKeys(pParam->orderInfo, pSource->src.pBlock, pParam->normKeyLen, pParam->normKeyLen,
+                     pSource->pNormKeys);
+  return TSDB_CODE_SUCCESS;
+}
+
+#define SORT_RUN_QUEUED  0
+#define SORT_RUN_RUNNING 1
+#define SORT_RUN_DONE    2
+
+/*
+ * A run sorted on the shared task queue. It is referred by the sort handle and by the queued task, and the last one
+ * frees it. Whoever moves it out of SORT_RUN_QUEUED sorts it, so the query thread sorts a run by itself rather than
+ * waiting for the task queue to take it.
+ */
+typedef struct SSortRunTask {
+  SSDataBlock*  pBlock;
+  SArray*       pSortInfo;  // copy of the sort info, since the column and compare function are set in it when sorting
+  int32_t       code;
+  int64_t       elapsed;
+  int8_t        state;
+  int32_t       ref;
+  TdThreadMutex lock;
+  TdThreadCond  done;
+} SSortRunTask;
+
+static void releaseSortRun(SSortRunTask* pTask) {
+  if (atomic_sub_fetch_32(&pTask->ref, 1) > 0) {
+    return;
+  }
+
+  blockDataDestroy(pTask->pBlock);
+  taosArrayDestroy(pTask->pSortInfo);
+  taosThreadCondDestroy(&pTask->done);
+  taosThreadMutexDestroy(&pTask->lock);
+  taosMemoryFree(pTask);
+}
+
+static void doSortRun(SSortRunTask* pTask) {
+  int64_t st = taosGetTimestampUs();
+  int32_t code = tsortSortBlock(pTask->pSortInfo, pTask->pBlock);
+
+  taosThreadMutexLock(&pTask->lock);
+  pTask->code = code;
+  pTask->elapsed = taosGetTimestampUs() - st;
+  atomic_store_8(&pTask->state, SORT_RUN_DONE);
+  taosThreadCondBroadcast(&pTask->done);
+  taosThreadMutexUnlock(&pTask->lock);
+}
+
+static int32_t sortRunAsync(void* param) {
+  SSortRunTask* pTask = param;
+  if (atomic_val_compare_exchange_8(&pTask->state, SORT_RUN_QUEUED, SORT_RUN_RUNNING) == SORT_RUN_QUEUED) {
+    doSortRun(pTask);
+  }
+
+  releaseSortRun(pTask);
+  return TSDB_CODE_SUCCESS;
+}
+
+// the block is owned by the run once it is submitted
+static int32_t submitSortRun(SArray* pRuns, SArray* pSortInfo, SSDataBlock* pBlock) {
+  SSortRunTask* pTask = taosMemoryCalloc(1, sizeof(SSortRunTask));
+  if (pTask == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pTask->pSortInfo = taosArrayDup(pSortInfo, NULL);
+  if (pTask->pSortInfo == NULL || taosArrayPush(pRuns, &pTask) == NULL) {
+    taosArrayDestroy(pTask->pSortInfo);
+    taosMemoryFree(pTask);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosThreadMutexInit(&pTask->lock, NULL);
+  taosThreadCondInit(&pTask->done, NULL);
+  pTask->pBlock = pBlock;
+  pTask->state = SORT_RUN_QUEUED;
+  pTask->ref = 2;
+
+  // the run stays queued and is sorted by the query thread if the task queue does not accept it
+  if (taosAsyncExec(sortRunAsync, pTask, NULL) != 0) {
+    atomic_sub_fetch_32(&pTask->ref, 1);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// sort the run in the query thread if it is not taken by the task queue yet, otherwise wait for it
+static void waitSortRun(SSortRunTask* pTask) {
+  if (atomic_val_compare_exchange_8(&pTask->state, SORT_RUN_QUEUED, SORT_RUN_RUNNING) == SORT_RUN_QUEUED) {
+    doSortRun(pTask);
+    return;
+  }
+
+  taosThreadMutexLock(&pTask->lock);
+  while (atomic_load_8(&pTask->state) != SORT_RUN_DONE) {
+    taosThreadCondWait(&pTask->done, &pTask->lock);
+  }
+  taosThreadMutexUnlock(&pTask->lock);
+}
+
+// the runs not taken by the task queue are dropped, and the running ones are freed by the task queue once sorted
+static void destroySortRuns(SArray* pRuns) {
+  for (int32_t i = 0; i < taosArrayGetSize(pRuns); ++i) {
+    SSortRunTask* pTask = taosArrayGetP(pRuns, i);
+    atomic_val_compare_exchange_8(&pTask->state, SORT_RUN_QUEUED, SORT_RUN_DONE);
+    releaseSortRun(pTask);
+  }
+
+  taosArrayDestroy(pRuns);
+}
+
 /**
  *
  * @param type
@@ -245,6 +654,7 @@ static int32_t sortComparCleanup(SMsortComparParam* cmpParam) {
     if (pSource->pageIdList) {
       taosArrayDestroy(pSource->pageIdList);
     }
+    taosMemoryFreeClear(pSource->pNormKeys);
     taosMemoryFreeClear(pSource);
     cmpParam->pSources[i] = NULL;
   }
@@ -280,6 +690,7 @@ void tsortClearOrderdSource(SArray* pOrderedSource, int64_t *fetchUs, int64_t *f
       (*pSource)->src.pBlock = NULL;
     }
 
+    taosMemoryFreeClear((*pSource)->pNormKeys);
     taosMemoryFreeClear(*pSource);
   }
 
@@ -291,6 +702,8 @@ void tsortDestroySortHandle(SSortHandle* pSortHandle) {
     return;
   }
   tsortClose(pSortHandle);
+  destroySortRuns(pSortHandle->pSortRuns);
+  pSortHandle->pSortRuns = NULL;
   if (pSortHandle->pMergeTree != NULL) {
     tMergeTreeDestroy(&pSortHandle->pMergeTree);
   }
@@ -398,6 +811,16 @@ static void setCurrentSourceDone(SSortSource* pSource, SSortHandle* pHandle) {
   ++pHandle->numOfCompletedSources;
 }
 
+static void prefetchSourcePages(SSortSource* pSource, SSortHandle* pHandle) {
+  int32_t num = (int32_t)taosArrayGetSize(pSource->pageIdList) - pSource->pageIndex - 1;
+  if (num <= 0) {
+    return;
+  }
+
+  int32_t* pPgId = taosArrayGet(pSource->pageIdList, pSource->pageIndex + 1);
+  dBufPrefetchPages(pHandle->pBuf, pPgId, TMIN(num, SORT_PREFETCH_PAGES));
+}
+
 static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32_t startIndex, int32_t endIndex,
                               SSortHandle* pHandle) {
   pParam->pSources = taosArrayGet(pSources, startIndex);
@@ -438,6 +861,8 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
       if (NULL == pPage) {
         return terrno;
       }
+
+      prefetchSourcePages(pSource, pHandle);
       
       code = blockDataFromBuf(pSource->src.pBlock, pPage);
       if (code != TSDB_CODE_SUCCESS) {
@@ -446,6 +871,12 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
       }
 
       releaseBufPage(pHandle->pBuf, pPage);
+
+      code = buildSourceNormKeys(pParam, pSource);
+      if (code != TSDB_CODE_SUCCESS) {
+        terrno = code;
+        return code;
+      }
     }
   } else {
     qDebug("start init for the multiway merge sort, %s", pHandle->idStr);
@@ -458,6 +889,13 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
       // set current source is done
       if (pSource->src.pBlock == NULL) {
         setCurrentSourceDone(pSource, pHandle);
+        continue;
+      }
+
+      code = buildSourceNormKeys(pParam, pSource);
+      if (code != TSDB_CODE_SUCCESS) {
+        terrno = code;
+        return code;
       }
     }
 
@@ -516,11 +954,18 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
           return terrno;
         }
 
+        prefetchSourcePages(pSource, pHandle);
+
         int32_t code = blockDataFromBuf(pSource->src.pBlock, pPage);
         if (code != TSDB_CODE_SUCCESS) {
           return code;
         }
         releaseBufPage(pHandle->pBuf, pPage);
+
+        code = buildSourceNormKeys(&pHandle->cmpParam, pSource);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
+        }
       }
     } else {
       int64_t st = taosGetTimestampUs();      
@@ -531,6 +976,11 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
         (*numOfCompleted) += 1;
         pSource->src.rowIndex = -1;
         qDebug("adjust merge tree. %d source completed", *numOfCompleted);
+      } else {
+        int32_t code = buildSourceNormKeys(&pHandle->cmpParam, pSource);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
+        }
       }
     }
   }
@@ -620,6 +1070,17 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
     int ret = pParam->cmpFn(left1, right1);
     return ret;
   } else {
+    if (pParam->normKeyLen > 0) {
+      int32_t ret = memcmp(pLeftSource->pNormKeys + (int64_t)pLeftSource->src.rowIndex * pParam->normKeyLen,
+                           pRightSource->pNormKeys + (int64_t)pRightSource->src.rowIndex * pParam->normKeyLen,
+                           pParam->normKeyLen);
+      if (ret != 0) {
+        return ret < 0 ? -1 : 1;
+      } else if (pParam->normKeyComplete) {
+        return 0;
+      }
+    }
+
     bool isVarType;
     for (int32_t i = 0; i < pInfo->size; ++i) {
       SBlockOrderInfo* pOrder = TARRAY_GET_ELEM(pInfo, i);
@@ -810,8 +1271,10 @@ static int32_t doInternalMergeSort(SSortHandle* pHandle) {
     pHandle->totalElapsed += el;
 
     SDiskbasedBufStatis statis = getDBufStatis(pHandle->pBuf);
-    qDebug("%s %d round mergesort, elapsed:%" PRId64 " readDisk:%.2f Kb, flushDisk:%.2f Kb", pHandle->idStr, t + 1, el,
-           statis.loadBytes / 1024.0, statis.flushBytes / 1024.0);
+    qDebug("%s %d round mergesort, elapsed:%" PRId64 " readDisk:%.2f Kb, flushDisk:%.2f Kb, rawFlushDisk:%.2f Kb, "
+           "prefetch/hit pages:%d/%d",
+           pHandle->idStr, t + 1, el, statis.loadBytes / 1024.0, statis.flushBytes / 1024.0,
+           statis.rawFlushBytes / 1024.0, statis.prefetchPages, statis.prefetchHits);
 
     if (pHandle->type == SORT_MULTISOURCE_MERGE) {
       pHandle->type = SORT_SINGLESOURCE_SORT;
@@ -1199,6 +1662,81 @@ static int32_t createBlocksMergeSortInitialSources(SSortHandle* pHandle) {
   return code;
 }
 
+static int32_t flushSortedRun(SSortHandle* pHandle, SSDataBlock* pBlock) {
+  if (pHandle->pqMaxRows > 0) blockDataKeepFirstNRows(pBlock, pHandle->pqMaxRows);
+  return doAddToBuf(pBlock, pHandle);
+}
+
+// wait for the eldest run to be sorted and flush it into the buffer
+static int32_t flushEldestSortRun(SSortHandle* pHandle) {
+  SSortRunTask* pTask = taosArrayGetP(pHandle->pSortRuns, 0);
+  taosArrayRemove(pHandle->pSortRuns, 0);
+
+  waitSortRun(pTask);
+  int32_t code = pTask->code;
+
+  pHandle->sortElapsed += pTask->elapsed;
+  if (code == TSDB_CODE_SUCCESS) {
+    code = flushSortedRun(pHandle, pTask->pBlock);
+  }
+
+  releaseSortRun(pTask);
+  return code;
+}
+
+/*
+ * A full run is handed over to the shared task queue instead of being sorted in place, and the query thread continues
+ * to fetch the next run. At most numOfSortThreads runs are in flight, and the runs are flushed in the order of creation.
+ */
+static int32_t sortFullRun(SSortHandle* pHandle) {
+  if (pHandle->pSortRuns == NULL && tsNumOfSortThreads > 0) {
+    pHandle->pSortRuns = taosArrayInit(tsNumOfSortThreads, POINTER_BYTES);
+  }
+
+  if (pHandle->pSortRuns == NULL) {
+    int64_t p = taosGetTimestampUs();
+    int32_t code = tsortSortBlock(pHandle->pSortInfo, pHandle->pDataBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    pHandle->sortElapsed += taosGetTimestampUs() - p;
+    return flushSortedRun(pHandle, pHandle->pDataBlock);
+  }
+
+  if (taosArrayGetSize(pHandle->pSortRuns) >= tsNumOfSortThreads) {
+    int32_t code = flushEldestSortRun(pHandle);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  SSDataBlock* pBlock = createOneDataBlock(pHandle->pDataBlock, false);
+  if (pBlock == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = submitSortRun(pHandle->pSortRuns, pHandle->pSortInfo, pHandle->pDataBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    blockDataDestroy(pBlock);
+    return code;
+  }
+
+  pHandle->pDataBlock = pBlock;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t flushAllSortRuns(SSortHandle* pHandle) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  while (pHandle->pSortRuns != NULL && taosArrayGetSize(pHandle->pSortRuns) > 0 && code == TSDB_CODE_SUCCESS) {
+    code = flushEldestSortRun(pHandle);
+  }
+
+  destroySortRuns(pHandle->pSortRuns);
+  pHandle->pSortRuns = NULL;
+  return code;
+}
+
 static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
   int32_t code = 0;
   size_t  sortBufSize = pHandle->numOfPages * pHandle->pageSize;
@@ -1245,8 +1783,7 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
     size_t size = blockDataGetSize(pHandle->pDataBlock);
     if (size > sortBufSize) {
       // Perform the in-memory sort and then flush data in the buffer into disk.
-      int64_t p = taosGetTimestampUs();
-      code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+      code = sortFullRun(pHandle);
       if (code != 0) {
         if (source->param && !source->onlyRef) {
           taosMemoryFree(source->param);
@@ -1259,14 +1796,6 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
         taosMemoryFree(source);
         return code;
       }
-
-      int64_t el = taosGetTimestampUs() - p;
-      pHandle->sortElapsed += el;
-      if (pHandle->pqMaxRows > 0) blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->pqMaxRows);
-      code = doAddToBuf(pHandle->pDataBlock, pHandle);
-      if (code != TSDB_CODE_SUCCESS) {
-        return code;
-      }
     }
   }
 
@@ -1282,7 +1811,7 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
     // Perform the in-memory sort and then flush data in the buffer into disk.
     int64_t p = taosGetTimestampUs();
 
-    code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+    code = tsortSortBlock(pHandle->pSortInfo, pHandle->pDataBlock);
     if (code != 0) {
       return code;
     }
@@ -1291,6 +1820,12 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
     int64_t el = taosGetTimestampUs() - p;
     pHandle->sortElapsed += el;
 
+    // the runs in flight are ahead of the last one
+    code = flushAllSortRuns(pHandle);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
     // All sorted data can fit in memory, external memory sort is not needed. Return to directly
     if (size <= sortBufSize && pHandle->pBuf == NULL) {
       pHandle->cmpParam.numOfSources = 1;
@@ -1304,6 +1839,10 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
       code = doAddToBuf(pHandle->pDataBlock, pHandle);
     }
   }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    code = flushAllSortRuns(pHandle);
+  }
   return code;
 }
 
@@ -1325,6 +1864,8 @@ static bool tsortOpenForBufMergeSort(SSortHandle* pHandle) {
     return code;
   }
 
+  initSortNormKey(pHandle);
+
   // do internal sort
   code = doInternalMergeSort(pHandle);
   if (code != TSDB_CODE_SUCCESS) {
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "executorInt.h"
+#include "functionMgt.h"
+#include "operator.h"
+#include "plannodes.h"
+#include "querytask.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+#include "tsimplehash.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t numOfRows = 4096;
+const int32_t numOfGroups = 1024;
+
+// group by tag, status_code
+SArray* createGroupCols() {
+  SArray* pGroupCols = taosArrayInit(2, sizeof(SColumn));
+  for (int32_t i = 0; i < 2; ++i) {
+    SColumn col = {0};
+    col.slotId = i;
+    col.type = TSDB_DATA_TYPE_INT;
+    col.bytes = sizeof(int32_t);
+    taosArrayPush(pGroupCols, &col);
+  }
+  return pGroupCols;
+}
+
+SSDataBlock* createGroupBlock(bool sorted, bool withNull) {
+  SSDataBlock* pBlock = createDataBlock();
+  for (int32_t i = 0; i < 2; ++i) {
+    SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), i + 1);
+    blockDataAppendColInfo(pBlock, &colInfo);
+  }
+  blockDataEnsureCapacity(pBlock, numOfRows);
+
+  SArray* pKeys = taosArrayInit(numOfRows, sizeof(int32_t));
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t k = (int32_t)(((int64_t)i * numOfGroups) / numOfRows);
+    taosArrayPush(pKeys, &k);
+  }
+
+  if (!sorted) {
+    int32_t* p = (int32_t*)pKeys->pData;
+    for (int32_t i = numOfRows - 1; i > 0; --i) {
+      int32_t j = taosRand() % (i + 1);
+      int32_t t = p[i];
+      p[i] = p[j];
+      p[j] = t;
+    }
+  }
+
+  SColumnInfoData* pTag = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+  SColumnInfoData* pStatus = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t k = *(int32_t*)taosArrayGet(pKeys, i);
+    int32_t tag = k / 16;
+    int32_t status = 200 + k % 16;
+    colDataSetVal(pTag, i, (const char*)&tag, false);
+    if (withNull && k % 16 == 0) {
+      colDataSetNULL(pStatus, i);
+    } else {
+      colDataSetVal(pStatus, i, (const char*)&status, false);
+    }
+  }
+
+  pBlock->info.rows = numOfRows;
+  taosArrayDestroy(pKeys);
+  return pBlock;
+}
+
+// the key layout of buildGroupKeys in groupoperator.c
+int32_t buildRowKey(char* pKey, SSDataBlock* pBlock, int32_t row) {
+  char* pStart = pKey + 2;
+  for (int32_t i = 0; i < 2; ++i) {
+    SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, i);
+    if (colDataIsNull_s(pCol, row)) {
+      pKey[i] = 1;
+      continue;
+    }
+    pKey[i] = 0;
+    memcpy(pStart, colDataGetData(pCol, row), sizeof(int32_t));
+    pStart += sizeof(int32_t);
+  }
+  return (int32_t)(pStart - pKey);
+}
+
+const int16_t inputBlkId = 1;
+const int16_t resBlkId = 2;
+
+// tag int, status int (null for one of 16 keys), val bigint (null every 7 rows), with the keys in random order
+typedef struct SGroupbyInput {
+  std::vector<int32_t> keys;
+  std::vector<int64_t> vals;
+} SGroupbyInput;
+
+typedef struct SGroupbyInputInfo {
+  const SGroupbyInput* pInput;
+  int32_t              blockRows;
+  int32_t              current;
+  SSDataBlock*         pBlock;
+} SGroupbyInputInfo;
+
+SGroupbyInput createGroupbyInput(int32_t rows) {
+  SGroupbyInput input;
+  for (int32_t i = 0; i < rows; ++i) {
+    input.keys.push_back(taosRand() % numOfGroups);
+    input.vals.push_back(i);
+  }
+  return input;
+}
+
+SSDataBlock* getGroupbyInputBlock(SOperatorInfo* pOperator) {
+  SGroupbyInputInfo*   pInfo = static_cast<SGroupbyInputInfo*>(pOperator->info);
+  const SGroupbyInput* pInput = pInfo->pInput;
+  int32_t              total = (int32_t)pInput->keys.size();
+  if (pInfo->current >= total) {
+    return NULL;
+  }
+
+  if (pInfo->pBlock == NULL) {
+    pInfo->pBlock = createDataBlock();
+    pInfo->pBlock->info.id.blockId = inputBlkId;
+    for (int32_t i = 0; i < 2; ++i) {
+      SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), i + 1);
+      blockDataAppendColInfo(pInfo->pBlock, &colInfo);
+    }
+    SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 3);
+    blockDataAppendColInfo(pInfo->pBlock, &valCol);
+    blockDataEnsureCapacity(pInfo->pBlock, pInfo->blockRows);
+  } else {
+    blockDataCleanup(pInfo->pBlock);
+  }
+
+  SSDataBlock* pBlock = pInfo->pBlock;
+  int32_t      rows = TMIN(pInfo->blockRows, total - pInfo->current);
+  for (int32_t i = 0; i < rows; ++i) {
+    int32_t j = pInfo->current + i;
+    int32_t k = pInput->keys[j];
+    int32_t tag = k / 16;
+    int32_t status = 200 + k % 16;
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i, (const char*)&tag, false);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i, (const char*)&status, (k % 16 == 0));
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2), i, (const char*)&pInput->vals[j],
+                  (j % 7 == 0));
+  }
+
+  pBlock->info.rows = rows;
+  pInfo->current += rows;
+  return pBlock;
+}
+
+void destroyGroupbyInput(void* param) {
+  SGroupbyInputInfo* pInfo = static_cast<SGroupbyInputInfo*>(param);
+  blockDataDestroy(pInfo->pBlock);
+  taosMemoryFree(pInfo);
+}
+
+SOperatorInfo* createGroupbyInputOperator(const SGroupbyInput* pInput, int32_t blockRows) {
+  SOperatorInfo*     pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  SGroupbyInputInfo* pInfo = static_cast<SGroupbyInputInfo*>(taosMemoryCalloc(1, sizeof(SGroupbyInputInfo)));
+  pInfo->pInput = pInput;
+  pInfo->blockRows = blockRows;
+
+  pOperator->name = "groupbyInputOperator4Test";
+  pOperator->info = pInfo;
+  pOperator->resultDataBlockId = inputBlkId;
+  pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, getGroupbyInputBlock, NULL, destroyGroupbyInput,
+                                         optrDefaultBufFn, NULL, optrDefaultGetNextExtFn, NULL);
+  return pOperator;
+}
+
+SNode* createColumn(int16_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->dataBlockId = inputBlkId;
+  pCol->slotId = slotId;
+  pCol->colId = slotId + 1;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return (SNode*)pCol;
+}
+
+SNode* createTarget(int16_t slotId, SNode* pExpr) {
+  STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+  pTarget->dataBlockId = resBlkId;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = pExpr;
+  return (SNode*)pTarget;
+}
+
+SNode* createAggFunc(const char* pName) {
+  SFunctionNode* pFunc = (SFunctionNode*)nodesMakeNode(QUERY_NODE_FUNCTION);
+  strcpy(pFunc->functionName, pName);
+  nodesListMakeStrictAppend(&pFunc->pParameterList, createColumn(2, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t)));
+
+  char msg[128] = {0};
+  EXPECT_EQ(fmGetFuncInfo(pFunc, msg, sizeof(msg)), TSDB_CODE_SUCCESS) << msg;
+  return (SNode*)pFunc;
+}
+
+void appendSlot(SDataBlockDescNode* pDesc, int16_t slotId, int8_t type, int32_t bytes) {
+  SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+  pSlot->slotId = slotId;
+  pSlot->dataType.type = type;
+  pSlot->dataType.bytes = bytes;
+  pSlot->output = true;
+  nodesListMakeStrictAppend(&pDesc->pSlots, (SNode*)pSlot);
+  pDesc->totalRowSize += bytes;
+  pDesc->outputRowSize += bytes;
+}
+
+// select count(val), sum(val), tag, status from input group by tag, status
+SAggPhysiNode* createGroupbyAggNode() {
+  SAggPhysiNode* pNode = (SAggPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_AGG);
+  nodesListMakeStrictAppend(&pNode->pAggFuncs, createTarget(0, createAggFunc("count")));
+  nodesListMakeStrictAppend(&pNode->pAggFuncs, createTarget(1, createAggFunc("sum")));
+  nodesListMakeStrictAppend(&pNode->pGroupKeys, createTarget(2, createColumn(0, TSDB_DATA_TYPE_INT, sizeof(int32_t))));
+  nodesListMakeStrictAppend(&pNode->pGroupKeys, createTarget(3, createColumn(1, TSDB_DATA_TYPE_INT, sizeof(int32_t))));
+
+  SDataBlockDescNode* pResDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pResDesc->dataBlockId = resBlkId;
+  appendSlot(pResDesc, 0, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  appendSlot(pResDesc, 1, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  appendSlot(pResDesc, 2, TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  appendSlot(pResDesc, 3, TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  pNode->node.pOutputDataBlockDesc = pResDesc;
+  return pNode;
+}
+
+std::string formatGroupRow(SSDataBlock* pRes, int32_t r) {
+  std::string row;
+  for (int32_t i = 0; i < taosArrayGetSize(pRes->pDataBlock); ++i) {
+    SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pRes->pDataBlock, i);
+    if (colDataIsNull_s(pCol, r)) {
+      row += "NULL";
+    } else if (pCol->info.type == TSDB_DATA_TYPE_INT) {
+      row += std::to_string(*(int32_t*)colDataGetData(pCol, r));
+    } else {
+      row += std::to_string(*(int64_t*)colDataGetData(pCol, r));
+    }
+    row += ",";
+  }
+  return row;
+}
+
+// run the group by operator on the input split into blocks of the given rows, and return the sorted result rows
+std::vector<std::string> runGroupbyOperator(const SGroupbyInput* pInput, int32_t blockRows) {
+  SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)taosMemoryCalloc(1, sizeof(SExecTaskInfo));
+  pTaskInfo->id.str = taosStrdup("groupbyTest");
+  SAggPhysiNode* pNode = createGroupbyAggNode();
+
+  std::vector<std::string> rows;
+  SOperatorInfo* pOperator = createGroupOperatorInfo(createGroupbyInputOperator(pInput, blockRows), pNode, pTaskInfo);
+  EXPECT_NE(pOperator, nullptr);
+  if (pOperator != NULL) {
+    while (true) {
+      SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+      if (pRes == NULL) {
+        break;
+      }
+      for (int32_t r = 0; r < pRes->info.rows; ++r) {
+        rows.push_back(formatGroupRow(pRes, r));
+      }
+    }
+    destroyOperator(pOperator);
+  }
+
+  nodesDestroyNode((SNode*)pNode);
+  taosMemoryFree(pTaskInfo->id.str);
+  taosMemoryFree(pTaskInfo);
+
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+// the result computed row by row in the test
+std::vector<std::string> calcGroupbyResult(const SGroupbyInput* pInput) {
+  std::map<int32_t, std::pair<int64_t, int64_t>> groups;
+  for (int32_t j = 0; j < (int32_t)pInput->keys.size(); ++j) {
+    std::pair<int64_t, int64_t>& g = groups[pInput->keys[j]];
+    if (j % 7 != 0) {
+      g.first += 1;
+      g.second += pInput->vals[j];
+    }
+  }
+
+  std::vector<std::string> rows;
+  for (auto& it : groups) {
+    int32_t     k = it.first;
+    std::string row = std::to_string(it.second.first) + ",";
+    row += (it.second.first == 0) ? "NULL," : std::to_string(it.second.second) + ",";
+    row += std::to_string(k / 16) + ",";
+    row += (k % 16 == 0) ? "NULL," : std::to_string(200 + k % 16) + ",";
+    rows.push_back(row);
+  }
+
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+}  // namespace
+
+TEST(groupbyTest, keyBatchSlots) {
+  SArray*      pGroupCols = createGroupCols();
+  SSDataBlock* pBlock = createGroupBlock(false, true);
+
+  SGroupKeyBatch batch = {0};
+  ASSERT_EQ(initGroupKeyBatch(&batch, 2 + 2 * sizeof(int32_t)), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(buildGroupKeyBatch(&batch, pGroupCols, pBlock), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(batch.numOfSlots, numOfGroups);
+  ASSERT_EQ(batch.pSlotOffset[batch.numOfSlots], numOfRows);
+
+  char key[16] = {0};
+  for (int32_t i = 0; i < batch.numOfSlots; ++i) {
+    int32_t first = batch.pSlotRow[i];
+    ASSERT_EQ(batch.pSelect[batch.pSlotOffset[i]], first);
+
+    for (int32_t j = batch.pSlotOffset[i]; j < batch.pSlotOffset[i + 1]; ++j) {
+      int32_t row = batch.pSelect[j];
+      if (j > batch.pSlotOffset[i]) {
+        ASSERT_GT(row, batch.pSelect[j - 1]);
+      }
+
+      int32_t len = buildRowKey(key, pBlock, row);
+      ASSERT_EQ(len, batch.pKeyLen[row]);
+      ASSERT_EQ(memcmp(key, batch.pKeys + row * batch.keyStride, len), 0);
+      ASSERT_EQ(memcmp(key, batch.pKeys + first * batch.keyStride, len), 0);
+    }
+  }
+
+  cleanupGroupKeyBatch(&batch);
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(pGroupCols);
+}
+
+TEST(groupbyTest, batchMatchesPerRow) {
+  ASSERT_EQ(fmFuncMgtInit(), TSDB_CODE_SUCCESS);
+
+  // the result rows are kept in the disk based buffer in the temp dir
+  if (tsTempDir[0] == 0) {
+    strcpy(tsTempDir, TD_TMP_DIR_PATH);
+  }
+  osUpdate();
+
+  SGroupbyInput input = createGroupbyInput(numOfRows * 8);
+
+  // the keys of a block are in random order, so the batch path takes over from the second block
+  std::vector<std::string> batchRes = runGroupbyOperator(&input, numOfRows);
+
+  // blocks smaller than GROUPBY_BATCH_MIN_ROWS always go through the per-row path
+  std::vector<std::string> rowRes = runGroupbyOperator(&input, 32);
+
+  std::vector<std::string> expect = calcGroupbyResult(&input);
+  ASSERT_EQ(expect.size(), numOfGroups);
+  ASSERT_EQ(rowRes, expect);
+  ASSERT_EQ(batchRes, expect);
+}
+
+#pragma GCC diagnostic pop
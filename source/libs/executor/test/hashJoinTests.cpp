@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "executorInt.h"
+#include "hashjoin.h"
+#include "operator.h"
+#include "plannodes.h"
+#include "querynodes.h"
+#include "querytask.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+
+namespace {
+
+const int16_t leftBlkId = 1;
+const int16_t rightBlkId = 2;
+const int16_t resBlkId = 3;
+
+const int32_t rowsPerBlock = 1000;
+const int32_t leftRows = 20000;   // build side, with nullable and var data columns
+const int32_t rightRows = 30000;  // probe side
+const int32_t leftKeys = 2000;
+const int32_t rightKeys = 3000;
+
+// left: key int, val bigint (null every 7 rows), str varchar (null every 5 rows)
+// right: key int, val bigint
+typedef struct SJoinInputInfo {
+  bool         left;
+  int32_t      totalRows;
+  int32_t      current;
+  SSDataBlock* pBlock;
+} SJoinInputInfo;
+
+SSDataBlock* getJoinInputBlock(SOperatorInfo* pOperator) {
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(pOperator->info);
+  if (pInfo->current >= pInfo->totalRows) {
+    return NULL;
+  }
+
+  if (pInfo->pBlock == NULL) {
+    pInfo->pBlock = createDataBlock();
+    pInfo->pBlock->info.id.blockId = pInfo->left ? leftBlkId : rightBlkId;
+
+    SColumnInfoData keyCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 0);
+    blockDataAppendColInfo(pInfo->pBlock, &keyCol);
+    SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+    blockDataAppendColInfo(pInfo->pBlock, &valCol);
+    if (pInfo->left) {
+      SColumnInfoData strCol = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE, 2);
+      blockDataAppendColInfo(pInfo->pBlock, &strCol);
+    }
+    blockDataEnsureCapacity(pInfo->pBlock, rowsPerBlock);
+  } else {
+    blockDataCleanup(pInfo->pBlock);
+  }
+
+  SSDataBlock* pBlock = pInfo->pBlock;
+  int32_t      rows = TMIN(rowsPerBlock, pInfo->totalRows - pInfo->current);
+  for (int32_t i = 0; i < rows; ++i) {
+    int32_t j = pInfo->current + i;
+    int32_t key = pInfo->left ? (j % leftKeys) : (j % rightKeys);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i, (const char*)&key, false);
+
+    int64_t val = pInfo->left ? j : (int64_t)j * 10;
+    bool    valNull = pInfo->left && (j % 7 == 0);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i, (const char*)&val, valNull);
+
+    if (pInfo->left) {
+      char str[16 + VARSTR_HEADER_SIZE] = {0};
+      snprintf(varDataVal(str), 16, "s%d", j);
+      varDataSetLen(str, strlen(varDataVal(str)));
+      colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2), i, str, (j % 5 == 0));
+    }
+  }
+
+  pBlock->info.rows = rows;
+  pInfo->current += rows;
+  return pBlock;
+}
+
+void destroyJoinInput(void* param) {
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(param);
+  blockDataDestroy(pInfo->pBlock);
+  taosMemoryFree(pInfo);
+}
+
+SOperatorInfo* createJoinInputOperator(bool left) {
+  SOperatorInfo*  pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(taosMemoryCalloc(1, sizeof(SJoinInputInfo)));
+  pInfo->left = left;
+  pInfo->totalRows = left ? leftRows : rightRows;
+
+  pOperator->name = "joinInputOperator4Test";
+  pOperator->info = pInfo;
+  pOperator->resultDataBlockId = left ? leftBlkId : rightBlkId;
+  pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, getJoinInputBlock, NULL, destroyJoinInput, optrDefaultBufFn,
+                                         NULL, optrDefaultGetNextExtFn, NULL);
+  return pOperator;
+}
+
+SNode* createColumn(int16_t blkId, int16_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->dataBlockId = blkId;
+  pCol->slotId = slotId;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return (SNode*)pCol;
+}
+
+SNode* createTarget(int16_t slotId, SNode* pExpr) {
+  STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+  pTarget->dataBlockId = resBlkId;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = pExpr;
+  return (SNode*)pTarget;
+}
+
+void appendSlot(SDataBlockDescNode* pDesc, int16_t slotId, int8_t type, int32_t bytes) {
+  SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+  pSlot->slotId = slotId;
+  pSlot->dataType.type = type;
+  pSlot->dataType.bytes = bytes;
+  pSlot->output = true;
+  nodesListMakeStrictAppend(&pDesc->pSlots, (SNode*)pSlot);
+  pDesc->totalRowSize += bytes;
+  pDesc->outputRowSize += bytes;
+}
+
+SDataBlockDescNode* createBlockDesc(int16_t blkId) {
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = blkId;
+  appendSlot(pDesc, 0, TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  appendSlot(pDesc, 1, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  if (blkId == leftBlkId) {
+    appendSlot(pDesc, 2, TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE);
+  }
+  return pDesc;
+}
+
+// select * from left inner join right on left.key = right.key
+SHashJoinPhysiNode* createHashJoinNode() {
+  SHashJoinPhysiNode* pNode = (SHashJoinPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  pNode->joinType = JOIN_TYPE_INNER;
+  pNode->inputStat[0].inputRowNum = leftRows;
+  pNode->inputStat[1].inputRowNum = rightRows;
+
+  nodesListMakeStrictAppend(&pNode->pOnLeft, createColumn(leftBlkId, 0, TSDB_DATA_TYPE_INT, sizeof(int32_t)));
+  nodesListMakeStrictAppend(&pNode->pOnRight, createColumn(rightBlkId, 0, TSDB_DATA_TYPE_INT, sizeof(int32_t)));
+
+  nodesListMakeStrictAppend(&pNode->pTargets,
+                            createTarget(0, createColumn(leftBlkId, 0, TSDB_DATA_TYPE_INT, sizeof(int32_t))));
+  nodesListMakeStrictAppend(&pNode->pTargets,
+                            createTarget(1, createColumn(leftBlkId, 1, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t))));
+  nodesListMakeStrictAppend(
+      &pNode->pTargets,
+      createTarget(2, createColumn(leftBlkId, 2, TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE)));
+  nodesListMakeStrictAppend(&pNode->pTargets,
+                            createTarget(3, createColumn(rightBlkId, 0, TSDB_DATA_TYPE_INT, sizeof(int32_t))));
+  nodesListMakeStrictAppend(&pNode->pTargets,
+                            createTarget(4, createColumn(rightBlkId, 1, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t))));
+
+  SDataBlockDescNode* pResDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pResDesc->dataBlockId = resBlkId;
+  appendSlot(pResDesc, 0, TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  appendSlot(pResDesc, 1, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  appendSlot(pResDesc, 2, TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE);
+  appendSlot(pResDesc, 3, TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  appendSlot(pResDesc, 4, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  pNode->node.pOutputDataBlockDesc = pResDesc;
+
+  for (int16_t blkId = leftBlkId; blkId <= rightBlkId; ++blkId) {
+    SPhysiNode* pChild = (SPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_PROJECT);
+    pChild->pOutputDataBlockDesc = createBlockDesc(blkId);
+    nodesListMakeStrictAppend(&pNode->node.pChildren, (SNode*)pChild);
+  }
+
+  return pNode;
+}
+
+std::string formatResRow(SSDataBlock* pRes, int32_t r) {
+  std::string row;
+  for (int32_t i = 0; i < taosArrayGetSize(pRes->pDataBlock); ++i) {
+    SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pRes->pDataBlock, i);
+    if (colDataIsNull_s(pCol, r)) {
+      row += "NULL";
+    } else if (pCol->info.type == TSDB_DATA_TYPE_INT) {
+      row += std::to_string(*(int32_t*)colDataGetData(pCol, r));
+    } else if (pCol->info.type == TSDB_DATA_TYPE_BIGINT) {
+      row += std::to_string(*(int64_t*)colDataGetData(pCol, r));
+    } else {
+      char* p = colDataGetData(pCol, r);
+      row += std::string(varDataVal(p), varDataLen(p));
+    }
+    row += ",";
+  }
+  return row;
+}
+
+// run the hash join with the memory limit of the build side, and return the sorted result rows
+std::vector<std::string> runHashJoin(int64_t memLimit, bool* spilled, int32_t* partNum, int64_t* spillRows) {
+  SExecTaskInfo*      pTaskInfo = (SExecTaskInfo*)taosMemoryCalloc(1, sizeof(SExecTaskInfo));
+  SHashJoinPhysiNode* pNode = createHashJoinNode();
+  SOperatorInfo*      pDownstream[2] = {createJoinInputOperator(true), createJoinInputOperator(false)};
+
+  SOperatorInfo* pOperator = createHashJoinOperatorInfo(pDownstream, 2, pNode, pTaskInfo);
+  EXPECT_NE(pOperator, nullptr);
+  if (pOperator == NULL) {
+    return {};
+  }
+
+  SHJoinOperatorInfo* pJoin = (SHJoinOperatorInfo*)pOperator->info;
+  pJoin->memLimit = memLimit;
+
+  std::vector<std::string> rows;
+  while (true) {
+    SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+    if (pRes == NULL) {
+      break;
+    }
+    for (int32_t r = 0; r < pRes->info.rows; ++r) {
+      rows.push_back(formatResRow(pRes, r));
+    }
+  }
+
+  *spilled = pJoin->spilled;
+  *partNum = pJoin->spill.partNum;
+  *spillRows = pJoin->execInfo.spillRows;
+
+  destroyOperator(pOperator);
+  nodesDestroyNode((SNode*)pNode);
+  taosMemoryFree(pTaskInfo);
+
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+}  // namespace
+
+TEST(hashJoinTest, spillMatchesInMemoryJoin) {
+  // the spill buffer is flushed to the temp dir
+  if (tsTempDir[0] == 0) {
+    strcpy(tsTempDir, TD_TMP_DIR_PATH);
+  }
+  osUpdate();
+
+  bool    spilled = false;
+  int32_t partNum = 0;
+  int64_t spillRows = 0;
+
+  std::vector<std::string> memRes = runHashJoin(INT64_MAX, &spilled, &partNum, &spillRows);
+  ASSERT_FALSE(spilled);
+  ASSERT_EQ(spillRows, 0);
+
+  // each of the left keys matches 10 left rows and 10 right rows
+  ASSERT_EQ(memRes.size(), (size_t)leftKeys * (leftRows / leftKeys) * (rightRows / rightKeys));
+
+  // the build side spills after the first block, the rows already in the key hash are restored to the partitions
+  std::vector<std::string> spillRes = runHashJoin(16 * 1024, &spilled, &partNum, &spillRows);
+  ASSERT_TRUE(spilled);
+  ASSERT_GE(partNum, HASH_JOIN_SPILL_MIN_PART_NUM);
+  ASSERT_EQ(spillRows, leftRows + rightRows);
+
+  ASSERT_EQ(spillRes.size(), memRes.size());
+  for (size_t i = 0; i < memRes.size(); ++i) {
+    ASSERT_EQ(spillRes[i], memRes[i]) << "row " << i;
+  }
+}
+
+#pragma GCC diagnostic pop
@@ -393,4 +393,257 @@ TEST(testCase, ordered_merge_sort_Test) {
 
 #endif
 
+namespace {
+const int32_t numOfNormKeyRows = 5000;
+
+// int with null, double and varchar with common prefixes, so the normalized keys are incomplete
+SSDataBlock* createNormKeyBlock() {
+  SSDataBlock* pBlock = createDataBlock();
+  SColumnInfoData c0 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  SColumnInfoData c1 = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 2);
+  SColumnInfoData c2 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 48 + VARSTR_HEADER_SIZE, 3);
+  blockDataAppendColInfo(pBlock, &c0);
+  blockDataAppendColInfo(pBlock, &c1);
+  blockDataAppendColInfo(pBlock, &c2);
+  blockDataEnsureCapacity(pBlock, numOfNormKeyRows);
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+  SColumnInfoData* p2 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2);
+
+  char buf[64] = {0};
+  for (int32_t i = 0; i < numOfNormKeyRows; ++i) {
+    int32_t v = (int32_t)(taosRand() % 64) - 32;
+    if (taosRand() % 10 == 0) {
+      colDataSetNULL(p0, i);
+    } else {
+      colDataSetVal(p0, i, (const char*)&v, false);
+    }
+
+    double d = (taosRand() % 16) * 0.5 - 4;
+    colDataSetVal(p1, i, (const char*)&d, false);
+
+    int32_t len = snprintf(varDataVal(buf), 48, "common_prefix_of_the_string_%d", (int32_t)(taosRand() % 100));
+    varDataSetLen(buf, len);
+    colDataSetVal(p2, i, buf, false);
+  }
+
+  pBlock->info.rows = numOfNormKeyRows;
+  return pBlock;
+}
+
+void checkSameSortKeys(SSDataBlock* p1, SSDataBlock* p2, int32_t numOfCols) {
+  ASSERT_EQ(p1->info.rows, p2->info.rows);
+  for (int32_t j = 0; j < numOfCols; ++j) {
+    SColumnInfoData* pCol1 = (SColumnInfoData*)taosArrayGet(p1->pDataBlock, j);
+    SColumnInfoData* pCol2 = (SColumnInfoData*)taosArrayGet(p2->pDataBlock, j);
+    for (int32_t i = 0; i < p1->info.rows; ++i) {
+      bool isNull = colDataIsNull_s(pCol1, i);
+      ASSERT_EQ(isNull, colDataIsNull_s(pCol2, i));
+      if (isNull) {
+        continue;
+      }
+
+      char* v1 = colDataGetData(pCol1, i);
+      char* v2 = colDataGetData(pCol2, i);
+      int32_t len = IS_VAR_DATA_TYPE(pCol1->info.type) ? varDataTLen(v1) : pCol1->info.bytes;
+      ASSERT_EQ(memcmp(v1, v2, len), 0);
+    }
+  }
+}
+
+SArray* createNormKeyOrder(int32_t order0, bool nullFirst, int32_t order1, int32_t order2) {
+  SArray*         pOrder = taosArrayInit(3, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo info = {0};
+
+  info.slotId = 0, info.order = order0, info.nullFirst = nullFirst;
+  taosArrayPush(pOrder, &info);
+  info.slotId = 2, info.order = order2, info.nullFirst = false;
+  taosArrayPush(pOrder, &info);
+  info.slotId = 1, info.order = order1;
+  taosArrayPush(pOrder, &info);
+  return pOrder;
+}
+}  // namespace
+
+TEST(testCase, norm_key_sort_Test) {
+  SSDataBlock* pBlock = createNormKeyBlock();
+
+  int32_t orders[][4] = {{TSDB_ORDER_ASC, 1, TSDB_ORDER_ASC, TSDB_ORDER_ASC},
+                         {TSDB_ORDER_DESC, 0, TSDB_ORDER_ASC, TSDB_ORDER_DESC},
+                         {TSDB_ORDER_ASC, 0, TSDB_ORDER_DESC, TSDB_ORDER_ASC}};
+  for (int32_t k = 0; k < sizeof(orders) / sizeof(orders[0]); ++k) {
+    SArray* pOrder = createNormKeyOrder(orders[k][0], orders[k][1], orders[k][2], orders[k][3]);
+
+    bool    complete = true;
+    int32_t keyLen = tsortGetNormKeyLen(pOrder, pBlock, &complete);
+    ASSERT_GT(keyLen, 0);
+    ASSERT_FALSE(complete);
+
+    SSDataBlock* pExpect = createOneDataBlock(pBlock, true);
+    SSDataBlock* pResult = createOneDataBlock(pBlock, true);
+    ASSERT_EQ(blockDataSort(pExpect, pOrder), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(tsortSortBlock(pOrder, pResult), TSDB_CODE_SUCCESS);
+    checkSameSortKeys(pExpect, pResult, 3);
+
+    blockDataDestroy(pExpect);
+    blockDataDestroy(pResult);
+    taosArrayDestroy(pOrder);
+  }
+
+  blockDataDestroy(pBlock);
+}
+
+TEST(testCase, norm_key_complete_Test) {
+  SSDataBlock* pBlock = createNormKeyBlock();
+
+  // int only, the order is decided by the normalized key
+  SArray* pOrder = createNormKeyOrder(TSDB_ORDER_DESC, 1, TSDB_ORDER_ASC, TSDB_ORDER_ASC);
+  taosArrayRemoveBatch(pOrder, 1, 2, NULL);
+
+  bool    complete = false;
+  int32_t keyLen = tsortGetNormKeyLen(pOrder, pBlock, &complete);
+  ASSERT_EQ(keyLen, 1 + sizeof(int32_t));
+  ASSERT_TRUE(complete);
+
+  SSDataBlock* pExpect = createOneDataBlock(pBlock, true);
+  SSDataBlock* pResult = createOneDataBlock(pBlock, true);
+  ASSERT_EQ(blockDataSort(pExpect, pOrder), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(tsortSortBlock(pOrder, pResult), TSDB_CODE_SUCCESS);
+
+  // rows of the same key may be in different order, so only the key column is compared
+  checkSameSortKeys(pExpect, pResult, 1);
+
+  // the normalized keys are in the order of the sorted rows
+  char* pKeys = (char*)taosMemoryMalloc(keyLen * numOfNormKeyRows);
+  tsortBuildNormKeys(pOrder, pResult, keyLen, keyLen, pKeys);
+  for (int32_t i = 1; i < numOfNormKeyRows; ++i) {
+    ASSERT_LE(memcmp(pKeys + (i - 1) * keyLen, pKeys + i * keyLen, keyLen), 0);
+  }
+
+  taosMemoryFree(pKeys);
+  blockDataDestroy(pExpect);
+  blockDataDestroy(pResult);
+  taosArrayDestroy(pOrder);
+  blockDataDestroy(pBlock);
+}
+
+TEST(testCase, norm_key_float_Test) {
+  // doubles within FLT_EQUAL, and -0.0 and 0.0, are equal to the comparator, so the rows are ordered by the int
+  const double values[] = {1.0, 1.0 + 1e-7, -0.0, 0.0, 2.5, 2.5 - 1e-7};
+  const int32_t numOfValues = sizeof(values) / sizeof(values[0]);
+  const int32_t rows = 600;
+
+  SSDataBlock*    pBlock = createDataBlock();
+  SColumnInfoData c0 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  SColumnInfoData c1 = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 2);
+  SColumnInfoData c2 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 3);
+  blockDataAppendColInfo(pBlock, &c0);
+  blockDataAppendColInfo(pBlock, &c1);
+  blockDataAppendColInfo(pBlock, &c2);
+  blockDataEnsureCapacity(pBlock, rows);
+  for (int32_t i = 0; i < rows; ++i) {
+    int32_t v = (i / numOfValues) % 3;
+    int32_t r = (i * 7919) % rows;  // unique, so the order of the rows is the same by either sort
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i, (const char*)&v, false);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i, (const char*)&values[i % numOfValues],
+                  false);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2), i, (const char*)&r, false);
+  }
+  pBlock->info.rows = rows;
+
+  int32_t orders[] = {TSDB_ORDER_ASC, TSDB_ORDER_DESC};
+  for (int32_t order : orders) {
+    SArray*         pOrder = taosArrayInit(3, sizeof(SBlockOrderInfo));
+    SBlockOrderInfo info = {0};
+    info.slotId = 0, info.order = TSDB_ORDER_ASC;
+    taosArrayPush(pOrder, &info);
+    info.slotId = 1, info.order = order;
+    taosArrayPush(pOrder, &info);
+    info.slotId = 2, info.order = TSDB_ORDER_ASC;
+    taosArrayPush(pOrder, &info);
+
+    // the key stops before the double column
+    bool    complete = true;
+    int32_t keyLen = tsortGetNormKeyLen(pOrder, pBlock, &complete);
+    ASSERT_EQ(keyLen, 1 + sizeof(int32_t));
+    ASSERT_FALSE(complete);
+
+    SSDataBlock* pExpect = createOneDataBlock(pBlock, true);
+    SSDataBlock* pResult = createOneDataBlock(pBlock, true);
+    ASSERT_EQ(blockDataSort(pExpect, pOrder), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(tsortSortBlock(pOrder, pResult), TSDB_CODE_SUCCESS);
+    checkSameSortKeys(pExpect, pResult, 3);
+
+    blockDataDestroy(pExpect);
+    blockDataDestroy(pResult);
+    taosArrayDestroy(pOrder);
+  }
+
+  blockDataDestroy(pBlock);
+}
+
+TEST(testCase, external_sort_run_Test) {
+  // the sorted runs are kept in the disk based buffer in the temp dir
+  if (tsTempDir[0] == 0) {
+    strcpy(tsTempDir, TD_TMP_DIR_PATH);
+  }
+  osUpdate();
+
+  // the runs are sorted by the query thread without the task queue, then on the task queue, then in place
+  int32_t numOfSortThreads = tsNumOfSortThreads;
+  for (int32_t k = 0; k < 3; ++k) {
+    if (k == 1) {
+      ASSERT_EQ(initTaskQueue(), 0);
+    } else if (k == 2) {
+      tsNumOfSortThreads = 0;
+    }
+
+    _info info = {0};
+    info.pageRows = 100;
+    info.count = 20;
+    info.type = TSDB_DATA_TYPE_INT;
+
+    SBlockOrderInfo oi = {0};
+    oi.order = TSDB_ORDER_DESC;
+    oi.slotId = 0;
+    SArray* orderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+    taosArrayPush(orderInfo, &oi);
+
+    SSDataBlock*    pBlock = createDataBlock();
+    SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+    blockDataAppendColInfo(pBlock, &colInfo);
+
+    // a buffer of a few pages, so that the source is sorted in runs
+    SSortHandle* phandle = tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, 128, 3, pBlock, "test_abc", 0, 0, 0);
+    tsortSetFetchRawDataFp(phandle, getSingleColDummyBlock, NULL, NULL);
+    blockDataDestroy(pBlock);
+
+    SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+    ps->param = &info;
+    ps->onlyRef = true;
+    tsortAddSource(phandle, ps);
+    ASSERT_EQ(tsortOpen(phandle), TSDB_CODE_SUCCESS);
+
+    int32_t rows = 0;
+    int32_t expect = info.startVal;
+    while (1) {
+      STupleHandle* pTupleHandle = tsortNextTuple(phandle);
+      if (pTupleHandle == NULL) {
+        break;
+      }
+
+      ASSERT_EQ(*(int32_t*)tsortGetValue(pTupleHandle, 0), expect--);
+      rows += 1;
+    }
+    ASSERT_EQ(rows, 20 * 100);
+
+    taosArrayDestroy(orderInfo);
+    tsortDestroySortHandle(phandle);
+  }
+
+  cleanupTaskQueue();
+  tsNumOfSortThreads = numOfSortThreads;
+}
+
 #pragma GCC diagnostic pop
@@ -18,6 +18,10 @@
 
 #include "parUtil.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 struct SToken;
 
 #define NEXT_TOKEN(pSql, sToken)                      \
@@ -58,5 +62,13 @@ void    insDestroyVgroupDataCxtList(SArray *pVgCxtList);
 void    insDestroyVgroupDataCxtHashMap(SHashObj *pVgCxtHash);
 void    insDestroyTableDataCxt(STableDataCxt *pTableCxt);
 void    insDestroyBoundColInfo(SBoundColInfo *pInfo);
+int32_t insGetInsertShape(void *pCache, const char *tbFName, const char *stbFName, const STableMeta *pStbMeta,
+                          const char *pSql, SVCreateTbReq **pCreateTbReq, int32_t *pLen);
+void    insPutInsertShape(void *pCache, const char *tbFName, const char *stbFName, const STableMeta *pStbMeta,
+                          const char *pClause, int32_t len, SVCreateTbReq *pCreateTbReq);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif  // TDENGINE_PAR_INSERT_UTIL_H
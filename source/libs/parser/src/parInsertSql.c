@@ -56,6 +56,7 @@ typedef struct SInsertParseContext {
   bool           forceUpdate;
   bool           needTableTagVal;
   bool           needRequest;       // whether or not request server
+  bool           tagsWithNow;       // tag values of the current table depend on the parse time
 } SInsertParseContext;
 
 typedef int32_t (*_row_append_fn_t)(SMsgBuf* pMsgBuf, const void* value, int32_t len, void* param);
@@ -937,6 +938,9 @@ static int32_t parseTagsClauseImpl(SInsertParseContext* pCxt, SVnodeModifyOpStmt
 
     SSchema* pTagSchema = &pSchema[pCxt->tags.pColIndex[i]];
     isJson = pTagSchema->type == TSDB_DATA_TYPE_JSON;
+    if (TK_NOW == token.type || TK_TODAY == token.type) {
+      pCxt->tagsWithNow = true;
+    }
     code = checkAndTrimValue(&token, pCxt->tmpTokenBuf, &pCxt->msg, pTagSchema->type);
     if (TK_NK_VARIABLE == token.type) {
       code = buildSyntaxErrMsg(&pCxt->msg, "not expected tags values ", token.z);
@@ -1060,9 +1064,38 @@ static int32_t parseUsingClauseBottom(SInsertParseContext* pCxt, SVnodeModifyOpS
     return TSDB_CODE_SUCCESS;
   }
 
-  int32_t code = parseBoundTagsClause(pCxt, pStmt);
-  if (TSDB_CODE_SUCCESS == code) {
-    code = parseTagsClause(pCxt, pStmt);
+  // the tags clause of a child table is mostly the same text in each insert of an application, so it is taken from
+  // the insert shape cache of the connection while the super table is unchanged. Stmt binds its own tags, and the
+  // subtable privilege is checked with the parsed tag values.
+  void* pCache = pCxt->pComCxt->pInsertShapeCache;
+  bool  useCache = NULL != pCache && NULL == pCxt->pComCxt->pStmtCb && NULL == pStmt->pTagCond;
+  char  tbFName[TSDB_TABLE_FNAME_LEN];
+  char  stbFName[TSDB_TABLE_FNAME_LEN];
+  if (useCache) {
+    tNameExtractFullName(&pStmt->targetTableName, tbFName);
+    tNameExtractFullName(&pStmt->usingTableName, stbFName);
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t len = 0;
+  if (useCache) {
+    code = insGetInsertShape(pCache, tbFName, stbFName, pStmt->pTableMeta, pStmt->pSql, &pStmt->pCreateTblReq, &len);
+  }
+
+  if (TSDB_CODE_SUCCESS == code && len > 0) {
+    pStmt->pSql += len;
+  } else if (TSDB_CODE_SUCCESS == code) {
+    const char* pClause = pStmt->pSql;
+    pCxt->tagsWithNow = false;
+    code = parseBoundTagsClause(pCxt, pStmt);
+    if (TSDB_CODE_SUCCESS == code) {
+      code = parseTagsClause(pCxt, pStmt);
+    }
+    // the clause ends with ')', so a following token never continues it
+    if (TSDB_CODE_SUCCESS == code && useCache && !pCxt->tagsWithNow && NULL != pStmt->pCreateTblReq) {
+      insPutInsertShape(pCache, tbFName, stbFName, pStmt->pTableMeta, pClause, pStmt->pSql - pClause,
+                        pStmt->pCreateTblReq);
+    }
   }
   if (TSDB_CODE_SUCCESS == code) {
     code = parseTableOptions(pCxt, pStmt);
@@ -2074,60 +2107,357 @@ static int32_t parseValuesClause(SInsertParseContext* pCxt, SVnodeModifyOpStmt*
   return code;
 }
 
+#define CSV_READ_BUF_SIZE            (4 * 1024 * 1024)  // bytes read from the csv file at a time
+#define CSV_PARSE_CHUNK_LINES        4096               // lines of a chunk, parsed by one thread
+#define CSV_PARALLEL_PARSE_MIN_LINES (CSV_PARSE_CHUNK_LINES * 2)
+
+static int32_t parseCsvLine(SInsertParseContext* pCxt, SVnodeModifyOpStmt* pStmt, SRowsDataContext rowsDataCxt,
+                            char* pLine, bool* pFirstLine, int32_t* pNumOfRows) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  bool    gotRow = false;
+  SToken  token;
+  strtolower(pLine, pLine);
+  const char* pRow = pLine;
+  if (!pStmt->stbSyntax) {
+    code = parseOneRow(pCxt, (const char**)&pRow, rowsDataCxt.pTableDataCxt, &gotRow, &token);
+  } else {
+    STableDataCxt* pTableDataCxt = NULL;
+    code = parseOneStbRow(pCxt, pStmt, (const char**)&pRow, rowsDataCxt.pStbRowsCxt, &gotRow, &token, &pTableDataCxt);
+    if (code == TSDB_CODE_SUCCESS) {
+      SStbRowsDataContext* pStbRowsCxt = rowsDataCxt.pStbRowsCxt;
+      void* pData = pTableDataCxt;
+      taosHashPut(pStmt->pTableCxtHashObj, &pStbRowsCxt->pCtbMeta->uid, sizeof(pStbRowsCxt->pCtbMeta->uid), &pData,
+                  POINTER_BYTES);
+    }
+  }
+  // the first line may be the header of the csv
+  if (code && *pFirstLine) {
+    *pFirstLine = false;
+    return TSDB_CODE_SUCCESS;
+  }
+  *pFirstLine = false;
+
+  if (TSDB_CODE_SUCCESS == code && gotRow) {
+    (*pNumOfRows)++;
+  }
+  return code;
+}
+
+typedef struct SCsvParseCtx {
+  SInsertParseContext* pCxt;
+  STableDataCxt*       pTableCxt;
+  char**               pLines;
+  int32_t              numOfLines;
+  int32_t              numOfChunks;
+  int32_t              nextChunk;
+  SArray**             pChunkRows;  // SArray<SRow*> of each chunk
+  int32_t              ref;         // the calling thread and the tasks not finished
+  tsem_t               done;        // posted for each chunk taken by the tasks
+  TdThreadMutex        lock;
+  // the first line failed to parse
+  int32_t              errLine;
+  int32_t              code;
+  char*                msg;
+} SCsvParseCtx;
+
+static void releaseCsvParseCtx(SCsvParseCtx* pCtx) {
+  if (atomic_sub_fetch_32(&pCtx->ref, 1) > 0) {
+    return;
+  }
+  tsem_destroy(&pCtx->done);
+  taosThreadMutexDestroy(&pCtx->lock);
+  taosMemoryFree(pCtx->pChunkRows);
+  taosMemoryFree(pCtx->msg);
+  taosMemoryFree(pCtx);
+}
+
+static void setCsvParseError(SCsvParseCtx* pCtx, int32_t line, int32_t code, const char* msg) {
+  taosThreadMutexLock(&pCtx->lock);
+  if (line < pCtx->errLine) {
+    pCtx->code = code;
+    tstrncpy(pCtx->msg, msg, pCtx->pCxt->msg.len);
+    atomic_store_32(&pCtx->errLine, line);
+  }
+  taosThreadMutexUnlock(&pCtx->lock);
+}
+
+// Parse the chunks of lines not taken by other threads, each into its own rows. A thread parses with its own copy of
+// the parse context and of the values of the table data context, the rest of which is only read. The contexts of the
+// calling thread are only valid while a chunk is left, since it returns once all the chunks are parsed.
+static void parseCsvChunks(SCsvParseCtx* pCtx, int32_t* pNumOfTaken) {
+  SInsertParseContext* pCxt = NULL;
+  SSubmitTbData        data = {0};
+  STableDataCxt        tableCxt = {0};
+
+  while (1) {
+    int32_t iChunk = atomic_fetch_add_32(&pCtx->nextChunk, 1);
+    if (iChunk >= pCtx->numOfChunks) {
+      break;
+    }
+
+    int32_t start = iChunk * CSV_PARSE_CHUNK_LINES;
+    int32_t end = TMIN(start + CSV_PARSE_CHUNK_LINES, pCtx->numOfLines);
+    // the chunks are taken in order, so the ones after a failed line are skipped
+    if (start < atomic_load_32(&pCtx->errLine)) {
+      int32_t code = TSDB_CODE_SUCCESS;
+      if (NULL == pCxt) {
+        pCxt = taosMemoryMalloc(sizeof(SInsertParseContext) + pCtx->pCxt->msg.len);
+        tableCxt = *pCtx->pTableCxt;
+        tableCxt.pData = &data;
+        tableCxt.pValues = taosArrayDup(pCtx->pTableCxt->pValues, NULL);
+        if (NULL == pCxt || NULL == tableCxt.pValues) {
+          code = TSDB_CODE_OUT_OF_MEMORY;
+        } else {
+          memcpy(pCxt, pCtx->pCxt, sizeof(SInsertParseContext));
+          pCxt->msg.buf = (char*)(pCxt + 1);
+          pCxt->msg.buf[0] = '\0';
+        }
+      }
+      if (TSDB_CODE_SUCCESS == code) {
+        data.aRowP = pCtx->pChunkRows[iChunk] = taosArrayInit(end - start, POINTER_BYTES);
+        if (NULL == data.aRowP) {
+          code = TSDB_CODE_OUT_OF_MEMORY;
+        }
+      }
+      if (TSDB_CODE_SUCCESS != code) {
+        setCsvParseError(pCtx, start, code, "");
+      }
+
+      for (int32_t i = start; i < end && TSDB_CODE_SUCCESS == code; ++i) {
+        bool    gotRow = false;
+        SToken  token;
+        char*   pLine = pCtx->pLines[i];
+        strtolower(pLine, pLine);
+        code = parseOneRow(pCxt, (const char**)&pLine, &tableCxt, &gotRow, &token);
+        if (TSDB_CODE_SUCCESS != code) {
+          setCsvParseError(pCtx, i, code, pCxt->msg.buf);
+        }
+      }
+    }
+
+    if (NULL == pNumOfTaken) {
+      tsem_post(&pCtx->done);
+    } else {
+      (*pNumOfTaken)++;
+    }
+  }
+
+  taosArrayDestroy(tableCxt.pValues);
+  taosMemoryFree(pCxt);
+}
+
+static int32_t parseCsvChunksTask(void* param) {
+  SCsvParseCtx* pCtx = param;
+  parseCsvChunks(pCtx, NULL);
+  releaseCsvParseCtx(pCtx);
+  return TSDB_CODE_SUCCESS;
+}
+
+// Parse the lines of a normal or child table on the client task queue threads and the calling thread. The rows of
+// each chunk are appended to the table data context in the order of lines, as parsing them one by one does.
+static int32_t parseCsvLinesParallel(SInsertParseContext* pCxt, STableDataCxt* pTableCxt, char** pLines,
+                                     int32_t numOfLines, int32_t* pNumOfRows) {
+  int32_t       code = TSDB_CODE_SUCCESS;
+  int32_t       numOfTasks = 0;
+  SCsvParseCtx* pCtx = taosMemoryCalloc(1, sizeof(SCsvParseCtx));
+  if (NULL == pCtx) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pCtx->pCxt = pCxt;
+  pCtx->pTableCxt = pTableCxt;
+  pCtx->pLines = pLines;
+  pCtx->numOfLines = numOfLines;
+  pCtx->numOfChunks = (numOfLines + CSV_PARSE_CHUNK_LINES - 1) / CSV_PARSE_CHUNK_LINES;
+  pCtx->errLine = numOfLines;
+  pCtx->ref = 1;
+  pCtx->pChunkRows = taosMemoryCalloc(pCtx->numOfChunks, POINTER_BYTES);
+  pCtx->msg = taosMemoryCalloc(1, pCxt->msg.len);
+  tsem_init(&pCtx->done, 0, 0);
+  taosThreadMutexInit(&pCtx->lock, NULL);
+  if (NULL == pCtx->pChunkRows || NULL == pCtx->msg) {
+    releaseCsvParseCtx(pCtx);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 1; i < TMIN(tsCsvParseThreads, pCtx->numOfChunks); ++i) {
+    atomic_add_fetch_32(&pCtx->ref, 1);
+    if (taosAsyncExec(parseCsvChunksTask, pCtx, NULL) != 0) {
+      atomic_sub_fetch_32(&pCtx->ref, 1);
+      break;
+    }
+    numOfTasks++;
+  }
+
+  // the calling thread waits for the chunks taken by the tasks, not for the tasks which have not started
+  int32_t numOfTaken = 0;
+  parseCsvChunks(pCtx, &numOfTaken);
+  for (int32_t i = numOfTaken; i < pCtx->numOfChunks; ++i) {
+    tsem_wait(&pCtx->done);
+  }
+
+  parserDebug("0x%" PRIx64 " insert from csv. %d lines parsed on %d threads", pCxt->pComCxt->requestId, numOfLines,
+              numOfTasks + 1);
+
+  if (pCtx->errLine < numOfLines) {
+    code = pCtx->code;
+    tstrncpy(pCxt->msg.buf, pCtx->msg, pCxt->msg.len);
+  }
+
+  for (int32_t i = 0; i < pCtx->numOfChunks; ++i) {
+    SArray* pRows = pCtx->pChunkRows[i];
+    if (NULL == pRows) {
+      continue;
+    }
+    int32_t numOfRows = taosArrayGetSize(pRows);
+    if (TSDB_CODE_SUCCESS == code) {
+      for (int32_t j = 0; j < numOfRows; ++j) {
+        insCheckTableDataOrder(pTableCxt, TD_ROW_KEY(*(SRow**)taosArrayGet(pRows, j)));
+      }
+      if (NULL == taosArrayAddAll(pTableCxt->pData->aRowP, pRows)) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+      } else {
+        (*pNumOfRows) += numOfRows;
+        numOfRows = 0;
+      }
+    }
+    for (int32_t j = 0; j < numOfRows; ++j) {
+      tRowDestroy(*(SRow**)taosArrayGet(pRows, j));
+    }
+    taosArrayDestroy(pRows);
+  }
+
+  releaseCsvParseCtx(pCtx);
+  return code;
+}
+
+// parse the lines read from the csv file, until tsMaxInsertBatchRows rows are parsed
+static int32_t parseCsvLines(SInsertParseContext* pCxt, SVnodeModifyOpStmt* pStmt, SRowsDataContext rowsDataCxt,
+                             SArray* pLines, bool* pFirstLine, int32_t* pNumOfRows) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t numOfLines = taosArrayGetSize(pLines);
+  int32_t i = 0;
+  if (*pFirstLine && numOfLines > 0) {
+    code = parseCsvLine(pCxt, pStmt, rowsDataCxt, *(char**)taosArrayGet(pLines, 0), pFirstLine, pNumOfRows);
+    ++i;
+  }
+
+  if (TSDB_CODE_SUCCESS == code && !pStmt->stbSyntax && tsCsvParseThreads > 1 &&
+      numOfLines - i >= CSV_PARALLEL_PARSE_MIN_LINES) {
+    return parseCsvLinesParallel(pCxt, rowsDataCxt.pTableDataCxt, (char**)taosArrayGet(pLines, i), numOfLines - i,
+                                 pNumOfRows);
+  }
+
+  for (; i < numOfLines && TSDB_CODE_SUCCESS == code; ++i) {
+    code = parseCsvLine(pCxt, pStmt, rowsDataCxt, *(char**)taosArrayGet(pLines, i), pFirstLine, pNumOfRows);
+  }
+  return code;
+}
+
+// Split the complete lines of buf from pos to end, at most maxLines non-empty ones, and return the position after them.
+// The lines are terminated in place.
+static int64_t splitCsvLines(char* buf, int64_t pos, int64_t end, int32_t maxLines, SArray* pLines, bool* pFirstLine) {
+  while (pos < end && taosArrayGetSize(pLines) < maxLines) {
+    char*   pLine = buf + pos;
+    char*   pEnd = memchr(pLine, '\n', end - pos);
+    int64_t len = (NULL == pEnd) ? end - pos : pEnd - pLine;
+    pos += (NULL == pEnd) ? len : len + 1;
+
+    // the last line of the file may have no '\n'
+    if (NULL == pEnd && len > 0 && '\r' == pLine[len - 1]) {
+      --len;
+    }
+    pLine[len] = '\0';
+
+    if (0 == len) {
+      if (0 == taosArrayGetSize(pLines)) {
+        *pFirstLine = false;
+      }
+      continue;
+    }
+    if (NULL == taosArrayPush(pLines, &pLine)) {
+      return -1;
+    }
+  }
+  return pos;
+}
+
+// The csv file is read in blocks of CSV_READ_BUF_SIZE bytes, and the complete lines of a block are parsed together.
+// When tsMaxInsertBatchRows rows are parsed, the file is positioned after the last parsed line for the next batch.
 static int32_t parseCsvFile(SInsertParseContext* pCxt, SVnodeModifyOpStmt* pStmt, SRowsDataContext rowsDataCxt,
                             int32_t* pNumOfRows) {
   int32_t code = TSDB_CODE_SUCCESS;
   (*pNumOfRows) = 0;
-  char*   pLine = NULL;
-  int64_t readLen = 0;
   bool    firstLine = (pStmt->fileProcessing == false);
   pStmt->fileProcessing = false;
-  while (TSDB_CODE_SUCCESS == code && (readLen = taosGetLineFile(pStmt->fp, &pLine)) != -1) {
-    if (('\r' == pLine[readLen - 1]) || ('\n' == pLine[readLen - 1])) {
-      pLine[--readLen] = '\0';
-    }
 
-    if (readLen == 0) {
-      firstLine = false;
-      continue;
-    }
+  int64_t bufSize = CSV_READ_BUF_SIZE;
+  int64_t len = 0;      // bytes in buf
+  int64_t pos = 0;      // start of the lines not parsed
+  int64_t lineEnd = 0;  // end of the complete lines
+  bool    eof = false;
+  char*   buf = taosMemoryMalloc(bufSize + 1);  // one more byte to terminate the last line
+  SArray* pLines = taosArrayInit(CSV_PARSE_CHUNK_LINES, POINTER_BYTES);
+  if (NULL == buf || NULL == pLines) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
 
-    bool gotRow = false;
-    if (TSDB_CODE_SUCCESS == code) {
-      SToken token;
-      strtolower(pLine, pLine);
-      const char* pRow = pLine;
-      if (!pStmt->stbSyntax) {
-        code = parseOneRow(pCxt, (const char**)&pRow, rowsDataCxt.pTableDataCxt, &gotRow, &token);
-      } else {
-        STableDataCxt* pTableDataCxt = NULL;
-        code = parseOneStbRow(pCxt, pStmt, (const char**)&pRow, rowsDataCxt.pStbRowsCxt, &gotRow, &token, &pTableDataCxt);
-        if (code == TSDB_CODE_SUCCESS) {
-          SStbRowsDataContext* pStbRowsCxt = rowsDataCxt.pStbRowsCxt;
-          void* pData = pTableDataCxt;
-          taosHashPut(pStmt->pTableCxtHashObj, &pStbRowsCxt->pCtbMeta->uid, sizeof(pStbRowsCxt->pCtbMeta->uid), &pData,
-                      POINTER_BYTES);
+  while (TSDB_CODE_SUCCESS == code) {
+    if (pos == lineEnd) {
+      if (eof) {
+        break;
+      }
+
+      len -= pos;
+      memmove(buf, buf + pos, len);
+      pos = 0;
+      // a line longer than the buffer
+      if (len == bufSize) {
+        char* tmp = taosMemoryRealloc(buf, bufSize * 2 + 1);
+        if (NULL == tmp) {
+          code = TSDB_CODE_OUT_OF_MEMORY;
+          break;
         }
+        buf = tmp;
+        bufSize *= 2;
       }
-      if (code && firstLine) {
-        firstLine = false;
-        code = 0;
-        continue;
+
+      int64_t readLen = taosReadFile(pStmt->fp, buf + len, bufSize - len);
+      if (readLen < 0) {
+        code = TAOS_SYSTEM_ERROR(errno);
+        break;
       }
+      len += readLen;
+      eof = (len < bufSize);
+
+      lineEnd = len;
+      if (!eof) {
+        while (lineEnd > 0 && '\n' != buf[lineEnd - 1]) {
+          --lineEnd;
+        }
+      }
+      continue;
     }
 
-    if (TSDB_CODE_SUCCESS == code && gotRow) {
-      (*pNumOfRows)++;
+    taosArrayClear(pLines);
+    pos = splitCsvLines(buf, pos, lineEnd, tsMaxInsertBatchRows - (*pNumOfRows), pLines, &firstLine);
+    if (pos < 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
     }
+    code = parseCsvLines(pCxt, pStmt, rowsDataCxt, pLines, &firstLine, pNumOfRows);
 
     if (TSDB_CODE_SUCCESS == code && (*pNumOfRows) >= tsMaxInsertBatchRows) {
       pStmt->fileProcessing = true;
+      // the next batch starts from the lines not parsed
+      if (taosLSeekFile(pStmt->fp, pos - len, SEEK_CUR) < 0) {
+        code = TAOS_SYSTEM_ERROR(errno);
+      }
       break;
     }
-
-    firstLine = false;
   }
-  taosMemoryFree(pLine);
+  taosArrayDestroy(pLines);
+  taosMemoryFree(buf);
 
   parserDebug("0x%" PRIx64 " %d rows have been parsed", pCxt->pComCxt->requestId, *pNumOfRows);
 
@@ -2181,7 +2511,7 @@ static int32_t parseDataFromFile(SInsertParseContext* pCxt, SVnodeModifyOpStmt*
   } else {
     strncpy(filePathStr, pFilePath->z, pFilePath->n);
   }
-  pStmt->fp = taosOpenFile(filePathStr, TD_FILE_READ | TD_FILE_STREAM);
+  pStmt->fp = taosOpenFile(filePathStr, TD_FILE_READ);
   if (NULL == pStmt->fp) {
     return TAOS_SYSTEM_ERROR(errno);
   }
@@ -21,6 +21,7 @@
 #include "querynodes.h"
 #include "tRealloc.h"
 #include "tdatablock.h"
+#include "tlrucache.h"
 
 void qDestroyBoundColInfo(void* pInfo) {
   if (NULL == pInfo) {
@@ -32,6 +33,93 @@ void qDestroyBoundColInfo(void* pInfo) {
   taosMemoryFreeClear(pBoundInfo->pColIndex);
 }
 
+// the parsed [(tag1_name, ...)] TAGS (tag1_value, ...) clause of a child table, valid while the super table keeps its
+// uid and versions
+typedef struct SInsertShape {
+  char           stbFName[TSDB_TABLE_FNAME_LEN];
+  uint64_t       suid;
+  int32_t        sversion;
+  int32_t        tversion;
+  SVCreateTbReq* pCreateTbReq;
+  int32_t        len;
+  char           clause[];
+} SInsertShape;
+
+static void destroyInsertShape(const void* key, size_t keyLen, void* value, void* ud) {
+  SInsertShape* pShape = value;
+  tdDestroySVCreateTbReq(pShape->pCreateTbReq);
+  taosMemoryFree(pShape->pCreateTbReq);
+  taosMemoryFree(pShape);
+}
+
+void* qCreateInsertShapeCache(int32_t capacity) {
+  if (capacity <= 0) {
+    return NULL;
+  }
+
+  // each shape is charged as 1, so the capacity is the number of child tables
+  SLRUCache* pCache = taosLRUCacheInit(capacity, -1, .5);
+  if (NULL != pCache) {
+    taosLRUCacheSetStrictCapacity(pCache, false);
+  }
+  return pCache;
+}
+
+void qDestroyInsertShapeCache(void* pCache) {
+  if (NULL == pCache) {
+    return;
+  }
+
+  taosLRUCacheEraseUnrefEntries(pCache);
+  taosLRUCacheCleanup(pCache);
+}
+
+int32_t insGetInsertShape(void* pCache, const char* tbFName, const char* stbFName, const STableMeta* pStbMeta,
+                          const char* pSql, SVCreateTbReq** pCreateTbReq, int32_t* pLen) {
+  *pLen = 0;
+  LRUHandle* h = taosLRUCacheLookup(pCache, tbFName, strlen(tbFName));
+  if (NULL == h) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t       code = TSDB_CODE_SUCCESS;
+  SInsertShape* pShape = taosLRUCacheValue(pCache, h);
+  if (pShape->suid == pStbMeta->suid && pShape->sversion == pStbMeta->sversion &&
+      pShape->tversion == pStbMeta->tversion && 0 == strcmp(pShape->stbFName, stbFName) &&
+      0 == strncmp(pShape->clause, pSql, pShape->len)) {
+    code = cloneSVreateTbReq(pShape->pCreateTbReq, pCreateTbReq);
+    if (TSDB_CODE_SUCCESS == code) {
+      *pLen = pShape->len;
+    }
+  }
+
+  taosLRUCacheRelease(pCache, h, false);
+  return code;
+}
+
+// failures only leave the clause to be parsed again next time
+void insPutInsertShape(void* pCache, const char* tbFName, const char* stbFName, const STableMeta* pStbMeta,
+                       const char* pClause, int32_t len, SVCreateTbReq* pCreateTbReq) {
+  SInsertShape* pShape = taosMemoryCalloc(1, sizeof(SInsertShape) + len);
+  if (NULL == pShape) {
+    return;
+  }
+
+  tstrncpy(pShape->stbFName, stbFName, TSDB_TABLE_FNAME_LEN);
+  pShape->suid = pStbMeta->suid;
+  pShape->sversion = pStbMeta->sversion;
+  pShape->tversion = pStbMeta->tversion;
+  pShape->len = len;
+  memcpy(pShape->clause, pClause, len);
+  if (TSDB_CODE_SUCCESS != cloneSVreateTbReq(pCreateTbReq, &pShape->pCreateTbReq)) {
+    destroyInsertShape(NULL, 0, pShape, NULL);
+    return;
+  }
+
+  (void)taosLRUCacheInsert(pCache, tbFName, strlen(tbFName), pShape, 1, destroyInsertShape, NULL,
+                           TAOS_LRU_PRIORITY_LOW, NULL);
+}
+
 static char* tableNameGetPosition(SToken* pToken, char target) {
   bool inEscape = false;
   bool inQuote = false;
@@ -257,6 +257,15 @@ class MockCatalogServiceImpl {
     meta_[db][stbname]->vgs.emplace_back(vgroup);
   }
 
+  void setTableVersion(const string& db, const string& tbname, int32_t sversion, int32_t tversion) {
+    std::shared_ptr<MockTableMeta> table = getTableMeta(db, tbname);
+    if (!table) {
+      throw std::runtime_error("table not found");
+    }
+    table->schema->sversion = sversion;
+    table->schema->tversion = tversion;
+  }
+
   void showTables() const {
 // number of forward fills
 #define NOF(n) ((n) / 2)
@@ -686,6 +695,10 @@ void MockCatalogService::createSubTable(const string& db, const string& stbname,
   impl_->createSubTable(db, stbname, tbname, vgid);
 }
 
+void MockCatalogService::setTableVersion(const string& db, const string& tbname, int32_t sversion, int32_t tversion) {
+  impl_->setTableVersion(db, tbname, sversion, tversion);
+}
+
 void MockCatalogService::showTables() const { impl_->showTables(); }
 
 void MockCatalogService::createFunction(const string& func, int8_t funcType, int8_t outputType, int32_t outputLen,
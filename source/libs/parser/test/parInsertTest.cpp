@@ -14,8 +14,14 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 
+#include "mockCatalogService.h"
+#include "parInsertUtil.h"
+#include "parInt.h"
 #include "parTestUtil.h"
+#include "parser.h"
+#include "tmsg.h"
 
 using namespace std;
 
@@ -84,4 +90,313 @@ TEST_F(ParserInsertTest, autoCreateTableTest) {
       "st1s2 (ts, c1, c2) USING st1 TAGS(2, 'abc', now) VALUES (now+1s, 2, 'shanghai')");
 }
 
+namespace {
+
+// parse the insert and return the create table reqs of its submit reqs, encoded
+void parseCreateTbReqs(const string& sql, void* pInsertShapeCache, vector<string>* pReqs) {
+  char          msgBuf[1024] = {0};
+  SParseContext cxt = {0};
+  cxt.db = "test";
+  cxt.pUser = "wangxiaoyu";
+  cxt.enableSysInfo = true;
+  cxt.pSql = sql.c_str();
+  cxt.sqlLen = sql.length();
+  cxt.pMsg = msgBuf;
+  cxt.msgLen = sizeof(msgBuf);
+  cxt.svrVer = "3.0.0.0";
+  cxt.pInsertShapeCache = pInsertShapeCache;
+
+  SQuery* pQuery = nullptr;
+  ASSERT_EQ(parseInsertSql(&cxt, &pQuery, nullptr, nullptr), TSDB_CODE_SUCCESS) << msgBuf;
+
+  SVnodeModifyOpStmt* pStmt = (SVnodeModifyOpStmt*)pQuery->pRoot;
+  pReqs->clear();
+  for (size_t i = 0; i < taosArrayGetSize(pStmt->pDataBlocks); ++i) {
+    SVgDataBlocks* pVg = (SVgDataBlocks*)taosArrayGetP(pStmt->pDataBlocks, i);
+    SSubmitReq2    req = {0};
+    SDecoder       decoder = {0};
+    tDecoderInit(&decoder, (uint8_t*)pVg->pData + sizeof(SSubmitReq2Msg), pVg->size - sizeof(SSubmitReq2Msg));
+    ASSERT_EQ(tDecodeSubmitReq(&decoder, &req), TSDB_CODE_SUCCESS);
+    for (size_t j = 0; j < taosArrayGetSize(req.aSubmitTbData); ++j) {
+      SSubmitTbData* pTbData = (SSubmitTbData*)taosArrayGet(req.aSubmitTbData, j);
+      ASSERT_NE(pTbData->pCreateTbReq, nullptr);
+
+      char     buf[4096] = {0};
+      SEncoder encoder = {0};
+      tEncoderInit(&encoder, (uint8_t*)buf, sizeof(buf));
+      ASSERT_EQ(tEncodeSVCreateTbReq(&encoder, pTbData->pCreateTbReq), 0);
+      pReqs->push_back(string(buf, encoder.pos));
+      tEncoderClear(&encoder);
+    }
+    tDestroySubmitReq(&req, TSDB_MSG_FLG_DECODE);
+    tDecoderClear(&decoder);
+  }
+  qDestroyQuery(pQuery);
+}
+
+// whether the tags clause of the insert into st1s1 is taken from the cache with the current meta of st1
+bool insertShapeHit(void* pInsertShapeCache, const string& sql) {
+  SName tbName = {0};
+  SName stbName = {0};
+  char  tbFName[TSDB_TABLE_FNAME_LEN] = {0};
+  char  stbFName[TSDB_TABLE_FNAME_LEN] = {0};
+  tNameExtractFullName(toName(0, "test", "st1s1", &tbName), tbFName);
+  tNameExtractFullName(toName(0, "test", "st1", &stbName), stbFName);
+
+  STableMeta* pStbMeta = nullptr;
+  if (TSDB_CODE_SUCCESS != g_mockCatalogService->catalogGetTableMeta(&stbName, &pStbMeta)) {
+    return false;
+  }
+  // the parser keeps the uid of the super table as the suid of the meta it looks the cache up with
+  pStbMeta->suid = pStbMeta->uid;
+
+  // the clause starts right after the super table name
+  const char*    pClause = sql.c_str() + sql.find("USING st1") + strlen("USING st1");
+  SVCreateTbReq* pCreateTbReq = nullptr;
+  int32_t        len = 0;
+  int32_t        code = insGetInsertShape(pInsertShapeCache, tbFName, stbFName, pStbMeta, pClause, &pCreateTbReq, &len);
+  tdDestroySVCreateTbReq(pCreateTbReq);
+  taosMemoryFree(pCreateTbReq);
+  taosMemoryFree(pStbMeta);
+  return TSDB_CODE_SUCCESS == code && len > 0;
+}
+
+}  // namespace
+
+// the tags clauses of the repeated inserts are taken from the insert shape cache, and give the create table reqs of
+// parsing them
+TEST_F(ParserInsertTest, insertShapeCacheTest) {
+  void* pCache = qCreateInsertShapeCache(16);
+  ASSERT_NE(pCache, nullptr);
+
+  // a different clause of the same table replaces the cached one
+  const string sqls[] = {"INSERT INTO st1s1 USING st1 (tag1, tag2) TAGS(1, 'wxy') VALUES (now, 1, 'beijing')",
+                         "INSERT INTO st1s1 USING st1 (tag1, tag2) TAGS(2, 'wxy') TTL 10 VALUES (now, 2, 'shanghai')"};
+  vector<string> fresh;
+  vector<string> reqs;
+  for (const string& sql : sqls) {
+    parseCreateTbReqs(sql, nullptr, &fresh);
+    ASSERT_EQ(fresh.size(), 1);
+    EXPECT_FALSE(insertShapeHit(pCache, sql));
+
+    parseCreateTbReqs(sql, pCache, &reqs);
+    EXPECT_EQ(reqs, fresh);
+    EXPECT_TRUE(insertShapeHit(pCache, sql));
+
+    parseCreateTbReqs(sql, pCache, &reqs);
+    EXPECT_EQ(reqs, fresh);
+  }
+
+  // an alter of the tags or columns of the super table changes its versions, and the clause is parsed again
+  STableMeta* pStbMeta = nullptr;
+  SName       stbName = {0};
+  ASSERT_EQ(g_mockCatalogService->catalogGetTableMeta(toName(0, "test", "st1", &stbName), &pStbMeta), 0);
+  int32_t sversion = pStbMeta->sversion;
+  int32_t tversion = pStbMeta->tversion;
+  taosMemoryFree(pStbMeta);
+
+  int32_t versions[][2] = {{sversion, tversion + 1}, {sversion + 1, tversion + 1}};
+  for (auto& version : versions) {
+    g_mockCatalogService->setTableVersion("test", "st1", version[0], version[1]);
+    EXPECT_FALSE(insertShapeHit(pCache, sqls[1]));
+
+    parseCreateTbReqs(sqls[1], pCache, &reqs);
+    EXPECT_EQ(reqs, fresh);
+    EXPECT_TRUE(insertShapeHit(pCache, sqls[1]));
+  }
+  g_mockCatalogService->setTableVersion("test", "st1", sversion, tversion);
+
+  // the tag values given as now depend on the parse time, they are never cached
+  const string nowSql = "INSERT INTO st1s1 USING st1 TAGS(1, 'wxy', now) VALUES (now, 3, 'guangzhou')";
+  parseCreateTbReqs(nowSql, pCache, &reqs);
+  EXPECT_FALSE(insertShapeHit(pCache, nowSql));
+
+  qDestroyInsertShapeCache(pCache);
+}
+
+namespace {
+
+const char*   csvFile = TD_TMP_DIR_PATH "parser_insert_file_test.csv";
+const int64_t csvStartTs = 1700000000000;
+
+// write numOfLines lines of t1 to the csv file, the ones in badLines with an invalid c1
+void writeCsvFile(int32_t numOfLines, bool header, const vector<int32_t>& badLines = {}) {
+  TdFilePtr fp = taosOpenFile(csvFile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC | TD_FILE_STREAM);
+  ASSERT_NE(fp, nullptr);
+  if (header) {
+    taosFprintfFile(fp, "ts,c1,c2,c3,c4,c5\n");
+  }
+  for (int32_t i = 0; i < numOfLines; ++i) {
+    if (find(badLines.begin(), badLines.end(), i) != badLines.end()) {
+      taosFprintfFile(fp, "%" PRId64 ",bad%d,'Beijing%d',%d,%d.5,%d\n", csvStartTs + i, i, i, i * 3, i, i);
+    } else {
+      taosFprintfFile(fp, "%" PRId64 ",%d,'Beijing%d',%d,%d.5,%d\n", csvStartTs + i, i, i, i * 3, i, i);
+    }
+  }
+  taosCloseFile(&fp);
+}
+
+struct InsertFileResult {
+  int32_t        code;
+  string         msg;
+  int32_t        numOfBatches;
+  vector<string> rows;  // the encoded rows in the order of the submit reqs
+};
+
+void collectSubmitRows(SArray* pDataBlocks, vector<string>* pRows) {
+  for (size_t i = 0; i < taosArrayGetSize(pDataBlocks); ++i) {
+    SVgDataBlocks* pVg = (SVgDataBlocks*)taosArrayGetP(pDataBlocks, i);
+    SSubmitReq2    req = {0};
+    SDecoder       decoder = {0};
+    tDecoderInit(&decoder, (uint8_t*)pVg->pData + sizeof(SSubmitReq2Msg), pVg->size - sizeof(SSubmitReq2Msg));
+    ASSERT_EQ(tDecodeSubmitReq(&decoder, &req), TSDB_CODE_SUCCESS);
+    for (size_t j = 0; j < taosArrayGetSize(req.aSubmitTbData); ++j) {
+      SSubmitTbData* pTbData = (SSubmitTbData*)taosArrayGet(req.aSubmitTbData, j);
+      ASSERT_EQ(pTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT, 0);
+      for (size_t k = 0; k < taosArrayGetSize(pTbData->aRowP); ++k) {
+        SRow* pRow = *(SRow**)taosArrayGet(pTbData->aRowP, k);
+        pRows->push_back(string((const char*)pRow, pRow->len));
+      }
+    }
+    tDestroySubmitReq(&req, TSDB_MSG_FLG_DECODE);
+    tDecoderClear(&decoder);
+    taosMemoryFree(pVg->pData);
+    taosMemoryFree(pVg);
+  }
+  taosArrayDestroy(pDataBlocks);
+}
+
+// parse the insert from the csv file in batches of tsMaxInsertBatchRows rows, as the client continues it
+void parseInsertFile(int32_t parseThreads, int32_t maxBatchRows, InsertFileResult* pRes) {
+  int32_t csvParseThreads = tsCsvParseThreads;
+  int32_t maxInsertBatchRows = tsMaxInsertBatchRows;
+  tsCsvParseThreads = parseThreads;
+  tsMaxInsertBatchRows = maxBatchRows;
+
+  string        sql = string("insert into t1 file '") + csvFile + "'";
+  char          msgBuf[1024] = {0};
+  SParseContext cxt = {0};
+  cxt.db = "test";
+  cxt.pUser = "wangxiaoyu";
+  cxt.enableSysInfo = true;
+  cxt.pSql = sql.c_str();
+  cxt.sqlLen = sql.length();
+  cxt.pMsg = msgBuf;
+  cxt.msgLen = sizeof(msgBuf);
+  cxt.svrVer = "3.0.0.0";
+
+  SQuery* pQuery = nullptr;
+  pRes->numOfBatches = 0;
+  pRes->rows.clear();
+  while (1) {
+    pRes->code = parseInsertSql(&cxt, &pQuery, nullptr, nullptr);
+    if (TSDB_CODE_SUCCESS != pRes->code) {
+      break;
+    }
+    SVnodeModifyOpStmt* pStmt = (SVnodeModifyOpStmt*)pQuery->pRoot;
+    ++(pRes->numOfBatches);
+    collectSubmitRows(pStmt->pDataBlocks, &pRes->rows);
+    pStmt->pDataBlocks = nullptr;
+    if (!pStmt->fileProcessing) {
+      break;
+    }
+  }
+  pRes->msg = msgBuf;
+  qDestroyQuery(pQuery);
+
+  tsCsvParseThreads = csvParseThreads;
+  tsMaxInsertBatchRows = maxInsertBatchRows;
+}
+
+void checkRowKeys(const vector<string>& rows, int32_t numOfRows) {
+  ASSERT_EQ(rows.size(), numOfRows);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    ASSERT_EQ(((const SRow*)rows[i].data())->ts, csvStartTs + i);
+  }
+}
+
+}  // namespace
+
+// INSERT INTO tb_name FILE csv_file_path
+TEST_F(ParserInsertTest, fileTest) {
+  useDb("root", "test");
+
+  // a header and enough lines to be parsed on several threads
+  const char* pFile = TD_TMP_DIR_PATH "parser_insert_file_test.csv";
+  TdFilePtr   fp = taosOpenFile(pFile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC | TD_FILE_STREAM);
+  ASSERT_NE(fp, nullptr);
+  taosFprintfFile(fp, "ts,c1,c2,c3,c4,c5\n");
+  for (int32_t i = 0; i < 20000; ++i) {
+    taosFprintfFile(fp, "%" PRId64 ",%d,'Beijing%d',%d,%d.5,%d\n", (int64_t)1700000000000 + i, i, i, i * 3, i, i);
+  }
+  taosCloseFile(&fp);
+
+  run(string("INSERT INTO t1 FILE '") + pFile + "'");
+
+  taosRemoveFile(pFile);
+}
+
+// the lines parsed on several threads give the rows of parsing them one by one, in the same order
+TEST_F(ParserInsertTest, fileParallelTest) {
+  InsertFileResult serial;
+  InsertFileResult parallel;
+
+  // the header is skipped
+  writeCsvFile(20000, true);
+  parseInsertFile(1, INT32_MAX, &serial);
+  ASSERT_EQ(serial.code, TSDB_CODE_SUCCESS);
+  checkRowKeys(serial.rows, 20000);
+  parseInsertFile(4, INT32_MAX, &parallel);
+  ASSERT_EQ(parallel.code, TSDB_CODE_SUCCESS);
+  EXPECT_EQ(parallel.numOfBatches, 1);
+  EXPECT_TRUE(parallel.rows == serial.rows);
+
+  // without a header, the first line is a row
+  writeCsvFile(20000, false);
+  parseInsertFile(4, INT32_MAX, &parallel);
+  ASSERT_EQ(parallel.code, TSDB_CODE_SUCCESS);
+  EXPECT_TRUE(parallel.rows == serial.rows);
+
+  taosRemoveFile(csvFile);
+}
+
+// the first failed line is reported, even if a later chunk fails first
+TEST_F(ParserInsertTest, fileParallelErrorTest) {
+  InsertFileResult serial;
+  InsertFileResult parallel;
+
+  writeCsvFile(20000, true, {10000, 15000});
+  parseInsertFile(1, INT32_MAX, &serial);
+  EXPECT_NE(serial.code, TSDB_CODE_SUCCESS);
+  EXPECT_NE(serial.msg.find("bad10000"), string::npos);
+  parseInsertFile(4, INT32_MAX, &parallel);
+  EXPECT_EQ(parallel.code, serial.code);
+  EXPECT_EQ(parallel.msg, serial.msg);
+
+  writeCsvFile(20000, true, {15000, 19999});
+  parseInsertFile(4, INT32_MAX, &parallel);
+  EXPECT_NE(parallel.code, TSDB_CODE_SUCCESS);
+  EXPECT_NE(parallel.msg.find("bad15000"), string::npos);
+
+  taosRemoveFile(csvFile);
+}
+
+// each batch of maxInsertBatchRows rows continues from the line after the last parsed one
+TEST_F(ParserInsertTest, fileBatchTest) {
+  InsertFileResult result;
+
+  writeCsvFile(20000, true);
+  parseInsertFile(4, 9000, &result);
+  ASSERT_EQ(result.code, TSDB_CODE_SUCCESS);
+  EXPECT_EQ(result.numOfBatches, 3);
+  checkRowKeys(result.rows, 20000);
+
+  parseInsertFile(1, 4096, &result);
+  ASSERT_EQ(result.code, TSDB_CODE_SUCCESS);
+  EXPECT_EQ(result.numOfBatches, 5);
+  checkRowKeys(result.rows, 20000);
+
+  taosRemoveFile(csvFile);
+}
+
 }  // namespace ParserTest
@@ -29,6 +29,7 @@
 #include "os.h"
 #include "parTestUtil.h"
 #include "parToken.h"
+#include "query.h"
 
 namespace ParserTest {
 
@@ -39,9 +40,11 @@ class ParserEnv : public testing::Environment {
     initMetaDataEnv();
     generateMetaData();
     initLog(TD_TMP_DIR_PATH "td");
+    initTaskQueue();
   }
 
   virtual void TearDown() {
+    cleanupTaskQueue();
     destroyMetaDataEnv();
     taosCleanupKeywordsTable();
     fmFuncMgtDestroy();
@@ -128,6 +128,12 @@ static void execHelper(struct SSchedMsg* pSchedMsg) {
 }
 
 int32_t taosAsyncExec(__async_exec_fn_t execFn, void* execParam, int32_t* code) {
+  // waiting on the semaphores of a queue that is never initialized blocks forever
+  if (pTaskQueue.queueSize == 0) {
+    qError("task queue is not initialized");
+    return -1;
+  }
+
   SSchedMsg schedMsg = {0};
   schedMsg.fp = execHelper;
   schedMsg.ahandle = execFn;
@@ -98,7 +98,8 @@ typedef struct SFilterRange {
 
 typedef bool (*rangeCompFunc)(const void *, const void *, const void *, const void *, __compar_fn_t);
 typedef int32_t (*filter_desc_compare_func)(const void *, const void *);
-typedef bool (*filter_exec_func)(void *, int32_t, SColumnInfoData *, SColumnDataAgg *, int16_t, int32_t *);
+typedef int32_t (*filter_exec_func)(void *, int32_t, SColumnInfoData *, SColumnDataAgg *, int16_t, int32_t *, bool *);
+typedef void (*filter_range_kernel_func)(const void *, int32_t, const void *, const void *, int8_t, int8_t *);
 typedef int32_t (*filer_get_col_from_name)(void *, int32_t, char *, void **);
 
 typedef struct SFilterDataInfo {
@@ -245,28 +246,29 @@ typedef struct {
 } SFltSclColumnRange;
 
 struct SFilterInfo {
-  bool              scalarMode;
-  SFltScalarCtx     sclCtx;
-  uint32_t          options;
-  uint32_t          status;
-  uint32_t          unitSize;
-  uint32_t          unitNum;
-  uint32_t          groupNum;
-  uint32_t          colRangeNum;
-  SFilterFields     fields[FLD_TYPE_MAX];
-  SFilterGroup     *groups;
-  SFilterUnit      *units;
-  SFilterComUnit   *cunits;
-  uint8_t          *unitRes;    // result
-  uint8_t          *unitFlags;  // got result
-  SFilterRangeCtx **colRange;
-  filter_exec_func  func;
-  uint8_t           blkFlag;
-  uint32_t          blkGroupNum;
-  uint32_t         *blkUnits;
-  int8_t           *blkUnitRes;
-  void             *pTable;
-  SArray           *blkList;
+  bool                     scalarMode;
+  SFltScalarCtx            sclCtx;
+  uint32_t                 options;
+  uint32_t                 status;
+  uint32_t                 unitSize;
+  uint32_t                 unitNum;
+  uint32_t                 groupNum;
+  uint32_t                 colRangeNum;
+  SFilterFields            fields[FLD_TYPE_MAX];
+  SFilterGroup            *groups;
+  SFilterUnit             *units;
+  SFilterComUnit          *cunits;
+  uint8_t                 *unitRes;    // result
+  uint8_t                 *unitFlags;  // got result
+  SFilterRangeCtx        **colRange;
+  filter_exec_func         func;
+  filter_range_kernel_func rangeKernel;  // typed kernel of the single range unit, NULL if not available
+  uint8_t                  blkFlag;
+  uint32_t                 blkGroupNum;
+  uint32_t                *blkUnits;
+  int8_t                  *blkUnitRes;
+  void                    *pTable;
+  SArray                  *blkList;
 
   SFilterPCtx pctx;
 };
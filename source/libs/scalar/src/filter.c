@@ -3100,25 +3100,30 @@ _return:
   return TSDB_CODE_SUCCESS;
 }
 
-static FORCE_INLINE bool filterExecuteImplAll(void *info, int32_t numOfRows, SColumnInfoData *p, SColumnDataAgg *statis,
-                                              int16_t numOfCols, int32_t *numOfQualified) {
-  return true;
+static FORCE_INLINE int32_t filterExecuteImplAll(void *info, int32_t numOfRows, SColumnInfoData *p,
+                                                 SColumnDataAgg *statis, int16_t numOfCols, int32_t *numOfQualified,
+                                                 bool *keepAll) {
+  *keepAll = true;
+  return TSDB_CODE_SUCCESS;
 }
 
-static FORCE_INLINE bool filterExecuteImplEmpty(void *info, int32_t numOfRows, SColumnInfoData *p,
-                                                SColumnDataAgg *statis, int16_t numOfCols, int32_t *numOfQualified) {
-  return false;
+static FORCE_INLINE int32_t filterExecuteImplEmpty(void *info, int32_t numOfRows, SColumnInfoData *p,
+                                                   SColumnDataAgg *statis, int16_t numOfCols, int32_t *numOfQualified,
+                                                   bool *keepAll) {
+  *keepAll = false;
+  return TSDB_CODE_SUCCESS;
 }
 
-static FORCE_INLINE bool filterExecuteImplIsNull(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes,
-                                                 SColumnDataAgg *statis, int16_t numOfCols, int32_t *numOfQualified) {
+static FORCE_INLINE int32_t filterExecuteImplIsNull(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes,
+                                                    SColumnDataAgg *statis, int16_t numOfCols, int32_t *numOfQualified,
+                                                    bool *keepAll) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
-  bool         all = true;
+  *keepAll = true;
 
   int8_t *p = (int8_t *)pRes->pData;
 
-  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
-    return all;
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, keepAll) == 0) {
+    return TSDB_CODE_SUCCESS;
   }
 
   for (int32_t i = 0; i < numOfRows; ++i) {
@@ -3126,22 +3131,23 @@ static FORCE_INLINE bool filterExecuteImplIsNull(void *pinfo, int32_t numOfRows,
 
     p[i] = colDataIsNull((SColumnInfoData *)info->cunits[uidx].colData, 0, i, NULL);
     if (p[i] == 0) {
-      all = false;
+      *keepAll = false;
     } else {
       (*numOfQualified) += 1;
     }
   }
 
-  return all;
+  return TSDB_CODE_SUCCESS;
 }
 
-static FORCE_INLINE bool filterExecuteImplNotNull(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes,
-                                                  SColumnDataAgg *statis, int16_t numOfCols, int32_t *numOfQualified) {
+static FORCE_INLINE int32_t filterExecuteImplNotNull(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes,
+                                                     SColumnDataAgg *statis, int16_t numOfCols, int32_t *numOfQualified,
+                                                     bool *keepAll) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
-  bool         all = true;
+  *keepAll = true;
 
-  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
-    return all;
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, keepAll) == 0) {
+    return TSDB_CODE_SUCCESS;
   }
 
   int8_t *p = (int8_t *)pRes->pData;
@@ -3151,36 +3157,290 @@ static FORCE_INLINE bool filterExecuteImplNotNull(void *pinfo, int32_t numOfRows
 
     p[i] = !colDataIsNull((SColumnInfoData *)info->cunits[uidx].colData, 0, i, NULL);
     if (p[i] == 0) {
-      all = false;
+      *keepAll = false;
     } else {
       (*numOfQualified) += 1;
     }
   }
 
-  return all;
+  return TSDB_CODE_SUCCESS;
+}
+
+// Bounds of the range compare functions in gRangeCompare, indexed by the rfunc of filterGetRangeCompFuncFromOptrs.
+static void filterGetRangeKernelFlags(int8_t rfunc, int8_t *noLower, int8_t *lowerIncl, int8_t *noUpper,
+                                      int8_t *upperIncl) {
+  *noLower = (rfunc == 6 || rfunc == 7);
+  *noUpper = (rfunc == 4 || rfunc == 5);
+  *lowerIncl = (rfunc == 2 || rfunc == 3 || rfunc == 5);
+  *upperIncl = (rfunc == 1 || rfunc == 3 || rfunc == 7);
+}
+
+#define FLT_INT_EQUAL(_x, _y)   ((_x) == (_y))
+#define FLT_VAL_GREATER(_x, _y) ((_x) > (_y))
+
+// The typed counterpart of gRangeCompare with gDataCompare, p[i] is set to whether the i-th value is in the range.
+// _eq and _gt follow the compare function of the type, so that gt and eq may both be true for float and double as
+// FLT_EQUAL tolerates, and the range test is branch free.
+#define DEFINE_FILTER_RANGE_KERNEL(_name, _type, _eq, _gt)                                                     \
+  static void filterRangeKernel_##_name(const void *pData, int32_t numOfRows, const void *pLower,             \
+                                        const void *pUpper, int8_t rfunc, int8_t *p) {                         \
+    const _type *v = (const _type *)pData;                                                                     \
+    _type        lo = *(const _type *)pLower;                                                                  \
+    _type        hi = *(const _type *)pUpper;                                                                  \
+    int8_t       noLower, lowerIncl, noUpper, upperIncl;                                                       \
+    filterGetRangeKernelFlags(rfunc, &noLower, &lowerIncl, &noUpper, &upperIncl);                              \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                                  \
+      int8_t eqLo = _eq(v[i], lo), gtLo = _gt(v[i], lo);                                                       \
+      int8_t eqHi = _eq(v[i], hi), gtHi = _gt(v[i], hi);                                                       \
+      p[i] = (noLower | (eqLo & lowerIncl) | (gtLo & !eqLo)) & (noUpper | (eqHi & upperIncl) | (!gtHi & !eqHi)); \
+    }                                                                                                          \
+  }
+
+DEFINE_FILTER_RANGE_KERNEL(TINYINT, int8_t, FLT_INT_EQUAL, FLT_VAL_GREATER)
+DEFINE_FILTER_RANGE_KERNEL(SMALLINT, int16_t, FLT_INT_EQUAL, FLT_VAL_GREATER)
+DEFINE_FILTER_RANGE_KERNEL(INT, int32_t, FLT_INT_EQUAL, FLT_VAL_GREATER)
+DEFINE_FILTER_RANGE_KERNEL(BIGINT, int64_t, FLT_INT_EQUAL, FLT_VAL_GREATER)
+DEFINE_FILTER_RANGE_KERNEL(UTINYINT, uint8_t, FLT_INT_EQUAL, FLT_VAL_GREATER)
+DEFINE_FILTER_RANGE_KERNEL(USMALLINT, uint16_t, FLT_INT_EQUAL, FLT_VAL_GREATER)
+DEFINE_FILTER_RANGE_KERNEL(UINT, uint32_t, FLT_INT_EQUAL, FLT_VAL_GREATER)
+DEFINE_FILTER_RANGE_KERNEL(UBIGINT, uint64_t, FLT_INT_EQUAL, FLT_VAL_GREATER)
+DEFINE_FILTER_RANGE_KERNEL(FLOAT, float, FLT_EQUAL, FLT_VAL_GREATER)
+DEFINE_FILTER_RANGE_KERNEL(DOUBLE, double, FLT_EQUAL, FLT_VAL_GREATER)
+
+static FORCE_INLINE void filterMaskToBytes(int32_t mask, int32_t num, int8_t *p) {
+  for (int32_t k = 0; k < num; ++k) {
+    p[k] = (mask >> k) & 1;
+  }
+}
+
+// AVX2 versions of the kernels of the common types, the rows left are done by the scalar kernels. The masks are
+// combined as the scalar kernel does: lower = noLower | (eqLo & lowerIncl) | (gtLo & ~eqLo), upper is alike.
+#if __AVX2__
+#define FILTER_RANGE_MASK_AVX2(_or, _and, _andnot, _eqLo, _gtLo, _eqHi, _gtHi) \
+  _and(_or(noLowerM, _or(_and(_eqLo, lowerInclM), _andnot(_eqLo, _gtLo))),      \
+       _or(noUpperM, _or(_and(_eqHi, upperInclM), _andnot(_or(_eqHi, _gtHi), onesM))))
+
+#define FILTER_RANGE_FLAGS_AVX2(_vtype, _set1)                                                \
+  int8_t noLower, lowerIncl, noUpper, upperIncl;                                              \
+  filterGetRangeKernelFlags(rfunc, &noLower, &lowerIncl, &noUpper, &upperIncl);               \
+  _vtype onesM = _set1(-1);                                                                   \
+  _vtype noLowerM = _set1(noLower ? -1 : 0), lowerInclM = _set1(lowerIncl ? -1 : 0);          \
+  _vtype noUpperM = _set1(noUpper ? -1 : 0), upperInclM = _set1(upperIncl ? -1 : 0);
+#endif
+
+static void filterRangeKernelAVX2_BIGINT(const void *pData, int32_t numOfRows, const void *pLower,
+                                         const void *pUpper, int8_t rfunc, int8_t *p) {
+  const int64_t *v = (const int64_t *)pData;
+  int32_t        i = 0;
+
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDEnable) {
+    FILTER_RANGE_FLAGS_AVX2(__m256i, _mm256_set1_epi64x)
+    __m256i lo = _mm256_set1_epi64x(*(const int64_t *)pLower);
+    __m256i hi = _mm256_set1_epi64x(*(const int64_t *)pUpper);
+
+    for (; i + 4 <= numOfRows; i += 4) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(v + i));
+      __m256i m = FILTER_RANGE_MASK_AVX2(_mm256_or_si256, _mm256_and_si256, _mm256_andnot_si256,
+                                         _mm256_cmpeq_epi64(x, lo), _mm256_cmpgt_epi64(x, lo),
+                                         _mm256_cmpeq_epi64(x, hi), _mm256_cmpgt_epi64(x, hi));
+      filterMaskToBytes(_mm256_movemask_pd(_mm256_castsi256_pd(m)), 4, p + i);
+    }
+  }
+#endif
+
+  filterRangeKernel_BIGINT(v + i, numOfRows - i, pLower, pUpper, rfunc, p + i);
+}
+
+static void filterRangeKernelAVX2_INT(const void *pData, int32_t numOfRows, const void *pLower, const void *pUpper,
+                                      int8_t rfunc, int8_t *p) {
+  const int32_t *v = (const int32_t *)pData;
+  int32_t        i = 0;
+
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDEnable) {
+    FILTER_RANGE_FLAGS_AVX2(__m256i, _mm256_set1_epi32)
+    __m256i lo = _mm256_set1_epi32(*(const int32_t *)pLower);
+    __m256i hi = _mm256_set1_epi32(*(const int32_t *)pUpper);
+
+    for (; i + 8 <= numOfRows; i += 8) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(v + i));
+      __m256i m = FILTER_RANGE_MASK_AVX2(_mm256_or_si256, _mm256_and_si256, _mm256_andnot_si256,
+                                         _mm256_cmpeq_epi32(x, lo), _mm256_cmpgt_epi32(x, lo),
+                                         _mm256_cmpeq_epi32(x, hi), _mm256_cmpgt_epi32(x, hi));
+      filterMaskToBytes(_mm256_movemask_ps(_mm256_castsi256_ps(m)), 8, p + i);
+    }
+  }
+#endif
+
+  filterRangeKernel_INT(v + i, numOfRows - i, pLower, pUpper, rfunc, p + i);
+}
+
+static void filterRangeKernelAVX2_DOUBLE(const void *pData, int32_t numOfRows, const void *pLower,
+                                         const void *pUpper, int8_t rfunc, int8_t *p) {
+  const double *v = (const double *)pData;
+  int32_t       i = 0;
+
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDEnable) {
+    FILTER_RANGE_FLAGS_AVX2(__m256i, _mm256_set1_epi64x)
+    __m256d lo = _mm256_set1_pd(*(const double *)pLower);
+    __m256d hi = _mm256_set1_pd(*(const double *)pUpper);
+    __m256d tol = _mm256_set1_pd(FLT_COMPAR_TOL_FACTOR * FLT_EPSILON);
+    __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(INT64_MAX));
+
+    for (; i + 4 <= numOfRows; i += 4) {
+      __m256d x = _mm256_loadu_pd(v + i);
+      __m256i eqLo = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_and_pd(_mm256_sub_pd(x, lo), absMask), tol, _CMP_LE_OQ));
+      __m256i gtLo = _mm256_castpd_si256(_mm256_cmp_pd(x, lo, _CMP_GT_OQ));
+      __m256i eqHi = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_and_pd(_mm256_sub_pd(x, hi), absMask), tol, _CMP_LE_OQ));
+      __m256i gtHi = _mm256_castpd_si256(_mm256_cmp_pd(x, hi, _CMP_GT_OQ));
+      __m256i m = FILTER_RANGE_MASK_AVX2(_mm256_or_si256, _mm256_and_si256, _mm256_andnot_si256, eqLo, gtLo, eqHi, gtHi);
+      filterMaskToBytes(_mm256_movemask_pd(_mm256_castsi256_pd(m)), 4, p + i);
+    }
+  }
+#endif
+
+  filterRangeKernel_DOUBLE(v + i, numOfRows - i, pLower, pUpper, rfunc, p + i);
+}
+
+static void filterRangeKernelAVX2_FLOAT(const void *pData, int32_t numOfRows, const void *pLower,
+                                        const void *pUpper, int8_t rfunc, int8_t *p) {
+  const float *v = (const float *)pData;
+  int32_t      i = 0;
+
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDEnable) {
+    FILTER_RANGE_FLAGS_AVX2(__m256i, _mm256_set1_epi32)
+    __m256 lo = _mm256_set1_ps(*(const float *)pLower);
+    __m256 hi = _mm256_set1_ps(*(const float *)pUpper);
+    __m256 tol = _mm256_set1_ps(FLT_COMPAR_TOL_FACTOR * FLT_EPSILON);
+    __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(INT32_MAX));
+
+    for (; i + 8 <= numOfRows; i += 8) {
+      __m256  x = _mm256_loadu_ps(v + i);
+      __m256i eqLo = _mm256_castps_si256(_mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(x, lo), absMask), tol, _CMP_LE_OQ));
+      __m256i gtLo = _mm256_castps_si256(_mm256_cmp_ps(x, lo, _CMP_GT_OQ));
+      __m256i eqHi = _mm256_castps_si256(_mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(x, hi), absMask), tol, _CMP_LE_OQ));
+      __m256i gtHi = _mm256_castps_si256(_mm256_cmp_ps(x, hi, _CMP_GT_OQ));
+      __m256i m = FILTER_RANGE_MASK_AVX2(_mm256_or_si256, _mm256_and_si256, _mm256_andnot_si256, eqLo, gtLo, eqHi, gtHi);
+      filterMaskToBytes(_mm256_movemask_ps(_mm256_castsi256_ps(m)), 8, p + i);
+    }
+  }
+#endif
+
+  filterRangeKernel_FLOAT(v + i, numOfRows - i, pLower, pUpper, rfunc, p + i);
+}
+
+// Pick the typed kernel of the range unit, when its compare function is the plain one of the column type. NaN
+// bounds are left to the compare functions, which order NaN before any value.
+static filter_range_kernel_func filterGetRangeKernel(SFilterComUnit *cunit) {
+  __compar_fn_t func = gDataCompare[cunit->func];
+
+  switch (cunit->dataType) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      return (func == compareInt8Val) ? filterRangeKernel_TINYINT : NULL;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return (func == compareInt16Val) ? filterRangeKernel_SMALLINT : NULL;
+    case TSDB_DATA_TYPE_INT:
+      return (func == compareInt32Val) ? filterRangeKernelAVX2_INT : NULL;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return (func == compareInt64Val) ? filterRangeKernelAVX2_BIGINT : NULL;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return (func == compareUint8Val) ? filterRangeKernel_UTINYINT : NULL;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return (func == compareUint16Val) ? filterRangeKernel_USMALLINT : NULL;
+    case TSDB_DATA_TYPE_UINT:
+      return (func == compareUint32Val) ? filterRangeKernel_UINT : NULL;
+    case TSDB_DATA_TYPE_UBIGINT:
+      return (func == compareUint64Val) ? filterRangeKernel_UBIGINT : NULL;
+    case TSDB_DATA_TYPE_FLOAT:
+      if (func != compareFloatVal || isnan(*(float *)cunit->valData) || isnan(*(float *)cunit->valData2)) {
+        return NULL;
+      }
+      return filterRangeKernelAVX2_FLOAT;
+    case TSDB_DATA_TYPE_DOUBLE:
+      if (func != compareDoubleVal || isnan(*(double *)cunit->valData) || isnan(*(double *)cunit->valData2)) {
+        return NULL;
+      }
+      return filterRangeKernelAVX2_DOUBLE;
+    default:
+      return NULL;
+  }
 }
 
-bool filterExecuteImplRange(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
-                            int16_t numOfCols, int32_t *numOfQualified) {
+// Clear the result of the null rows with the null bitmap of the column, skipping a word of non-null rows at a time,
+// and return the number of qualified rows.
+static int32_t filterApplyNullBitmap(SColumnInfoData *pData, int32_t numOfRows, int8_t *p) {
+  const uint8_t *bm = pData->hasNull ? (const uint8_t *)pData->nullbitmap : NULL;
+
+  if (bm != NULL) {
+    int32_t len = BitmapLen(numOfRows);
+    for (int32_t w = 0; w < len; w += 8) {
+      int32_t end = TMIN(w + 8, len);
+      if (end - w == 8) {
+        uint64_t word = 0;
+        memcpy(&word, bm + w, sizeof(word));
+        if (word == 0) {
+          continue;
+        }
+      }
+
+      for (int32_t j = w; j < end; ++j) {
+        if (bm[j] == 0) {
+          continue;
+        }
+        for (int32_t k = 0; k < 8 && (j << NBIT) + k < numOfRows; ++k) {
+          if (bm[j] & (1u << (7u - k))) {
+            p[(j << NBIT) + k] = 0;
+          }
+        }
+      }
+    }
+  }
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    num += p[i];
+  }
+
+  return num;
+}
+
+int32_t filterExecuteImplRange(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                               int16_t numOfCols, int32_t *numOfQualified, bool *keepAll) {
   SFilterInfo  *info = (SFilterInfo *)pinfo;
-  bool          all = true;
   uint16_t      dataSize = info->cunits[0].dataSize;
   rangeCompFunc rfunc = gRangeCompare[info->cunits[0].rfunc];
   void         *valData = info->cunits[0].valData;
   void         *valData2 = info->cunits[0].valData2;
   __compar_fn_t func = gDataCompare[info->cunits[0].func];
 
-  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
-    return all;
+  *keepAll = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, keepAll) == 0) {
+    return TSDB_CODE_SUCCESS;
   }
 
   int8_t *p = (int8_t *)pRes->pData;
 
+  if (info->rangeKernel != NULL) {
+    SColumnInfoData *pData = info->cunits[0].colData;
+    (*info->rangeKernel)(pData->pData, numOfRows, valData, valData2, info->cunits[0].rfunc, p);
+
+    int32_t num = filterApplyNullBitmap(pData, numOfRows, p);
+    (*numOfQualified) += num;
+    *keepAll = (num == numOfRows);
+    return TSDB_CODE_SUCCESS;
+  }
+
   for (int32_t i = 0; i < numOfRows; ++i) {
     SColumnInfoData *pData = info->cunits[0].colData;
 
     if (colDataIsNull_s(pData, i)) {
-      all = false;
+      *keepAll = false;
       p[i] = 0;
       continue;
     }
@@ -3189,31 +3449,71 @@ bool filterExecuteImplRange(void *pinfo, int32_t numOfRows, SColumnInfoData *pRe
     p[i] = (*rfunc)(colData, colData, valData, valData2, func);
 
     if (p[i] == 0) {
-      all = false;
+      *keepAll = false;
     } else {
       (*numOfQualified)++;
     }
   }
 
-  return all;
+  return TSDB_CODE_SUCCESS;
 }
 
-bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
-                           int16_t numOfCols, int32_t *numOfQualified) {
+// The buffer that the nchar values of the match/nmatch units are converted to mbs in, allocated once per block
+// rather than once per row. *pBuf is NULL if there is no such unit.
+static int32_t filterMallocMbsBuf(SFilterInfo *info, char **pBuf) {
+  int32_t size = 0;
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    SFilterComUnit *cunit = &info->cunits[i];
+    if (cunit->dataType == TSDB_DATA_TYPE_NCHAR && (cunit->optr == OP_TYPE_MATCH || cunit->optr == OP_TYPE_NMATCH)) {
+      size = TMAX(size, cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE);
+    }
+  }
+
+  *pBuf = NULL;
+  if (size > 0) {
+    *pBuf = taosMemoryCalloc(size, 1);
+    if (*pBuf == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// compare the nchar value of a match/nmatch unit after converting it to mbs in newColData
+static FORCE_INLINE int8_t filterDoCompareNcharMatch(SFilterComUnit *cunit, void *colData, char *newColData,
+                                                     int8_t res) {
+  int32_t len = taosUcs4ToMbs((TdUcs4 *)varDataVal(colData), varDataLen(colData), varDataVal(newColData));
+  if (len < 0) {
+    qError("castConvert1 taosUcs4ToMbs error");
+    return res;
+  }
+
+  varDataSetLen(newColData, len);
+  return filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
+}
+
+int32_t filterExecuteImplMisc(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                              int16_t numOfCols, int32_t *numOfQualified, bool *keepAll) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
-  bool         all = true;
+  *keepAll = true;
 
-  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
-    return all;
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, keepAll) == 0) {
+    return TSDB_CODE_SUCCESS;
   }
 
   int8_t *p = (int8_t *)pRes->pData;
+  char   *newColData = NULL;
+  int32_t code = filterMallocMbsBuf(info, &newColData);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
 
   for (int32_t i = 0; i < numOfRows; ++i) {
     uint32_t uidx = info->groups[0].unitIdxs[0];
     if (colDataIsNull_s((SColumnInfoData *)info->cunits[uidx].colData, i)) {
       p[i] = 0;
-      all = false;
+      *keepAll = false;
       continue;
     }
 
@@ -3221,41 +3521,38 @@ bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes
     // match/nmatch for nchar type need convert from ucs4 to mbs
     if (info->cunits[uidx].dataType == TSDB_DATA_TYPE_NCHAR &&
         (info->cunits[uidx].optr == OP_TYPE_MATCH || info->cunits[uidx].optr == OP_TYPE_NMATCH)) {
-      char   *newColData = taosMemoryCalloc(info->cunits[uidx].dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
-      int32_t len = taosUcs4ToMbs((TdUcs4 *)varDataVal(colData), varDataLen(colData), varDataVal(newColData));
-      if (len < 0) {
-        qError("castConvert1 taosUcs4ToMbs error");
-      } else {
-        varDataSetLen(newColData, len);
-        p[i] = filterDoCompare(gDataCompare[info->cunits[uidx].func], info->cunits[uidx].optr, newColData,
-                               info->cunits[uidx].valData);
-      }
-      taosMemoryFreeClear(newColData);
+      p[i] = filterDoCompareNcharMatch(&info->cunits[uidx], colData, newColData, p[i]);
     } else {
       p[i] = filterDoCompare(gDataCompare[info->cunits[uidx].func], info->cunits[uidx].optr, colData,
                              info->cunits[uidx].valData);
     }
 
     if (p[i] == 0) {
-      all = false;
+      *keepAll = false;
     } else {
       (*numOfQualified) += 1;
     }
   }
 
-  return all;
+  taosMemoryFree(newColData);
+  return TSDB_CODE_SUCCESS;
 }
 
-bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis, int16_t numOfCols,
-                       int32_t *numOfQualified) {
+int32_t filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                          int16_t numOfCols, int32_t *numOfQualified, bool *keepAll) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
-  bool         all = true;
+  *keepAll = true;
 
-  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
-    return all;
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, keepAll) == 0) {
+    return TSDB_CODE_SUCCESS;
   }
 
   int8_t *p = (int8_t *)pRes->pData;
+  char   *newColData = NULL;
+  int32_t code = filterMallocMbsBuf(info, &newColData);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
 
   for (int32_t i = 0; i < numOfRows; ++i) {
     // FILTER_UNIT_CLR_F(info);
@@ -3289,15 +3586,7 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
           } else {
             if (cunit->dataType == TSDB_DATA_TYPE_NCHAR &&
                 (cunit->optr == OP_TYPE_MATCH || cunit->optr == OP_TYPE_NMATCH)) {
-              char   *newColData = taosMemoryCalloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
-              int32_t len = taosUcs4ToMbs((TdUcs4 *)varDataVal(colData), varDataLen(colData), varDataVal(newColData));
-              if (len < 0) {
-                qError("castConvert1 taosUcs4ToMbs error");
-              } else {
-                varDataSetLen(newColData, len);
-                p[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
-              }
-              taosMemoryFreeClear(newColData);
+              p[i] = filterDoCompareNcharMatch(cunit, colData, newColData, p[i]);
             } else {
               p[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
             }
@@ -3318,13 +3607,14 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
     }
 
     if (p[i] == 0) {
-      all = false;
+      *keepAll = false;
     } else {
       (*numOfQualified) += 1;
     }
   }
 
-  return all;
+  taosMemoryFree(newColData);
+  return TSDB_CODE_SUCCESS;
 }
 
 int32_t filterSetExecFunc(SFilterInfo *info) {
@@ -3355,6 +3645,7 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
 
   if (info->cunits[0].rfunc >= 0) {
     info->func = filterExecuteImplRange;
+    info->rangeKernel = filterGetRangeKernel(&info->cunits[0]);
     return TSDB_CODE_SUCCESS;
   }
 
@@ -4733,7 +5024,11 @@ int32_t filterExecute(SFilterInfo *info, SSDataBlock *pSrc, SColumnInfoData **p,
     return TSDB_CODE_APP_ERROR;
   }
 
-  bool keepAll = (*info->func)(info, pSrc->info.rows, *p, statis, numOfCols, &output.numOfQualified);
+  bool keepAll = false;
+  code = (*info->func)(info, pSrc->info.rows, *p, statis, numOfCols, &output.numOfQualified, &keepAll);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
 
   // todo this should be return during filter procedure
   if (keepAll) {
@@ -1145,6 +1145,250 @@ static void doReleaseVec(SColumnInfoData *pCol, int32_t type) {
   }
 }
 
+// rows converted to double and combined at a time by the typed arithmetic kernels, so the batch stays in L1 cache
+#define VECTOR_MATH_BATCH_ROWS 1024
+
+typedef void (*_loadDoubleValue_fn_t)(const void *src, int32_t start, int32_t num, double *dst);
+
+#define DEFINE_VECTOR_LOAD_DOUBLE(_name, _type)                                                       \
+  static void vectorLoadDouble_##_name(const void *src, int32_t start, int32_t num, double *dst) { \
+    const _type *p = (const _type *)src + start;                                                     \
+    for (int32_t j = 0; j < num; ++j) {                                                              \
+      dst[j] = (double)p[j];                                                                         \
+    }                                                                                                \
+  }
+
+// _load converts the 4 values at p + j into a __m256d
+#if __AVX2__
+#define DEFINE_VECTOR_LOAD_DOUBLE_AVX2(_name, _type, _load)                                           \
+  static void vectorLoadDouble_##_name(const void *src, int32_t start, int32_t num, double *dst) { \
+    const _type *p = (const _type *)src + start;                                                     \
+    int32_t      j = 0;                                                                              \
+    if (tsAVX2Enable && tsSIMDEnable) {                                                              \
+      for (; j + 4 <= num; j += 4) {                                                                 \
+        _mm256_storeu_pd(dst + j, _load);                                                            \
+      }                                                                                              \
+    }                                                                                                \
+    for (; j < num; ++j) {                                                                           \
+      dst[j] = (double)p[j];                                                                         \
+    }                                                                                                \
+  }
+#else
+#define DEFINE_VECTOR_LOAD_DOUBLE_AVX2(_name, _type, _load) DEFINE_VECTOR_LOAD_DOUBLE(_name, _type)
+#endif
+
+static FORCE_INLINE int32_t vectorLoad4Bytes(const void *p) {
+  int32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+DEFINE_VECTOR_LOAD_DOUBLE_AVX2(TINYINT, int8_t,
+                               _mm256_cvtepi32_pd(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(vectorLoad4Bytes(p + j)))))
+DEFINE_VECTOR_LOAD_DOUBLE_AVX2(UTINYINT, uint8_t,
+                               _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(vectorLoad4Bytes(p + j)))))
+DEFINE_VECTOR_LOAD_DOUBLE_AVX2(SMALLINT, int16_t,
+                               _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(p + j)))))
+DEFINE_VECTOR_LOAD_DOUBLE_AVX2(USMALLINT, uint16_t,
+                               _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(p + j)))))
+DEFINE_VECTOR_LOAD_DOUBLE_AVX2(INT, int32_t, _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)(p + j))))
+DEFINE_VECTOR_LOAD_DOUBLE_AVX2(FLOAT, float, _mm256_cvtps_pd(_mm_loadu_ps(p + j)))
+// AVX2 has no conversion of 32 bits unsigned and 64 bits integers to double
+DEFINE_VECTOR_LOAD_DOUBLE(UINT, uint32_t)
+DEFINE_VECTOR_LOAD_DOUBLE(BIGINT, int64_t)
+DEFINE_VECTOR_LOAD_DOUBLE(UBIGINT, uint64_t)
+DEFINE_VECTOR_LOAD_DOUBLE(BOOL, bool)
+
+// the typed counterpart of getVectorDoubleValueFn, NULL for the types that are left to the generic path
+static _loadDoubleValue_fn_t getVectorLoadDoubleFn(int32_t srcType) {
+  switch (srcType) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return vectorLoadDouble_TINYINT;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return vectorLoadDouble_UTINYINT;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return vectorLoadDouble_SMALLINT;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return vectorLoadDouble_USMALLINT;
+    case TSDB_DATA_TYPE_INT:
+      return vectorLoadDouble_INT;
+    case TSDB_DATA_TYPE_UINT:
+      return vectorLoadDouble_UINT;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return vectorLoadDouble_BIGINT;
+    case TSDB_DATA_TYPE_UBIGINT:
+      return vectorLoadDouble_UBIGINT;
+    case TSDB_DATA_TYPE_FLOAT:
+      return vectorLoadDouble_FLOAT;
+    case TSDB_DATA_TYPE_BOOL:
+      return vectorLoadDouble_BOOL;
+    default:
+      return NULL;
+  }
+}
+
+// output = left op right, or (left - right) * factor for the subtraction of a constant. right is NULL for a constant
+static void vectorMathDoubleKernel(const double *left, const double *right, double rightVal, double *output,
+                                   int32_t num, int32_t optr, int32_t factor) {
+  int32_t j = 0;
+
+#if __AVX2__
+  if (tsAVX2Enable && tsSIMDEnable) {
+    __m256d c = _mm256_set1_pd(rightVal);
+    __m256d f = _mm256_set1_pd((double)factor);
+    for (; j + 4 <= num; j += 4) {
+      __m256d l = _mm256_loadu_pd(left + j);
+      __m256d r = (right == NULL) ? c : _mm256_loadu_pd(right + j);
+      __m256d v;
+      if (optr == OP_TYPE_ADD) {
+        v = _mm256_add_pd(l, r);
+      } else if (optr == OP_TYPE_SUB) {
+        v = (right == NULL) ? _mm256_mul_pd(_mm256_sub_pd(l, r), f) : _mm256_sub_pd(l, r);
+      } else {
+        v = _mm256_mul_pd(l, r);
+      }
+      _mm256_storeu_pd(output + j, v);
+    }
+  }
+#endif
+
+  for (; j < num; ++j) {
+    double r = (right == NULL) ? rightVal : right[j];
+    if (optr == OP_TYPE_ADD) {
+      output[j] = left[j] + r;
+    } else if (optr == OP_TYPE_SUB) {
+      output[j] = (right == NULL) ? (left[j] - r) * factor : left[j] - r;
+    } else {
+      output[j] = left[j] * r;
+    }
+  }
+}
+
+// Merge the null bitmaps of the inputs into the output a word at a time, and zero the output of the null rows as
+// colDataSetNULL does. pRightCol is NULL for a constant.
+static void vectorMathMergeNull(SColumnInfoData *pLeftCol, SColumnInfoData *pRightCol, SColumnInfoData *pOutputCol,
+                                int32_t numOfRows) {
+  const uint8_t *lbm = (pLeftCol->hasNull) ? (const uint8_t *)pLeftCol->nullbitmap : NULL;
+  const uint8_t *rbm = (pRightCol != NULL && pRightCol->hasNull) ? (const uint8_t *)pRightCol->nullbitmap : NULL;
+  if (lbm == NULL && rbm == NULL) {
+    return;
+  }
+
+  uint8_t *obm = (uint8_t *)pOutputCol->nullbitmap;
+  double  *output = (double *)pOutputCol->pData;
+  int32_t  len = BitmapLen(numOfRows);
+  bool     hasNull = false;
+
+  for (int32_t w = 0; w < len; w += 8) {
+    int32_t end = TMIN(w + 8, len);
+    if (end - w == 8) {
+      uint64_t lw = 0, rw = 0;
+      if (lbm) memcpy(&lw, lbm + w, sizeof(lw));
+      if (rbm) memcpy(&rw, rbm + w, sizeof(rw));
+      if ((lw | rw) == 0) {
+        continue;
+      }
+    }
+
+    for (int32_t j = w; j < end; ++j) {
+      uint8_t bm = (lbm ? lbm[j] : 0) | (rbm ? rbm[j] : 0);
+      if (j == len - 1 && (numOfRows & 7) != 0) {
+        bm &= (uint8_t)(0xFF << (8 - (numOfRows & 7)));  // bits beyond numOfRows
+      }
+      if (bm == 0) {
+        continue;
+      }
+
+      obm[j] |= bm;
+      for (int32_t k = 0; k < 8; ++k) {
+        if (bm & (1u << (7u - k))) {
+          output[(j << NBIT) + k] = 0;
+        }
+      }
+      hasNull = true;
+    }
+  }
+
+  if (hasNull) {
+    pOutputCol->hasNull = true;
+  }
+}
+
+// Add, subtract or multiply two numeric columns, or a numeric column and a constant, with the typed kernels above
+// instead of fetching each value through getVectorDoubleValueFn. Only ascending scans into a double output are
+// handled, false is returned for the others and for json or var data types, which are left to the generic path.
+static bool vectorMathTyped(SScalarParam *pLeft, SScalarParam *pRight, SColumnInfoData *pLeftCol,
+                            SColumnInfoData *pRightCol, SColumnInfoData *pOutputCol, int32_t step, int32_t optr) {
+  int32_t numOfRows = TMAX(pLeft->numOfRows, pRight->numOfRows);
+  int32_t factor = 1;
+  bool    isConst = false;
+
+  if (pLeft->numOfRows != pRight->numOfRows) {
+    if (pLeft->numOfRows == 1) {  // the constant is always on the right, as the helpers of the generic path do
+      TSWAP(pLeftCol, pRightCol);
+      factor = -1;
+    } else if (pRight->numOfRows != 1) {
+      return false;
+    }
+    isConst = true;
+  }
+
+  _loadDoubleValue_fn_t loadLeftFn = getVectorLoadDoubleFn(pLeftCol->info.type);
+  _loadDoubleValue_fn_t loadRightFn = getVectorLoadDoubleFn(pRightCol->info.type);
+  bool                  isDoubleLeft = (pLeftCol->info.type == TSDB_DATA_TYPE_DOUBLE);
+  bool                  isDoubleRight = (pRightCol->info.type == TSDB_DATA_TYPE_DOUBLE);
+
+  if (step != 1 || pOutputCol->info.type != TSDB_DATA_TYPE_DOUBLE || (loadLeftFn == NULL && !isDoubleLeft) ||
+      (loadRightFn == NULL && !isDoubleRight)) {
+    return false;
+  }
+
+  double rightVal = 0;
+  if (isConst) {
+    if (IS_HELPER_NULL(pRightCol, 0)) {
+      colDataSetNNULL(pOutputCol, 0, numOfRows);
+      return true;
+    }
+
+    if (isDoubleRight) {
+      rightVal = *(double *)pRightCol->pData;
+    } else {
+      loadRightFn(pRightCol->pData, 0, 1, &rightVal);
+    }
+  }
+
+  double  leftBuf[VECTOR_MATH_BATCH_ROWS];
+  double  rightBuf[VECTOR_MATH_BATCH_ROWS];
+  double *output = (double *)pOutputCol->pData;
+
+  for (int32_t start = 0; start < numOfRows; start += VECTOR_MATH_BATCH_ROWS) {
+    int32_t       num = TMIN(VECTOR_MATH_BATCH_ROWS, numOfRows - start);
+    const double *left = leftBuf;
+    const double *right = NULL;
+
+    if (isDoubleLeft) {
+      left = (const double *)pLeftCol->pData + start;
+    } else {
+      loadLeftFn(pLeftCol->pData, start, num, leftBuf);
+    }
+
+    if (!isConst) {
+      if (isDoubleRight) {
+        right = (const double *)pRightCol->pData + start;
+      } else {
+        loadRightFn(pRightCol->pData, start, num, rightBuf);
+        right = rightBuf;
+      }
+    }
+
+    vectorMathDoubleKernel(left, right, rightVal, output + start, num, optr, factor);
+  }
+
+  vectorMathMergeNull(pLeftCol, isConst ? NULL : pRightCol, pOutputCol, numOfRows);
+  return true;
+}
+
 void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut, int32_t _ord) {
   SColumnInfoData *pOutputCol = pOut->columnData;
 
@@ -1185,7 +1429,7 @@ void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) + getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     }
-  } else {
+  } else if (!vectorMathTyped(pLeft, pRight, pLeftCol, pRightCol, pOutputCol, step, OP_TYPE_ADD)) {
     double              *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1286,7 +1530,7 @@ void vectorMathSub(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) - getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     }
-  } else {
+  } else if (!vectorMathTyped(pLeft, pRight, pLeftCol, pRightCol, pOutputCol, step, OP_TYPE_SUB)) {
     double              *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1346,7 +1590,9 @@ void vectorMathMultiply(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
   double *output = (double *)pOutputCol->pData;
-  if (pLeft->numOfRows == pRight->numOfRows) {
+  if (vectorMathTyped(pLeft, pRight, pLeftCol, pRightCol, pOutputCol, step, OP_TYPE_MULTI)) {
+    // done by the typed kernels
+  } else if (pLeft->numOfRows == pRight->numOfRows) {
     for (; i < pRight->numOfRows && i >= 0; i += step, output += 1) {
       if (IS_NULL) {
         colDataSetNULL(pOutputCol, i);
@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -38,6 +39,7 @@
 #include "scalar.h"
 #include "stub.h"
 #include "taos.h"
+#include "tcompare.h"
 #include "tdatablock.h"
 #include "tdef.h"
 #include "tglobal.h"
@@ -1341,6 +1343,178 @@ TEST(scalarModelogicTest, diff_columns_or_and_or) {
 }
 #endif
 
+namespace {
+
+// the filter of "lowerOp lower and upperOp upper" on the last column of src, a bound is not set if its op is 0
+SNode *flttMakeRangeNode(SSDataBlock **src, int32_t type, int32_t rowNum, void *value, EOperatorType lowerOp,
+                         void *lower, EOperatorType upperOp, void *upper) {
+  SNode  *list[2] = {0};
+  int32_t num = 0;
+  SNode  *pCol = NULL;
+  flttMakeColumnNode(&pCol, src, type, tDataTypes[type].bytes, rowNum, value);
+
+  // both bounds are on the same column, so that they are merged into one range unit
+  EOperatorType ops[2] = {lowerOp, upperOp};
+  void         *bounds[2] = {lower, upper};
+  for (int32_t i = 0; i < 2; ++i) {
+    if (ops[i] == 0) {
+      continue;
+    }
+
+    SNode *pLeft = nodesCloneNode(pCol), *pRight = NULL;
+    flttMakeValueNode(&pRight, type, bounds[i]);
+    flttMakeOpNode(&list[num++], ops[i], TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+  }
+
+  nodesDestroyNode(pCol);
+  if (num == 1) {
+    return list[0];
+  }
+
+  SNode *logicNode = NULL;
+  flttMakeLogicNode(&logicNode, LOGIC_COND_TYPE_AND, list, num);
+  return logicNode;
+}
+
+// execute the filter with the generic compare functions, the scalar kernel and the AVX2 kernel if the cpu has it
+void flttCheckRangeFilter(SSDataBlock *src, SNode *pNode, bool withKernel, const int8_t *eRes, int32_t rowNum) {
+  SFilterInfo *filter = NULL;
+  ASSERT_EQ(filterInitFromNode(pNode, &filter, 0), 0);
+
+  SFilterColumnParam param = {(int32_t)taosArrayGetSize(src->pDataBlock), src->pDataBlock};
+  ASSERT_EQ(filterSetDataFromSlotId(filter, &param), 0);
+  ASSERT_EQ(filter->rangeKernel != NULL, withKernel);
+
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+
+  char                     simdEnable = tsSIMDEnable, avx2Enable = tsAVX2Enable;
+  filter_range_kernel_func kernel = filter->rangeKernel;
+  for (int32_t mode = 0; mode < 3; ++mode) {
+    filter->rangeKernel = (mode == 0) ? NULL : kernel;
+    tsSIMDEnable = (mode == 2);
+    tsAVX2Enable = (mode == 2) ? avx2 : 0;
+
+    SColumnInfoData *pRes = NULL;
+    int32_t          status = 0;
+    ASSERT_EQ(filterExecute(filter, src, &pRes, NULL, (int16_t)param.numOfCols, &status), 0);
+    for (int32_t i = 0; i < rowNum; ++i) {
+      ASSERT_EQ(((int8_t *)pRes->pData)[i], eRes[i]) << "mode " << mode << ", row " << i;
+    }
+
+    colDataDestroy(pRes);
+    taosMemoryFree(pRes);
+  }
+
+  filter->rangeKernel = kernel;
+  tsSIMDEnable = simdEnable;
+  tsAVX2Enable = avx2Enable;
+  filterFreeInfo(filter);
+}
+
+typedef struct SFlttRange {
+  EOperatorType lowerOp;
+  EOperatorType upperOp;
+} SFlttRange;
+
+const std::vector<SFlttRange> flttBoundedRanges = {{OP_TYPE_GREATER_EQUAL, OP_TYPE_LOWER_THAN},
+                                                   {OP_TYPE_GREATER_THAN, OP_TYPE_LOWER_EQUAL},
+                                                   {OP_TYPE_GREATER_EQUAL, OP_TYPE_LOWER_EQUAL},
+                                                   {OP_TYPE_GREATER_THAN, (EOperatorType)0},
+                                                   {(EOperatorType)0, OP_TYPE_LOWER_THAN}};
+
+// values around the bounds within and beyond the FLT_EQUAL tolerance, NaN and infinity, and a null every 5 rows
+template <class T>
+void flttCheckFloatRange(int32_t type, __compar_fn_t cmp, T lower, T upper, const std::vector<SFlttRange> &ranges) {
+  const int32_t rowNum = 37;
+  const T       tol = FLT_COMPAR_TOL_FACTOR * FLT_EPSILON;
+  const T       values[] = {lower - 2 * tol, lower - tol / 2, lower, lower + tol / 2, lower + 2 * tol,
+                            (lower + upper) / 2, upper - 2 * tol, upper - tol / 2, upper, upper + tol / 2,
+                            upper + 2 * tol, (T)NAN, (T)INFINITY, (T)-INFINITY, 0, upper + 1};
+  const int32_t numOfValues = sizeof(values) / sizeof(values[0]);
+
+  T leftv[rowNum];
+  for (int32_t i = 0; i < rowNum; ++i) {
+    leftv[i] = values[i % numOfValues];
+  }
+
+  bool nanBound = isnan(lower) || isnan(upper);
+  for (auto &r : ranges) {
+    SSDataBlock *src = NULL;
+    SNode       *pNode = flttMakeRangeNode(&src, type, rowNum, leftv, r.lowerOp, &lower, r.upperOp, &upper);
+
+    SColumnInfoData *pColumn = (SColumnInfoData *)taosArrayGetLast(src->pDataBlock);
+    int8_t           eRes[rowNum];
+    for (int32_t i = 0; i < rowNum; ++i) {
+      if (i % 5 == 0) {
+        colDataSetNULL(pColumn, i);
+        eRes[i] = 0;
+        continue;
+      }
+
+      // the order of the compare function of the type, in which NaN is less than any other value
+      int32_t c1 = cmp(&leftv[i], &lower), c2 = cmp(&leftv[i], &upper);
+      bool    inLower = (r.lowerOp == 0) || (r.lowerOp == OP_TYPE_GREATER_EQUAL ? c1 >= 0 : c1 > 0);
+      bool    inUpper = (r.upperOp == 0) || (r.upperOp == OP_TYPE_LOWER_EQUAL ? c2 <= 0 : c2 < 0);
+      eRes[i] = inLower && inUpper;
+    }
+
+    flttCheckRangeFilter(src, pNode, !nanBound, eRes, rowNum);
+    nodesDestroyNode(pNode);
+    blockDataDestroy(src);
+  }
+}
+
+}  // namespace
+
+TEST(columnTest, bigint_column_range_with_null) {
+  const int32_t rowNum = 100;
+  int64_t       leftv[rowNum];
+  int8_t        eRes[rowNum];
+  int64_t       lower = 3, upper = 40;
+  SSDataBlock  *src = NULL;
+
+  for (int32_t i = 0; i < rowNum; ++i) {
+    leftv[i] = i - 10;
+  }
+
+  SNode *pNode = flttMakeRangeNode(&src, TSDB_DATA_TYPE_BIGINT, rowNum, leftv, OP_TYPE_GREATER_EQUAL, &lower,
+                                   OP_TYPE_LOWER_THAN, &upper);
+  SColumnInfoData *pColumn = (SColumnInfoData *)taosArrayGetLast(src->pDataBlock);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    if (i % 7 == 0) {
+      colDataSetNULL(pColumn, i);
+    }
+    eRes[i] = (i % 7 != 0) && leftv[i] >= lower && leftv[i] < upper;
+  }
+
+  flttCheckRangeFilter(src, pNode, true, eRes, rowNum);
+  nodesDestroyNode(pNode);
+  blockDataDestroy(src);
+}
+
+TEST(columnTest, float_column_range_kernel) {
+  flttCheckFloatRange<float>(TSDB_DATA_TYPE_FLOAT, compareFloatVal, 1, 2, flttBoundedRanges);
+  flttCheckFloatRange<float>(TSDB_DATA_TYPE_FLOAT, compareFloatVal, -1000, 1000, flttBoundedRanges);
+}
+
+TEST(columnTest, double_column_range_kernel) {
+  flttCheckFloatRange<double>(TSDB_DATA_TYPE_DOUBLE, compareDoubleVal, 1, 2, flttBoundedRanges);
+  flttCheckFloatRange<double>(TSDB_DATA_TYPE_DOUBLE, compareDoubleVal, -1000, 1000, flttBoundedRanges);
+}
+
+TEST(columnTest, float_column_range_nan_bound) {
+  // the NaN bounds are left to the compare functions, in which NaN is less than any other value
+  std::vector<SFlttRange> lowerRanges = {{OP_TYPE_GREATER_EQUAL, (EOperatorType)0},
+                                         {OP_TYPE_GREATER_THAN, (EOperatorType)0}};
+  std::vector<SFlttRange> upperRanges = {{(EOperatorType)0, OP_TYPE_LOWER_EQUAL},
+                                         {(EOperatorType)0, OP_TYPE_LOWER_THAN}};
+  flttCheckFloatRange<float>(TSDB_DATA_TYPE_FLOAT, compareFloatVal, NAN, 2, lowerRanges);
+  flttCheckFloatRange<float>(TSDB_DATA_TYPE_FLOAT, compareFloatVal, 1, NAN, upperRanges);
+  flttCheckFloatRange<double>(TSDB_DATA_TYPE_DOUBLE, compareDoubleVal, NAN, 2, lowerRanges);
+  flttCheckFloatRange<double>(TSDB_DATA_TYPE_DOUBLE, compareDoubleVal, 1, NAN, upperRanges);
+}
+
 template <class SignedT, class UnsignedT>
 int32_t compareSignedWithUnsigned(SignedT l, UnsignedT r) {
   if (l < 0) return -1;
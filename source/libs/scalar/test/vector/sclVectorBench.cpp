@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "os.h"
+#include "function.h"
+#include "osSysinfo.h"
+#include "querynodes.h"
+#include "sclvector.h"
+#include "tdatablock.h"
+
+namespace {
+
+const int32_t numOfRows = 4096;
+const int32_t numOfLoops = 2000;
+
+void setSimdEnable(bool enable) {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+  tsSIMDEnable = enable;
+  tsAVX2Enable = enable ? avx2 : 0;
+}
+
+// a column of rows random values of the type, with every 10th row null if withNull
+SColumnInfoData *createColumn(int16_t type, int32_t rows, bool withNull, uint32_t *seed) {
+  SColumnInfoData *pCol = static_cast<SColumnInfoData *>(taosMemoryCalloc(1, sizeof(SColumnInfoData)));
+  *pCol = createColumnInfoData(type, tDataTypes[type].bytes, 1);
+  EXPECT_EQ(colInfoDataEnsureCapacity(pCol, rows, true), 0);
+
+  for (int32_t i = 0; i < rows; ++i) {
+    if (withNull && i % 10 == 3) {
+      colDataSetNULL(pCol, i);
+      continue;
+    }
+
+    char    *p = pCol->pData + i * pCol->info.bytes;
+    uint32_t v = taosRandR(seed) % 100000;
+    switch (type) {
+      case TSDB_DATA_TYPE_INT:
+        *(int32_t *)p = (int32_t)v - 50000;
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        *(int64_t *)p = (int64_t)v * 1000;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        *(float *)p = v / 100.0f;
+        break;
+      default:
+        *(double *)p = v / 1000.0;
+        break;
+    }
+  }
+
+  return pCol;
+}
+
+void destroyColumn(SColumnInfoData *pCol) {
+  colDataDestroy(pCol);
+  taosMemoryFree(pCol);
+}
+
+double runOperator(_bin_scalar_fn_t fp, SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut) {
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfLoops; ++i) {
+    pOut->columnData->hasNull = false;
+    fp(pLeft, pRight, pOut, TSDB_ORDER_ASC);
+  }
+  int64_t el = taosGetTimestampUs() - st;
+  return (double)numOfRows * numOfLoops * 1000000.0 / (el > 0 ? el : 1);
+}
+
+// run the operator with the SIMD kernels disabled and enabled, and print rows/s. The outputs are checked in sclVectorTest
+void runVectorBench(const char *name, int32_t optr, int16_t leftType, int16_t rightType, bool rightConst,
+                    bool withNull) {
+  uint32_t         seed = 100;
+  int32_t          rightRows = rightConst ? 1 : numOfRows;
+  SColumnInfoData *pLeftCol = createColumn(leftType, numOfRows, withNull, &seed);
+  SColumnInfoData *pRightCol = createColumn(rightType, rightRows, false, &seed);
+  SColumnInfoData *pScalarCol = createColumn(TSDB_DATA_TYPE_DOUBLE, numOfRows, false, &seed);
+  SColumnInfoData *pSimdCol = createColumn(TSDB_DATA_TYPE_DOUBLE, numOfRows, false, &seed);
+
+  SScalarParam left = {.columnData = pLeftCol, .numOfRows = numOfRows};
+  SScalarParam right = {.columnData = pRightCol, .numOfRows = rightRows};
+  SScalarParam scalarOut = {.columnData = pScalarCol};
+  SScalarParam simdOut = {.columnData = pSimdCol};
+
+  _bin_scalar_fn_t fp = getBinScalarOperatorFn(optr);
+
+  setSimdEnable(false);
+  double scalar = runOperator(fp, &left, &right, &scalarOut);
+
+  setSimdEnable(true);
+  double simd = runOperator(fp, &left, &right, &simdOut);
+
+  printf("%-28s %d rows: scalar %.1f Mrows/s, simd %.1f Mrows/s\n", name, numOfRows, scalar / 1000000,
+         simd / 1000000);
+
+  setSimdEnable(false);
+  destroyColumn(pLeftCol);
+  destroyColumn(pRightCol);
+  destroyColumn(pScalarCol);
+  destroyColumn(pSimdCol);
+}
+
+}  // namespace
+
+TEST(sclVectorBench, add) {
+  runVectorBench("double + double", OP_TYPE_ADD, TSDB_DATA_TYPE_DOUBLE, TSDB_DATA_TYPE_DOUBLE, false, false);
+  runVectorBench("int + bigint", OP_TYPE_ADD, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT, false, false);
+  runVectorBench("float + constant, null", OP_TYPE_ADD, TSDB_DATA_TYPE_FLOAT, TSDB_DATA_TYPE_DOUBLE, true, true);
+}
+
+TEST(sclVectorBench, sub) {
+  runVectorBench("double - double", OP_TYPE_SUB, TSDB_DATA_TYPE_DOUBLE, TSDB_DATA_TYPE_DOUBLE, false, false);
+  runVectorBench("bigint - int, null", OP_TYPE_SUB, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_INT, false, true);
+  runVectorBench("int - constant", OP_TYPE_SUB, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_DOUBLE, true, false);
+}
+
+TEST(sclVectorBench, multiply) {
+  runVectorBench("double * double", OP_TYPE_MULTI, TSDB_DATA_TYPE_DOUBLE, TSDB_DATA_TYPE_DOUBLE, false, false);
+  runVectorBench("float * float, null", OP_TYPE_MULTI, TSDB_DATA_TYPE_FLOAT, TSDB_DATA_TYPE_FLOAT, false, true);
+  runVectorBench("int * constant", OP_TYPE_MULTI, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_DOUBLE, true, false);
+}
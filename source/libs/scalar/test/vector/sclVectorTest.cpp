@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "os.h"
+#include "function.h"
+#include "osSysinfo.h"
+#include "querynodes.h"
+#include "sclvector.h"
+#include "tdatablock.h"
+
+namespace {
+
+// more than one batch of the typed kernels, and not a multiple of 8 or of the 4 lanes of AVX2
+const int32_t numOfRows = 2 * 1024 + 13;
+
+const int16_t numericTypes[] = {TSDB_DATA_TYPE_BOOL,     TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_UTINYINT,
+                                TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_INT,
+                                TSDB_DATA_TYPE_UINT,     TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_UBIGINT,
+                                TSDB_DATA_TYPE_FLOAT,    TSDB_DATA_TYPE_DOUBLE};
+
+void setSimdEnable(bool enable) {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+  tsSIMDEnable = enable;
+  tsAVX2Enable = enable ? avx2 : 0;
+}
+
+// a column of rows random values of the type, with the rows of i % nullStep == nullRow null if nullStep > 0
+SColumnInfoData *createColumn(int16_t type, int32_t rows, int32_t nullStep, int32_t nullRow, uint32_t *seed) {
+  SColumnInfoData *pCol = static_cast<SColumnInfoData *>(taosMemoryCalloc(1, sizeof(SColumnInfoData)));
+  *pCol = createColumnInfoData(type, tDataTypes[type].bytes, 1);
+  EXPECT_EQ(colInfoDataEnsureCapacity(pCol, rows, true), 0);
+
+  for (int32_t i = 0; i < rows; ++i) {
+    if (nullStep > 0 && i % nullStep == nullRow) {
+      colDataSetNULL(pCol, i);
+      continue;
+    }
+
+    char   *p = pCol->pData + i * pCol->info.bytes;
+    int64_t v = (int64_t)(taosRandR(seed) % 200000) - 100000;
+    switch (type) {
+      case TSDB_DATA_TYPE_BOOL:
+        *(int8_t *)p = (v & 1);
+        break;
+      case TSDB_DATA_TYPE_TINYINT:
+      case TSDB_DATA_TYPE_UTINYINT:
+        *(int8_t *)p = (int8_t)v;
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+      case TSDB_DATA_TYPE_USMALLINT:
+        *(int16_t *)p = (int16_t)v;
+        break;
+      case TSDB_DATA_TYPE_INT:
+      case TSDB_DATA_TYPE_UINT:
+        *(int32_t *)p = (int32_t)v * 1000;
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+      case TSDB_DATA_TYPE_UBIGINT:
+        *(int64_t *)p = v * 1000000007LL;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        *(float *)p = v / 100.0f;
+        break;
+      default:
+        *(double *)p = v / 1000.0;
+        break;
+    }
+  }
+
+  return pCol;
+}
+
+void destroyColumn(SColumnInfoData *pCol) {
+  colDataDestroy(pCol);
+  taosMemoryFree(pCol);
+}
+
+// the row by row generic path: a null input gives a null output, and the constant is always the right operand of the
+// helpers, so the subtraction of a column from a constant is (column - constant) * -1
+double genericMath(int32_t optr, SColumnInfoData *pLeftCol, int32_t leftRows, SColumnInfoData *pRightCol,
+                   int32_t rightRows, int32_t i, bool *isNull) {
+  int32_t li = (leftRows == 1) ? 0 : i;
+  int32_t ri = (rightRows == 1) ? 0 : i;
+  *isNull = colDataIsNull_s(pLeftCol, li) || colDataIsNull_s(pRightCol, ri);
+  if (*isNull) {
+    return 0;
+  }
+
+  double l = getVectorDoubleValueFn(pLeftCol->info.type)(pLeftCol->pData, li);
+  double r = getVectorDoubleValueFn(pRightCol->info.type)(pRightCol->pData, ri);
+  if (optr == OP_TYPE_ADD) {
+    return (leftRows == 1 && rightRows != 1) ? r + l : l + r;
+  } else if (optr == OP_TYPE_SUB) {
+    return (leftRows == 1 && rightRows != 1) ? (r - l) * -1 : l - r;
+  } else {
+    return (leftRows == 1 && rightRows != 1) ? r * l : l * r;
+  }
+}
+
+// run the operator with the SIMD kernels disabled and enabled, and check both are the same as the generic path
+void checkVectorMath(int32_t optr, SColumnInfoData *pLeftCol, int32_t leftRows, SColumnInfoData *pRightCol,
+                     int32_t rightRows) {
+  int32_t          rows = TMAX(leftRows, rightRows);
+  _bin_scalar_fn_t fp = getBinScalarOperatorFn(optr);
+
+  for (int32_t simd = 0; simd < 2; ++simd) {
+    SColumnInfoData *pOutCol = static_cast<SColumnInfoData *>(taosMemoryCalloc(1, sizeof(SColumnInfoData)));
+    *pOutCol = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 1);
+    ASSERT_EQ(colInfoDataEnsureCapacity(pOutCol, rows, true), 0);
+
+    SScalarParam left = {.columnData = pLeftCol, .numOfRows = leftRows};
+    SScalarParam right = {.columnData = pRightCol, .numOfRows = rightRows};
+    SScalarParam out = {.columnData = pOutCol};
+
+    setSimdEnable(simd == 1);
+    fp(&left, &right, &out, TSDB_ORDER_ASC);
+    setSimdEnable(false);
+    ASSERT_EQ(out.numOfRows, rows);
+
+    for (int32_t i = 0; i < rows; ++i) {
+      bool   isNull = false;
+      double expect = genericMath(optr, pLeftCol, leftRows, pRightCol, rightRows, i, &isNull);
+      ASSERT_EQ(colDataIsNull_s(pOutCol, i), isNull) << "optr:" << optr << " row:" << i;
+      if (!isNull) {
+        double v = ((double *)pOutCol->pData)[i];
+        ASSERT_EQ(memcmp(&v, &expect, sizeof(double)), 0)
+            << "optr:" << optr << " row:" << i << " value:" << v << " expect:" << expect;
+      }
+    }
+
+    destroyColumn(pOutCol);
+  }
+}
+
+void checkVectorMathTypes(int32_t optr) {
+  uint32_t seed = 100;
+  for (int16_t leftType : numericTypes) {
+    for (int16_t rightType : numericTypes) {
+      // nulls on both sides at different rows, or on neither of them. The left column has null rows beyond the rows
+      // of the operation in the last byte of its bitmap, which are not taken into the output
+      for (int32_t withNull = 0; withNull < 2; ++withNull) {
+        SColumnInfoData *pLeftCol = createColumn(leftType, numOfRows + 3, withNull ? 10 : 0, 3, &seed);
+        SColumnInfoData *pRightCol = createColumn(rightType, numOfRows, withNull ? 7 : 0, 5, &seed);
+        SColumnInfoData *pConstCol = createColumn(rightType, 1, 0, 0, &seed);
+
+        checkVectorMath(optr, pLeftCol, numOfRows, pRightCol, numOfRows);
+        checkVectorMath(optr, pLeftCol, numOfRows, pConstCol, 1);
+        checkVectorMath(optr, pConstCol, 1, pLeftCol, numOfRows);
+
+        destroyColumn(pLeftCol);
+        destroyColumn(pRightCol);
+        destroyColumn(pConstCol);
+      }
+    }
+  }
+
+  // a null constant on either side gives a null column
+  SColumnInfoData *pCol = createColumn(TSDB_DATA_TYPE_INT, numOfRows, 10, 3, &seed);
+  SColumnInfoData *pNullCol = createColumn(TSDB_DATA_TYPE_DOUBLE, 1, 1, 0, &seed);
+  checkVectorMath(optr, pCol, numOfRows, pNullCol, 1);
+  checkVectorMath(optr, pNullCol, 1, pCol, numOfRows);
+  destroyColumn(pCol);
+  destroyColumn(pNullCol);
+}
+
+}  // namespace
+
+TEST(sclVectorTest, add) { checkVectorMathTypes(OP_TYPE_ADD); }
+
+TEST(sclVectorTest, sub) {
+  checkVectorMathTypes(OP_TYPE_SUB);
+
+  // a constant equal to the column gives -0.0 by the factor of the generic path, when it is the left operand
+  uint32_t         seed = 100;
+  SColumnInfoData *pCol = createColumn(TSDB_DATA_TYPE_DOUBLE, numOfRows, 0, 0, &seed);
+  SColumnInfoData *pConstCol = createColumn(TSDB_DATA_TYPE_DOUBLE, 1, 0, 0, &seed);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    ((double *)pCol->pData)[i] = (i % 3 == 0) ? 1.5 : i;
+  }
+  *(double *)pConstCol->pData = 1.5;
+
+  checkVectorMath(OP_TYPE_SUB, pConstCol, 1, pCol, numOfRows);
+  checkVectorMath(OP_TYPE_SUB, pCol, numOfRows, pConstCol, 1);
+
+  destroyColumn(pCol);
+  destroyColumn(pConstCol);
+}
+
+TEST(sclVectorTest, multiply) { checkVectorMathTypes(OP_TYPE_MULTI); }
@@ -105,6 +105,8 @@ int32_t streamDispatchStreamBlock(SStreamTask* pTask);
 void    destroyDispatchMsg(SStreamDispatchReq* pReq, int32_t numOfVgroups);
 int32_t getNumOfDispatchBranch(SStreamTask* pTask);
 void    clearBufferedDispatchMsg(SStreamTask* pTask);
+int32_t streamAddBlockIntoDispatchMsg(SStreamTask* pTask, const SSDataBlock* pBlock, SStreamDispatchReq* pReq);
+int32_t streamTaskSearchVgroup(SStreamTask* pTask, uint32_t hashValue, int32_t vgSz);
 
 int32_t           streamProcessCheckpointBlock(SStreamTask* pTask, SStreamDataBlock* pBlock);
 SStreamDataBlock* createStreamBlockFromDispatchMsg(const SStreamDispatchReq* pReq, int32_t blockType, int32_t srcVg);
@@ -166,8 +166,8 @@ static int32_t streamTaskAppendInputBlocks(SStreamTask* pTask, const SStreamDisp
   if (pBlock == NULL) {
     streamTaskInputFail(pTask);
     status = TASK_INPUT_STATUS__FAILED;
-    stError("vgId:%d, s-task:%s failed to receive dispatch msg, reason: out of memory", pTask->pMeta->vgId,
-           pTask->id.idStr);
+    stError("vgId:%d, s-task:%s failed to receive dispatch msg, reason:%s", pTask->pMeta->vgId, pTask->id.idStr,
+            tstrerror(terrno));
   } else {
     if (pBlock->type == STREAM_INPUT__TRANS_STATE) {
       pTask->status.appendTranstateBlock = true;
@@ -14,10 +14,41 @@
  */
 
 #include "streamInt.h"
+#include "tcompression.h"
+
+// decode the block of dispatch msg, the compressed one is decompressed into *ppBuf first
+static int32_t streamDecodeDispatchBlock(SSDataBlock* pDataBlock, const SRetrieveTableRsp* pRetrieve, int32_t len,
+                                         char** ppBuf, int32_t* pBufLen) {
+  if (!pRetrieve->compressed) {
+    return blockDecode(pDataBlock, pRetrieve->data) == NULL ? TSDB_CODE_OUT_OF_MEMORY : 0;
+  }
+
+  int32_t rawLen = htonl(pRetrieve->compLen);
+  int32_t compLen = len - (int32_t)sizeof(SRetrieveTableRsp);
+  if (rawLen <= 0 || compLen <= 0) {
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  if (*pBufLen < rawLen) {
+    char* p = taosMemoryRealloc(*ppBuf, rawLen);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    *ppBuf = p;
+    *pBufLen = rawLen;
+  }
+
+  if (tsDecompressString((void*)pRetrieve->data, compLen, 1, *ppBuf, rawLen, ONE_STAGE_COMP, NULL, 0) != rawLen) {
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  return blockDecode(pDataBlock, *ppBuf) == NULL ? TSDB_CODE_OUT_OF_MEMORY : 0;
+}
 
 SStreamDataBlock* createStreamBlockFromDispatchMsg(const SStreamDispatchReq* pReq, int32_t blockType, int32_t srcVg) {
   SStreamDataBlock* pData = taosAllocateQitem(sizeof(SStreamDataBlock), DEF_QITEM, pReq->totalLen);
   if (pData == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
   }
 
@@ -29,15 +60,27 @@ SStreamDataBlock* createStreamBlockFromDispatchMsg(const SStreamDispatchReq* pRe
   SArray* pArray = taosArrayInit_s(sizeof(SSDataBlock), blockNum);
   if (pArray == NULL) {
     taosFreeQitem(pData);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
   }
 
   ASSERT((pReq->blockNum == taosArrayGetSize(pReq->data)) && (pReq->blockNum == taosArrayGetSize(pReq->dataLen)));
 
+  char*   pBuf = NULL;
+  int32_t bufLen = 0;
   for (int32_t i = 0; i < blockNum; i++) {
     SRetrieveTableRsp* pRetrieve = (SRetrieveTableRsp*) taosArrayGetP(pReq->data, i);
     SSDataBlock*       pDataBlock = taosArrayGet(pArray, i);
-    blockDecode(pDataBlock, pRetrieve->data);
+    int32_t            len = *(int32_t*)taosArrayGet(pReq->dataLen, i);
+
+    int32_t code = streamDecodeDispatchBlock(pDataBlock, pRetrieve, len, &pBuf, &bufLen);
+    if (code != TSDB_CODE_SUCCESS) {
+      taosMemoryFree(pBuf);
+      taosArrayDestroyEx(pArray, (FDelete)blockDataFreeRes);
+      taosFreeQitem(pData);
+      terrno = code;
+      return NULL;
+    }
 
     // TODO: refactor
     pDataBlock->info.window.skey = be64toh(pRetrieve->skey);
@@ -50,6 +93,7 @@ SStreamDataBlock* createStreamBlockFromDispatchMsg(const SStreamDispatchReq* pRe
     pDataBlock->info.childId = pReq->upstreamChildId;
   }
 
+  taosMemoryFree(pBuf);
   pData->blocks = pArray;
   return pData;
 }
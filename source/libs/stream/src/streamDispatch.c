@@ -14,6 +14,7 @@
  */
 
 #include "streamInt.h"
+#include "tcompression.h"
 #include "tmisce.h"
 #include "trpc.h"
 #include "ttimer.h"
@@ -23,6 +24,12 @@ typedef struct SBlockName {
   char     parTbName[TSDB_TABLE_NAME_LEN];
 } SBlockName;
 
+typedef struct SDispatchHashRange {
+  uint32_t hashBegin;
+  uint32_t hashEnd;
+  int32_t  index;  // index of the vgroup in pVgroupInfos
+} SDispatchHashRange;
+
 typedef struct {
   int32_t upStreamTaskId;
   SEpSet  upstreamNodeEpset;
@@ -31,7 +38,10 @@ typedef struct {
 
 static void    doRetryDispatchData(void* param, void* tmrId);
 static int32_t doSendDispatchMsg(SStreamTask* pTask, const SStreamDispatchReq* pReq, int32_t vgId, SEpSet* pEpSet);
-static int32_t streamAddBlockIntoDispatchMsg(const SSDataBlock* pBlock, SStreamDispatchReq* pReq);
+static int32_t streamEncodeDispatchBlock(SStreamTask* pTask, const SSDataBlock* pBlock, void** ppBuf, int32_t* pLen,
+                                         int32_t* pRawLen);
+static void    streamAddEncodedBlockIntoDispatchMsg(SStreamTask* pTask, SStreamDispatchReq* pReq, void* buf,
+                                                    int32_t len, int32_t rawLen);
 static int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock,
                                        int32_t vgSz, int64_t groupId);
 static int32_t tInitStreamDispatchReq(SStreamDispatchReq* pReq, const SStreamTask* pTask, int32_t vgId,
@@ -351,7 +361,7 @@ static int32_t doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pD
 
     for (int32_t i = 0; i < numOfBlocks; i++) {
       SSDataBlock* pDataBlock = taosArrayGet(pData->blocks, i);
-      code = streamAddBlockIntoDispatchMsg(pDataBlock, pReq);
+      code = streamAddBlockIntoDispatchMsg(pTask, pDataBlock, pReq);
       if (code != TSDB_CODE_SUCCESS) {
         destroyDispatchMsg(pReq, 1);
         return code;
@@ -387,13 +397,28 @@ static int32_t doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pD
       // TODO: do not use broadcast
       if (pDataBlock->info.type == STREAM_DELETE_RESULT || pDataBlock->info.type == STREAM_CHECKPOINT ||
           pDataBlock->info.type == STREAM_TRANS_STATE) {
+        // encode the block once, and copy the encoded data to all vgroups
+        void*   buf = NULL;
+        int32_t len = 0;
+        int32_t rawLen = 0;
+        code = streamEncodeDispatchBlock(pTask, pDataBlock, &buf, &len, &rawLen);
+        if (code != 0) {
+          destroyDispatchMsg(pReqs, numOfVgroups);
+          return code;
+        }
+
         for (int32_t j = 0; j < numOfVgroups; j++) {
-          code = streamAddBlockIntoDispatchMsg(pDataBlock, &pReqs[j]);
-          if (code != 0) {
+          void* p = taosMemoryMalloc(len);
+          if (p == NULL) {
+            taosMemoryFree(buf);
             destroyDispatchMsg(pReqs, numOfVgroups);
-            return code;
+            terrno = TSDB_CODE_OUT_OF_MEMORY;
+            return -1;
           }
 
+          memcpy(p, buf, len);
+          streamAddEncodedBlockIntoDispatchMsg(pTask, &pReqs[j], p, len, rawLen);
+
           // it's a new vnode to receive dispatch msg, so add one
           if (pReqs[j].blockNum == 0) {
             atomic_add_fetch_32(&pTask->outputInfo.shuffleDispatcher.waitingRspCnt, 1);
@@ -402,6 +427,7 @@ static int32_t doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pD
           pReqs[j].blockNum++;
         }
 
+        taosMemoryFree(buf);
         continue;
       }
 
@@ -424,6 +450,11 @@ static int32_t doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pD
             pTask->msgInfo.pData);
   }
 
+  STaskExecStatisInfo* pInfo = &pTask->execInfo;
+  stDebug("s-task:%s total dispatched size:%" PRId64 " bytes, before compression:%" PRId64
+          " bytes, encode cost:%" PRId64 "us",
+          pTask->id.idStr, pInfo->dispatchDataSize, pInfo->dispatchEncodeSize, pInfo->dispatchEncodeCost);
+
   return code;
 }
 
@@ -569,6 +600,63 @@ void streamRetryDispatchData(SStreamTask* pTask, int64_t waitDuration) {
   }
 }
 
+static int32_t compareDispatchHashRange(const void* p1, const void* p2) {
+  const SDispatchHashRange* pRange1 = p1;
+  const SDispatchHashRange* pRange2 = p2;
+  if (pRange1->hashBegin == pRange2->hashBegin) {
+    return 0;
+  }
+  return pRange1->hashBegin < pRange2->hashBegin ? -1 : 1;
+}
+
+static int32_t streamTaskBuildHashRanges(STaskDispatcherShuffle* pDispatcher, int32_t vgSz) {
+  SArray* vgInfo = pDispatcher->dbInfo.pVgroupInfos;
+
+  taosArrayDestroy(pDispatcher->pHashRanges);
+  pDispatcher->pHashRanges = taosArrayInit(vgSz, sizeof(SDispatchHashRange));
+  if (pDispatcher->pHashRanges == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < vgSz; i++) {
+    SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, i);
+    ASSERT(pVgInfo->vgId > 0);
+
+    SDispatchHashRange range = {.hashBegin = pVgInfo->hashBegin, .hashEnd = pVgInfo->hashEnd, .index = i};
+    taosArrayPush(pDispatcher->pHashRanges, &range);
+  }
+
+  taosArraySort(pDispatcher->pHashRanges, compareDispatchHashRange);
+  return 0;
+}
+
+// binary search of the vgroup whose hash range covers the hash value, return the index of the vgroup or -1
+int32_t streamTaskSearchVgroup(SStreamTask* pTask, uint32_t hashValue, int32_t vgSz) {
+  STaskDispatcherShuffle* pDispatcher = &pTask->outputInfo.shuffleDispatcher;
+  if (pDispatcher->pHashRanges == NULL || taosArrayGetSize(pDispatcher->pHashRanges) != vgSz) {
+    if (streamTaskBuildHashRanges(pDispatcher, vgSz) != 0) {
+      return -1;
+    }
+  }
+
+  int32_t low = 0;
+  int32_t high = vgSz - 1;
+  while (low <= high) {
+    int32_t             mid = (low + high) >> 1;
+    SDispatchHashRange* pRange = taosArrayGet(pDispatcher->pHashRanges, mid);
+    if (hashValue < pRange->hashBegin) {
+      high = mid - 1;
+    } else if (hashValue > pRange->hashEnd) {
+      low = mid + 1;
+    } else {
+      return pRange->index;
+    }
+  }
+
+  return -1;
+}
+
 int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock, int32_t vgSz,
                                 int64_t groupId) {
   uint32_t hashValue = 0;
@@ -613,28 +701,21 @@ int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, S
     }
   }
 
-  bool found = false;
-  // TODO: optimize search
-  int32_t j;
-  for (j = 0; j < vgSz; j++) {
-    SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, j);
-    ASSERT(pVgInfo->vgId > 0);
-
-    if (hashValue >= pVgInfo->hashBegin && hashValue <= pVgInfo->hashEnd) {
-      if (streamAddBlockIntoDispatchMsg(pDataBlock, &pReqs[j]) < 0) {
-        return -1;
-      }
+  int32_t j = streamTaskSearchVgroup(pTask, hashValue, vgSz);
+  ASSERT(j >= 0);
+  if (j < 0) {
+    return -1;
+  }
 
-      if (pReqs[j].blockNum == 0) {
-        atomic_add_fetch_32(&pTask->outputInfo.shuffleDispatcher.waitingRspCnt, 1);
-      }
+  if (streamAddBlockIntoDispatchMsg(pTask, pDataBlock, &pReqs[j]) < 0) {
+    return -1;
+  }
 
-      pReqs[j].blockNum++;
-      found = true;
-      break;
-    }
+  if (pReqs[j].blockNum == 0) {
+    atomic_add_fetch_32(&pTask->outputInfo.shuffleDispatcher.waitingRspCnt, 1);
   }
-  ASSERT(found);
+
+  pReqs[j].blockNum++;
   return 0;
 }
 
@@ -758,12 +839,45 @@ int32_t streamTaskSendCheckpointSourceRsp(SStreamTask* pTask) {
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t streamAddBlockIntoDispatchMsg(const SSDataBlock* pBlock, SStreamDispatchReq* pReq) {
-  int32_t dataStrLen = sizeof(SRetrieveTableRsp) + blockGetEncodeSize(pBlock);
+static int32_t streamTaskEnsureEncodeBuf(SDispatchMsgInfo* pMsgInfo, int32_t len) {
+  if (pMsgInfo->encodeBufLen >= len) {
+    return 0;
+  }
+
+  char* p = taosMemoryRealloc(pMsgInfo->pEncodeBuf, len);
+  if (p == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  pMsgInfo->pEncodeBuf = p;
+  pMsgInfo->encodeBufLen = len;
+  return 0;
+}
+
+// Encode the block into a new buffer of the dispatch msg. The encoded block not smaller than
+// tsStreamDispatchCompressSize is encoded into the buffer of the task and then compressed into the new buffer, and
+// compLen of the compressed one is the length before compression.
+static int32_t streamEncodeDispatchBlock(SStreamTask* pTask, const SSDataBlock* pBlock, void** ppBuf, int32_t* pLen,
+                                         int32_t* pRawLen) {
+  SDispatchMsgInfo* pMsgInfo = &pTask->msgInfo;
+  int64_t           st = taosGetTimestampUs();
+  int32_t           encodeSize = blockGetEncodeSize(pBlock);
+  bool              compress = (tsStreamDispatchCompressSize > 0 && encodeSize >= tsStreamDispatchCompressSize);
+
+  // one more byte for the compression indicator
+  int32_t dataStrLen = sizeof(SRetrieveTableRsp) + encodeSize + (compress ? 1 : 0);
   ASSERT(dataStrLen > 0);
 
-  void*   buf = taosMemoryCalloc(1, dataStrLen);
-  if (buf == NULL) return -1;
+  if (compress && streamTaskEnsureEncodeBuf(pMsgInfo, encodeSize) != 0) {
+    return -1;
+  }
+
+  void* buf = taosMemoryCalloc(1, dataStrLen);
+  if (buf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
 
   SRetrieveTableRsp* pRetrieve = (SRetrieveTableRsp*)buf;
   pRetrieve->useconds = 0;
@@ -781,13 +895,52 @@ int32_t streamAddBlockIntoDispatchMsg(const SSDataBlock* pBlock, SStreamDispatch
   int32_t numOfCols = (int32_t)taosArrayGetSize(pBlock->pDataBlock);
   pRetrieve->numOfCols = htonl(numOfCols);
 
-  int32_t actualLen = blockEncode(pBlock, pRetrieve->data, numOfCols);
+  int32_t rawLen = 0;
+  int32_t actualLen = 0;
+  if (compress) {
+    rawLen = blockEncode(pBlock, pMsgInfo->pEncodeBuf, numOfCols);
+    ASSERT(rawLen <= encodeSize);
+
+    actualLen = tsCompressString(pMsgInfo->pEncodeBuf, rawLen, 1, pRetrieve->data, rawLen + 1, ONE_STAGE_COMP, NULL, 0);
+    pRetrieve->compressed = 1;
+    pRetrieve->compLen = htonl(rawLen);
+  } else {
+    rawLen = blockEncode(pBlock, pRetrieve->data, numOfCols);
+    actualLen = rawLen;
+  }
+
   actualLen += sizeof(SRetrieveTableRsp);
   ASSERT(actualLen <= dataStrLen);
-  taosArrayPush(pReq->dataLen, &actualLen);
+
+  *ppBuf = buf;
+  *pLen = actualLen;
+  *pRawLen = sizeof(SRetrieveTableRsp) + rawLen;
+
+  pTask->execInfo.dispatchEncodeCost += taosGetTimestampUs() - st;
+  return 0;
+}
+
+static void streamAddEncodedBlockIntoDispatchMsg(SStreamTask* pTask, SStreamDispatchReq* pReq, void* buf, int32_t len,
+                                                 int32_t rawLen) {
+  taosArrayPush(pReq->dataLen, &len);
   taosArrayPush(pReq->data, &buf);
 
-  pReq->totalLen += dataStrLen;
+  // the receiver holds the block decoded, so it is the size before compression
+  pReq->totalLen += rawLen;
+
+  pTask->execInfo.dispatchDataSize += len;
+  pTask->execInfo.dispatchEncodeSize += rawLen;
+}
+
+int32_t streamAddBlockIntoDispatchMsg(SStreamTask* pTask, const SSDataBlock* pBlock, SStreamDispatchReq* pReq) {
+  void*   buf = NULL;
+  int32_t len = 0;
+  int32_t rawLen = 0;
+  if (streamEncodeDispatchBlock(pTask, pBlock, &buf, &len, &rawLen) != 0) {
+    return -1;
+  }
+
+  streamAddEncodedBlockIntoDispatchMsg(pTask, pReq, buf, len, rawLen);
   return 0;
 }
 
@@ -423,6 +423,7 @@ void tFreeStreamTask(SStreamTask* pTask) {
     tSimpleHashCleanup(pTask->outputInfo.tbSink.pTblInfo);
   } else if (pTask->outputInfo.type == TASK_OUTPUT__SHUFFLE_DISPATCH) {
     taosArrayDestroy(pTask->outputInfo.shuffleDispatcher.dbInfo.pVgroupInfos);
+    taosArrayDestroy(pTask->outputInfo.shuffleDispatcher.pHashRanges);
     pTask->checkReqIds = taosArrayDestroy(pTask->checkReqIds);
   }
 
@@ -449,6 +450,7 @@ void tFreeStreamTask(SStreamTask* pTask) {
   streamTaskDestroyUpstreamInfo(&pTask->upstreamInfo);
 
   pTask->msgInfo.pRetryList = taosArrayDestroy(pTask->msgInfo.pRetryList);
+  taosMemoryFreeClear(pTask->msgInfo.pEncodeBuf);
   taosMemoryFree(pTask->outputInfo.pTokenBucket);
   taosThreadMutexDestroy(&pTask->lock);
 
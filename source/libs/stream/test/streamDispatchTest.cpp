@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+#include <tglobal.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "streamInt.h"
+
+namespace {
+
+SSDataBlock *createTestBlock(int32_t rows) {
+  SSDataBlock *pBlock = createDataBlock();
+
+  SColumnInfoData tsCol = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t), 1);
+  blockDataAppendColInfo(pBlock, &tsCol);
+  SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+  blockDataAppendColInfo(pBlock, &valCol);
+  blockDataEnsureCapacity(pBlock, rows);
+
+  SColumnInfoData *pTsCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+  SColumnInfoData *pValCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+  for (int32_t i = 0; i < rows; ++i) {
+    int64_t ts = 1700000000000 + i;
+    int64_t val = i % 16;  // repeated values to be compressed well
+    colDataSetVal(pTsCol, i, (const char *)&ts, false);
+    colDataSetVal(pValCol, i, (const char *)&val, false);
+  }
+
+  pBlock->info.rows = rows;
+  pBlock->info.type = STREAM_NORMAL;
+  pBlock->info.window.skey = 1700000000000;
+  pBlock->info.window.ekey = 1700000000000 + rows - 1;
+  pBlock->info.version = 100;
+  return pBlock;
+}
+
+void initDispatchReq(SStreamDispatchReq *pReq) {
+  memset(pReq, 0, sizeof(SStreamDispatchReq));
+  pReq->data = taosArrayInit(4, POINTER_BYTES);
+  pReq->dataLen = taosArrayInit(4, sizeof(int32_t));
+}
+
+void checkBlock(const SSDataBlock *pBlock, int32_t rows) {
+  ASSERT_EQ(pBlock->info.rows, rows);
+  ASSERT_EQ(taosArrayGetSize(pBlock->pDataBlock), 2);
+  EXPECT_EQ(pBlock->info.window.skey, 1700000000000);
+  EXPECT_EQ(pBlock->info.window.ekey, 1700000000000 + rows - 1);
+  EXPECT_EQ(pBlock->info.version, 100);
+
+  SColumnInfoData *pTsCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+  SColumnInfoData *pValCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+  for (int32_t i = 0; i < rows; ++i) {
+    ASSERT_EQ(*(int64_t *)colDataGetData(pTsCol, i), 1700000000000 + i);
+    ASSERT_EQ(*(int64_t *)colDataGetData(pValCol, i), i % 16);
+  }
+}
+
+void addVgroup(SArray *pVgroups, int32_t vgId, uint32_t hashBegin, uint32_t hashEnd) {
+  SVgroupInfo vg = {0};
+  vg.vgId = vgId;
+  vg.hashBegin = hashBegin;
+  vg.hashEnd = hashEnd;
+  taosArrayPush(pVgroups, &vg);
+}
+
+int32_t searchVgId(SStreamTask *pTask, uint32_t hashValue) {
+  SArray *pVgroups = pTask->outputInfo.shuffleDispatcher.dbInfo.pVgroupInfos;
+  int32_t index = streamTaskSearchVgroup(pTask, hashValue, taosArrayGetSize(pVgroups));
+  return index < 0 ? -1 : ((SVgroupInfo *)taosArrayGet(pVgroups, index))->vgId;
+}
+
+}  // namespace
+
+TEST(streamDispatchTest, encodeDecodeBlock) {
+  int32_t compressSize = tsStreamDispatchCompressSize;
+  tsStreamDispatchCompressSize = 4096;
+
+  SStreamTask *pTask = (SStreamTask *)taosMemoryCalloc(1, sizeof(SStreamTask));
+  SSDataBlock *pSmall = createTestBlock(10);
+  SSDataBlock *pLarge = createTestBlock(10000);
+  ASSERT_LT(blockGetEncodeSize(pSmall), tsStreamDispatchCompressSize);
+  ASSERT_GE(blockGetEncodeSize(pLarge), tsStreamDispatchCompressSize);
+
+  SStreamDispatchReq req;
+  initDispatchReq(&req);
+  ASSERT_EQ(streamAddBlockIntoDispatchMsg(pTask, pSmall, &req), 0);
+  ASSERT_EQ(streamAddBlockIntoDispatchMsg(pTask, pLarge, &req), 0);
+  req.blockNum = 2;
+
+  SRetrieveTableRsp *pSmallRsp = (SRetrieveTableRsp *)taosArrayGetP(req.data, 0);
+  SRetrieveTableRsp *pLargeRsp = (SRetrieveTableRsp *)taosArrayGetP(req.data, 1);
+  EXPECT_EQ(pSmallRsp->compressed, 0);
+  EXPECT_EQ(pLargeRsp->compressed, 1);
+  EXPECT_LT(*(int32_t *)taosArrayGet(req.dataLen, 1), blockGetEncodeSize(pLarge));
+
+  // the total length is the one before compression, which the receiver holds
+  EXPECT_GE(req.totalLen, blockGetEncodeSize(pSmall) + blockGetEncodeSize(pLarge));
+
+  SStreamDataBlock *pData = createStreamBlockFromDispatchMsg(&req, STREAM_INPUT__DATA_BLOCK, 1);
+  ASSERT_NE(pData, nullptr);
+  ASSERT_EQ(taosArrayGetSize(pData->blocks), 2);
+  checkBlock((SSDataBlock *)taosArrayGet(pData->blocks, 0), 10);
+  checkBlock((SSDataBlock *)taosArrayGet(pData->blocks, 1), 10000);
+
+  destroyStreamDataBlock(pData);
+  taosArrayDestroyP(req.data, taosMemoryFree);
+  taosArrayDestroy(req.dataLen);
+  blockDataDestroy(pSmall);
+  blockDataDestroy(pLarge);
+  taosMemoryFree(pTask->msgInfo.pEncodeBuf);
+  taosMemoryFree(pTask);
+  tsStreamDispatchCompressSize = compressSize;
+}
+
+TEST(streamDispatchTest, compressDisabled) {
+  int32_t compressSize = tsStreamDispatchCompressSize;
+  tsStreamDispatchCompressSize = 0;
+
+  SStreamTask *pTask = (SStreamTask *)taosMemoryCalloc(1, sizeof(SStreamTask));
+  SSDataBlock *pLarge = createTestBlock(10000);
+
+  SStreamDispatchReq req;
+  initDispatchReq(&req);
+  ASSERT_EQ(streamAddBlockIntoDispatchMsg(pTask, pLarge, &req), 0);
+  req.blockNum = 1;
+  EXPECT_EQ(((SRetrieveTableRsp *)taosArrayGetP(req.data, 0))->compressed, 0);
+  EXPECT_EQ(pTask->msgInfo.pEncodeBuf, nullptr);
+
+  SStreamDataBlock *pData = createStreamBlockFromDispatchMsg(&req, STREAM_INPUT__DATA_BLOCK, 1);
+  ASSERT_NE(pData, nullptr);
+  checkBlock((SSDataBlock *)taosArrayGet(pData->blocks, 0), 10000);
+
+  destroyStreamDataBlock(pData);
+  taosArrayDestroyP(req.data, taosMemoryFree);
+  taosArrayDestroy(req.dataLen);
+  blockDataDestroy(pLarge);
+  taosMemoryFree(pTask);
+  tsStreamDispatchCompressSize = compressSize;
+}
+
+TEST(streamDispatchTest, searchVgroup) {
+  SStreamTask *pTask = (SStreamTask *)taosMemoryCalloc(1, sizeof(SStreamTask));
+  SArray      *pVgroups = taosArrayInit(4, sizeof(SVgroupInfo));
+  pTask->outputInfo.shuffleDispatcher.dbInfo.pVgroupInfos = pVgroups;
+
+  // not sorted by the hash range
+  addVgroup(pVgroups, 3, 2147483648u, 3221225471u);
+  addVgroup(pVgroups, 1, 0, 1073741823u);
+  addVgroup(pVgroups, 4, 3221225472u, UINT32_MAX);
+  addVgroup(pVgroups, 2, 1073741824u, 2147483647u);
+
+  EXPECT_EQ(searchVgId(pTask, 0), 1);
+  EXPECT_EQ(searchVgId(pTask, 1073741823u), 1);
+  EXPECT_EQ(searchVgId(pTask, 1073741824u), 2);
+  EXPECT_EQ(searchVgId(pTask, 2147483647u), 2);
+  EXPECT_EQ(searchVgId(pTask, 2147483648u), 3);
+  EXPECT_EQ(searchVgId(pTask, 3221225471u), 3);
+  EXPECT_EQ(searchVgId(pTask, 3221225472u), 4);
+  EXPECT_EQ(searchVgId(pTask, UINT32_MAX), 4);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pVgroups); ++i) {
+    SVgroupInfo *pVg = (SVgroupInfo *)taosArrayGet(pVgroups, i);
+    uint32_t     mid = pVg->hashBegin + (pVg->hashEnd - pVg->hashBegin) / 2;
+    EXPECT_EQ(searchVgId(pTask, mid), pVg->vgId);
+  }
+
+  // the ranges are rebuilt once the number of vgroups changes, and a hash value in no range is not found
+  taosArrayClear(pVgroups);
+  addVgroup(pVgroups, 6, 100, 199);
+  addVgroup(pVgroups, 5, 0, 99);
+  addVgroup(pVgroups, 7, 300, 399);
+
+  EXPECT_EQ(searchVgId(pTask, 0), 5);
+  EXPECT_EQ(searchVgId(pTask, 99), 5);
+  EXPECT_EQ(searchVgId(pTask, 100), 6);
+  EXPECT_EQ(searchVgId(pTask, 199), 6);
+  EXPECT_EQ(searchVgId(pTask, 200), -1);
+  EXPECT_EQ(searchVgId(pTask, 299), -1);
+  EXPECT_EQ(searchVgId(pTask, 300), 7);
+  EXPECT_EQ(searchVgId(pTask, 399), 7);
+  EXPECT_EQ(searchVgId(pTask, 400), -1);
+  EXPECT_EQ(searchVgId(pTask, UINT32_MAX), -1);
+
+  // a single vgroup covering all the hash values
+  taosArrayClear(pVgroups);
+  addVgroup(pVgroups, 8, 0, UINT32_MAX);
+  EXPECT_EQ(searchVgId(pTask, 0), 8);
+  EXPECT_EQ(searchVgId(pTask, UINT32_MAX), 8);
+
+  taosArrayDestroy(pTask->outputInfo.shuffleDispatcher.pHashRanges);
+  taosArrayDestroy(pVgroups);
+  taosMemoryFree(pTask);
+}
+
+#pragma GCC diagnostic pop
@@ -41,8 +41,11 @@ SSyncRaftEntry* syncEntryBuild(int32_t dataLen);
 SSyncRaftEntry* syncEntryBuildFromClientRequest(const SyncClientRequest* pMsg, SyncTerm term, SyncIndex index);
 SSyncRaftEntry* syncEntryBuildFromRpcMsg(const SRpcMsg* pMsg, SyncTerm term, SyncIndex index);
 SSyncRaftEntry* syncEntryBuildFromAppendEntries(const SyncAppendEntries* pMsg);
+int32_t         syncEntriesBuildFromAppendEntries(const SyncAppendEntries* pMsg, SSyncRaftEntry** ppEntries,
+                                                  int32_t maxEntries, int32_t* pNumOfEntries);
 SSyncRaftEntry* syncEntryBuildNoop(SyncTerm term, SyncIndex index, int32_t vgId);
 void            syncEntryDestroy(SSyncRaftEntry* pEntry);
+void            syncEntriesDestroy(SSyncRaftEntry** ppEntries, int32_t numOfEntries);
 void            syncEntry2OriginalRpc(const SSyncRaftEntry* pEntry, SRpcMsg* pRpcMsg);  // step 7
 
 static FORCE_INLINE bool syncLogReplBarrier(SSyncRaftEntry* pEntry) {
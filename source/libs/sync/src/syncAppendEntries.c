@@ -94,6 +94,8 @@ int32_t syncNodeOnAppendEntries(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
   SRpcMsg            rpcRsp = {0};
   bool               accepted = false;
   SSyncRaftEntry*    pEntry = NULL;
+  SSyncRaftEntry*    entries[SYNC_APPEND_ENTRIES_MAX_NUM] = {0};
+  int32_t            numOfEntries = 0;
   bool               resetElect = false;
 
   // if already drop replica, do not process
@@ -137,33 +139,40 @@ int32_t syncNodeOnAppendEntries(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
     goto _IGNORE;
   }
 
-  pEntry = syncEntryBuildFromAppendEntries(pMsg);
-  if (pEntry == NULL) {
-    sError("vgId:%d, failed to get raft entry from append entries since %s", ths->vgId, terrstr());
+  if (syncEntriesBuildFromAppendEntries(pMsg, entries, SYNC_APPEND_ENTRIES_MAX_NUM, &numOfEntries) < 0 ||
+      numOfEntries == 0) {
+    sError("vgId:%d, failed to get raft entries from append entries since %s", ths->vgId, terrstr());
     goto _IGNORE;
   }
 
-  if (pMsg->prevLogIndex + 1 != pEntry->index || pEntry->term < 0) {
-    sError("vgId:%d, invalid previous log index in msg. index:%" PRId64 ",  term:%" PRId64 ", prevLogIndex:%" PRId64
-           ", prevLogTerm:%" PRId64,
-           ths->vgId, pEntry->index, pEntry->term, pMsg->prevLogIndex, pMsg->prevLogTerm);
-    goto _IGNORE;
+  for (int32_t i = 0; i < numOfEntries; ++i) {
+    pEntry = entries[i];
+    if (pMsg->prevLogIndex + 1 + i != pEntry->index || pEntry->term < 0) {
+      sError("vgId:%d, invalid previous log index in msg. index:%" PRId64 ",  term:%" PRId64 ", prevLogIndex:%" PRId64
+             ", prevLogTerm:%" PRId64 ", pos:%d",
+             ths->vgId, pEntry->index, pEntry->term, pMsg->prevLogIndex, pMsg->prevLogTerm, i);
+      goto _IGNORE;
+    }
   }
+  pEntry = NULL;
+
+  // the run is acked as a whole by its last index
+  pReply->lastSendIndex = pMsg->prevLogIndex + numOfEntries;
 
   sTrace("vgId:%d, recv append entries msg. index:%" PRId64 ", term:%" PRId64 ", preLogIndex:%" PRId64
-         ", prevLogTerm:%" PRId64 " commitIndex:%" PRId64 " entryterm:%" PRId64,
+         ", prevLogTerm:%" PRId64 " commitIndex:%" PRId64 " entryterm:%" PRId64 ", entries:%d",
          pMsg->vgId, pMsg->prevLogIndex + 1, pMsg->term, pMsg->prevLogIndex, pMsg->prevLogTerm, pMsg->commitIndex,
-         pEntry->term);
+         entries[0]->term, numOfEntries);
 
   if (ths->fsmState == SYNC_FSM_STATE_INCOMPLETE) {
     pReply->fsmState = ths->fsmState;
-    sWarn("vgId:%d, unable to accept, due to incomplete fsm state. index:%" PRId64, ths->vgId, pEntry->index);
-    syncEntryDestroy(pEntry);
+    sWarn("vgId:%d, unable to accept, due to incomplete fsm state. index:%" PRId64, ths->vgId, entries[0]->index);
+    syncEntriesDestroy(entries, numOfEntries);
     goto _SEND_RESPONSE;
   }
 
   // accept
-  if (syncLogBufferAccept(ths->pLogBuf, ths, pEntry, pMsg->prevLogTerm) < 0) {
+  if (syncLogBufferAcceptRun(ths->pLogBuf, ths, entries, numOfEntries, pMsg->prevLogTerm) < 0) {
     goto _SEND_RESPONSE;
   }
   accepted = true;
@@ -191,6 +200,6 @@ _SEND_RESPONSE:
 
 _IGNORE:
   rpcFreeCont(rpcRsp.pCont);
-  syncEntryDestroy(pEntry);
+  syncEntriesDestroy(entries, numOfEntries);
   return 0;
 }
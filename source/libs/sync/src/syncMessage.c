@@ -156,7 +156,18 @@ int32_t syncBuildAppendEntriesReply(SRpcMsg* pMsg, int32_t vgId) {
 
 int32_t syncBuildAppendEntriesFromRaftEntry(SSyncNode* pNode, SSyncRaftEntry* pEntry, SyncTerm prevLogTerm,
                                             SRpcMsg* pRpcMsg) {
-  uint32_t dataLen = pEntry->bytes;
+  return syncBuildAppendEntriesFromRaftEntries(pNode, &pEntry, 1, prevLogTerm, pRpcMsg);
+}
+
+// the entries of consecutive indexes are packed one after another into data, each one sized by its own bytes
+int32_t syncBuildAppendEntriesFromRaftEntries(SSyncNode* pNode, SSyncRaftEntry** ppEntries, int32_t numOfEntries,
+                                              SyncTerm prevLogTerm, SRpcMsg* pRpcMsg) {
+  uint32_t dataLen = 0;
+  for (int32_t i = 0; i < numOfEntries; ++i) {
+    ASSERT(i == 0 || ppEntries[i]->index == ppEntries[i - 1]->index + 1);
+    dataLen += ppEntries[i]->bytes;
+  }
+
   uint32_t bytes = sizeof(SyncAppendEntries) + dataLen;
   pRpcMsg->contLen = bytes;
   pRpcMsg->pCont = rpcMallocCont(pRpcMsg->contLen);
@@ -170,9 +181,13 @@ int32_t syncBuildAppendEntriesFromRaftEntry(SSyncNode* pNode, SSyncRaftEntry* pE
   pMsg->msgType = pRpcMsg->msgType = TDMT_SYNC_APPEND_ENTRIES;
   pMsg->dataLen = dataLen;
 
-  (void)memcpy(pMsg->data, pEntry, dataLen);
+  uint32_t offset = 0;
+  for (int32_t i = 0; i < numOfEntries; ++i) {
+    (void)memcpy(pMsg->data + offset, ppEntries[i], ppEntries[i]->bytes);
+    offset += ppEntries[i]->bytes;
+  }
 
-  pMsg->prevLogIndex = pEntry->index - 1;
+  pMsg->prevLogIndex = ppEntries[0]->index - 1;
   pMsg->prevLogTerm = prevLogTerm;
   pMsg->vgId = pNode->vgId;
   pMsg->srcId = pNode->myRaftId;
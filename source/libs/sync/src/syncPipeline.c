@@ -27,6 +27,7 @@
 #include "syncUtil.h"
 #include "syncRaftCfg.h"
 #include "syncVoteMgr.h"
+#include "tglobal.h"
 
 static bool syncIsMsgBlock(tmsg_t type) {
   return (type == TDMT_VND_CREATE_TABLE) || (type == TDMT_VND_ALTER_TABLE) || (type == TDMT_VND_DROP_TABLE) ||
@@ -313,9 +314,10 @@ bool syncLogBufferIsEmpty(SSyncLogBuffer* pBuf) {
   return empty;
 }
 
-int32_t syncLogBufferAccept(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry* pEntry, SyncTerm prevTerm) {
-  taosThreadMutexLock(&pBuf->mutex);
-  syncLogBufferValidate(pBuf);
+// chained: the entry follows the one just accepted from the same message, whose term is prevTerm. The match of the
+// run with the matched entries is checked entry by entry in syncLogBufferProceed.
+static int32_t syncLogBufferAcceptWithoutLock(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry* pEntry,
+                                              SyncTerm prevTerm, bool chained) {
   int32_t         ret = -1;
   SyncIndex       index = pEntry->index;
   SyncIndex       prevIndex = pEntry->index - 1;
@@ -353,7 +355,7 @@ int32_t syncLogBufferAccept(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEnt
     goto _out;
   }
 
-  if (index > pBuf->matchIndex && lastMatchTerm != prevTerm) {
+  if (index > pBuf->matchIndex && lastMatchTerm != prevTerm && !chained) {
     sWarn("vgId:%d, not ready to accept. index:%" PRId64 ", term:%" PRId64 ": prevterm:%" PRId64
           " != lastmatch:%" PRId64 ". log buffer: [%" PRId64 " %" PRId64 " %" PRId64 ", %" PRId64 ")",
           pNode->vgId, pEntry->index, pEntry->term, prevTerm, lastMatchTerm, pBuf->startIndex, pBuf->commitIndex,
@@ -399,6 +401,38 @@ _out:
     syncEntryDestroy(pExist);
     pExist = NULL;
   }
+  return ret;
+}
+
+int32_t syncLogBufferAccept(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry* pEntry, SyncTerm prevTerm) {
+  taosThreadMutexLock(&pBuf->mutex);
+  syncLogBufferValidate(pBuf);
+  int32_t ret = syncLogBufferAcceptWithoutLock(pBuf, pNode, pEntry, prevTerm, false);
+  syncLogBufferValidate(pBuf);
+  taosThreadMutexUnlock(&pBuf->mutex);
+  return ret;
+}
+
+// accept the entries of consecutive indexes of one append entries msg. The entries are taken over, and the ones after
+// the first not accepted are dropped, to be sent again by the leader.
+int32_t syncLogBufferAcceptRun(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEntry** ppEntries, int32_t numOfEntries,
+                               SyncTerm prevTerm) {
+  int32_t ret = 0;
+  int32_t i = 0;
+
+  taosThreadMutexLock(&pBuf->mutex);
+  syncLogBufferValidate(pBuf);
+  for (; i < numOfEntries; ++i) {
+    SyncTerm term = ppEntries[i]->term;
+    ret = syncLogBufferAcceptWithoutLock(pBuf, pNode, ppEntries[i], prevTerm, i > 0);
+    ppEntries[i] = NULL;
+    if (ret < 0) {
+      i++;
+      break;
+    }
+    prevTerm = term;
+  }
+  syncEntriesDestroy(ppEntries + i, numOfEntries - i);
   syncLogBufferValidate(pBuf);
   taosThreadMutexUnlock(&pBuf->mutex);
   return ret;
@@ -763,7 +797,7 @@ int32_t syncLogReplRetryOnNeed(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
   SyncTerm term = -1;
   int64_t  batchSize = TMAX(1, pMgr->size >> (4 + pMgr->retryBackoff));
 
-  for (SyncIndex index = pMgr->startIndex; index < pMgr->endIndex; index++) {
+  for (SyncIndex index = pMgr->startIndex; index < pMgr->endIndex;) {
     int64_t pos = index % pMgr->size;
     ASSERT(!pMgr->states[pos].barrier || (index == pMgr->startIndex || index + 1 == pMgr->endIndex));
 
@@ -778,24 +812,34 @@ int32_t syncLogReplRetryOnNeed(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
               pDestId->addr);
         goto _out;
       }
+      index++;
       continue;
     }
 
-    bool barrier = false;
-    if (syncLogReplSendTo(pMgr, pNode, index, &term, pDestId, &barrier) < 0) {
+    // resend the following unacked entries due for retry together
+    int32_t maxEntries = 1;
+    while (index + maxEntries < pMgr->endIndex && count + maxEntries <= batchSize) {
+      SSyncReplInfo* pInfo = &pMgr->states[(index + maxEntries) % pMgr->size];
+      if (pInfo->acked || nowMs < pInfo->timeMs + retryWaitMs) {
+        break;
+      }
+      maxEntries++;
+    }
+
+    int32_t nEntries = 0;
+    bool    barrier = false;
+    if (syncLogReplSendRunTo(pMgr, pNode, index, maxEntries, nowMs, pDestId, &nEntries, &term, &barrier) < 0) {
       sError("vgId:%d, failed to replicate sync log entry since %s. index:%" PRId64 ", dest:%" PRIx64 "", pNode->vgId,
              terrstr(), index, pDestId->addr);
       goto _out;
     }
-    ASSERT(barrier == pMgr->states[pos].barrier);
-    pMgr->states[pos].timeMs = nowMs;
-    pMgr->states[pos].term = term;
-    pMgr->states[pos].acked = false;
 
     retried = true;
     if (firstIndex == -1) firstIndex = index;
+    index += nEntries;
 
-    if (batchSize <= count++) {
+    count += nEntries;
+    if (batchSize < count) {
       break;
     }
   }
@@ -985,35 +1029,33 @@ int32_t syncLogReplAttempt(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
   SyncTerm  term = -1;
   SyncIndex firstIndex = -1;
 
-  for (SyncIndex index = pMgr->endIndex; index <= pNode->pLogBuf->matchIndex; index++) {
+  for (SyncIndex index = pMgr->endIndex; index <= pNode->pLogBuf->matchIndex;) {
     if (batchSize < count || limit <= index - pMgr->startIndex) {
       break;
     }
     if (pMgr->startIndex + 1 < index && pMgr->states[(index - 1) % pMgr->size].barrier) {
       break;
     }
-    int64_t  pos = index % pMgr->size;
-    SRaftId* pDestId = &pNode->replicasId[pMgr->peerId];
-    bool     barrier = false;
-    SyncTerm term = -1;
-    if (syncLogReplSendTo(pMgr, pNode, index, &term, pDestId, &barrier) < 0) {
+    int64_t maxEntries = TMIN(batchSize + 1 - count, limit - (index - pMgr->startIndex));
+    maxEntries = TMIN(maxEntries, pNode->pLogBuf->matchIndex + 1 - index);
+
+    int32_t nEntries = 0;
+    bool    barrier = false;
+    if (syncLogReplSendRunTo(pMgr, pNode, index, maxEntries, nowMs, pDestId, &nEntries, &term, &barrier) < 0) {
       sError("vgId:%d, failed to replicate log entry since %s. index:%" PRId64 ", dest: 0x%016" PRIx64 "", pNode->vgId,
              terrstr(), index, pDestId->addr);
       return -1;
     }
-    pMgr->states[pos].barrier = barrier;
-    pMgr->states[pos].timeMs = nowMs;
-    pMgr->states[pos].term = term;
-    pMgr->states[pos].acked = false;
 
     if (firstIndex == -1) firstIndex = index;
-    count++;
+    count += nEntries;
+    index += nEntries;
 
-    pMgr->endIndex = index + 1;
+    pMgr->endIndex = index;
     if (barrier) {
       sInfo("vgId:%d, replicated sync barrier to dnode:%d. index:%" PRId64 ", term:%" PRId64 ", repl-mgr:[%" PRId64
             " %" PRId64 ", %" PRId64 ")",
-            pNode->vgId, DID(pDestId), index, term, pMgr->startIndex, pMgr->matchIndex, pMgr->endIndex);
+            pNode->vgId, DID(pDestId), index - 1, term, pMgr->startIndex, pMgr->matchIndex, pMgr->endIndex);
       break;
     }
   }
@@ -1299,3 +1341,83 @@ _err:
   }
   return -1;
 }
+
+// send the entries from index on in one append entries msg, at most maxEntries of them and up to the size limit of the
+// msg, ending with a barrier if any, and record them as sent in the repl mgr. Followers of older versions accept only
+// one entry per msg, so runs are sent only when syncAppendEntriesNum is raised after all replicas are upgraded.
+int32_t syncLogReplSendRunTo(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex index, int32_t maxEntries,
+                             int64_t nowMs, SRaftId* pDestId, int32_t* pNumOfEntries, SyncTerm* pTerm, bool* pBarrier) {
+  SSyncRaftEntry* entries[SYNC_APPEND_ENTRIES_MAX_NUM] = {0};
+  bool            inBufs[SYNC_APPEND_ENTRIES_MAX_NUM] = {0};
+  SRpcMsg         msgOut = {0};
+  SyncTerm        prevLogTerm = -1;
+  SSyncLogBuffer* pBuf = pNode->pLogBuf;
+  int32_t         num = 0;
+  int64_t         bytes = 0;
+  bool            barrier = false;
+  int32_t         ret = -1;
+
+  maxEntries = TMIN(maxEntries, TMIN(tsSyncAppendEntriesNum, SYNC_APPEND_ENTRIES_MAX_NUM));
+  maxEntries = TMAX(maxEntries, 1);
+  while (num < maxEntries && !barrier) {
+    bool            inBuf = false;
+    SSyncRaftEntry* pEntry = syncLogBufferGetOneEntry(pBuf, pNode, index + num, &inBuf);
+    if (pEntry == NULL) {
+      if (num > 0) break;
+      sWarn("vgId:%d, failed to get raft entry for index:%" PRId64 "", pNode->vgId, index);
+      if (terrno == TSDB_CODE_WAL_LOG_NOT_EXIST) {
+        sInfo("vgId:%d, reset sync log repl of peer:%" PRIx64 " since %s. index:%" PRId64, pNode->vgId, pDestId->addr,
+              terrstr(), index);
+        (void)syncLogReplReset(pMgr);
+      }
+      goto _out;
+    }
+
+    if (num > 0 && bytes + pEntry->bytes > SYNC_APPEND_ENTRIES_MAX_BYTES) {
+      if (!inBuf) syncEntryDestroy(pEntry);
+      break;
+    }
+
+    entries[num] = pEntry;
+    inBufs[num] = inBuf;
+    num++;
+    bytes += pEntry->bytes;
+    barrier = syncLogReplBarrier(pEntry);
+  }
+
+  prevLogTerm = syncLogReplGetPrevLogTerm(pMgr, pNode, index);
+  if (prevLogTerm < 0) {
+    sError("vgId:%d, failed to get prev log term since %s. index:%" PRId64 "", pNode->vgId, terrstr(), index);
+    goto _out;
+  }
+
+  if (syncBuildAppendEntriesFromRaftEntries(pNode, entries, num, prevLogTerm, &msgOut) < 0) {
+    sError("vgId:%d, failed to get append entries for index:%" PRId64 "", pNode->vgId, index);
+    goto _out;
+  }
+
+  (void)syncNodeSendAppendEntries(pNode, pDestId, &msgOut);
+
+  for (int32_t i = 0; i < num; ++i) {
+    SSyncReplInfo* pInfo = &pMgr->states[(index + i) % pMgr->size];
+    pInfo->barrier = syncLogReplBarrier(entries[i]);
+    pInfo->timeMs = nowMs;
+    pInfo->term = entries[i]->term;
+    pInfo->acked = false;
+  }
+
+  sTrace("vgId:%d, replicate %d msgs index:%" PRId64 " ... %" PRId64 " term:%" PRId64 " prevterm:%" PRId64
+         " to dest: 0x%016" PRIx64,
+         pNode->vgId, num, index, index + num - 1, entries[num - 1]->term, prevLogTerm, pDestId->addr);
+
+  *pNumOfEntries = num;
+  *pBarrier = barrier;
+  if (pTerm) *pTerm = entries[num - 1]->term;
+  ret = 0;
+
+_out:
+  for (int32_t i = 0; i < num; ++i) {
+    if (!inBufs[i]) syncEntryDestroy(entries[i]);
+  }
+  return ret;
+}
@@ -74,6 +74,38 @@ SSyncRaftEntry* syncEntryBuildFromAppendEntries(const SyncAppendEntries* pMsg) {
   return pEntry;
 }
 
+int32_t syncEntriesBuildFromAppendEntries(const SyncAppendEntries* pMsg, SSyncRaftEntry** ppEntries, int32_t maxEntries,
+                                          int32_t* pNumOfEntries) {
+  int32_t  num = 0;
+  uint32_t offset = 0;
+
+  while (offset < pMsg->dataLen) {
+    const SSyncRaftEntry* pRaw = (const SSyncRaftEntry*)(pMsg->data + offset);
+    if (num >= maxEntries || pMsg->dataLen - offset < sizeof(SSyncRaftEntry) || pRaw->bytes < sizeof(SSyncRaftEntry) ||
+        pRaw->bytes > pMsg->dataLen - offset) {
+      terrno = TSDB_CODE_INVALID_MSG;
+      goto _err;
+    }
+
+    SSyncRaftEntry* pEntry = taosMemoryMalloc(pRaw->bytes);
+    if (pEntry == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      goto _err;
+    }
+    memcpy(pEntry, pRaw, pRaw->bytes);
+    ppEntries[num++] = pEntry;
+    offset += pEntry->bytes;
+  }
+
+  *pNumOfEntries = num;
+  return 0;
+
+_err:
+  syncEntriesDestroy(ppEntries, num);
+  *pNumOfEntries = 0;
+  return -1;
+}
+
 SSyncRaftEntry* syncEntryBuildNoop(SyncTerm term, SyncIndex index, int32_t vgId) {
   SSyncRaftEntry* pEntry = syncEntryBuild(sizeof(SMsgHead));
   if (pEntry == NULL) return NULL;
@@ -99,6 +131,13 @@ void syncEntryDestroy(SSyncRaftEntry* pEntry) {
   }
 }
 
+void syncEntriesDestroy(SSyncRaftEntry** ppEntries, int32_t numOfEntries) {
+  for (int32_t i = 0; i < numOfEntries; ++i) {
+    syncEntryDestroy(ppEntries[i]);
+    ppEntries[i] = NULL;
+  }
+}
+
 void syncEntry2OriginalRpc(const SSyncRaftEntry* pEntry, SRpcMsg* pRpcMsg) {
   pRpcMsg->msgType = pEntry->originalRpcType;
   pRpcMsg->contLen = (int32_t)(pEntry->dataLen);
@@ -61,6 +61,8 @@ SSyncLogStore* logStoreCreate(SSyncNode* pSyncNode) {
   taosThreadMutexInit(&(pData->mutex), NULL);
   pData->pWalHandle = walOpenReader(pData->pWal, NULL, 0);
   ASSERT(pData->pWalHandle != NULL);
+  // restore and replication to lagging followers read the entries in order
+  walReaderSetReadAhead(pData->pWalHandle, WAL_READ_AHEAD_SIZE);
 
   pLogStore->syncLogUpdateCommitIndex = raftLogUpdateCommitIndex;
   pLogStore->syncLogCommitIndex = raftlogCommitIndex;
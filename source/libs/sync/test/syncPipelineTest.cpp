@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "syncMessage.h"
+#include "syncPipeline.h"
+#include "syncRaftEntry.h"
+#include "tglobal.h"
+
+namespace {
+
+const int32_t kPeerId = 1;
+const uint64_t kPeerAddr = 0x1234;
+
+// first index of each sent append entries msg, and the number of entries packed in it
+std::vector<std::pair<SyncIndex, int32_t>> sentRuns;
+
+int32_t captureSendMsg(const SEpSet* pEpSet, SRpcMsg* pMsg) {
+  SyncAppendEntries* pAppend = (SyncAppendEntries*)pMsg->pCont;
+  SSyncRaftEntry*    entries[SYNC_APPEND_ENTRIES_MAX_NUM] = {0};
+  int32_t            num = 0;
+  EXPECT_EQ(syncEntriesBuildFromAppendEntries(pAppend, entries, SYNC_APPEND_ENTRIES_MAX_NUM, &num), 0);
+  EXPECT_GT(num, 0);
+  if (num > 0) {
+    EXPECT_EQ(pAppend->prevLogIndex + 1, entries[0]->index);
+    sentRuns.push_back({entries[0]->index, num});
+  }
+  syncEntriesDestroy(entries, num);
+  rpcFreeCont(pMsg->pCont);
+  return 0;
+}
+
+SSyncRaftEntry* buildEntry(SyncIndex index, SyncTerm term, int32_t dataLen, bool barrier) {
+  SSyncRaftEntry* pEntry = syncEntryBuild(dataLen);
+  pEntry->msgType = TDMT_SYNC_CLIENT_REQUEST;
+  pEntry->originalRpcType = barrier ? TDMT_SYNC_NOOP : TDMT_VND_SUBMIT;
+  pEntry->term = term;
+  pEntry->index = index;
+  memset(pEntry->data, (int)(index & 0x7f), dataLen);
+  return pEntry;
+}
+
+SSyncNode* createNode() {
+  SSyncNode* pNode = (SSyncNode*)taosMemoryCalloc(1, sizeof(SSyncNode));
+  taosThreadMutexInit(&pNode->raftStore.mutex, NULL);
+  pNode->vgId = 2;
+  pNode->raftStore.currentTerm = 3;
+  pNode->pLogBuf = syncLogBufferCreate();
+  pNode->peersNum = 1;
+  pNode->peersId[0].addr = kPeerAddr;
+  pNode->replicasId[kPeerId].addr = kPeerAddr;
+  pNode->syncSendMSg = captureSendMsg;
+
+  // the dummy entry at the start of the buffer, matched and committed
+  SSyncLogBuffer* pBuf = pNode->pLogBuf;
+  pBuf->entries[0].pItem = buildEntry(0, 1, 8, false);
+  pBuf->endIndex = 1;
+  return pNode;
+}
+
+void destroyNode(SSyncNode* pNode) {
+  syncLogBufferDestroy(pNode->pLogBuf);
+  taosThreadMutexDestroy(&pNode->raftStore.mutex);
+  taosMemoryFree(pNode);
+}
+
+// append matched entries [1, num] of term 1 to the leader's buffer, with a barrier at barrierIndex
+void appendEntries(SSyncNode* pNode, SyncIndex num, SyncIndex barrierIndex) {
+  SSyncLogBuffer* pBuf = pNode->pLogBuf;
+  for (SyncIndex index = pBuf->endIndex; index <= num; ++index) {
+    pBuf->entries[index % pBuf->size].pItem = buildEntry(index, 1, 16 + index, index == barrierIndex);
+  }
+  pBuf->endIndex = num + 1;
+  pBuf->matchIndex = num;
+}
+
+SSyncLogReplMgr* createReplMgr() {
+  SSyncLogReplMgr* pMgr = syncLogReplCreate();
+  pMgr->peerId = kPeerId;
+  pMgr->restored = true;
+  pMgr->startIndex = 0;
+  pMgr->matchIndex = 0;
+  pMgr->endIndex = 1;
+
+  // the dummy entry is acked, as after a probe
+  pMgr->states[0].acked = true;
+  pMgr->states[0].term = 1;
+  pMgr->states[0].timeMs = taosGetMonoTimestampMs();
+  return pMgr;
+}
+
+class SyncPipelineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    entriesNum = tsSyncAppendEntriesNum;
+    sentRuns.clear();
+  }
+  void TearDown() override { tsSyncAppendEntriesNum = entriesNum; }
+
+  int32_t entriesNum = 1;
+};
+
+}  // namespace
+
+TEST_F(SyncPipelineTest, appendEntriesRoundTrip) {
+  SSyncNode*      pNode = createNode();
+  SSyncRaftEntry* entries[4] = {0};
+  for (int32_t i = 0; i < 4; ++i) {
+    entries[i] = buildEntry(10 + i, 2, 7 * i + 1, i == 3);
+  }
+
+  SRpcMsg rpcMsg = {0};
+  ASSERT_EQ(syncBuildAppendEntriesFromRaftEntries(pNode, entries, 4, 2, &rpcMsg), 0);
+  SyncAppendEntries* pMsg = (SyncAppendEntries*)rpcMsg.pCont;
+  EXPECT_EQ(pMsg->prevLogIndex, 9);
+  EXPECT_EQ(pMsg->prevLogTerm, 2);
+  EXPECT_EQ(pMsg->term, 3);
+  EXPECT_EQ(pMsg->bytes, sizeof(SyncAppendEntries) + pMsg->dataLen);
+
+  SSyncRaftEntry* decoded[SYNC_APPEND_ENTRIES_MAX_NUM] = {0};
+  int32_t         num = 0;
+  ASSERT_EQ(syncEntriesBuildFromAppendEntries(pMsg, decoded, SYNC_APPEND_ENTRIES_MAX_NUM, &num), 0);
+  ASSERT_EQ(num, 4);
+  for (int32_t i = 0; i < num; ++i) {
+    ASSERT_EQ(decoded[i]->bytes, entries[i]->bytes);
+    EXPECT_EQ(memcmp(decoded[i], entries[i], entries[i]->bytes), 0);
+  }
+  syncEntriesDestroy(decoded, num);
+
+  // more entries than the caller can take, or a truncated msg, is rejected
+  EXPECT_EQ(syncEntriesBuildFromAppendEntries(pMsg, decoded, 3, &num), -1);
+  EXPECT_EQ(terrno, TSDB_CODE_INVALID_MSG);
+  EXPECT_EQ(num, 0);
+  pMsg->dataLen -= 1;
+  EXPECT_EQ(syncEntriesBuildFromAppendEntries(pMsg, decoded, SYNC_APPEND_ENTRIES_MAX_NUM, &num), -1);
+  EXPECT_EQ(num, 0);
+  rpcFreeCont(rpcMsg.pCont);
+
+  // a msg of one entry is laid out as before, so that old followers can still decode it
+  ASSERT_EQ(syncBuildAppendEntriesFromRaftEntries(pNode, entries, 1, 2, &rpcMsg), 0);
+  pMsg = (SyncAppendEntries*)rpcMsg.pCont;
+  EXPECT_EQ(pMsg->dataLen, entries[0]->bytes);
+  SSyncRaftEntry* pEntry = syncEntryBuildFromAppendEntries(pMsg);
+  EXPECT_EQ(memcmp(pEntry, entries[0], entries[0]->bytes), 0);
+  syncEntryDestroy(pEntry);
+  rpcFreeCont(rpcMsg.pCont);
+
+  syncEntriesDestroy(entries, 4);
+  destroyNode(pNode);
+}
+
+TEST_F(SyncPipelineTest, acceptRunPartially) {
+  SSyncNode*      pNode = createNode();
+  SSyncLogBuffer* pBuf = pNode->pLogBuf;
+
+  // the last two entries are out of the buffer range: the ones before are accepted, the rest are dropped
+  SyncIndex       first = pBuf->size - 2;
+  SSyncRaftEntry* entries[4] = {0};
+  for (int32_t i = 0; i < 4; ++i) {
+    entries[i] = buildEntry(first + i, 1, 8, false);
+  }
+  EXPECT_EQ(syncLogBufferAcceptRun(pBuf, pNode, entries, 4, 1), -1);
+  for (int32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(entries[i], nullptr);
+  }
+  EXPECT_EQ(pBuf->endIndex, pBuf->size);
+  EXPECT_EQ(pBuf->matchIndex, 0);
+  EXPECT_NE(pBuf->entries[first % pBuf->size].pItem, nullptr);
+  EXPECT_NE(pBuf->entries[(first + 1) % pBuf->size].pItem, nullptr);
+  EXPECT_EQ(pBuf->entries[first % pBuf->size].prevLogTerm, 1);
+
+  // the first entry of a run is checked against the last match term, the following ones are chained on it
+  SSyncRaftEntry* mismatched[2] = {buildEntry(1, 2, 8, false), buildEntry(2, 2, 8, false)};
+  EXPECT_EQ(syncLogBufferAcceptRun(pBuf, pNode, mismatched, 2, 2), -1);
+  EXPECT_EQ(pBuf->entries[1].pItem, nullptr);
+  EXPECT_EQ(pBuf->entries[2].pItem, nullptr);
+
+  SSyncRaftEntry* chained[2] = {buildEntry(1, 1, 8, false), buildEntry(2, 2, 8, false)};
+  EXPECT_EQ(syncLogBufferAcceptRun(pBuf, pNode, chained, 2, 1), 0);
+  EXPECT_EQ(pBuf->entries[1].prevLogTerm, 1);
+  EXPECT_EQ(pBuf->entries[2].prevLogTerm, 1);
+  EXPECT_EQ(pBuf->entries[2].pItem->term, 2);
+
+  destroyNode(pNode);
+}
+
+TEST_F(SyncPipelineTest, attemptSingleEntryByDefault) {
+  SSyncNode*       pNode = createNode();
+  SSyncLogReplMgr* pMgr = createReplMgr();
+  appendEntries(pNode, 4, -1);
+
+  tsSyncAppendEntriesNum = 1;
+  ASSERT_EQ(syncLogReplAttempt(pMgr, pNode), 0);
+  ASSERT_EQ(sentRuns.size(), 4);
+  for (int32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(sentRuns[i].first, i + 1);
+    EXPECT_EQ(sentRuns[i].second, 1);
+  }
+  EXPECT_EQ(pMgr->endIndex, 5);
+
+  syncLogReplDestroy(pMgr);
+  destroyNode(pNode);
+}
+
+TEST_F(SyncPipelineTest, attemptStopsAtBarrier) {
+  SSyncNode*       pNode = createNode();
+  SSyncLogReplMgr* pMgr = createReplMgr();
+  appendEntries(pNode, 10, 5);
+
+  tsSyncAppendEntriesNum = SYNC_APPEND_ENTRIES_MAX_NUM;
+  ASSERT_EQ(syncLogReplAttempt(pMgr, pNode), 0);
+  ASSERT_EQ(sentRuns.size(), 1);
+  EXPECT_EQ(sentRuns[0].first, 1);
+  EXPECT_EQ(sentRuns[0].second, 5);
+  EXPECT_EQ(pMgr->endIndex, 6);
+  for (SyncIndex index = 1; index < 6; ++index) {
+    SSyncReplInfo* pInfo = &pMgr->states[index % pMgr->size];
+    EXPECT_FALSE(pInfo->acked);
+    EXPECT_EQ(pInfo->term, 1);
+    EXPECT_EQ(pInfo->barrier, index == 5);
+  }
+
+  // the pipeline stays closed behind the unacked barrier
+  sentRuns.clear();
+  ASSERT_EQ(syncLogReplAttempt(pMgr, pNode), 0);
+  EXPECT_TRUE(sentRuns.empty());
+  EXPECT_EQ(pMgr->endIndex, 6);
+
+  syncLogReplDestroy(pMgr);
+  destroyNode(pNode);
+}
+
+TEST_F(SyncPipelineTest, retryResendsUnackedRuns) {
+  SSyncNode*       pNode = createNode();
+  SSyncLogReplMgr* pMgr = createReplMgr();
+  appendEntries(pNode, 5, 5);
+
+  tsSyncAppendEntriesNum = SYNC_APPEND_ENTRIES_MAX_NUM;
+  ASSERT_EQ(syncLogReplAttempt(pMgr, pNode), 0);
+  ASSERT_EQ(sentRuns.size(), 1);
+
+  // index 3 was acked, the others are due for retry
+  int64_t dueMs = taosGetMonoTimestampMs() - syncLogReplGetRetryBackoffTimeMs(pMgr) - 1;
+  for (SyncIndex index = pMgr->startIndex; index < pMgr->endIndex; ++index) {
+    pMgr->states[index % pMgr->size].timeMs = dueMs;
+  }
+  pMgr->states[3 % pMgr->size].acked = true;
+
+  sentRuns.clear();
+  ASSERT_EQ(syncLogReplRetryOnNeed(pMgr, pNode), 0);
+  ASSERT_EQ(sentRuns.size(), 2);
+  EXPECT_EQ(sentRuns[0].first, 1);
+  EXPECT_EQ(sentRuns[0].second, 2);
+  EXPECT_EQ(sentRuns[1].first, 4);
+  EXPECT_EQ(sentRuns[1].second, 2);
+  EXPECT_EQ(pMgr->retryBackoff, 1);
+  EXPECT_GT(pMgr->states[1].timeMs, dueMs);
+  EXPECT_EQ(pMgr->states[3].timeMs, dueMs);
+
+  // nothing is due again before the backoff
+  sentRuns.clear();
+  ASSERT_EQ(syncLogReplRetryOnNeed(pMgr, pNode), 0);
+  EXPECT_TRUE(sentRuns.empty());
+
+  syncLogReplDestroy(pMgr);
+  destroyNode(pNode);
+}
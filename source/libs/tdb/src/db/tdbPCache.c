@@ -17,10 +17,14 @@
 // #include <sys/types.h>
 // #include <unistd.h>
 
-struct SPCache {
-  int         szPage;
-  int         nPages;
-  SPage     **aPage;
+// The cache is partitioned into shards by the page hash, each of which has its own lock, free list, hash table and
+// lru list, so fetches of different pages from many threads do not contend on one lock. A page belongs to the shard
+// of its pgid while it is in use, and is taken by another shard, from its free list or the tail of its lru list, when
+// that shard runs out of pages.
+#define TDB_PCACHE_MAX_SHARDS     8
+#define TDB_PCACHE_PAGES_PER_SHARD 64
+
+typedef struct {
   tdb_mutex_t mutex;
   int         nFree;
   SPage      *pFree;
@@ -29,6 +33,14 @@ struct SPCache {
   SPage     **pgHash;
   int         nRecyclable;
   SPage       lru;
+} SPCacheShard;
+
+struct SPCache {
+  int           szPage;
+  int           nPages;
+  SPage       **aPage;
+  int           nShards;
+  SPCacheShard *aShard;
 };
 
 static inline uint32_t tdbPCachePageHash(const SPgid *pPgid) {
@@ -36,18 +48,41 @@ static inline uint32_t tdbPCachePageHash(const SPgid *pPgid) {
   return (uint32_t)(t[0] + t[1] + t[2] + t[3] + t[4] + t[5] + (pPgid)->pgno);
 }
 
+static inline int tdbPCacheShardOf(SPCache *pCache, const SPgid *pPgid) {
+  // scramble the hash, so the adjacent pages of a file are spread over the shards
+  return (int)(((tdbPCachePageHash(pPgid) * 2654435761u) >> 16) % pCache->nShards);
+}
+
 static int    tdbPCacheOpenImpl(SPCache *pCache);
-static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn);
-static void   tdbPCachePinPage(SPCache *pCache, SPage *pPage);
-static void   tdbPCacheRemovePageFromHash(SPCache *pCache, SPage *pPage);
-static void   tdbPCacheAddPageToHash(SPCache *pCache, SPage *pPage);
+static SPage *tdbPCacheFetchImpl(SPCache *pCache, int iShard, const SPgid *pPgid, TXN *pTxn);
+static void   tdbPCachePinPage(SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheRemovePageFromHash(SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheAddPageToHash(SPCacheShard *pShard, SPage *pPage);
 static void   tdbPCacheUnpinPage(SPCache *pCache, SPage *pPage);
 static int    tdbPCacheCloseImpl(SPCache *pCache);
 
-static void tdbPCacheInitLock(SPCache *pCache) { tdbMutexInit(&(pCache->mutex), NULL); }
-static void tdbPCacheDestroyLock(SPCache *pCache) { tdbMutexDestroy(&(pCache->mutex)); }
-static void tdbPCacheLock(SPCache *pCache) { tdbMutexLock(&(pCache->mutex)); }
-static void tdbPCacheUnlock(SPCache *pCache) { tdbMutexUnlock(&(pCache->mutex)); }
+static void tdbPCacheInitLock(SPCacheShard *pShard) { tdbMutexInit(&(pShard->mutex), NULL); }
+static void tdbPCacheDestroyLock(SPCacheShard *pShard) { tdbMutexDestroy(&(pShard->mutex)); }
+static void tdbPCacheLock(SPCacheShard *pShard) { tdbMutexLock(&(pShard->mutex)); }
+static void tdbPCacheUnlock(SPCacheShard *pShard) { tdbMutexUnlock(&(pShard->mutex)); }
+
+static void tdbPCacheLockAll(SPCache *pCache) {
+  for (int i = 0; i < pCache->nShards; i++) {
+    tdbPCacheLock(&pCache->aShard[i]);
+  }
+}
+
+static void tdbPCacheUnlockAll(SPCache *pCache) {
+  for (int i = pCache->nShards - 1; i >= 0; i--) {
+    tdbPCacheUnlock(&pCache->aShard[i]);
+  }
+}
+
+static void tdbPCachePushFree(SPCacheShard *pShard, SPage *pPage) {
+  pPage->pFreeNext = pShard->pFree;
+  pShard->pFree = pPage;
+  pShard->nFree++;
+}
 
 int tdbPCacheOpen(int pageSize, int cacheSize, SPCache **ppCache) {
   SPCache *pCache;
@@ -124,9 +159,8 @@ static int tdbPCacheAlterImpl(SPCache *pCache, int32_t nPage) {
 
     // add page to free list
     for (int32_t iPage = pCache->nPages; iPage < nPage; iPage++) {
-      aPage[iPage]->pFreeNext = pCache->pFree;
-      pCache->pFree = aPage[iPage];
-      pCache->nFree++;
+      aPage[iPage]->iShard = iPage % pCache->nShards;
+      tdbPCachePushFree(&pCache->aShard[aPage[iPage]->iShard], aPage[iPage]);
     }
 
     for (int32_t iPage = 0; iPage < pCache->nPages; iPage++) {
@@ -136,17 +170,20 @@ static int tdbPCacheAlterImpl(SPCache *pCache, int32_t nPage) {
     tdbOsFree(pCache->aPage);
     pCache->aPage = aPage;
   } else {
-    for (SPage **ppPage = &pCache->pFree; *ppPage;) {
-      int32_t iPage = (*ppPage)->id;
-
-      if (iPage >= nPage) {
-        SPage *pPage = *ppPage;
-        *ppPage = pPage->pFreeNext;
-        pCache->aPage[pPage->id] = NULL;
-        tdbPageDestroy(pPage, tdbDefaultFree, NULL);
-        pCache->nFree--;
-      } else {
-        ppPage = &(*ppPage)->pFreeNext;
+    for (int i = 0; i < pCache->nShards; i++) {
+      SPCacheShard *pShard = &pCache->aShard[i];
+      for (SPage **ppPage = &pShard->pFree; *ppPage;) {
+        int32_t iPage = (*ppPage)->id;
+
+        if (iPage >= nPage) {
+          SPage *pPage = *ppPage;
+          *ppPage = pPage->pFreeNext;
+          pCache->aPage[pPage->id] = NULL;
+          tdbPageDestroy(pPage, tdbDefaultFree, NULL);
+          pShard->nFree--;
+        } else {
+          ppPage = &(*ppPage)->pFreeNext;
+        }
       }
     }
   }
@@ -158,11 +195,11 @@ static int tdbPCacheAlterImpl(SPCache *pCache, int32_t nPage) {
 int tdbPCacheAlter(SPCache *pCache, int32_t nPage) {
   int ret = 0;
 
-  tdbPCacheLock(pCache);
+  tdbPCacheLockAll(pCache);
 
   ret = tdbPCacheAlterImpl(pCache, nPage);
 
-  tdbPCacheUnlock(pCache);
+  tdbPCacheUnlockAll(pCache);
 
   return ret;
 }
@@ -170,15 +207,16 @@ int tdbPCacheAlter(SPCache *pCache, int32_t nPage) {
 SPage *tdbPCacheFetch(SPCache *pCache, const SPgid *pPgid, TXN *pTxn) {
   SPage *pPage;
   i32    nRef = 0;
+  int    iShard = tdbPCacheShardOf(pCache, pPgid);
 
-  tdbPCacheLock(pCache);
+  tdbPCacheLock(&pCache->aShard[iShard]);
 
-  pPage = tdbPCacheFetchImpl(pCache, pPgid, pTxn);
+  pPage = tdbPCacheFetchImpl(pCache, iShard, pPgid, pTxn);
   if (pPage) {
     nRef = tdbRefPage(pPage);
   }
 
-  tdbPCacheUnlock(pCache);
+  tdbPCacheUnlock(&pCache->aShard[iShard]);
 
   // printf("thread %" PRId64 " fetch page %d pgno %d pPage %p nRef %d\n", taosGetSelfPthreadId(), pPage->id,
   //        TDB_PAGE_PGNO(pPage), pPage, nRef);
@@ -193,23 +231,25 @@ SPage *tdbPCacheFetch(SPCache *pCache, const SPgid *pPgid, TXN *pTxn) {
 }
 
 void tdbPCacheMarkFree(SPCache *pCache, SPage *pPage) {
-  tdbPCacheLock(pCache);
-  tdbPCacheRemovePageFromHash(pCache, pPage);
+  SPCacheShard *pShard = &pCache->aShard[pPage->iShard];
+
+  tdbPCacheLock(pShard);
+  tdbPCacheRemovePageFromHash(pShard, pPage);
   pPage->isFree = 1;
-  tdbPCacheUnlock(pCache);
+  tdbPCacheUnlock(pShard);
 }
 
 static void tdbPCacheFreePage(SPCache *pCache, SPage *pPage) {
+  SPCacheShard *pShard = &pCache->aShard[pPage->iShard];
+
   if (pPage->id < pCache->nPages) {
-    pPage->pFreeNext = pCache->pFree;
-    pCache->pFree = pPage;
     pPage->isFree = 0;
-    ++pCache->nFree;
+    tdbPCachePushFree(pShard, pPage);
     tdbTrace("pcache/free page %p/%d, pgno:%d, ", pPage, pPage->id, TDB_PAGE_PGNO(pPage));
   } else {
     tdbTrace("pcache/free2 page: %p/%d, pgno:%d, ", pPage, pPage->id, TDB_PAGE_PGNO(pPage));
 
-    tdbPCacheRemovePageFromHash(pCache, pPage);
+    tdbPCacheRemovePageFromHash(pShard, pPage);
     tdbPageDestroy(pPage, tdbDefaultFree, NULL);
   }
 }
@@ -222,7 +262,9 @@ void tdbPCacheInvalidatePage(SPCache *pCache, SPager *pPager, SPgno pgno) {
   memcpy(&pgid, pPager->fid, TDB_FILE_ID_LEN);
   pgid.pgno = pgno;
 
-  pPage = pCache->pgHash[tdbPCachePageHash(pPgid) % pCache->nHash];
+  SPCacheShard *pShard = &pCache->aShard[tdbPCacheShardOf(pCache, pPgid)];
+
+  pPage = pShard->pgHash[tdbPCachePageHash(pPgid) % pShard->nHash];
   while (pPage) {
     if (pPage->pgid.pgno == pPgid->pgno && memcmp(pPage->pgid.fileid, pPgid->fileid, TDB_FILE_ID_LEN) == 0) break;
     pPage = pPage->pHashNext;
@@ -231,10 +273,10 @@ void tdbPCacheInvalidatePage(SPCache *pCache, SPager *pPager, SPgno pgno) {
   if (pPage) {
     bool moveToFreeList = false;
     if (pPage->pLruNext) {
-      tdbPCachePinPage(pCache, pPage);
+      tdbPCachePinPage(pShard, pPage);
       moveToFreeList = true;
     }
-    tdbPCacheRemovePageFromHash(pCache, pPage);
+    tdbPCacheRemovePageFromHash(pShard, pPage);
     if (moveToFreeList) {
       tdbPCacheFreePage(pCache, pPage);
     }
@@ -249,7 +291,9 @@ void tdbPCacheRelease(SPCache *pCache, SPage *pPage, TXN *pTxn) {
     return;
   }
 
-  tdbPCacheLock(pCache);
+  SPCacheShard *pShard = &pCache->aShard[pPage->iShard];
+
+  tdbPCacheLock(pShard);
   nRef = tdbUnrefPage(pPage);
   tdbTrace("pcache/release page %p/%d/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id, nRef);
   if (nRef == 0) {
@@ -266,22 +310,68 @@ void tdbPCacheRelease(SPCache *pCache, SPage *pPage, TXN *pTxn) {
     } else {
       if (TDB_TXN_IS_WRITE(pTxn)) {
         // remove from hash
-        tdbPCacheRemovePageFromHash(pCache, pPage);
+        tdbPCacheRemovePageFromHash(pShard, pPage);
       }
 
       tdbPageDestroy(pPage, pTxn->xFree, pTxn->xArg);
     }
     // }
   }
-  tdbPCacheUnlock(pCache);
+  tdbPCacheUnlock(pShard);
 }
 
 int tdbPCacheGetPageSize(SPCache *pCache) { return pCache->szPage; }
 
-static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn) {
-  int    ret = 0;
+// take a free page of another shard, the shards are only tried so a fetch never waits for the lock of another one
+static SPage *tdbPCacheStealFreePage(SPCache *pCache, int iShard) {
+  SPage *pPage = NULL;
+
+  for (int i = 1; i < pCache->nShards && pPage == NULL; i++) {
+    SPCacheShard *pShard = &pCache->aShard[(iShard + i) % pCache->nShards];
+    if (pShard->nFree == 0 || tdbMutexTryLock(&pShard->mutex) != 0) {
+      continue;
+    }
+
+    if (pShard->pFree) {
+      pPage = pShard->pFree;
+      pShard->pFree = pPage->pFreeNext;
+      pShard->nFree--;
+    }
+
+    tdbPCacheUnlock(pShard);
+  }
+
+  return pPage;
+}
+
+// recycle the least recently used page of another shard, tried as tdbPCacheStealFreePage, so the pages of a skewed
+// shard are not created beyond the cache size while the other shards hold unused ones
+static SPage *tdbPCacheStealLruPage(SPCache *pCache, int iShard) {
   SPage *pPage = NULL;
-  SPage *pPageH = NULL;
+
+  for (int i = 1; i < pCache->nShards && pPage == NULL; i++) {
+    SPCacheShard *pShard = &pCache->aShard[(iShard + i) % pCache->nShards];
+    if (pShard->nRecyclable == 0 || tdbMutexTryLock(&pShard->mutex) != 0) {
+      continue;
+    }
+
+    if (!pShard->lru.pLruPrev->isAnchor) {
+      pPage = pShard->lru.pLruPrev;
+      tdbPCacheRemovePageFromHash(pShard, pPage);
+      tdbPCachePinPage(pShard, pPage);
+    }
+
+    tdbPCacheUnlock(pShard);
+  }
+
+  return pPage;
+}
+
+static SPage *tdbPCacheFetchImpl(SPCache *pCache, int iShard, const SPgid *pPgid, TXN *pTxn) {
+  int           ret = 0;
+  SPage        *pPage = NULL;
+  SPage        *pPageH = NULL;
+  SPCacheShard *pShard = &pCache->aShard[iShard];
 
   if (!pTxn) {
     tdbError("tdb/pcache: null ptr pTxn, fetch impl failed.");
@@ -289,7 +379,7 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
   }
 
   // 1. Search the hash table
-  pPage = pCache->pgHash[tdbPCachePageHash(pPgid) % pCache->nHash];
+  pPage = pShard->pgHash[tdbPCachePageHash(pPgid) % pShard->nHash];
   while (pPage) {
     if (pPage->pgid.pgno == pPgid->pgno && memcmp(pPage->pgid.fileid, pPgid->fileid, TDB_FILE_ID_LEN) == 0) break;
     pPage = pPage->pHashNext;
@@ -297,7 +387,7 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
 
   if (pPage) {
     if (pPage->isLocal || TDB_TXN_IS_WRITE(pTxn)) {
-      tdbPCachePinPage(pCache, pPage);
+      tdbPCachePinPage(pShard, pPage);
       return pPage;
     }
   }
@@ -308,21 +398,34 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
   pPage = NULL;
 
   // 2. Try to allocate a new page from the free list
-  if (pCache->pFree) {
-    pPage = pCache->pFree;
-    pCache->pFree = pPage->pFreeNext;
-    pCache->nFree--;
+  if (pShard->pFree) {
+    pPage = pShard->pFree;
+    pShard->pFree = pPage->pFreeNext;
+    pShard->nFree--;
     pPage->pLruNext = NULL;
   }
 
-  // 3. Try to Recycle a page
-  if (!pPage && !pCache->lru.pLruPrev->isAnchor) {
-    pPage = pCache->lru.pLruPrev;
-    tdbPCacheRemovePageFromHash(pCache, pPage);
-    tdbPCachePinPage(pCache, pPage);
+  // 3. Try to take a free page of the other shards, before any cached page is recycled
+  if (!pPage) {
+    pPage = tdbPCacheStealFreePage(pCache, iShard);
+    if (pPage) {
+      pPage->pLruNext = NULL;
+    }
+  }
+
+  // 4. Try to Recycle a page
+  if (!pPage && !pShard->lru.pLruPrev->isAnchor) {
+    pPage = pShard->lru.pLruPrev;
+    tdbPCacheRemovePageFromHash(pShard, pPage);
+    tdbPCachePinPage(pShard, pPage);
+  }
+
+  // 5. Try to recycle a page of the other shards
+  if (!pPage) {
+    pPage = tdbPCacheStealLruPage(pCache, iShard);
   }
 
-  // 4. Try a create new page
+  // 6. Try a create new page
   if (!pPage && pTxn->xMalloc != NULL) {
     ret = tdbPageCreate(pCache->szPage, &pPage, pTxn->xMalloc, pTxn->xArg);
     if (ret < 0 || pPage == NULL) {
@@ -338,10 +441,11 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
     pPage->id = -1;
   }
 
-  // 5. Page here are just created from a free list
+  // 7. Page here are just created from a free list
   // or by recycling or allocated streesly,
   // need to initialize it
   if (pPage) {
+    pPage->iShard = iShard;
     if (pPageH) {
       // copy the page content
       memcpy(&(pPage->pgid), pPgid, sizeof(*pPgid));
@@ -371,7 +475,7 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
       pPage->pPager = NULL;
 
       if (pPage->isLocal || TDB_TXN_IS_WRITE(pTxn)) {
-        tdbPCacheAddPageToHash(pCache, pPage);
+        tdbPCacheAddPageToHash(pShard, pPage);
       }
     }
   }
@@ -379,7 +483,7 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
   return pPage;
 }
 
-static void tdbPCachePinPage(SPCache *pCache, SPage *pPage) {
+static void tdbPCachePinPage(SPCacheShard *pShard, SPage *pPage) {
   if (pPage->pLruNext != NULL) {
     int32_t nRef = tdbGetPageRef(pPage);
     if (nRef != 0) {
@@ -391,7 +495,7 @@ static void tdbPCachePinPage(SPCache *pCache, SPage *pPage) {
     pPage->pLruNext->pLruPrev = pPage->pLruPrev;
     pPage->pLruNext = NULL;
 
-    pCache->nRecyclable--;
+    pShard->nRecyclable--;
 
     tdbTrace("pcache/pin page %p/%d, pgno:%d, ", pPage, pPage->id, TDB_PAGE_PGNO(pPage));
   }
@@ -416,49 +520,51 @@ static void tdbPCacheUnpinPage(SPCache *pCache, SPage *pPage) {
     return;
   }
 
+  SPCacheShard *pShard = &pCache->aShard[pPage->iShard];
+
   tdbTrace("pCache:%p unpin page %p/%d, nPages:%d, pgno:%d, ", pCache, pPage, pPage->id, pCache->nPages,
            TDB_PAGE_PGNO(pPage));
   if (pPage->id < pCache->nPages) {
-    pPage->pLruPrev = &(pCache->lru);
-    pPage->pLruNext = pCache->lru.pLruNext;
-    pCache->lru.pLruNext->pLruPrev = pPage;
-    pCache->lru.pLruNext = pPage;
+    pPage->pLruPrev = &(pShard->lru);
+    pPage->pLruNext = pShard->lru.pLruNext;
+    pShard->lru.pLruNext->pLruPrev = pPage;
+    pShard->lru.pLruNext = pPage;
 
-    pCache->nRecyclable++;
+    pShard->nRecyclable++;
 
     // printf("unpin page %d pgno %d pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
     tdbTrace("pcache/unpin page %p/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id);
   } else {
     tdbTrace("pcache destroy page: %p/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id);
 
-    tdbPCacheRemovePageFromHash(pCache, pPage);
+    tdbPCacheRemovePageFromHash(pShard, pPage);
     tdbPageDestroy(pPage, tdbDefaultFree, NULL);
   }
 }
 
-static void tdbPCacheRemovePageFromHash(SPCache *pCache, SPage *pPage) {
-  uint32_t h = tdbPCachePageHash(&(pPage->pgid)) % pCache->nHash;
+static void tdbPCacheRemovePageFromHash(SPCacheShard *pShard, SPage *pPage) {
+  uint32_t h = tdbPCachePageHash(&(pPage->pgid)) % pShard->nHash;
 
-  SPage **ppPage = &(pCache->pgHash[h]);
+  SPage **ppPage = &(pShard->pgHash[h]);
   for (; (*ppPage) && *ppPage != pPage; ppPage = &((*ppPage)->pHashNext))
     ;
 
   if (*ppPage) {
     *ppPage = pPage->pHashNext;
-    pCache->nPage--;
+    pShard->nPage--;
     // printf("rmv page %d to hash, pgno %d, pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
   }
 
   tdbTrace("pcache/remove page %p/%d from hash %" PRIu32 " pgno:%d, ", pPage, pPage->id, h, TDB_PAGE_PGNO(pPage));
 }
 
-static void tdbPCacheAddPageToHash(SPCache *pCache, SPage *pPage) {
-  uint32_t h = tdbPCachePageHash(&(pPage->pgid)) % pCache->nHash;
+static void tdbPCacheAddPageToHash(SPCacheShard *pShard, SPage *pPage) {
+  uint32_t h = tdbPCachePageHash(&(pPage->pgid)) % pShard->nHash;
 
-  pPage->pHashNext = pCache->pgHash[h];
-  pCache->pgHash[h] = pPage;
+  pPage->pHashNext = pShard->pgHash[h];
+  pShard->pgHash[h] = pPage;
 
-  pCache->nPage++;
+  pShard->nPage++;
 
   tdbTrace("pcache/add page %p/%d to hash %" PRIu32 " pgno:%d, ", pPage, pPage->id, h, TDB_PAGE_PGNO(pPage));
 }
@@ -469,11 +575,40 @@ static int tdbPCacheOpenImpl(SPCache *pCache) {
   int    tsize;
   int    ret;
 
-  tdbPCacheInitLock(pCache);
+  pCache->nShards = pCache->nPages / TDB_PCACHE_PAGES_PER_SHARD;
+  if (pCache->nShards < 1) {
+    pCache->nShards = 1;
+  } else if (pCache->nShards > TDB_PCACHE_MAX_SHARDS) {
+    pCache->nShards = TDB_PCACHE_MAX_SHARDS;
+  }
+
+  pCache->aShard = (SPCacheShard *)tdbOsCalloc(pCache->nShards, sizeof(SPCacheShard));
+  if (pCache->aShard == NULL) {
+    return -1;
+  }
+
+  for (int iShard = 0; iShard < pCache->nShards; iShard++) {
+    SPCacheShard *pShard = &pCache->aShard[iShard];
+
+    tdbPCacheInitLock(pShard);
+
+    // Open the hash table
+    pShard->nPage = 0;
+    pShard->nHash = pCache->nPages / pCache->nShards < 8 ? 8 : pCache->nPages / pCache->nShards;
+    pShard->pgHash = (SPage **)tdbOsCalloc(pShard->nHash, sizeof(SPage *));
+    if (pShard->pgHash == NULL) {
+      // TODO
+      return -1;
+    }
+
+    // Open LRU list
+    pShard->nRecyclable = 0;
+    pShard->lru.isAnchor = 1;
+    pShard->lru.pLruNext = &(pShard->lru);
+    pShard->lru.pLruPrev = &(pShard->lru);
+  }
 
   // Open the free list
-  pCache->nFree = 0;
-  pCache->pFree = NULL;
   for (int i = 0; i < pCache->nPages; i++) {
     if (tdbPageCreate(pCache->szPage, &pPage, tdbDefaultMalloc, NULL) < 0) {
       // TODO: handle error
@@ -490,50 +625,40 @@ static int tdbPCacheOpenImpl(SPCache *pCache) {
     pPage->pDirtyNext = NULL;
 
     // add page to free list
-    pPage->pFreeNext = pCache->pFree;
-    pCache->pFree = pPage;
-    pCache->nFree++;
+    pPage->iShard = i % pCache->nShards;
+    tdbPCachePushFree(&pCache->aShard[pPage->iShard], pPage);
 
     // add to local list
     pPage->id = i;
     pCache->aPage[i] = pPage;
   }
 
-  // Open the hash table
-  pCache->nPage = 0;
-  pCache->nHash = pCache->nPages < 8 ? 8 : pCache->nPages;
-  pCache->pgHash = (SPage **)tdbOsCalloc(pCache->nHash, sizeof(SPage *));
-  if (pCache->pgHash == NULL) {
-    // TODO
-    return -1;
-  }
-
-  // Open LRU list
-  pCache->nRecyclable = 0;
-  pCache->lru.isAnchor = 1;
-  pCache->lru.pLruNext = &(pCache->lru);
-  pCache->lru.pLruPrev = &(pCache->lru);
-
   return 0;
 }
 
 static int tdbPCacheCloseImpl(SPCache *pCache) {
-  // free free page
-  for (SPage *pPage = pCache->pFree; pPage;) {
-    SPage *pPageT = pPage->pFreeNext;
-    tdbPageDestroy(pPage, tdbDefaultFree, NULL);
-    pPage = pPageT;
-  }
+  for (int iShard = 0; iShard < pCache->nShards; iShard++) {
+    SPCacheShard *pShard = &pCache->aShard[iShard];
 
-  for (int32_t iBucket = 0; iBucket < pCache->nHash; iBucket++) {
-    for (SPage *pPage = pCache->pgHash[iBucket]; pPage;) {
-      SPage *pPageT = pPage->pHashNext;
+    // free free page
+    for (SPage *pPage = pShard->pFree; pPage;) {
+      SPage *pPageT = pPage->pFreeNext;
       tdbPageDestroy(pPage, tdbDefaultFree, NULL);
       pPage = pPageT;
     }
+
+    for (int32_t iBucket = 0; iBucket < pShard->nHash; iBucket++) {
+      for (SPage *pPage = pShard->pgHash[iBucket]; pPage;) {
+        SPage *pPageT = pPage->pHashNext;
+        tdbPageDestroy(pPage, tdbDefaultFree, NULL);
+        pPage = pPageT;
+      }
+    }
+
+    tdbOsFree(pShard->pgHash);
+    tdbPCacheDestroyLock(pShard);
   }
 
-  tdbOsFree(pCache->pgHash);
-  tdbPCacheDestroyLock(pCache);
+  tdbOsFree(pCache->aShard);
   return 0;
 }
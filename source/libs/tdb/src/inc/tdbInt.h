@@ -212,6 +212,7 @@ int tdbPagerRollback(SPager *pPager);
   u8           isFree;     \
   volatile i32 nRef;       \
   i32          id;         \
+  i32          iShard;     \
   SPage       *pFreeNext;  \
   SPage       *pHashNext;  \
   SPage       *pLruNext;   \
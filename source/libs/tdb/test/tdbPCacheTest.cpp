@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+
+#define ALLOW_FORBID_FUNC
+#include "os.h"
+#include "tdb.h"
+#include "tdbInt.h"
+
+#include <thread>
+#include <vector>
+
+typedef struct SPoolMem {
+  int64_t          size;
+  struct SPoolMem *prev;
+  struct SPoolMem *next;
+} SPoolMem;
+
+static SPoolMem *openPool() {
+  SPoolMem *pPool = (SPoolMem *)taosMemoryMalloc(sizeof(*pPool));
+
+  pPool->prev = pPool->next = pPool;
+  pPool->size = 0;
+
+  return pPool;
+}
+
+static void clearPool(SPoolMem *pPool) {
+  SPoolMem *pMem;
+
+  do {
+    pMem = pPool->next;
+
+    if (pMem == pPool) break;
+
+    pMem->next->prev = pMem->prev;
+    pMem->prev->next = pMem->next;
+    pPool->size -= pMem->size;
+
+    taosMemoryFree(pMem);
+  } while (1);
+
+  assert(pPool->size == 0);
+}
+
+static void closePool(SPoolMem *pPool) {
+  clearPool(pPool);
+  taosMemoryFree(pPool);
+}
+
+static void *poolMalloc(void *arg, size_t size) {
+  SPoolMem *pPool = (SPoolMem *)arg;
+  SPoolMem *pMem = (SPoolMem *)taosMemoryMalloc(sizeof(*pMem) + size);
+  if (pMem == NULL) {
+    assert(0);
+  }
+
+  pMem->size = sizeof(*pMem) + size;
+  pMem->next = pPool->next;
+  pMem->prev = pPool;
+
+  pPool->next->prev = pMem;
+  pPool->next = pMem;
+  pPool->size += pMem->size;
+
+  return (void *)(&pMem[1]);
+}
+
+static void poolFree(void *arg, void *ptr) {
+  SPoolMem *pPool = (SPoolMem *)arg;
+  SPoolMem *pMem = &(((SPoolMem *)ptr)[-1]);
+
+  pMem->next->prev = pMem->prev;
+  pMem->prev->next = pMem->next;
+  pPool->size -= pMem->size;
+
+  taosMemoryFree(pMem);
+}
+
+static const int nData = 200000;
+static const int nGetsPerThread = 200000;
+
+static void insertData(TDB *pEnv, TTB *pDb) {
+  char      key[64];
+  char      val[64];
+  TXN      *txn = NULL;
+  SPoolMem *pPool = openPool();
+
+  tdbBegin(pEnv, &txn, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  for (int iData = 0; iData < nData; iData++) {
+    sprintf(key, "key%d", iData);
+    sprintf(val, "value%d", iData);
+    GTEST_ASSERT_EQ(tdbTbInsert(pDb, key, strlen(key), val, strlen(val), txn), 0);
+
+    if (pPool->size >= 4 * 1024 * 1024) {
+      tdbCommit(pEnv, txn);
+      tdbPostCommit(pEnv, txn);
+
+      clearPool(pPool);
+      tdbBegin(pEnv, &txn, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+    }
+  }
+
+  tdbCommit(pEnv, txn);
+  tdbPostCommit(pEnv, txn);
+  closePool(pPool);
+}
+
+// random point gets, as concurrent meta lookups of table entries do
+static void getData(TTB *pDb, uint32_t seed, int *pFailed) {
+  char     key[64];
+  char     val[64];
+  void    *pVal = NULL;
+  int      vLen = 0;
+  uint32_t r = seed;
+
+  for (int i = 0; i < nGetsPerThread; i++) {
+    r = r * 1103515245 + 12345;
+    int iData = (int)((r >> 8) % nData);
+
+    sprintf(key, "key%d", iData);
+    sprintf(val, "value%d", iData);
+    if (tdbTbGet(pDb, key, strlen(key), &pVal, &vLen) != 0 || vLen != (int)strlen(val) ||
+        memcmp(pVal, val, vLen) != 0) {
+      (*pFailed)++;
+    }
+  }
+
+  tdbFree(pVal);
+}
+
+TEST(tdb_pcache_test, concurrent_get) {
+  TDB *pEnv = NULL;
+  TTB *pDb = NULL;
+
+  taosRemoveDir("tdb_pcache");
+
+  // enough pages for several shards, but fewer than the pages of the table, so pages are recycled during the gets
+  GTEST_ASSERT_EQ(tdbOpen("tdb_pcache", 4096, 1024, &pEnv, 0), 0);
+  GTEST_ASSERT_EQ(tdbTbOpen("db.db", -1, -1, NULL, pEnv, &pDb, 0), 0);
+
+  insertData(pEnv, pDb);
+
+  for (int nThreads = 1; nThreads <= 8; nThreads *= 2) {
+    std::vector<std::thread> threads;
+    std::vector<int>         failed(nThreads, 0);
+
+    int64_t st = taosGetTimestampUs();
+    for (int i = 0; i < nThreads; i++) {
+      threads.emplace_back(getData, pDb, (uint32_t)(i + 1), &failed[i]);
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    int64_t el = taosGetTimestampUs() - st;
+
+    for (int i = 0; i < nThreads; i++) {
+      GTEST_ASSERT_EQ(failed[i], 0);
+    }
+
+    printf("%d threads, %d gets: %" PRId64 " us, %.0f gets/s\n", nThreads, nThreads * nGetsPerThread, el,
+           nThreads * nGetsPerThread * 1000000.0 / el);
+  }
+
+  tdbTbClose(pDb);
+  GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+  taosRemoveDir("tdb_pcache");
+}
+
+static void *countMalloc(void *arg, size_t size) {
+  (*(int *)arg)++;
+  return taosMemoryMalloc(size);
+}
+
+static void countFree(void *arg, void *ptr) { taosMemoryFree(ptr); }
+
+// the pages held at a time fall unevenly into the shards, and a shard out of pages recycles the ones of the others
+// before any page is created beyond the cache size
+TEST(tdb_pcache_test, skewed_fetch) {
+  const int            nPages = 512;
+  SPCache             *pCache = NULL;
+  TXN                  txn = {0};
+  int                  nCreated = 0;
+  SPgid                pgid = {0};
+  std::vector<SPage *> pages;
+
+  GTEST_ASSERT_EQ(tdbPCacheOpen(4096, nPages, &pCache), 0);
+  GTEST_ASSERT_EQ(tdbTxnOpen(&txn, 0, countMalloc, countFree, &nCreated, 0), 0);
+
+  // all the pages of the cache end up in the lru lists
+  for (SPgno pgno = 1; pgno <= nPages * 4; pgno++) {
+    pgid.pgno = pgno;
+    SPage *pPage = tdbPCacheFetch(pCache, &pgid, &txn);
+    ASSERT_NE(pPage, nullptr);
+    tdbPCacheRelease(pCache, pPage, &txn);
+  }
+  GTEST_ASSERT_EQ(nCreated, 0);
+
+  for (SPgno pgno = nPages * 4 + 1; pgno <= nPages * 5; pgno++) {
+    pgid.pgno = pgno;
+    SPage *pPage = tdbPCacheFetch(pCache, &pgid, &txn);
+    ASSERT_NE(pPage, nullptr);
+    pages.push_back(pPage);
+  }
+  GTEST_ASSERT_EQ(nCreated, 0);
+
+  // all the pages are held, so one more is created
+  pgid.pgno = nPages * 5 + 1;
+  SPage *pPage = tdbPCacheFetch(pCache, &pgid, &txn);
+  ASSERT_NE(pPage, nullptr);
+  GTEST_ASSERT_EQ(nCreated, 1);
+  tdbPCacheRelease(pCache, pPage, &txn);
+
+  for (SPage *pHeld : pages) {
+    tdbPCacheRelease(pCache, pHeld, &txn);
+  }
+  tdbPCacheClose(pCache);
+}
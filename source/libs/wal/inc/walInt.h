@@ -42,6 +42,37 @@ typedef struct WalIdxEntry {
   int64_t offset;
 } SWalIdxEntry;
 
+// group commit: entries are appended to a staging buffer and written out
+// with one write for the log file and one for the idx file
+struct SWalWriteBuf {
+  char         *pLog;       // staged SWalCkHead + body
+  int64_t       logSize;
+  int64_t       logCap;
+  SWalIdxEntry *pIdx;       // staged idx entries
+  int32_t       numOfEntries;
+  int32_t       idxCap;
+  int64_t       firstVer;   // first staged version, -1 if nothing is staged
+  int64_t       logOffset;  // log file offset of the first staged entry
+  int64_t       stageTs;    // ms when the first entry was staged
+  int64_t       maxSize;
+  int32_t       maxDelay;
+  SWalGroupCommitStat stat;
+};
+
+// tail cache: copies of the latest appended entries of consecutive versions, so that
+// readers following the head of the wal are served from memory instead of the files
+struct SWalTailCache {
+  TdThreadRwlock    lock;
+  SWalCkHead      **pEntries;  // ring of entries, the one of firstVer at head
+  int32_t           cap;
+  int32_t           head;
+  int32_t           num;
+  int64_t           firstVer;  // -1 if nothing is cached
+  int64_t           size;      // bytes of cached entries
+  int64_t           maxSize;
+  SWalTailCacheStat stat;
+};
+
 static inline int tSerializeWalIdxEntry(void** buf, SWalIdxEntry* pIdxEntry) {
   int tlen = 0;
   tlen += taosEncodeFixedI64(buf, pIdxEntry->ver);
@@ -166,6 +197,28 @@ int64_t walGetSeq();
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
 
+// group commit section
+// the wal thread checks the staged entries every half of the group commit delay at most, and flushes the ones which
+// would be staged longer than the delay before its next check
+#define WAL_GROUP_FLUSH_INTERVAL(_delay) TMAX((_delay) / 2, 1)
+
+SWalWriteBuf* walOpenWriteBuf(int64_t maxSize, int32_t maxDelay);
+void          walCloseWriteBuf(SWalWriteBuf* pBuf);
+void          walResetWriteBuf(SWalWriteBuf* pBuf);
+void          walFlushWriteBuf(SWal* pWal);
+void          walFlushWriteBufIfExpired(SWal* pWal, int32_t aheadMs);
+void          walFlushWriteBufForRead(SWal* pWal, int64_t ver);
+// group commit section end
+
+// tail cache section
+SWalTailCache* walOpenTailCache(int64_t maxSize);
+void           walCloseTailCache(SWalTailCache* pCache);
+void           walTailCacheClear(SWalTailCache* pCache);
+void           walTailCacheTruncate(SWalTailCache* pCache, int64_t ver);
+void           walTailCachePut(SWalTailCache* pCache, const SWalCkHead* pHead, const void* body, int32_t bodyLen);
+int32_t        walTailCacheGet(SWalTailCache* pCache, int64_t ver, SWalCkHead** ppHead, int64_t* pCapacity, bool* pHit);
+// tail cache section end
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "taoserror.h"
+#include "walInt.h"
+
+#define WAL_TAIL_CACHE_MIN_CAP 64
+
+SWalTailCache *walOpenTailCache(int64_t maxSize) {
+  SWalTailCache *pCache = taosMemoryCalloc(1, sizeof(SWalTailCache));
+  if (pCache == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pCache->maxSize = maxSize;
+  pCache->firstVer = -1;
+  taosThreadRwlockInit(&pCache->lock, NULL);
+  return pCache;
+}
+
+static void walTailCachePopFront(SWalTailCache *pCache) {
+  SWalCkHead *pEntry = pCache->pEntries[pCache->head];
+  pCache->size -= sizeof(SWalCkHead) + pEntry->head.bodyLen;
+  taosMemoryFree(pEntry);
+  pCache->pEntries[pCache->head] = NULL;
+  pCache->head = (pCache->head + 1) % pCache->cap;
+  pCache->firstVer++;
+  if (--pCache->num == 0) {
+    pCache->head = 0;
+    pCache->firstVer = -1;
+  }
+}
+
+static void walTailCachePopBack(SWalTailCache *pCache) {
+  int32_t     pos = (pCache->head + pCache->num - 1) % pCache->cap;
+  SWalCkHead *pEntry = pCache->pEntries[pos];
+  pCache->size -= sizeof(SWalCkHead) + pEntry->head.bodyLen;
+  taosMemoryFree(pEntry);
+  pCache->pEntries[pos] = NULL;
+  if (--pCache->num == 0) {
+    pCache->head = 0;
+    pCache->firstVer = -1;
+  }
+}
+
+static void walTailCacheClearImpl(SWalTailCache *pCache) {
+  while (pCache->num > 0) {
+    walTailCachePopFront(pCache);
+  }
+}
+
+void walCloseTailCache(SWalTailCache *pCache) {
+  if (pCache == NULL) return;
+  walTailCacheClearImpl(pCache);
+  taosMemoryFree(pCache->pEntries);
+  taosThreadRwlockDestroy(&pCache->lock);
+  taosMemoryFree(pCache);
+}
+
+void walTailCacheClear(SWalTailCache *pCache) {
+  if (pCache == NULL) return;
+  taosThreadRwlockWrlock(&pCache->lock);
+  walTailCacheClearImpl(pCache);
+  taosThreadRwlockUnlock(&pCache->lock);
+}
+
+void walTailCacheTruncate(SWalTailCache *pCache, int64_t ver) {
+  if (pCache == NULL) return;
+  taosThreadRwlockWrlock(&pCache->lock);
+  while (pCache->num > 0 && pCache->firstVer + pCache->num - 1 >= ver) {
+    walTailCachePopBack(pCache);
+  }
+  taosThreadRwlockUnlock(&pCache->lock);
+}
+
+static int32_t walTailCacheGrow(SWalTailCache *pCache) {
+  int32_t      cap = TMAX(pCache->cap * 2, WAL_TAIL_CACHE_MIN_CAP);
+  SWalCkHead **pEntries = taosMemoryCalloc(cap, sizeof(SWalCkHead *));
+  if (pEntries == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < pCache->num; ++i) {
+    pEntries[i] = pCache->pEntries[(pCache->head + i) % pCache->cap];
+  }
+  taosMemoryFree(pCache->pEntries);
+  pCache->pEntries = pEntries;
+  pCache->cap = cap;
+  pCache->head = 0;
+  return 0;
+}
+
+// called on append with pWal->mutex held, failures only leave the entry to the files
+void walTailCachePut(SWalTailCache *pCache, const SWalCkHead *pHead, const void *body, int32_t bodyLen) {
+  if (pCache == NULL) return;
+
+  int64_t ver = pHead->head.version;
+  int64_t size = sizeof(SWalCkHead) + bodyLen;
+
+  taosThreadRwlockWrlock(&pCache->lock);
+
+  // cached versions are consecutive, a gap starts over from ver
+  if (pCache->num > 0 && ver != pCache->firstVer + pCache->num) {
+    walTailCacheClearImpl(pCache);
+  }
+
+  if (size > pCache->maxSize) {
+    walTailCacheClearImpl(pCache);
+    goto _out;
+  }
+
+  while (pCache->num > 0 && pCache->size + size > pCache->maxSize) {
+    walTailCachePopFront(pCache);
+  }
+
+  if (pCache->num == pCache->cap && walTailCacheGrow(pCache) < 0) {
+    walTailCacheClearImpl(pCache);
+    goto _out;
+  }
+
+  SWalCkHead *pEntry = taosMemoryMalloc(size);
+  if (pEntry == NULL) {
+    walTailCacheClearImpl(pCache);
+    goto _out;
+  }
+  memcpy(pEntry, pHead, sizeof(SWalCkHead));
+  memcpy(pEntry->head.body, body, bodyLen);
+
+  if (pCache->num == 0) {
+    pCache->firstVer = ver;
+  }
+  pCache->pEntries[(pCache->head + pCache->num) % pCache->cap] = pEntry;
+  pCache->num++;
+  pCache->size += size;
+
+_out:
+  taosThreadRwlockUnlock(&pCache->lock);
+}
+
+// copy the entry of ver into *ppHead, whose body capacity is *pCapacity, as walFetchBody does from the files
+int32_t walTailCacheGet(SWalTailCache *pCache, int64_t ver, SWalCkHead **ppHead, int64_t *pCapacity, bool *pHit) {
+  int32_t code = 0;
+
+  *pHit = false;
+  if (pCache == NULL) return 0;
+
+  taosThreadRwlockRdlock(&pCache->lock);
+  if (pCache->num > 0 && ver >= pCache->firstVer && ver < pCache->firstVer + pCache->num) {
+    SWalCkHead *pEntry = pCache->pEntries[(pCache->head + (ver - pCache->firstVer)) % pCache->cap];
+    int32_t     bodyLen = pEntry->head.bodyLen;
+
+    if (*pCapacity < bodyLen) {
+      SWalCkHead *ptr = taosMemoryRealloc(*ppHead, sizeof(SWalCkHead) + bodyLen);
+      if (ptr == NULL) {
+        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        code = -1;
+        goto _out;
+      }
+      *ppHead = ptr;
+      *pCapacity = bodyLen;
+    }
+
+    memcpy(*ppHead, pEntry, sizeof(SWalCkHead) + bodyLen);
+    *pHit = true;
+  }
+
+_out:
+  atomic_add_fetch_64(*pHit ? &pCache->stat.numOfHits : &pCache->stat.numOfMisses, 1);
+  taosThreadRwlockUnlock(&pCache->lock);
+  return code;
+}
+
+void walGetTailCacheStat(SWal *pWal, SWalTailCacheStat *pStat) {
+  memset(pStat, 0, sizeof(SWalTailCacheStat));
+  SWalTailCache *pCache = pWal->pTailCache;
+  if (pCache == NULL) return;
+
+  taosThreadRwlockRdlock(&pCache->lock);
+  pStat->numOfEntries = pCache->num;
+  pStat->numOfBytes = pCache->size;
+  pStat->numOfHits = atomic_load_64(&pCache->stat.numOfHits);
+  pStat->numOfMisses = atomic_load_64(&pCache->stat.numOfMisses);
+  taosThreadRwlockUnlock(&pCache->lock);
+}
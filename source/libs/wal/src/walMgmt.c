@@ -17,6 +17,7 @@
 #include "os.h"
 #include "taoserror.h"
 #include "tcompare.h"
+#include "tglobal.h"
 #include "tref.h"
 #include "walInt.h"
 
@@ -143,6 +144,24 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
   pWal->writeHead.head.protoVer = WAL_PROTO_VER;
   pWal->writeHead.magic = WAL_MAGIC;
 
+  // init group commit
+  if (tsWalGroupCommitSize > 0) {
+    pWal->pWriteBuf = walOpenWriteBuf(tsWalGroupCommitSize, tsWalGroupCommitDelay);
+    if (pWal->pWriteBuf == NULL) {
+      wError("vgId:%d, failed to init group commit buffer since %s", pWal->cfg.vgId, terrstr());
+      goto _err;
+    }
+  }
+
+  // init tail cache
+  if (tsWalTailCacheSize > 0) {
+    pWal->pTailCache = walOpenTailCache(tsWalTailCacheSize);
+    if (pWal->pTailCache == NULL) {
+      wError("vgId:%d, failed to init tail cache since %s", pWal->cfg.vgId, terrstr());
+      goto _err;
+    }
+  }
+
   // load meta
   (void)walLoadMeta(pWal);
 
@@ -168,6 +187,8 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
   return pWal;
 
 _err:
+  walCloseWriteBuf(pWal->pWriteBuf);
+  walCloseTailCache(pWal->pTailCache);
   taosArrayDestroy(pWal->fileInfoSet);
   taosHashCleanup(pWal->pRefHash);
   taosThreadMutexDestroy(&pWal->mutex);
@@ -204,6 +225,7 @@ int32_t walAlter(SWal *pWal, SWalCfg *pCfg) {
 
 int32_t walPersist(SWal *pWal) {
   taosThreadMutexLock(&pWal->mutex);
+  walFlushWriteBuf(pWal);
   int32_t ret = walSaveMeta(pWal);
   taosThreadMutexUnlock(&pWal->mutex);
   return ret;
@@ -211,6 +233,11 @@ int32_t walPersist(SWal *pWal) {
 
 void walClose(SWal *pWal) {
   taosThreadMutexLock(&pWal->mutex);
+  walFlushWriteBuf(pWal);
+  walCloseWriteBuf(pWal->pWriteBuf);
+  pWal->pWriteBuf = NULL;
+  walCloseTailCache(pWal->pTailCache);
+  pWal->pTailCache = NULL;
   (void)walSaveMeta(pWal);
   taosCloseFile(&pWal->pLogFile);
   pWal->pLogFile = NULL;
@@ -255,15 +282,43 @@ static bool walNeedFsync(SWal *pWal) {
   return false;
 }
 
-static void walUpdateSeq() {
-  taosMsleep(WAL_REFRESH_MS);
+// the seq is bumped every WAL_REFRESH_MS, the fsync period of each wal is counted by it
+static bool walUpdateSeq(int64_t *pRefreshTs) {
+  int64_t now = taosGetTimestampMs();
+  if (now - *pRefreshTs < WAL_REFRESH_MS) {
+    return false;
+  }
+
+  *pRefreshTs = now;
   atomic_add_fetch_32(&tsWal.seq, 1);
+  return true;
 }
 
-static void walFsyncAll() {
+// flush the staged entries due before the next round and fsync the wals due in this seq, return the ms to sleep
+static int32_t walFsyncAll(bool refreshed) {
+  int32_t interval = WAL_REFRESH_MS;
+  if (tsWalGroupCommitSize > 0) {
+    interval = TMIN(interval, WAL_GROUP_FLUSH_INTERVAL(tsWalGroupCommitDelay));
+  }
+
   SWal *pWal = taosIterateRef(tsWal.refSetId, 0);
   while (pWal) {
-    if (walNeedFsync(pWal)) {
+    bool needFsync = refreshed && walNeedFsync(pWal);
+    if (pWal->pWriteBuf != NULL) {
+      taosThreadMutexLock(&pWal->mutex);
+      if (pWal->pWriteBuf != NULL) {
+        int32_t walInterval = WAL_GROUP_FLUSH_INTERVAL(pWal->pWriteBuf->maxDelay);
+        if (needFsync) {
+          walFlushWriteBuf(pWal);
+        } else {
+          walFlushWriteBufIfExpired(pWal, walInterval);
+        }
+        interval = TMIN(interval, walInterval);
+      }
+      taosThreadMutexUnlock(&pWal->mutex);
+    }
+
+    if (needFsync) {
       wTrace("vgId:%d, do fsync, level:%d seq:%d rseq:%d", pWal->cfg.vgId, pWal->cfg.level, pWal->fsyncSeq,
              atomic_load_32(&tsWal.seq));
       int32_t code = taosFsyncFile(pWal->pLogFile);
@@ -274,13 +329,17 @@ static void walFsyncAll() {
     }
     pWal = taosIterateRef(tsWal.refSetId, pWal->refId);
   }
+
+  return interval;
 }
 
 static void *walThreadFunc(void *param) {
   setThreadName("wal");
+  int32_t interval = WAL_REFRESH_MS;
+  int64_t refreshTs = taosGetTimestampMs();
   while (1) {
-    walUpdateSeq();
-    walFsyncAll();
+    taosMsleep(interval);
+    interval = walFsyncAll(walUpdateSeq(&refreshTs));
 
     if (atomic_load_8(&tsWal.stop)) break;
   }
@@ -293,6 +352,7 @@ static int32_t walCreateThread() {
   taosThreadAttrInit(&thAttr);
   taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
 
+  atomic_store_8(&tsWal.stop, 0);
   if (taosThreadCreate(&tsWal.thread, &thAttr, walThreadFunc, NULL) != 0) {
     wError("failed to create wal thread since %s", strerror(errno));
     terrno = TAOS_SYSTEM_ERROR(errno);
@@ -16,6 +16,8 @@
 #include "taoserror.h"
 #include "walInt.h"
 
+#define WAL_READ_AHEAD_MIN_SIZE (64 * 1024)
+
 SWalReader *walOpenReader(SWal *pWal, SWalFilterCond *cond, int64_t id) {
   SWalReader *pReader = taosMemoryCalloc(1, sizeof(SWalReader));
   if (pReader == NULL) {
@@ -61,6 +63,7 @@ void walCloseReader(SWalReader *pReader) {
   taosCloseFile(&pReader->pIdxFile);
   taosCloseFile(&pReader->pLogFile);
   taosMemoryFreeClear(pReader->pHead);
+  taosMemoryFreeClear(pReader->readAhead.pBuf);
   taosMemoryFree(pReader);
 }
 
@@ -128,6 +131,133 @@ void walReaderVerifyOffset(SWalReader *pWalReader, STqOffsetVal* pOffset){
   }
 }
 
+void walReaderSetReadAhead(SWalReader *pReader, int32_t maxSize) {
+  if (pReader == NULL) return;
+
+  taosThreadMutexLock(&pReader->mutex);
+  SWalReadAhead *pAhead = &pReader->readAhead;
+  if (pAhead->pos < pAhead->len && pReader->pLogFile != NULL) {
+    // keep the log file at the position of the next entry
+    taosLSeekFile(pReader->pLogFile, pAhead->pos - pAhead->len, SEEK_CUR);
+  }
+  taosMemoryFreeClear(pAhead->pBuf);
+  memset(pAhead, 0, sizeof(SWalReadAhead));
+  pAhead->maxSize = maxSize;
+  taosThreadMutexUnlock(&pReader->mutex);
+}
+
+// called when the log file is changed or seeked, the entry at the new position is read without read ahead
+static void walReadAheadReset(SWalReader *pReader) {
+  SWalReadAhead *pAhead = &pReader->readAhead;
+  pAhead->pos = 0;
+  pAhead->len = 0;
+  pAhead->window = 0;
+}
+
+// called when an entry is read right after the previous one, so that random reads never read ahead
+static void walReadAheadStart(SWalReader *pReader) {
+  SWalReadAhead *pAhead = &pReader->readAhead;
+  if (pAhead->window <= 0) {
+    pAhead->window = TMIN(WAL_READ_AHEAD_MIN_SIZE, pAhead->maxSize);
+  }
+}
+
+// the buffered data may have been truncated from the file, read them again from the file
+static int32_t walReadAheadCheck(SWalReader *pReader) {
+  SWalReadAhead *pAhead = &pReader->readAhead;
+  if (pAhead->pos == pAhead->len || pAhead->truncateSeq == atomic_load_64(&pReader->pWal->truncateSeq)) {
+    return 0;
+  }
+
+  if (taosLSeekFile(pReader->pLogFile, pAhead->pos - pAhead->len, SEEK_CUR) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+  walReadAheadReset(pReader);
+  return 0;
+}
+
+// read from the current position of the log file as taosReadFile does, in chunks of the read ahead window if enabled
+static int64_t walReadLogFile(SWalReader *pReader, void *buf, int64_t len) {
+  SWalReadAhead *pAhead = &pReader->readAhead;
+  if (pAhead->maxSize <= 0) {
+    return taosReadFile(pReader->pLogFile, buf, len);
+  }
+
+  if (walReadAheadCheck(pReader) < 0) {
+    return -1;
+  }
+
+  int64_t nread = 0;
+  while (nread < len) {
+    if (pAhead->pos == pAhead->len) {
+      // large bodies and the reads before the window is started bypass the buffer
+      if (len - nread >= pAhead->window) {
+        int64_t ret = taosReadFile(pReader->pLogFile, (char *)buf + nread, len - nread);
+        if (ret < 0) {
+          return -1;
+        }
+        nread += ret;
+        break;
+      }
+
+      if (pAhead->cap < pAhead->window) {
+        char *p = taosMemoryRealloc(pAhead->pBuf, pAhead->window);
+        if (p == NULL) {
+          terrno = TSDB_CODE_OUT_OF_MEMORY;
+          return -1;
+        }
+        pAhead->pBuf = p;
+        pAhead->cap = pAhead->window;
+      }
+
+      pAhead->truncateSeq = atomic_load_64(&pReader->pWal->truncateSeq);
+      int64_t ret = taosReadFile(pReader->pLogFile, pAhead->pBuf, pAhead->window);
+      if (ret < 0) {
+        return -1;
+      } else if (ret == 0) {
+        break;
+      }
+
+      pAhead->pos = 0;
+      pAhead->len = ret;
+      pAhead->window = TMIN(pAhead->window * 2, pAhead->maxSize);
+    }
+
+    int32_t n = TMIN(len - nread, pAhead->len - pAhead->pos);
+    memcpy((char *)buf + nread, pAhead->pBuf + pAhead->pos, n);
+    pAhead->pos += n;
+    nread += n;
+  }
+
+  return nread;
+}
+
+// skip len bytes from the current position of the log file
+static int32_t walSkipLogFile(SWalReader *pReader, int64_t len) {
+  SWalReadAhead *pAhead = &pReader->readAhead;
+  if (pAhead->maxSize > 0) {
+    if (walReadAheadCheck(pReader) < 0) {
+      return -1;
+    }
+
+    if (len <= pAhead->len - pAhead->pos) {
+      pAhead->pos += len;
+      return 0;
+    }
+
+    len -= pAhead->len - pAhead->pos;
+    pAhead->pos = 0;
+    pAhead->len = 0;
+  }
+
+  if (taosLSeekFile(pReader->pLogFile, len, SEEK_CUR) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+  return 0;
+}
+
 static int64_t walReadSeekFilePos(SWalReader *pReader, int64_t fileFirstVer, int64_t ver) {
   int64_t ret = 0;
 
@@ -156,6 +286,7 @@ static int64_t walReadSeekFilePos(SWalReader *pReader, int64_t fileFirstVer, int
     return -1;
   }
 
+  walReadAheadReset(pReader);
   ret = taosLSeekFile(pLogTFile, entry.offset, SEEK_SET);
   if (ret < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
@@ -171,6 +302,7 @@ static int32_t walReadChangeFile(SWalReader *pReader, int64_t fileFirstVer) {
 
   taosCloseFile(&pReader->pIdxFile);
   taosCloseFile(&pReader->pLogFile);
+  walReadAheadReset(pReader);
 
   walBuildLogName(pReader->pWal, fileFirstVer, fnameStr);
   TdFilePtr pLogFile = taosOpenFile(fnameStr, TD_FILE_READ);
@@ -200,6 +332,8 @@ static int32_t walReadChangeFile(SWalReader *pReader, int64_t fileFirstVer) {
 int32_t walReadSeekVerImpl(SWalReader *pReader, int64_t ver) {
   SWal *pWal = pReader->pWal;
 
+  walFlushWriteBufForRead(pWal, ver);
+
   // bsearch in fileSet
   SWalFileInfo tmpInfo;
   tmpInfo.firstVer = ver;
@@ -226,6 +360,7 @@ int32_t walReadSeekVerImpl(SWalReader *pReader, int64_t ver) {
          pReader->curVersion, ver);
 
   pReader->curVersion = ver;
+  pReader->fromCache = 0;
   return 0;
 }
 
@@ -261,16 +396,28 @@ int32_t walFetchHead(SWalReader *pRead, int64_t ver) {
     return -1;
   }
 
-  if (pRead->curVersion != ver) {
-    code = walReaderSeekVer(pRead, ver);
+  bool hit = false;
+  if (walTailCacheGet(pRead->pWal->pTailCache, ver, &pRead->pHead, &pRead->capacity, &hit) < 0) {
+    return -1;
+  }
+  if (hit) {
+    pRead->curVersion = ver;
+    pRead->fromCache = 1;
+    return 0;
+  }
+
+  if (pRead->curVersion != ver || pRead->fromCache) {
+    code = (pRead->curVersion != ver) ? walReaderSeekVer(pRead, ver) : walReadSeekVerImpl(pRead, ver);
     if (code < 0) {
       return -1;
     }
     seeked = true;
+  } else {
+    walReadAheadStart(pRead);
   }
 
   while (1) {
-    contLen = taosReadFile(pRead->pLogFile, pRead->pHead, sizeof(SWalCkHead));
+    contLen = walReadLogFile(pRead, pRead->pHead, sizeof(SWalCkHead));
     if (contLen == sizeof(SWalCkHead)) {
       break;
     } else if (contLen == 0 && !seeked) {
@@ -307,9 +454,12 @@ int32_t walSkipFetchBody(SWalReader *pRead) {
          pRead->pWal->cfg.vgId, pRead->pHead->head.version, pRead->pWal->vers.firstVer, pRead->pWal->vers.commitVer,
          pRead->pWal->vers.lastVer, pRead->pWal->vers.appliedVer, pRead->readerId);
 
-  int64_t code = taosLSeekFile(pRead->pLogFile, pRead->pHead->head.bodyLen, SEEK_CUR);
-  if (code < 0) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
+  if (pRead->fromCache) {
+    pRead->curVersion++;
+    return 0;
+  }
+
+  if (walSkipLogFile(pRead, pRead->pHead->head.bodyLen) < 0) {
     return -1;
   }
 
@@ -328,6 +478,12 @@ int32_t walFetchBody(SWalReader *pRead) {
          ", 0x%" PRIx64,
          vgId, ver, pVer->firstVer, pVer->commitVer, pVer->lastVer, pVer->appliedVer, id);
 
+  // the body was copied along with the head
+  if (pRead->fromCache) {
+    pRead->curVersion++;
+    return 0;
+  }
+
   if (pRead->capacity < pReadHead->bodyLen) {
     SWalCkHead *ptr = (SWalCkHead *)taosMemoryRealloc(pRead->pHead, sizeof(SWalCkHead) + pReadHead->bodyLen);
     if (ptr == NULL) {
@@ -339,7 +495,7 @@ int32_t walFetchBody(SWalReader *pRead) {
     pRead->capacity = pReadHead->bodyLen;
   }
 
-  if (pReadHead->bodyLen != taosReadFile(pRead->pLogFile, pReadHead->body, pReadHead->bodyLen)) {
+  if (pReadHead->bodyLen != walReadLogFile(pRead, pReadHead->body, pReadHead->bodyLen)) {
     if (pReadHead->bodyLen < 0) {
       terrno = TAOS_SYSTEM_ERROR(errno);
       wError("vgId:%d, wal fetch body error:%" PRId64 ", read request index:%" PRId64 ", since %s, 0x%"PRIx64,
@@ -389,17 +545,32 @@ int32_t walReadVer(SWalReader *pReader, int64_t ver) {
 
   taosThreadMutexLock(&pReader->mutex);
 
-  if (pReader->curVersion != ver) {
-    if (walReaderSeekVer(pReader, ver) < 0) {
+  bool hit = false;
+  if (walTailCacheGet(pReader->pWal->pTailCache, ver, &pReader->pHead, &pReader->capacity, &hit) < 0) {
+    taosThreadMutexUnlock(&pReader->mutex);
+    return -1;
+  }
+  if (hit) {
+    pReader->curVersion = ver + 1;
+    pReader->fromCache = 1;
+    taosThreadMutexUnlock(&pReader->mutex);
+    return 0;
+  }
+
+  if (pReader->curVersion != ver || pReader->fromCache) {
+    code = (pReader->curVersion != ver) ? walReaderSeekVer(pReader, ver) : walReadSeekVerImpl(pReader, ver);
+    if (code < 0) {
       wError("vgId:%d, unexpected wal log, index:%" PRId64 ", since %s", pReader->pWal->cfg.vgId, ver, terrstr());
       taosThreadMutexUnlock(&pReader->mutex);
       return -1;
     }
     seeked = true;
+  } else {
+    walReadAheadStart(pReader);
   }
 
   while (1) {
-    contLen = taosReadFile(pReader->pLogFile, pReader->pHead, sizeof(SWalCkHead));
+    contLen = walReadLogFile(pReader, pReader->pHead, sizeof(SWalCkHead));
     if (contLen == sizeof(SWalCkHead)) {
       break;
     } else if (contLen == 0 && !seeked) {
@@ -443,7 +614,7 @@ int32_t walReadVer(SWalReader *pReader, int64_t ver) {
     pReader->capacity = pReader->pHead->head.bodyLen;
   }
 
-  if ((contLen = taosReadFile(pReader->pLogFile, pReader->pHead->head.body, pReader->pHead->head.bodyLen)) !=
+  if ((contLen = walReadLogFile(pReader, pReader->pHead->head.body, pReader->pHead->head.bodyLen)) !=
       pReader->pHead->head.bodyLen) {
     if (contLen < 0)
       terrno = TAOS_SYSTEM_ERROR(errno);
@@ -488,7 +659,9 @@ void walReadReset(SWalReader *pReader) {
   taosThreadMutexLock(&pReader->mutex);
   taosCloseFile(&pReader->pIdxFile);
   taosCloseFile(&pReader->pLogFile);
+  walReadAheadReset(pReader);
   pReader->curFileFirstVer = -1;
   pReader->curVersion = -1;
+  pReader->fromCache = 0;
   taosThreadMutexUnlock(&pReader->mutex);
 }
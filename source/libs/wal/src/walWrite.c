@@ -36,6 +36,11 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
     }
   }
 
+  // staged and cached entries are covered by the snapshot, and read ahead buffers filled while the files are being
+  // removed are stale, so the seq is bumped on both sides
+  walResetWriteBuf(pWal->pWriteBuf);
+  walTailCacheClear(pWal->pTailCache);
+  atomic_add_fetch_64(&pWal->truncateSeq, 1);
   taosCloseFile(&pWal->pLogFile);
   taosCloseFile(&pWal->pIdxFile);
 
@@ -48,6 +53,7 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
       if (taosRemoveFile(fnameStr) < 0) {
         terrno = TAOS_SYSTEM_ERROR(errno);
         wError("vgId:%d, restore from snapshot, cannot remove file %s since %s", pWal->cfg.vgId, fnameStr, terrstr());
+        atomic_add_fetch_64(&pWal->truncateSeq, 1);
         taosThreadMutexUnlock(&pWal->mutex);
         return -1;
       }
@@ -57,6 +63,7 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
       if (taosRemoveFile(fnameStr) < 0) {
         terrno = TAOS_SYSTEM_ERROR(errno);
         wError("vgId:%d, cannot remove file %s since %s", pWal->cfg.vgId, fnameStr, terrstr());
+        atomic_add_fetch_64(&pWal->truncateSeq, 1);
         taosThreadMutexUnlock(&pWal->mutex);
         return -1;
       }
@@ -75,6 +82,7 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
   pWal->vers.commitVer = ver;
   pWal->vers.snapshotVer = ver;
   pWal->vers.verInSnapshotting = -1;
+  atomic_add_fetch_64(&pWal->truncateSeq, 1);
 
   taosThreadMutexUnlock(&pWal->mutex);
   return 0;
@@ -98,23 +106,24 @@ int32_t walCommit(SWal *pWal, int64_t ver) {
   return 0;
 }
 
-int32_t walRollback(SWal *pWal, int64_t ver) {
-  taosThreadMutexLock(&pWal->mutex);
+static int32_t walRollbackImpl(SWal *pWal, int64_t ver) {
   wInfo("vgId:%d, wal rollback for version %" PRId64, pWal->cfg.vgId, ver);
   int64_t code;
   char    fnameStr[WAL_FILE_LEN];
   if (ver > pWal->vers.lastVer || ver <= pWal->vers.commitVer || ver <= pWal->vers.snapshotVer) {
     terrno = TSDB_CODE_WAL_INVALID_VER;
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
 
+  // staged entries must reach the files before they can be truncated
+  walFlushWriteBuf(pWal);
+  walTailCacheTruncate(pWal->pTailCache, ver);
+
   // find correct file
   if (ver < walGetLastFileFirstVer(pWal)) {
     // change current files
     code = walChangeWrite(pWal, ver);
     if (code < 0) {
-      taosThreadMutexUnlock(&pWal->mutex);
       return -1;
     }
 
@@ -137,19 +146,16 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
   TdFilePtr pIdxFile = taosOpenFile(fnameStr, TD_FILE_WRITE | TD_FILE_READ | TD_FILE_APPEND);
 
   if (pIdxFile == NULL) {
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
   int64_t idxOff = walGetVerIdxOffset(pWal, ver);
   code = taosLSeekFile(pIdxFile, idxOff, SEEK_SET);
   if (code < 0) {
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
   // read idx file and get log file pos
   SWalIdxEntry entry;
   if (taosReadFile(pIdxFile, &entry, sizeof(SWalIdxEntry)) != sizeof(SWalIdxEntry)) {
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
 
@@ -160,33 +166,28 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
   if (pLogFile == NULL) {
     // TODO
     terrno = TAOS_SYSTEM_ERROR(errno);
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
   code = taosLSeekFile(pLogFile, entry.offset, SEEK_SET);
   if (code < 0) {
     // TODO
     terrno = TAOS_SYSTEM_ERROR(errno);
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
   // validate offset
   SWalCkHead head;
   int64_t    size = taosReadFile(pLogFile, &head, sizeof(SWalCkHead));
   if (size != sizeof(SWalCkHead)) {
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
   code = walValidHeadCksum(&head);
 
   if (code != 0) {
     terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
   if (head.head.version != ver) {
     terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
 
@@ -194,13 +195,11 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
   code = taosFtruncateFile(pLogFile, entry.offset);
   if (code < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
   code = taosFtruncateFile(pIdxFile, idxOff);
   if (code < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
   pWal->vers.lastVer = ver - 1;
@@ -213,15 +212,24 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
   code = walSaveMeta(pWal);
   if (code < 0) {
     wError("vgId:%d, failed to save meta since %s", pWal->cfg.vgId, terrstr());
-    taosThreadMutexUnlock(&pWal->mutex);
     return -1;
   }
 
-  // unlock
-  taosThreadMutexUnlock(&pWal->mutex);
   return 0;
 }
 
+int32_t walRollback(SWal *pWal, int64_t ver) {
+  taosThreadMutexLock(&pWal->mutex);
+
+  // read ahead buffers filled while the files are being truncated are stale, so the seq is bumped on both sides
+  atomic_add_fetch_64(&pWal->truncateSeq, 1);
+  int32_t code = walRollbackImpl(pWal, ver);
+  atomic_add_fetch_64(&pWal->truncateSeq, 1);
+
+  taosThreadMutexUnlock(&pWal->mutex);
+  return code;
+}
+
 static FORCE_INLINE int32_t walCheckAndRoll(SWal *pWal) {
   if (taosArrayGetSize(pWal->fileInfoSet) == 0) {
     if (walRollImpl(pWal) < 0) {
@@ -242,6 +250,7 @@ static FORCE_INLINE int32_t walCheckAndRoll(SWal *pWal) {
   }
 
   if (walGetLastFileCachedSize(pWal) > tsWalFsyncDataSizeLimit) {
+    walFlushWriteBuf(pWal);
     if (walSaveMeta(pWal) < 0) {
       return -1;
     }
@@ -289,6 +298,8 @@ int32_t walEndSnapshot(SWal *pWal) {
     goto END;
   }
 
+  walFlushWriteBuf(pWal);
+
   pWal->vers.snapshotVer = ver;
   int ts = taosGetTimestampSec();
   ver = TMAX(ver - pWal->vers.logRetention, pWal->vers.firstVer - 1);
@@ -394,6 +405,9 @@ END:
 int32_t walRollImpl(SWal *pWal) {
   int32_t code = 0;
 
+  // staged entries belong to the current file
+  walFlushWriteBuf(pWal);
+
   if (pWal->pIdxFile != NULL) {
     code = taosFsyncFile(pWal->pIdxFile);
     if (code != 0) {
@@ -462,6 +476,146 @@ END:
   return code;
 }
 
+SWalWriteBuf *walOpenWriteBuf(int64_t maxSize, int32_t maxDelay) {
+  SWalWriteBuf *pBuf = taosMemoryCalloc(1, sizeof(SWalWriteBuf));
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pBuf->maxSize = maxSize;
+  pBuf->maxDelay = maxDelay;
+  pBuf->firstVer = -1;
+  return pBuf;
+}
+
+void walCloseWriteBuf(SWalWriteBuf *pBuf) {
+  if (pBuf == NULL) return;
+  taosMemoryFree(pBuf->pLog);
+  taosMemoryFree(pBuf->pIdx);
+  taosMemoryFree(pBuf);
+}
+
+void walResetWriteBuf(SWalWriteBuf *pBuf) {
+  if (pBuf == NULL) return;
+  pBuf->logSize = 0;
+  pBuf->numOfEntries = 0;
+  pBuf->logOffset = 0;
+  pBuf->stageTs = 0;
+  atomic_store_64(&pBuf->firstVer, -1);
+}
+
+static int32_t walStageEntry(SWalWriteBuf *pBuf, int64_t offset, const SWalCkHead *pHead, const void *body,
+                             int32_t bodyLen) {
+  int64_t size = sizeof(SWalCkHead) + bodyLen;
+  if (pBuf->logSize + size > pBuf->logCap) {
+    int64_t cap = TMAX(pBuf->logCap * 2, pBuf->logSize + size);
+    char   *pLog = taosMemoryRealloc(pBuf->pLog, cap);
+    if (pLog == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    pBuf->pLog = pLog;
+    pBuf->logCap = cap;
+  }
+
+  if (pBuf->numOfEntries >= pBuf->idxCap) {
+    int32_t       cap = TMAX(pBuf->idxCap * 2, 64);
+    SWalIdxEntry *pIdx = taosMemoryRealloc(pBuf->pIdx, cap * sizeof(SWalIdxEntry));
+    if (pIdx == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    pBuf->pIdx = pIdx;
+    pBuf->idxCap = cap;
+  }
+
+  memcpy(pBuf->pLog + pBuf->logSize, pHead, sizeof(SWalCkHead));
+  memcpy(pBuf->pLog + pBuf->logSize + sizeof(SWalCkHead), body, bodyLen);
+  pBuf->logSize += size;
+
+  pBuf->pIdx[pBuf->numOfEntries].ver = pHead->head.version;
+  pBuf->pIdx[pBuf->numOfEntries].offset = offset;
+  if (pBuf->numOfEntries++ == 0) {
+    pBuf->logOffset = offset;
+    pBuf->stageTs = taosGetTimestampMs();
+    atomic_store_64(&pBuf->firstVer, pHead->head.version);
+  }
+  return 0;
+}
+
+// write all staged entries of the current file, caller should hold pWal->mutex. The staged entries were acknowledged
+// by walWrite, so a failed flush stops the process.
+void walFlushWriteBuf(SWal *pWal) {
+  SWalWriteBuf *pBuf = pWal->pWriteBuf;
+  if (pBuf == NULL || pBuf->numOfEntries == 0) return;
+
+  int64_t firstVer = pBuf->firstVer;
+  int64_t idxSize = pBuf->numOfEntries * sizeof(SWalIdxEntry);
+
+  wDebug("vgId:%d, wal group flush, index:%" PRId64 "-%" PRId64 ", entries:%d, bytes:%" PRId64, pWal->cfg.vgId,
+         firstVer, pWal->vers.lastVer, pBuf->numOfEntries, pBuf->logSize);
+
+  if (taosWriteFile(pWal->pIdxFile, pBuf->pIdx, idxSize) != idxSize) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, failed to write idx entries due to %s. ver:%" PRId64, pWal->cfg.vgId, strerror(errno), firstVer);
+    goto _err;
+  }
+
+  if (taosWriteFile(pWal->pLogFile, pBuf->pLog, pBuf->logSize) != pBuf->logSize) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
+           strerror(errno));
+    goto _err;
+  }
+
+  pBuf->stat.numOfFlushes++;
+  pBuf->stat.numOfEntries += pBuf->numOfEntries;
+  pBuf->stat.numOfBytes += pBuf->logSize;
+  pBuf->stat.maxEntriesPerFlush = TMAX(pBuf->stat.maxEntriesPerFlush, pBuf->numOfEntries);
+  walResetWriteBuf(pBuf);
+  return;
+
+_err:
+  wFatal("vgId:%d, failed to flush staged WAL entries since %s, index:%" PRId64 "-%" PRId64, pWal->cfg.vgId, terrstr(),
+         firstVer, pWal->vers.lastVer);
+  taosMsleep(100);
+  exit(EXIT_FAILURE);
+}
+
+// flush the staged entries if they are full, or the first one would be staged longer than the delay in aheadMs
+void walFlushWriteBufIfExpired(SWal *pWal, int32_t aheadMs) {
+  SWalWriteBuf *pBuf = pWal->pWriteBuf;
+  if (pBuf == NULL || pBuf->numOfEntries == 0) return;
+
+  if (pBuf->logSize < pBuf->maxSize && taosGetTimestampMs() + aheadMs - pBuf->stageTs < pBuf->maxDelay) {
+    return;
+  }
+  walFlushWriteBuf(pWal);
+}
+
+// readers go through the files, so entries they ask for must not stay staged
+void walFlushWriteBufForRead(SWal *pWal, int64_t ver) {
+  SWalWriteBuf *pBuf = pWal->pWriteBuf;
+  if (pBuf == NULL) return;
+
+  int64_t firstVer = atomic_load_64(&pBuf->firstVer);
+  if (firstVer < 0 || ver < firstVer) return;
+
+  taosThreadMutexLock(&pWal->mutex);
+  walFlushWriteBuf(pWal);
+  taosThreadMutexUnlock(&pWal->mutex);
+}
+
+void walGetGroupCommitStat(SWal *pWal, SWalGroupCommitStat *pStat) {
+  memset(pStat, 0, sizeof(SWalGroupCommitStat));
+  if (pWal->pWriteBuf == NULL) return;
+
+  taosThreadMutexLock(&pWal->mutex);
+  *pStat = pWal->pWriteBuf->stat;
+  taosThreadMutexUnlock(&pWal->mutex);
+}
+
 static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
   SWalIdxEntry  entry = {.ver = ver, .offset = offset};
   SWalFileInfo *pFileInfo = walGetCurFileInfo(pWal);
@@ -508,6 +662,25 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   wDebug("vgId:%d, wal write log %" PRId64 ", msgType: %s, cksum head %u cksum body %u", pWal->cfg.vgId, index,
          TMSG_INFO(msgType), pWal->writeHead.cksumHead, pWal->writeHead.cksumBody);
 
+  if (pWal->pWriteBuf != NULL) {
+    if (walStageEntry(pWal->pWriteBuf, offset, &pWal->writeHead, body, bodyLen) < 0) {
+      return -1;
+    }
+
+    // set status, the staged entry is written out by the next group flush
+    if (pWal->vers.firstVer == -1) {
+      pWal->vers.firstVer = 0;
+    }
+    pWal->vers.lastVer = index;
+    pWal->totSize += sizeof(SWalCkHead) + bodyLen;
+    pFileInfo->lastVer = index;
+    pFileInfo->fileSize += sizeof(SWalCkHead) + bodyLen;
+    walTailCachePut(pWal->pTailCache, &pWal->writeHead, body, bodyLen);
+
+    walFlushWriteBufIfExpired(pWal, 0);
+    return 0;
+  }
+
   code = walWriteIndex(pWal, index, offset);
   if (code < 0) {
     goto END;
@@ -537,6 +710,7 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   pWal->totSize += sizeof(SWalCkHead) + bodyLen;
   pFileInfo->lastVer = index;
   pFileInfo->fileSize += sizeof(SWalCkHead) + bodyLen;
+  walTailCachePut(pWal->pTailCache, &pWal->writeHead, body, bodyLen);
 
   return 0;
 
@@ -558,6 +732,8 @@ END:
     taosMsleep(100);
     exit(EXIT_FAILURE);
   }
+
+  atomic_add_fetch_64(&pWal->truncateSeq, 1);
   return -1;
 }
 
@@ -640,6 +816,7 @@ int32_t walWrite(SWal *pWal, int64_t index, tmsg_t msgType, const void *body, in
 void walFsync(SWal *pWal, bool forceFsync) {
   taosThreadMutexLock(&pWal->mutex);
   if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
+    walFlushWriteBuf(pWal);
     wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
     if (taosFsyncFile(pWal->pLogFile) < 0) {
       wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
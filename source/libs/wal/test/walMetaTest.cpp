@@ -3,6 +3,7 @@
 #include <iostream>
 #include <queue>
 
+#include "tglobal.h"
 #include "walInt.h"
 
 const char* ranStr = "tvapq02tcp";
@@ -144,6 +145,119 @@ class WalRetentionEnv : public ::testing::Test {
   const char* pathName = TD_TMP_DIR_PATH "wal_test";
 };
 
+class WalGroupCommitEnv : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    int code = walInit();
+    ASSERT(code == 0);
+  }
+
+  static void TearDownTestCase() { walCleanUp(); }
+
+  void SetUp() override {
+    taosRemoveDir(pathName);
+    SWalCfg* pCfg = (SWalCfg*)taosMemoryMalloc(sizeof(SWalCfg));
+    memset(pCfg, 0, sizeof(SWalCfg));
+    pCfg->rollPeriod = -1;
+    pCfg->segSize = -1;
+    pCfg->retentionPeriod = 0;
+    pCfg->retentionSize = 0;
+    pCfg->level = TAOS_WAL_WRITE;
+    tsWalGroupCommitSize = 1024 * 1024;
+    tsWalGroupCommitDelay = 1000;
+    // reads have to go through the files to flush the staged entries
+    int32_t tailCacheSize = tsWalTailCacheSize;
+    tsWalTailCacheSize = 0;
+    pWal = walOpen(pathName, pCfg);
+    tsWalGroupCommitSize = 0;
+    tsWalTailCacheSize = tailCacheSize;
+    taosMemoryFree(pCfg);
+    ASSERT(pWal != NULL);
+    ASSERT(pWal->pWriteBuf != NULL);
+  }
+
+  void TearDown() override {
+    walClose(pWal);
+    pWal = NULL;
+  }
+
+  SWal*       pWal = NULL;
+  const char* pathName = TD_TMP_DIR_PATH "wal_test";
+};
+
+class WalTailCacheEnv : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    int code = walInit();
+    ASSERT(code == 0);
+  }
+
+  static void TearDownTestCase() { walCleanUp(); }
+
+  void SetUp() override {
+    taosRemoveDir(pathName);
+    SWalCfg* pCfg = (SWalCfg*)taosMemoryMalloc(sizeof(SWalCfg));
+    memset(pCfg, 0, sizeof(SWalCfg));
+    pCfg->rollPeriod = -1;
+    pCfg->segSize = -1;
+    pCfg->retentionPeriod = 0;
+    pCfg->retentionSize = 0;
+    pCfg->level = TAOS_WAL_WRITE;
+    // room for the latest few entries only, older ones are read from the files
+    int32_t tailCacheSize = tsWalTailCacheSize;
+    tsWalTailCacheSize = 1024;
+    pWal = walOpen(pathName, pCfg);
+    tsWalTailCacheSize = tailCacheSize;
+    taosMemoryFree(pCfg);
+    ASSERT(pWal != NULL);
+    ASSERT(pWal->pTailCache != NULL);
+  }
+
+  void TearDown() override {
+    walClose(pWal);
+    pWal = NULL;
+  }
+
+  SWal*       pWal = NULL;
+  const char* pathName = TD_TMP_DIR_PATH "wal_test";
+};
+
+class WalReadAheadEnv : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    int code = walInit();
+    ASSERT(code == 0);
+  }
+
+  static void TearDownTestCase() { walCleanUp(); }
+
+  void SetUp() override {
+    taosRemoveDir(pathName);
+    SWalCfg* pCfg = (SWalCfg*)taosMemoryMalloc(sizeof(SWalCfg));
+    memset(pCfg, 0, sizeof(SWalCfg));
+    pCfg->rollPeriod = -1;
+    pCfg->segSize = -1;
+    pCfg->retentionPeriod = 0;
+    pCfg->retentionSize = 0;
+    pCfg->level = TAOS_WAL_WRITE;
+    // all reads go through the files
+    int32_t tailCacheSize = tsWalTailCacheSize;
+    tsWalTailCacheSize = 0;
+    pWal = walOpen(pathName, pCfg);
+    tsWalTailCacheSize = tailCacheSize;
+    taosMemoryFree(pCfg);
+    ASSERT(pWal != NULL);
+  }
+
+  void TearDown() override {
+    walClose(pWal);
+    pWal = NULL;
+  }
+
+  SWal*       pWal = NULL;
+  const char* pathName = TD_TMP_DIR_PATH "wal_test";
+};
+
 TEST_F(WalCleanEnv, createNew) {
   walRollFileInfo(pWal);
   ASSERT(pWal->fileInfoSet != NULL);
@@ -443,3 +557,265 @@ TEST_F(WalRetentionEnv, repairMeta1) {
   }
   walCloseReader(pRead);
 }
+
+TEST_F(WalGroupCommitEnv, readStaged) {
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL, 0);
+  ASSERT(pRead != NULL);
+
+  int i;
+  for (i = 0; i < 100; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, i);
+    int len = strlen(newStr);
+    code = walWrite(pWal, i, 0, newStr, len);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pWal->vers.lastVer, i);
+  }
+  ASSERT_EQ(pWal->pWriteBuf->numOfEntries, 100);
+
+  // reading a staged entry flushes the whole batch at once
+  code = walReadVer(pRead, 99);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->pWriteBuf->numOfEntries, 0);
+
+  SWalGroupCommitStat stat;
+  walGetGroupCommitStat(pWal, &stat);
+  ASSERT_EQ(stat.numOfFlushes, 1);
+  ASSERT_EQ(stat.numOfEntries, 100);
+  ASSERT_EQ(stat.maxEntriesPerFlush, 100);
+
+  for (int i = 0; i < 1000; i++) {
+    int ver = taosRand() % 100;
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, ver);
+    int len = strlen(newStr);
+    ASSERT_EQ(pRead->pHead->head.bodyLen, len);
+    for (int j = 0; j < len; j++) {
+      EXPECT_EQ(newStr[j], pRead->pHead->head.body[j]);
+    }
+  }
+  walCloseReader(pRead);
+}
+
+TEST_F(WalGroupCommitEnv, rollbackStaged) {
+  int code;
+  for (int i = 0; i < 10; i++) {
+    code = walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pWal->vers.lastVer, i);
+  }
+  code = walRollback(pWal, 5);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->vers.lastVer, 4);
+  ASSERT_EQ(pWal->pWriteBuf->numOfEntries, 0);
+
+  code = walWrite(pWal, 5, 6, (void*)ranStr, ranStrLen);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->vers.lastVer, 5);
+  walFsync(pWal, true);
+  ASSERT_EQ(pWal->pWriteBuf->numOfEntries, 0);
+
+  code = walSaveMeta(pWal);
+  ASSERT_EQ(code, 0);
+}
+
+TEST_F(WalGroupCommitEnv, flushByDelay) {
+  int code = walWrite(pWal, 0, 0, (void*)ranStr, ranStrLen);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->pWriteBuf->numOfEntries, 1);
+
+  // the entry is flushed once it would exceed the delay before the next check
+  taosThreadMutexLock(&pWal->mutex);
+  walFlushWriteBufIfExpired(pWal, 0);
+  ASSERT_EQ(pWal->pWriteBuf->numOfEntries, 1);
+  walFlushWriteBufIfExpired(pWal, pWal->pWriteBuf->maxDelay);
+  ASSERT_EQ(pWal->pWriteBuf->numOfEntries, 0);
+
+  // without more appends, the wal thread flushes the staged entries within the delay, which is much shorter than the
+  // refresh interval of the thread
+  pWal->pWriteBuf->maxDelay = 100;
+  taosThreadMutexUnlock(&pWal->mutex);
+  for (int64_t i = 1; i <= 3; i++) {
+    code = walWrite(pWal, i, 0, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+
+    int64_t st = taosGetTimestampMs();
+    while (atomic_load_64(&pWal->pWriteBuf->firstVer) != -1 && taosGetTimestampMs() - st < 3 * WAL_REFRESH_MS) {
+      taosMsleep(5);
+    }
+    ASSERT_EQ(atomic_load_64(&pWal->pWriteBuf->firstVer), -1);
+
+    // the first round may still sleep for the refresh interval, before the thread finds the wal
+    if (i > 1) {
+      EXPECT_LT(taosGetTimestampMs() - st, WAL_REFRESH_MS / 2);
+    }
+  }
+
+  SWalGroupCommitStat stat;
+  walGetGroupCommitStat(pWal, &stat);
+  ASSERT_EQ(stat.numOfFlushes, 4);
+  ASSERT_EQ(stat.numOfEntries, 4);
+}
+
+static void checkTailCacheEntry(SWalReader* pRead, const char* prefix, int64_t ver) {
+  char newStr[100];
+  sprintf(newStr, "%s-%" PRId64, prefix, ver);
+  int len = strlen(newStr);
+  ASSERT_EQ(pRead->pHead->head.version, ver);
+  ASSERT_EQ(pRead->pHead->head.bodyLen, len);
+  ASSERT_EQ(memcmp(newStr, pRead->pHead->head.body, len), 0);
+}
+
+TEST_F(WalTailCacheEnv, readTail) {
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL, 0);
+  ASSERT(pRead != NULL);
+
+  for (int64_t i = 0; i < 100; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%" PRId64, ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+
+  SWalTailCacheStat stat;
+  walGetTailCacheStat(pWal, &stat);
+  ASSERT_GT(stat.numOfEntries, 0);
+  ASSERT_LT(stat.numOfEntries, 100);
+  ASSERT_LE(stat.numOfBytes, 1024);
+  int64_t firstCached = 100 - stat.numOfEntries;
+
+  // random reads are served from the cache or the files
+  for (int i = 0; i < 1000; i++) {
+    int64_t ver = taosRand() % 100;
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    checkTailCacheEntry(pRead, ranStr, ver);
+  }
+  walGetTailCacheStat(pWal, &stat);
+  ASSERT_GT(stat.numOfHits, 0);
+  ASSERT_GT(stat.numOfMisses, 0);
+
+  // rolled back entries are dropped from the cache as well
+  code = walRollback(pWal, 95);
+  ASSERT_EQ(code, 0);
+  for (int64_t i = 95; i < 100; i++) {
+    char newStr[100];
+    sprintf(newStr, "new-%" PRId64, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+  for (int64_t ver = 90; ver < 100; ver++) {
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    checkTailCacheEntry(pRead, ver < 95 ? ranStr : "new", ver);
+  }
+
+  // a scan passes from the files to the cache and back
+  code = walCommit(pWal, 99);
+  ASSERT_EQ(code, 0);
+  for (int64_t ver = firstCached - 5; ver < 100; ver++) {
+    code = walFetchHead(pRead, ver);
+    ASSERT_EQ(code, 0);
+    if (ver % 3 == 0) {
+      code = walSkipFetchBody(pRead);
+      ASSERT_EQ(code, 0);
+      ASSERT_EQ(pRead->pHead->head.version, ver);
+      continue;
+    }
+    code = walFetchBody(pRead);
+    ASSERT_EQ(code, 0);
+    checkTailCacheEntry(pRead, ver < 95 ? ranStr : "new", ver);
+  }
+  code = walFetchHead(pRead, 10);
+  ASSERT_EQ(code, 0);
+  code = walFetchBody(pRead);
+  ASSERT_EQ(code, 0);
+  checkTailCacheEntry(pRead, ranStr, 10);
+
+  walCloseReader(pRead);
+}
+
+TEST_F(WalReadAheadEnv, readAhead) {
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL, 0);
+  ASSERT(pRead != NULL);
+  walReaderSetReadAhead(pRead, 4096);
+
+  for (int64_t i = 0; i < 1000; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%" PRId64, ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+  code = walCommit(pWal, 899);
+  ASSERT_EQ(code, 0);
+
+  // a scan of the committed entries, skipping some bodies
+  for (int64_t ver = 0; ver < 900; ver++) {
+    code = walFetchHead(pRead, ver);
+    ASSERT_EQ(code, 0);
+    if (ver % 3 == 0) {
+      code = walSkipFetchBody(pRead);
+      ASSERT_EQ(code, 0);
+      ASSERT_EQ(pRead->pHead->head.version, ver);
+      continue;
+    }
+    code = walFetchBody(pRead);
+    ASSERT_EQ(code, 0);
+    checkTailCacheEntry(pRead, ranStr, ver);
+  }
+
+  // random reads seek and drop the read ahead data, and read no more than the entry
+  for (int i = 0; i < 1000; i++) {
+    int64_t ver = taosRand() % 1000;
+    bool    seek = (ver != walReaderGetCurrentVer(pRead));
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    checkTailCacheEntry(pRead, ranStr, ver);
+    if (seek) {
+      ASSERT_EQ(pRead->readAhead.len, 0);
+      ASSERT_EQ(pRead->readAhead.window, 0);
+    }
+  }
+
+  // the window starts with the entry read right after it, up to the max size
+  code = walReadVer(pRead, 500);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pRead->readAhead.len, 0);
+  code = walReadVer(pRead, 501);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pRead->readAhead.len, 4096);
+  for (int64_t ver = 502; ver < 600; ver++) {
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    checkTailCacheEntry(pRead, ranStr, ver);
+  }
+  ASSERT_EQ(pRead->readAhead.window, 4096);
+
+  // entries read ahead before a rollback are read again from the files
+  code = walReadVer(pRead, 949);
+  ASSERT_EQ(code, 0);
+  code = walReadVer(pRead, 950);
+  ASSERT_EQ(code, 0);
+  ASSERT_GT(pRead->readAhead.len, 0);
+  code = walRollback(pWal, 960);
+  ASSERT_EQ(code, 0);
+  for (int64_t i = 960; i < 1000; i++) {
+    char newStr[100];
+    sprintf(newStr, "new-%" PRId64, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+  for (int64_t ver = 951; ver < 1000; ver++) {
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    checkTailCacheEntry(pRead, ver < 960 ? ranStr : "new", ver);
+  }
+
+  walCloseReader(pRead);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "tglobal.h"
+#include "walInt.h"
+
+namespace {
+
+const int64_t numOfEntries = 200000;
+const char*   pathName = TD_TMP_DIR_PATH "wal_replay_bench";
+
+// entries of 64 to 1024 bytes, as the submit msgs of small batches
+int32_t buildBody(char* buf, int64_t ver) {
+  int32_t len = 64 + (ver * 131) % 960;
+  for (int32_t i = 0; i < len; i++) {
+    buf[i] = (char)(ver + i);
+  }
+  return len;
+}
+
+SWal* openWal() {
+  SWalCfg cfg;
+  memset(&cfg, 0, sizeof(SWalCfg));
+  cfg.rollPeriod = -1;
+  cfg.segSize = 16 * 1024;  // 16MB, so the replay passes several closed segments
+  cfg.retentionPeriod = -1;
+  cfg.retentionSize = -1;
+  cfg.level = TAOS_WAL_WRITE;
+
+  // the replay reads the files, as a restart or a lagging reader does
+  int32_t tailCacheSize = tsWalTailCacheSize;
+  tsWalTailCacheSize = 0;
+  SWal* pWal = walOpen(pathName, &cfg);
+  tsWalTailCacheSize = tailCacheSize;
+  return pWal;
+}
+
+// replay all entries by walFetchHead/walFetchBody, skipping the bodies of every 4th entry as the tq reader does for
+// the msgs it is not interested in, and return the replayed body bytes
+int64_t replay(SWal* pWal, int32_t readAhead, int64_t* cost) {
+  SWalReader* pRead = walOpenReader(pWal, NULL, 0);
+  EXPECT_NE(pRead, nullptr);
+  walReaderSetReadAhead(pRead, readAhead);
+
+  char    expected[1024];
+  int64_t bytes = 0;
+  int64_t st = taosGetTimestampUs();
+  for (int64_t ver = 0; ver < numOfEntries; ver++) {
+    EXPECT_EQ(walFetchHead(pRead, ver), 0);
+    if (ver % 4 == 3) {
+      EXPECT_EQ(walSkipFetchBody(pRead), 0);
+      continue;
+    }
+
+    EXPECT_EQ(walFetchBody(pRead), 0);
+    int32_t len = buildBody(expected, ver);
+    EXPECT_EQ(pRead->pHead->head.version, ver);
+    EXPECT_EQ(pRead->pHead->head.bodyLen, len);
+    EXPECT_EQ(memcmp(pRead->pHead->head.body, expected, len), 0);
+    bytes += len;
+  }
+  *cost = taosGetTimestampUs() - st;
+
+  walCloseReader(pRead);
+  return bytes;
+}
+
+}  // namespace
+
+TEST(walReplayBench, replay) {
+  ASSERT_EQ(walInit(), 0);
+  taosRemoveDir(pathName);
+
+  SWal* pWal = openWal();
+  ASSERT_NE(pWal, nullptr);
+
+  char body[1024];
+  for (int64_t ver = 0; ver < numOfEntries; ver++) {
+    int32_t len = buildBody(body, ver);
+    ASSERT_EQ(walWrite(pWal, ver, 0, body, len), 0);
+  }
+  ASSERT_EQ(walCommit(pWal, numOfEntries - 1), 0);
+
+  int32_t readAheads[] = {0, 256 * 1024, WAL_READ_AHEAD_SIZE};
+  for (int32_t i = 0; i < (int32_t)(sizeof(readAheads) / sizeof(readAheads[0])); i++) {
+    int64_t cost = 0;
+    int64_t bytes = replay(pWal, readAheads[i], &cost);
+    cost = cost > 0 ? cost : 1;
+    printf("read ahead %7d bytes: %" PRId64 " entries in %" PRId64 "us, %.0f entries/s, %.1f MB/s\n", readAheads[i],
+           numOfEntries, cost, numOfEntries * 1000000.0 / cost, bytes / (double)cost);
+  }
+
+  walClose(pWal);
+  taosRemoveDir(pathName);
+  walCleanUp();
+}
@@ -36,6 +36,7 @@
 #include <sys/sendfile.h>
 #endif
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #define LINUX_FILE_NO_TEXT_OPTION 0
 #define O_TEXT                    LINUX_FILE_NO_TEXT_OPTION
@@ -1196,6 +1197,88 @@ int32_t taosFsyncFile(TdFilePtr pFile) {
   return 0;
 }
 
+// Scatter read from offset, returns the bytes read, which is less than the total length of iov at the end of file.
+int64_t taosPReadvFile(TdFilePtr pFile, const TdIoVec *iov, int32_t iovcnt, int64_t offset) {
+  if (pFile == NULL) {
+    return 0;
+  }
+
+#if defined(WINDOWS) || defined(_TD_DARWIN_64)
+  int64_t total = 0;
+  for (int32_t i = 0; i < iovcnt; ++i) {
+    int64_t n = taosPReadFile(pFile, iov[i].buf, iov[i].len, offset + total);
+    if (n < 0) {
+      return -1;
+    }
+    total += n;
+    if (n < iov[i].len) break;
+  }
+  return total;
+#else
+#if FILE_WITH_LOCK
+  taosThreadRwlockRdlock(&(pFile->rwlock));
+#endif
+  ASSERT(pFile->fd >= 0);  // Please check if you have closed the file.
+  if (pFile->fd < 0) {
+#if FILE_WITH_LOCK
+    taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+    return -1;
+  }
+
+  struct iovec vec[128];
+  int64_t      total = 0;
+  int32_t      i = 0;
+  while (i < iovcnt) {
+    int32_t nvec = iovcnt - i;
+    if (nvec > (int32_t)tListLen(vec)) nvec = (int32_t)tListLen(vec);
+    int64_t size = 0;
+    for (int32_t j = 0; j < nvec; ++j) {
+      vec[j].iov_base = iov[i + j].buf;
+      vec[j].iov_len = iov[i + j].len;
+      size += iov[i + j].len;
+    }
+
+    int64_t n = preadv(pFile->fd, vec, nvec, offset + total);
+    if (n < 0) {
+      total = -1;
+      break;
+    }
+
+    total += n;
+    if (n < size) break;  // end of file
+    i += nvec;
+  }
+
+#if FILE_WITH_LOCK
+  taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+  return total;
+#endif
+}
+
+int32_t taosReadAheadFile(TdFilePtr pFile, int64_t offset, int64_t count) {
+  if (pFile == NULL) {
+    return 0;
+  }
+
+#if defined(WINDOWS) || defined(_TD_DARWIN_64)
+  // no read-ahead hint is available, the following read is served synchronously
+  return 0;
+#else
+  if (pFile->fd < 0) {
+    return 0;
+  }
+
+  int32_t ret = posix_fadvise(pFile->fd, offset, count, POSIX_FADV_WILLNEED);
+  if (ret != 0) {
+    errno = ret;
+    return -1;
+  }
+  return 0;
+#endif
+}
+
 void taosFprintfFile(TdFilePtr pFile, const char *format, ...) {
   if (pFile == NULL || pFile->fp == NULL) {
     return;
@@ -168,6 +168,59 @@ TEST(osTest, osFile) {
   //printf("remove file success");
 }
 
+TEST(osTest, osPReadvFile) {
+  char         *fname = "./osPReadvFileTest.txt";
+  const int32_t size = 100000;
+  char         *data = (char *)taosMemoryMalloc(size);
+  char         *buf = (char *)taosMemoryCalloc(1, size);
+  for (int32_t i = 0; i < size; ++i) {
+    data[i] = (char)(i * 7 + i / 251);
+  }
+
+  TdFilePtr pFile = taosOpenFile(fname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_READ | TD_FILE_TRUNC);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosWriteFile(pFile, data, size), size);
+
+  // more vectors than one preadv call takes, of different lengths
+  TdIoVec iov[300];
+  int32_t len = 0;
+  for (int32_t i = 0; i < 300; ++i) {
+    iov[i].buf = buf + len;
+    iov[i].len = 1 + i % 37;
+    len += iov[i].len;
+  }
+  ASSERT_EQ(taosPReadvFile(pFile, iov, 300, 1000), len);
+  ASSERT_EQ(memcmp(buf, data + 1000, len), 0);
+
+  // the vectors are filled one after another
+  memset(buf, 0, size);
+  iov[0] = (TdIoVec){.buf = buf + 500, .len = 100};
+  iov[1] = (TdIoVec){.buf = buf, .len = 200};
+  ASSERT_EQ(taosPReadvFile(pFile, iov, 2, 10), 300);
+  ASSERT_EQ(memcmp(buf + 500, data + 10, 100), 0);
+  ASSERT_EQ(memcmp(buf, data + 110, 200), 0);
+
+  // a read beyond the end of the file stops there, in the middle of a vector or across the vectors
+  memset(buf, 0, size);
+  for (int32_t i = 0; i < 300; ++i) {
+    iov[i].buf = buf + i * 100;
+    iov[i].len = 100;
+  }
+  ASSERT_EQ(taosPReadvFile(pFile, iov, 300, size - 150), 150);
+  ASSERT_EQ(memcmp(buf, data + size - 150, 150), 0);
+  ASSERT_EQ(taosPReadvFile(pFile, iov, 300, size - 29950), 29950);
+  ASSERT_EQ(memcmp(buf, data + size - 29950, 29950), 0);
+  ASSERT_EQ(taosPReadvFile(pFile, iov, 2, size), 0);
+
+  // the file offset is not moved
+  ASSERT_EQ(taosLSeekFile(pFile, 0, SEEK_CUR), size);
+
+  taosCloseFile(&pFile);
+  taosRemoveFile(fname);
+  taosMemoryFree(data);
+  taosMemoryFree(buf);
+}
+
 #ifndef OSFILE_PERFORMANCE_TEST
 
 #define MAX_WORDS          100
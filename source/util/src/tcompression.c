@@ -97,6 +97,11 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
                                14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
                                15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
 
+  if (tsSIMDEnable && tsAVX2Enable) {
+    int32_t len = tsCompressINTImpAvx2(input, nelements, output, type);
+    if (len >= 0) return len;
+  }
+
   // get the byte limit.
   int32_t word_length = getWordLength(type);
 
@@ -438,6 +443,11 @@ int32_t tsCompressTimestampImp(const char *const input, const int32_t nelements,
 
   if (nelements == 0) return 0;
 
+  if (tsSIMDEnable && tsAVX2Enable) {
+    int32_t len = tsCompressTimestampAvx2(input, nelements, output);
+    if (len >= 0) return len;
+  }
+
   int64_t *istream = (int64_t *)input;
 
   int64_t prev_value = istream[0];
@@ -621,6 +631,11 @@ void encodeDoubleValue(uint64_t diff, uint8_t flag, char *const output, int32_t
 }
 
 int32_t tsCompressDoubleImp(const char *const input, const int32_t nelements, char *const output) {
+  if (tsSIMDEnable && tsAVX2Enable) {
+    int32_t len = tsCompressDoubleImpAvx2(input, nelements, output);
+    if (len >= 0) return len;
+  }
+
   int32_t byte_limit = nelements * DOUBLE_BYTES + 1;
   int32_t opos = 1;
 
@@ -590,3 +590,394 @@ int32_t tsDecompressTimestampAvx512(const char *const input, const int32_t nelem
 #endif
   return 0;
 }
+
+/* ---------------------------------------------- Compression ---------------------------------------------------- */
+#if __AVX2__
+#define SIMPLE8B_MAX_INT64 ((uint64_t)1152921504606846974LL)
+
+// a - b in the way of safeInt64Add(a, -b), returns true if it overflows
+static FORCE_INLINE bool tsSubOverflow(int64_t a, int64_t b, int64_t *r) {
+  int64_t nb = (int64_t)(0 - (uint64_t)b);
+  *r = (int64_t)((uint64_t)a + (uint64_t)nb);
+  return ((~(a ^ nb)) & (a ^ *r)) < 0;
+}
+
+// the lane wise version of tsSubOverflow, the overflow is in the sign bit of each returned lane
+static FORCE_INLINE __m256i tsSubOverflowAvx2(__m256i a, __m256i b, __m256i *r) {
+  __m256i nb = _mm256_sub_epi64(_mm256_setzero_si256(), b);
+  *r = _mm256_add_epi64(a, nb);
+  return _mm256_andnot_si256(_mm256_xor_si256(a, nb), _mm256_xor_si256(a, *r));
+}
+
+static FORCE_INLINE __m256i tsZigzagEncodeAvx2(__m256i v) {
+  __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), v);
+  return _mm256_xor_si256(sign, _mm256_slli_epi64(v, 1));
+}
+
+static FORCE_INLINE int64_t tsGetIntValue(const char *const input, int32_t i, const char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return (int64_t)(*((int8_t *)input + i));
+    case TSDB_DATA_TYPE_SMALLINT:
+      return (int64_t)(*((int16_t *)input + i));
+    case TSDB_DATA_TYPE_INT:
+      return (int64_t)(*((int32_t *)input + i));
+    default:
+      return (int64_t)(*((int64_t *)input + i));
+  }
+}
+
+// load 4 integers from the i-th one, and sign extend them to int64
+static FORCE_INLINE __m256i tsLoadIntValueAvx2(const char *const input, int32_t i, const char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT: {
+      int32_t v;
+      memcpy(&v, input + i, sizeof(v));
+      return _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(v));
+    }
+    case TSDB_DATA_TYPE_SMALLINT:
+      return _mm256_cvtepi16_epi64(_mm_loadl_epi64((const __m128i *)(input + i * SHORT_BYTES)));
+    case TSDB_DATA_TYPE_INT:
+      return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(input + i * INT_BYTES)));
+    default:
+      return _mm256_loadu_si256((const __m256i *)(input + i * LONG_BYTES));
+  }
+}
+#endif
+
+/*
+ * The zigzag encoded deltas and their selectors are computed for the whole input with AVX2 at first, then they are
+ * packed into the simple8b words in the same way of tsCompressINTImp, so the output is identical to it.
+ * Return -1 if it is not available, and the caller falls back to tsCompressINTImp.
+ */
+int32_t tsCompressINTImpAvx2(const char *const input, const int32_t nelements, char *const output, const char type) {
+#if __AVX2__
+  char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+  int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+  char    bit_to_selector[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12, 13, 13, 13, 13, 13,
+                               14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+                               15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
+
+  int32_t word_length = getWordLength(type);
+  if (word_length == -1) {
+    return -1;
+  }
+
+  int32_t byte_limit = nelements * word_length + 1;
+  int32_t opos = 1;
+
+  uint64_t *pZigzag = taosMemoryMalloc(nelements * (sizeof(uint64_t) + sizeof(char)));
+  if (pZigzag == NULL) {
+    return -1;
+  }
+  char *pSelector = (char *)(pZigzag + nelements);
+
+  // zigzag encoded deltas, and whether any of them is out of the range of simple8b
+  const __m256i signBit = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i maxVal = _mm256_set1_epi64x((int64_t)((SIMPLE8B_MAX_INT64 - 1) ^ (uint64_t)INT64_MIN));
+  __m256i       invalid = _mm256_setzero_si256();
+  bool          overflow = false;
+  int32_t       i = 0;
+
+  if (nelements > 0) {
+    int64_t first = tsGetIntValue(input, 0, type);
+    pZigzag[0] = ZIGZAG_ENCODE(int64_t, first);
+    overflow = (pZigzag[0] >= SIMPLE8B_MAX_INT64);
+    i = 1;
+  }
+
+  for (; i + 4 <= nelements; i += 4) {
+    __m256i diff;
+    __m256i curr = tsLoadIntValueAvx2(input, i, type);
+    __m256i prev = tsLoadIntValueAvx2(input, i - 1, type);
+    invalid = _mm256_or_si256(invalid, tsSubOverflowAvx2(curr, prev, &diff));
+
+    __m256i zigzag = tsZigzagEncodeAvx2(diff);
+    invalid = _mm256_or_si256(invalid, _mm256_cmpgt_epi64(_mm256_xor_si256(zigzag, signBit), maxVal));
+    _mm256_storeu_si256((__m256i *)(pZigzag + i), zigzag);
+  }
+
+  for (; i < nelements; i++) {
+    int64_t diff = 0;
+    overflow |= tsSubOverflow(tsGetIntValue(input, i, type), tsGetIntValue(input, i - 1, type), &diff);
+    pZigzag[i] = ZIGZAG_ENCODE(int64_t, diff);
+    overflow |= (pZigzag[i] >= SIMPLE8B_MAX_INT64);
+  }
+
+  if (overflow || _mm256_movemask_pd(_mm256_castsi256_pd(invalid)) != 0) {
+    goto _copy_and_exit;
+  }
+
+  for (i = 0; i < nelements; i++) {
+    pSelector[i] = (pZigzag[i] == 0) ? 0 : bit_to_selector[(LONG_BYTES * BITS_PER_BYTE) - BUILDIN_CLZL(pZigzag[i])];
+  }
+
+  for (i = 0; i < nelements;) {
+    char    selector = 0;
+    int32_t elems = 0;
+
+    for (int32_t j = i; j < nelements; j++) {
+      char s = pSelector[j];
+      if (elems + 1 <= selector_to_elems[(int32_t)selector] && elems + 1 <= selector_to_elems[(int32_t)s]) {
+        selector = selector > s ? selector : s;
+        elems++;
+      } else {
+        while (elems < selector_to_elems[(int32_t)selector]) selector++;
+        elems = selector_to_elems[(int32_t)selector];
+        break;
+      }
+    }
+
+    char     bit = bit_per_integer[(int32_t)selector];
+    uint64_t mask = INT64MASK(bit);
+    uint64_t buffer = (uint64_t)selector;
+    for (int32_t k = 0; k < elems; k++) {
+      buffer |= ((pZigzag[i++] & mask) << (bit * k + 4));
+    }
+
+    if (opos + sizeof(buffer) <= byte_limit) {
+      memcpy(output + opos, &buffer, sizeof(buffer));
+      opos += sizeof(buffer);
+    } else {
+      goto _copy_and_exit;
+    }
+  }
+
+  taosMemoryFree(pZigzag);
+  output[0] = 0;
+  return opos;
+
+_copy_and_exit:
+  taosMemoryFree(pZigzag);
+  output[0] = 1;
+  memcpy(output + 1, input, byte_limit - 1);
+  return byte_limit;
+#else
+  return -1;
+#endif
+}
+
+#if __AVX2__
+// append one zigzag encoded delta of delta to the timestamp stream, the pair of them shares one flag byte.
+// return false if the stream is going to be longer than the raw data.
+static FORCE_INLINE bool tsPutTimestampDD(char *const output, int32_t limit, int32_t *pos, int32_t i, uint64_t dd,
+                                          uint64_t *dd1, uint8_t *flag1) {
+  uint8_t flag = (dd == 0) ? 0 : (uint8_t)(LONG_BYTES - BUILDIN_CLZL(dd) / BITS_PER_BYTE);
+  if ((i & 0x01) == 0) {
+    *dd1 = dd;
+    *flag1 = flag;
+    return true;
+  }
+
+  int32_t p = *pos;
+  if (p + CHAR_BYTES + *flag1 + flag > limit) return false;
+
+  output[p++] = (char)(*flag1 | (flag << 4));
+  if (p + 2 * LONG_BYTES <= limit) {
+    // store the whole words, the extra bytes are overwritten by the following ones
+    memcpy(output + p, dd1, LONG_BYTES);
+    memcpy(output + p + *flag1, &dd, LONG_BYTES);
+  } else {
+    memcpy(output + p, dd1, *flag1);
+    memcpy(output + p + *flag1, &dd, flag);
+  }
+
+  *pos = p + *flag1 + flag;
+  return true;
+}
+#endif
+
+/*
+ * The delta of delta of timestamps are computed 4 at a time with AVX2, and the output is identical to
+ * tsCompressTimestampImp. Return -1 if it is not available.
+ */
+int32_t tsCompressTimestampAvx2(const char *const input, const int32_t nelements, char *const output) {
+#if __AVX2__
+  const int64_t *istream = (const int64_t *)input;
+  int32_t        limit = nelements * LONG_BYTES;
+  int32_t        pos = 1;
+  int32_t        i = 0;
+  uint64_t       dd1 = 0;
+  uint8_t        flag1 = 0;
+  uint64_t       zigzag[4];
+  __m256i        invalid = _mm256_setzero_si256();
+
+  if (nelements == 0) return 0;
+
+  if (istream[0] < 0) {
+    uWarn("compression timestamp is over signed long long range. ts = 0x%" PRIx64 " \n", istream[0]);
+    goto _exit_over;
+  }
+
+  // the first delta of delta is against the delta of -istream[0]
+  int64_t prev_value = istream[0];
+  int64_t prev_delta = -prev_value;
+  for (; i < nelements && i < 2; i++) {
+    int64_t curr_delta = 0, delta_of_delta = 0;
+    if (tsSubOverflow(istream[i], prev_value, &curr_delta)) goto _exit_over;
+    if (tsSubOverflow(curr_delta, prev_delta, &delta_of_delta)) goto _exit_over;
+    if (!tsPutTimestampDD(output, limit, &pos, i, ZIGZAG_ENCODE(int64_t, delta_of_delta), &dd1, &flag1)) {
+      goto _exit_over;
+    }
+    prev_value = istream[i];
+    prev_delta = curr_delta;
+  }
+
+  for (; i + 4 <= nelements; i += 4) {
+    __m256i delta, prevDelta, deltaOfDelta;
+    __m256i v0 = _mm256_loadu_si256((const __m256i *)(istream + i));
+    __m256i v1 = _mm256_loadu_si256((const __m256i *)(istream + i - 1));
+    __m256i v2 = _mm256_loadu_si256((const __m256i *)(istream + i - 2));
+
+    invalid = _mm256_or_si256(invalid, tsSubOverflowAvx2(v0, v1, &delta));
+    (void)tsSubOverflowAvx2(v1, v2, &prevDelta);  // checked as delta already
+    invalid = _mm256_or_si256(invalid, tsSubOverflowAvx2(delta, prevDelta, &deltaOfDelta));
+    _mm256_storeu_si256((__m256i *)zigzag, tsZigzagEncodeAvx2(deltaOfDelta));
+
+    for (int32_t k = 0; k < 4; ++k) {
+      if (!tsPutTimestampDD(output, limit, &pos, i + k, zigzag[k], &dd1, &flag1)) goto _exit_over;
+    }
+  }
+
+  if (_mm256_movemask_pd(_mm256_castsi256_pd(invalid)) != 0) goto _exit_over;
+
+  if (i >= 2) {
+    prev_value = istream[i - 1];
+    prev_delta = istream[i - 1] - istream[i - 2];
+  }
+
+  for (; i < nelements; i++) {
+    int64_t curr_delta = 0, delta_of_delta = 0;
+    if (tsSubOverflow(istream[i], prev_value, &curr_delta)) goto _exit_over;
+    if (tsSubOverflow(curr_delta, prev_delta, &delta_of_delta)) goto _exit_over;
+    if (!tsPutTimestampDD(output, limit, &pos, i, ZIGZAG_ENCODE(int64_t, delta_of_delta), &dd1, &flag1)) {
+      goto _exit_over;
+    }
+    prev_value = istream[i];
+    prev_delta = curr_delta;
+  }
+
+  if (nelements % 2 == 1) {
+    if (pos + CHAR_BYTES + flag1 > limit) goto _exit_over;
+    output[pos++] = (char)flag1;
+    memcpy(output + pos, &dd1, flag1);
+    pos += flag1;
+  }
+
+  output[0] = 1;  // Means the string is compressed
+  return pos;
+
+_exit_over:
+  output[0] = 0;  // Means the string is not compressed
+  memcpy(output + 1, input, nelements * LONG_BYTES);
+  return nelements * LONG_BYTES + 1;
+#else
+  return -1;
+#endif
+}
+
+#if __AVX2__
+static FORCE_INLINE uint8_t tsGetDoubleFlag(uint64_t diff) {
+  int32_t leading_zeros = LONG_BYTES * BITS_PER_BYTE;
+  int32_t trailing_zeros = leading_zeros;
+
+  if (diff) {
+    trailing_zeros = BUILDIN_CTZL(diff);
+    leading_zeros = BUILDIN_CLZL(diff);
+  }
+
+  uint8_t nbytes = 0;
+  if (trailing_zeros > leading_zeros) {
+    nbytes = (uint8_t)(LONG_BYTES - trailing_zeros / BITS_PER_BYTE);
+    if (nbytes > 0) nbytes--;
+    return ((uint8_t)1 << 3) | nbytes;
+  } else {
+    nbytes = (uint8_t)(LONG_BYTES - leading_zeros / BITS_PER_BYTE);
+    if (nbytes > 0) nbytes--;
+    return nbytes;
+  }
+}
+
+// append the pair of xor-ed values, return false if the stream is going to be longer than the raw data
+static FORCE_INLINE bool tsPutDoublePair(char *const output, int32_t limit, int32_t *pos, uint64_t diff1,
+                                         uint8_t flag1, uint64_t diff2, uint8_t flag2) {
+  int32_t nbyte1 = (flag1 & INT8MASK(3)) + 1;
+  int32_t nbyte2 = (flag2 & INT8MASK(3)) + 1;
+  int32_t p = *pos;
+  if (p + 1 + nbyte1 + nbyte2 > limit) return false;
+
+  diff1 >>= (LONG_BYTES * BITS_PER_BYTE - nbyte1 * BITS_PER_BYTE) * (flag1 >> 3);
+  diff2 >>= (LONG_BYTES * BITS_PER_BYTE - nbyte2 * BITS_PER_BYTE) * (flag2 >> 3);
+
+  output[p++] = (char)(flag1 | (flag2 << 4));
+  if (p + 2 * LONG_BYTES <= limit) {
+    memcpy(output + p, &diff1, LONG_BYTES);
+    memcpy(output + p + nbyte1, &diff2, LONG_BYTES);
+  } else {
+    memcpy(output + p, &diff1, nbyte1);
+    memcpy(output + p + nbyte1, &diff2, nbyte2);
+  }
+
+  *pos = p + nbyte1 + nbyte2;
+  return true;
+}
+#endif
+
+/*
+ * The xor of adjacent doubles are computed 4 at a time with AVX2, and the output is identical to tsCompressDoubleImp.
+ * Return -1 if it is not available.
+ */
+int32_t tsCompressDoubleImpAvx2(const char *const input, const int32_t nelements, char *const output) {
+#if __AVX2__
+  const uint64_t *istream = (const uint64_t *)input;
+  int32_t         byte_limit = nelements * DOUBLE_BYTES + 1;
+  int32_t         opos = 1;
+  int32_t         i = 0;
+  uint64_t        diff[4];
+
+  // each loop handles 4 values of 2 pairs, the first one of them is xor-ed with the last value of the previous loop
+  for (; i + 4 <= nelements; i += 4) {
+    if (i > 0) {
+      __m256i curr = _mm256_loadu_si256((const __m256i *)(istream + i));
+      __m256i prev = _mm256_loadu_si256((const __m256i *)(istream + i - 1));
+      _mm256_storeu_si256((__m256i *)diff, _mm256_xor_si256(curr, prev));
+    } else {
+      diff[0] = istream[0];
+      diff[1] = istream[1] ^ istream[0];
+      diff[2] = istream[2] ^ istream[1];
+      diff[3] = istream[3] ^ istream[2];
+    }
+
+    if (!tsPutDoublePair(output, byte_limit, &opos, diff[0], tsGetDoubleFlag(diff[0]), diff[1],
+                         tsGetDoubleFlag(diff[1])) ||
+        !tsPutDoublePair(output, byte_limit, &opos, diff[2], tsGetDoubleFlag(diff[2]), diff[3],
+                         tsGetDoubleFlag(diff[3]))) {
+      goto _copy_and_exit;
+    }
+  }
+
+  for (; i < nelements; i += 2) {
+    uint64_t diff1 = istream[i] ^ ((i > 0) ? istream[i - 1] : 0);
+    uint64_t diff2 = 0;
+    uint8_t  flag2 = 0;
+    if (i + 1 < nelements) {
+      diff2 = istream[i + 1] ^ istream[i];
+      flag2 = tsGetDoubleFlag(diff2);
+    }
+
+    if (!tsPutDoublePair(output, byte_limit, &opos, diff1, tsGetDoubleFlag(diff1), diff2, flag2)) {
+      goto _copy_and_exit;
+    }
+  }
+
+  output[0] = 0;
+  return opos;
+
+_copy_and_exit:
+  output[0] = 1;
+  memcpy(output + 1, input, byte_limit - 1);
+  return byte_limit;
+#else
+  return -1;
+#endif
+}
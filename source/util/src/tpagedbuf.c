@@ -11,9 +11,12 @@
 #define HAS_DATA_IN_DISK(_p)           ((_p)->offset >= 0)
 #define NO_IN_MEM_AVAILABLE_PAGES(_b)  (listNEles((_b)->lruList) >= (_b)->inMemPages)
 
+// number of unreferenced pages at the eldest end of the LRU list that are checked for a clean victim
+#define EVICT_CLEAN_PAGE_WINDOW 8
+
 typedef struct SPageDiskInfo {
   int64_t offset;
-  int32_t length;
+  int64_t length;
 } SPageDiskInfo, SFreeListItem;
 
 struct SPageInfo {
@@ -24,6 +27,7 @@ struct SPageInfo {
   int32_t    length : 29;
   bool       used : 1;   // set current page is in used
   bool       dirty : 1;  // set current buffer page is dirty or not
+  bool       prefetched : 1;  // read-ahead has been issued since the page is flushed to disk
 };
 
 struct SDiskbasedBuf {
@@ -42,7 +46,7 @@ struct SDiskbasedBuf {
   SList*    lruList;
   void*     emptyDummyIdList;  // dummy id list
   void*     assistBuf;         // assistant buffer for compress/decompress data
-  SArray*   pFree;             // free area in file
+  SArray*   pFree;             // free area in file, in the order of offset and the adjacent areas are merged
   bool      comp;              // compressed before flushed to disk
   uint64_t  nextPos;           // next page flush position
 
@@ -70,51 +74,103 @@ static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
+// the compressed data is one byte longer than the source at most, see tsCompressStringImp
+static FORCE_INLINE size_t getCompBufSize(int32_t pageSize) { return pageSize + sizeof(SFilePage) + 1; }
+
+static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {
   if (!pBuf->comp) {
     *dst = srcSize;
     return data;
   }
 
-  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, srcSize, ONE_STAGE_COMP, NULL, 0);
-
-  memcpy(data, pBuf->assistBuf, *dst);
-  return data;
+  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, getCompBufSize(pBuf->pageSize), ONE_STAGE_COMP, NULL, 0);
+  return pBuf->assistBuf;
 }
 
-static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
+static int32_t doDecompressData(void* data, int32_t srcSize, void* pDst, SDiskbasedBuf* pBuf) {
   if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+    return srcSize;
+  }
+
+  return tsDecompressString(data, srcSize, 1, pDst, pBuf->pageSize + sizeof(SFilePage), ONE_STAGE_COMP, NULL, 0);
+}
+
+// best fit in the free areas, or append to the end of file
+static int64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, int32_t size) {
+  int32_t index = -1;
+  int64_t minLen = INT64_MAX;
+
+  size_t num = taosArrayGetSize(pBuf->pFree);
+  for (int32_t i = 0; i < num; ++i) {
+    SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
+    if (pi->length >= size && pi->length < minLen) {
+      index = i;
+      minLen = pi->length;
+      if (minLen == size) {
+        break;
+      }
+    }
   }
 
-  *dst = tsDecompressString(data, srcSize, 1, pBuf->assistBuf, pBuf->pageSize, ONE_STAGE_COMP, NULL, 0);
-  if (*dst > 0) {
-    memcpy(data, pBuf->assistBuf, *dst);
+  // no available recycle space, allocate new area in file
+  if (index == -1) {
+    int64_t offset = pBuf->nextPos;
+    pBuf->nextPos += size;
+    return offset;
   }
-  return data;
+
+  SFreeListItem* pi = taosArrayGet(pBuf->pFree, index);
+  int64_t        offset = pi->offset;
+  pi->offset += size;
+  pi->length -= size;
+  if (pi->length == 0) {
+    taosArrayRemove(pBuf->pFree, index);
+  }
+
+  return offset;
 }
 
-static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
-  if (pBuf->pFree == NULL) {
-    return pBuf->nextPos;
-  } else {
-    int32_t offset = -1;
+static void releasePositionInFile(SDiskbasedBuf* pBuf, int64_t offset, int64_t length) {
+  if (length <= 0) {
+    return;
+  }
 
-    size_t num = taosArrayGetSize(pBuf->pFree);
-    for (int32_t i = 0; i < num; ++i) {
-      SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
-      if (pi->length >= size) {
-        offset = pi->offset;
-        pi->offset += (int32_t)size;
-        pi->length -= (int32_t)size;
+  // the first free area after the released one
+  size_t  num = taosArrayGetSize(pBuf->pFree);
+  int32_t s = 0, e = (int32_t)num;
+  while (s < e) {
+    int32_t        mid = s + (e - s) / 2;
+    SFreeListItem* pi = taosArrayGet(pBuf->pFree, mid);
+    if (pi->offset < offset) {
+      s = mid + 1;
+    } else {
+      e = mid;
+    }
+  }
 
-        return offset;
-      }
+  SFreeListItem* pPrev = (s > 0) ? taosArrayGet(pBuf->pFree, s - 1) : NULL;
+  SFreeListItem* pNext = (s < num) ? taosArrayGet(pBuf->pFree, s) : NULL;
+
+  if (pPrev != NULL && pPrev->offset + pPrev->length == offset) {
+    pPrev->length += length;
+    if (pNext != NULL && pPrev->offset + pPrev->length == pNext->offset) {
+      pPrev->length += pNext->length;
+      taosArrayRemove(pBuf->pFree, s);
     }
+  } else if (pNext != NULL && offset + length == pNext->offset) {
+    pNext->offset = offset;
+    pNext->length += length;
+  } else {
+    SFreeListItem item = {.offset = offset, .length = length};
+    taosArrayInsert(pBuf->pFree, s, &item);
+  }
 
-    // no available recycle space, allocate new area in file
-    return pBuf->nextPos;
+  // the free area at the end of file is returned to the unallocated part
+  num = taosArrayGetSize(pBuf->pFree);
+  SFreeListItem* pLast = taosArrayGet(pBuf->pFree, num - 1);
+  if (pLast->offset + pLast->length == pBuf->nextPos) {
+    pBuf->nextPos = pLast->offset;
+    taosArrayPop(pBuf->pFree);
   }
 }
 
@@ -130,13 +186,7 @@ static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
 static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize + POINTER_BYTES + sizeof(SFilePage); }
 
 static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, int64_t offset, const char* pData, int32_t size) {
-  int32_t ret = taosLSeekFile(pBuf->pFile, offset, SEEK_SET);
-  if (ret == -1) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    return terrno;
-  }
-
-  ret = (int32_t)taosWriteFile(pBuf->pFile, pData, size);
+  int32_t ret = (int32_t)taosPWriteFile(pBuf->pFile, pData, size, offset);
   if (ret != size) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return terrno;
@@ -148,6 +198,7 @@ static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, int64_t offset, const cha
   }
 
   pBuf->statis.flushBytes += size;
+  pBuf->statis.rawFlushBytes += pBuf->pageSize + sizeof(SFilePage);
   pBuf->statis.flushPages += 1;
 
   return TSDB_CODE_SUCCESS;
@@ -163,43 +214,30 @@ static char* doFlushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   int32_t size = pBuf->pageSize;
   int64_t offset = pg->offset;
 
-  char* t = NULL;
-  if ((!HAS_DATA_IN_DISK(pg)) || pg->dirty) {
+  // this page is flushed to disk for the first time, or the content is changed
+  if (pg->dirty) {
     void* payload = GET_PAYLOAD_DATA(pg);
-    t = doCompressData(payload, pBuf->pageSize + sizeof(SFilePage), &size, pBuf);
+    char* t = doCompressData(payload, pBuf->pageSize + sizeof(SFilePage), &size, pBuf);
     if (size < 0) {
       uError("failed to compress data when flushing data to disk, %s", pBuf->id);
       terrno = TSDB_CODE_INVALID_PARA;
       return NULL;
     }
-  }
 
-  // this page is flushed to disk for the first time
-  if (pg->dirty) {
     if (!HAS_DATA_IN_DISK(pg)) {
       offset = allocateNewPositionInFile(pBuf, size);
-      pBuf->nextPos += size;
-
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
-    } else {
-      // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
-      if (pg->length < size) {
-        // 1. add current space to free list
-        SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
-        taosArrayPush(pBuf->pFree, &dinfo);
-
-        // 2. allocate new position, and update the info
-        offset = allocateNewPositionInFile(pBuf, size);
-        pBuf->nextPos += size;
-      }
+    } else if (pg->length < size) {
+      // length becomes greater, current space is not enough, add it to free list and allocate new place
+      releasePositionInFile(pBuf, offset, pg->length);
+      offset = allocateNewPositionInFile(pBuf, size);
+    } else if (pg->length > size) {
+      // length becomes smaller, the remaining space is added to free list
+      releasePositionInFile(pBuf, offset + size, pg->length - size);
+    }
 
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
+    int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
+    if (code != TSDB_CODE_SUCCESS) {
+      return NULL;
     }
   } else {  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
     size = pg->length;
@@ -214,6 +252,7 @@ static char* doFlushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
 
   pg->offset = offset;
   pg->length = size;  // on disk size
+  pg->prefetched = false;
   return pDataBuf;
 }
 
@@ -241,14 +280,11 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     return TSDB_CODE_INVALID_PARA;
   }
 
-  int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-  if (ret == -1) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
-  }
-
+  // the compressed data is read into the assistant buffer, and decompressed into the page
   void* pPage = (void*)GET_PAYLOAD_DATA(pg);
-  ret = (int32_t)taosReadFile(pBuf->pFile, pPage, pg->length);
+  void* pRead = pBuf->comp ? pBuf->assistBuf : pPage;
+
+  int32_t ret = (int32_t)taosPReadFile(pBuf->pFile, pRead, pg->length, pg->offset);
   if (ret != pg->length) {
     ret = TAOS_SYSTEM_ERROR(errno);
     return ret;
@@ -256,9 +292,18 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
 
   pBuf->statis.loadBytes += pg->length;
   pBuf->statis.loadPages += 1;
+  if (pg->prefetched) {
+    pBuf->statis.prefetchHits += 1;
+    pg->prefetched = false;
+  }
+
+  int32_t fullSize = doDecompressData(pRead, pg->length, pPage, pBuf);
+  if (fullSize < 0) {
+    uError("failed to decompress buf page:%d, offset:%" PRId64 ", length:%d, %s", pg->pageId, pg->offset, pg->length,
+           pBuf->id);
+    return TSDB_CODE_FILE_CORRUPTED;
+  }
 
-  int32_t fullSize = 0;
-  doDecompressData(pPage, pg->length, &fullSize, pBuf);
   return 0;
 }
 
@@ -278,14 +323,20 @@ static SPageInfo* registerNewPageInfo(SDiskbasedBuf* pBuf, int32_t pageId) {
   ppi->used = true;
   ppi->pn = NULL;
   ppi->dirty = false;
+  ppi->prefetched = false;
 
   return *(SPageInfo**)taosArrayPush(pBuf->pIdList, &ppi);
 }
 
+// A clean page that has a copy on disk is evicted without writing, so it is preferred to the eldest unreferenced page if it is
+// found among the first EVICT_CLEAN_PAGE_WINDOW unreferenced pages.
 static SListNode* getEldestUnrefedPage(SDiskbasedBuf* pBuf) {
   SListIter iter = {0};
   tdListInitIter(pBuf->lruList, &iter, TD_LIST_BACKWARD);
 
+  SListNode* pVictim = NULL;
+  int32_t    numOfUnrefed = 0;
+
   SListNode* pn = NULL;
   while ((pn = tdListNext(&iter)) != NULL) {
     SPageInfo* pageInfo = *(SPageInfo**)pn->data;
@@ -293,12 +344,24 @@ static SListNode* getEldestUnrefedPage(SDiskbasedBuf* pBuf) {
     SPageInfo* p = *(SPageInfo**)(pageInfo->pData);
     ASSERT(pageInfo->pageId >= 0 && pageInfo->pn == pn && p == pageInfo);
 
-    if (!pageInfo->used) {
+    if (pageInfo->used) {
+      continue;
+    }
+
+    if (!pageInfo->dirty && HAS_DATA_IN_DISK(pageInfo)) {
+      return pn;
+    }
+
+    if (pVictim == NULL) {
+      pVictim = pn;
+    }
+
+    if (++numOfUnrefed >= EVICT_CLEAN_PAGE_WINDOW) {
       break;
     }
   }
 
-  return pn;
+  return pVictim;
 }
 
 static char* evictBufPage(SDiskbasedBuf* pBuf) {
@@ -355,6 +418,16 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
   pPBuf->fileSize = 0;
   pPBuf->pFree = taosArrayInit(4, sizeof(SFreeListItem));
   pPBuf->freePgList = tdListNew(POINTER_BYTES);
+  if (pPBuf->pFree == NULL || pPBuf->freePgList == NULL) {
+    goto _error;
+  }
+
+  // pages are compressed when flushed to disk by default
+  pPBuf->comp = true;
+  pPBuf->assistBuf = taosMemoryMalloc(getCompBufSize(pagesize));
+  if (pPBuf->assistBuf == NULL) {
+    goto _error;
+  }
 
   // at least more than 2 pages must be in memory
   if (inMemBufSize < pagesize * 2) {
@@ -595,6 +668,11 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
           ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
           ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
     }
+
+    if (ps->rawFlushBytes > 0) {
+      uDebug("compRatio:%.2f%%, prefetch/hit pages:%d/%d, %s", ps->flushBytes * 100.0 / ps->rawFlushBytes,
+             ps->prefetchPages, ps->prefetchHits, pBuf->id);
+    }
   }
 
   if (needRemoveFile) {
@@ -648,9 +726,18 @@ void setBufPageDirty(void* pPage, bool dirty) {
 }
 
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) {
+  // the pages on disk are decompressed by the current flag, so it can not be changed anymore
+  if (pBuf->fileSize > 0) {
+    uWarn("failed to set compress flag:%d, pages have been flushed to disk, %s", comp, pBuf->id);
+    return;
+  }
+
   pBuf->comp = comp;
-  if (comp  && (pBuf->assistBuf == NULL)) {
-    pBuf->assistBuf = taosMemoryMalloc(pBuf->pageSize + 2);  // EXTRA BYTES
+  if (comp && (pBuf->assistBuf == NULL)) {
+    pBuf->assistBuf = taosMemoryMalloc(getCompBufSize(pBuf->pageSize));
+    if (pBuf->assistBuf == NULL) {
+      pBuf->comp = false;
+    }
   }
 }
 
@@ -659,6 +746,14 @@ void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
 
   ppi->used = false;
   ppi->dirty = false;
+  ppi->prefetched = false;
+
+  // the space in file is not needed anymore
+  if (HAS_DATA_IN_DISK(ppi)) {
+    releasePositionInFile(pBuf, ppi->offset, ppi->length);
+    ppi->offset = -1;
+    ppi->length = -1;
+  }
 
   // add this pageinfo into the free page info list
   SListNode* pNode = tdListPopNode(pBuf->lruList, ppi->pn);
@@ -669,6 +764,57 @@ void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
   tdListAppend(pBuf->freePgList, &ppi);
 }
 
+static void doReadAheadPages(SDiskbasedBuf* pBuf, int64_t offset, int64_t length) {
+  if (taosReadAheadFile(pBuf->pFile, offset, length) != 0) {
+    uDebug("failed to read ahead buf pages, offset:%" PRId64 ", length:%" PRId64 ", reason:%s, %s", offset, length,
+           strerror(errno), pBuf->id);
+  }
+}
+
+int32_t dBufPrefetchPages(SDiskbasedBuf* pBuf, const int32_t* pageIds, int32_t num) {
+  if (pBuf->pFile == NULL) {  // no page is on disk
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // pages that are adjacent in file are merged into one read-ahead request
+  int64_t start = -1;
+  int64_t end = -1;
+
+  for (int32_t i = 0; i < num; ++i) {
+    SPageInfo** pi = tSimpleHashGet(pBuf->all, &pageIds[i], sizeof(int32_t));
+    if (pi == NULL || *pi == NULL) {
+      uError("failed to locate the buffer page:%d, %s", pageIds[i], pBuf->id);
+      return TSDB_CODE_INVALID_PARA;
+    }
+
+    SPageInfo* pg = *pi;
+    if (BUF_PAGE_IN_MEM(pg) || !HAS_DATA_IN_DISK(pg) || pg->prefetched) {
+      continue;
+    }
+
+    pg->prefetched = true;
+    pBuf->statis.prefetchPages += 1;
+
+    if (start >= 0 && pg->offset == end) {
+      end += pg->length;
+      continue;
+    }
+
+    if (start >= 0) {
+      doReadAheadPages(pBuf, start, end - start);
+    }
+
+    start = pg->offset;
+    end = pg->offset + pg->length;
+  }
+
+  if (start >= 0) {
+    doReadAheadPages(pBuf, start, end - start);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 void dBufSetPrintInfo(SDiskbasedBuf* pBuf) { pBuf->printStatis = true; }
 
 SDiskbasedBufStatis getDBufStatis(const SDiskbasedBuf* pBuf) { return pBuf->statis; }
@@ -691,9 +837,11 @@ void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
   if (ps->loadPages > 0) {
     printf(
         "Get/Release pages:%d/%d, flushToDisk:%.2f Kb (%d Pages), loadFromDisk:%.2f Kb (%d Pages), avgPageSize:%.2f "
-        "Kb\n",
+        "Kb, compRatio:%.2f%%, prefetch/hit pages:%d/%d\n",
         ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
-        ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
+        ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages),
+        (ps->rawFlushBytes > 0) ? ps->flushBytes * 100.0 / ps->rawFlushBytes : 100.0, ps->prefetchPages,
+        ps->prefetchHits);
   } else {
     // printf("no page loaded\n");
   }
@@ -721,4 +869,5 @@ void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
   pBuf->totalBufSize = 0;
   pBuf->allocateId = -1;
   pBuf->fileSize = 0;
+  pBuf->nextPos = 0;
 }
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <tcompression.h>
+#include "osSysinfo.h"
+
+namespace {
+
+const int32_t numOfRows = 4096;
+const int32_t numOfLoops = 2000;
+
+typedef int32_t (*FCompress)(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                             void *pBuf, int32_t nBuf);
+
+void setSimdEnable(bool enable) {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+  tsSIMDEnable = enable;
+  tsAVX2Enable = enable ? avx2 : 0;
+}
+
+double compressMBps(FCompress fp, void *pIn, int32_t bytes, char *pOut, int32_t *pLen) {
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfLoops; ++i) {
+    *pLen = fp(pIn, bytes, numOfRows, pOut, bytes + 1, ONE_STAGE_COMP, NULL, 0);
+  }
+  int64_t el = taosGetTimestampUs() - st;
+  return (double)bytes * numOfLoops / (el > 0 ? el : 1);
+}
+
+// time the scalar and the SIMD encoder, the streams are checked to be the same in compressTest
+void runCompressBench(const char *name, FCompress fp, void *pIn, int32_t bytes) {
+  char   *pScalar = static_cast<char *>(taosMemoryMalloc(bytes + 1));
+  char   *pSimd = static_cast<char *>(taosMemoryMalloc(bytes + 1));
+  int32_t scalarLen = 0, simdLen = 0;
+
+  setSimdEnable(false);
+  double scalar = compressMBps(fp, pIn, bytes, pScalar, &scalarLen);
+
+  setSimdEnable(true);
+  double simd = compressMBps(fp, pIn, bytes, pSimd, &simdLen);
+
+  printf("%-10s %d rows, ratio %.2f: scalar %.1f MB/s, simd %.1f MB/s\n", name, numOfRows,
+         (double)bytes / scalarLen, scalar, simd);
+
+  setSimdEnable(false);
+  taosMemoryFree(pScalar);
+  taosMemoryFree(pSimd);
+}
+
+}  // namespace
+
+TEST(compressBench, timestamp) {
+  int64_t *pList = static_cast<int64_t *>(taosMemoryMalloc(numOfRows * sizeof(int64_t)));
+  uint32_t seed = 100;
+  int64_t  ts = 1700000000000;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    ts += 1000 + taosRandR(&seed) % 10;
+    pList[i] = ts;
+  }
+
+  runCompressBench("timestamp", tsCompressTimestamp, pList, numOfRows * sizeof(int64_t));
+  taosMemoryFree(pList);
+}
+
+TEST(compressBench, double) {
+  double  *pList = static_cast<double *>(taosMemoryMalloc(numOfRows * sizeof(double)));
+  uint32_t seed = 100;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pList[i] = 20.0 + (taosRandR(&seed) % 100) / 10.0;
+  }
+
+  runCompressBench("double", tsCompressDouble, pList, numOfRows * sizeof(double));
+  taosMemoryFree(pList);
+}
+
+TEST(compressBench, integer) {
+  int64_t *pBigint = static_cast<int64_t *>(taosMemoryMalloc(numOfRows * sizeof(int64_t)));
+  int32_t *pInt = static_cast<int32_t *>(taosMemoryMalloc(numOfRows * sizeof(int32_t)));
+  int16_t *pSmallint = static_cast<int16_t *>(taosMemoryMalloc(numOfRows * sizeof(int16_t)));
+  int8_t  *pTinyint = static_cast<int8_t *>(taosMemoryMalloc(numOfRows * sizeof(int8_t)));
+  uint32_t seed = 100;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t v = taosRandR(&seed) % 100;
+    pBigint[i] = v;
+    pInt[i] = v;
+    pSmallint[i] = v;
+    pTinyint[i] = v;
+  }
+
+  runCompressBench("bigint", tsCompressBigint, pBigint, numOfRows * sizeof(int64_t));
+  runCompressBench("int", tsCompressInt, pInt, numOfRows * sizeof(int32_t));
+  runCompressBench("smallint", tsCompressSmallint, pSmallint, numOfRows * sizeof(int16_t));
+  runCompressBench("tinyint", tsCompressTinyint, pTinyint, numOfRows * sizeof(int8_t));
+
+  taosMemoryFree(pBigint);
+  taosMemoryFree(pInt);
+  taosMemoryFree(pSmallint);
+  taosMemoryFree(pTinyint);
+}
@@ -0,0 +1,161 @@
+#include <float.h>
+#include <gtest/gtest.h>
+#include <math.h>
+#include <stdlib.h>
+#include <tcompression.h>
+#include "osSysinfo.h"
+
+namespace {
+
+typedef int32_t (*FCompress)(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                             void *pBuf, int32_t nBuf);
+
+// the lengths cover a single value, the tails of the 4-lane AVX2 loops and the blocks of the simple8b selectors
+const int32_t numOfRowsList[] = {1, 2, 3, 4, 5, 7, 8, 9, 239, 240, 241, 1023, 4096};
+
+void setSimdEnable(bool enable) {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+  tsSIMDEnable = enable;
+  tsAVX2Enable = enable ? avx2 : 0;
+}
+
+// the SIMD encoder produces the same stream as the scalar one, and the stream is decoded to the input
+void checkSameStream(FCompress fpCompress, FCompress fpDecompress, void *pIn, int32_t nEle, int32_t bytes) {
+  char *pScalar = static_cast<char *>(taosMemoryCalloc(1, bytes + 1));
+  char *pSimd = static_cast<char *>(taosMemoryCalloc(1, bytes + 1));
+  char *pOut = static_cast<char *>(taosMemoryCalloc(1, bytes + 1));
+
+  setSimdEnable(false);
+  int32_t scalarLen = fpCompress(pIn, bytes, nEle, pScalar, bytes + 1, ONE_STAGE_COMP, NULL, 0);
+  setSimdEnable(true);
+  int32_t simdLen = fpCompress(pIn, bytes, nEle, pSimd, bytes + 1, ONE_STAGE_COMP, NULL, 0);
+  setSimdEnable(false);
+
+  ASSERT_GT(scalarLen, 0);
+  ASSERT_EQ(scalarLen, simdLen);
+  ASSERT_EQ(memcmp(pScalar, pSimd, scalarLen), 0);
+
+  ASSERT_EQ(fpDecompress(pSimd, simdLen, nEle, pOut, bytes, ONE_STAGE_COMP, NULL, 0), bytes);
+  ASSERT_EQ(memcmp(pIn, pOut, bytes), 0);
+
+  taosMemoryFree(pScalar);
+  taosMemoryFree(pSimd);
+  taosMemoryFree(pOut);
+}
+
+template <typename T>
+void checkIntegers(FCompress fpCompress, FCompress fpDecompress, const T *pList, int32_t nEle) {
+  for (int32_t n : numOfRowsList) {
+    if (n > nEle) break;
+    checkSameStream(fpCompress, fpDecompress, (void *)pList, n, n * sizeof(T));
+  }
+}
+
+}  // namespace
+
+TEST(compressTest, timestamp) {
+  const int32_t numOfRows = 4096;
+  int64_t      *pList = static_cast<int64_t *>(taosMemoryMalloc(numOfRows * sizeof(int64_t)));
+  uint32_t      seed = 100;
+
+  // regular, jittered and backward timestamps
+  for (int32_t k = 0; k < 3; ++k) {
+    int64_t ts = 1700000000000;
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      if (k == 0) {
+        ts += 1000;
+      } else if (k == 1) {
+        ts += 1000 + taosRandR(&seed) % 10;
+      } else {
+        ts += (int64_t)(taosRandR(&seed) % 2000000) - 1000000;
+      }
+      pList[i] = ts;
+    }
+
+    checkIntegers(tsCompressTimestamp, tsDecompressTimestamp, pList, numOfRows);
+  }
+
+  taosMemoryFree(pList);
+}
+
+TEST(compressTest, double) {
+  const int32_t numOfRows = 4096;
+  double       *pList = static_cast<double *>(taosMemoryMalloc(numOfRows * sizeof(double)));
+  uint32_t      seed = 100;
+
+  // repeated, close and random values, and the special ones
+  const double special[] = {0.0, -0.0, INFINITY, -INFINITY, NAN, DBL_MAX, DBL_MIN, -DBL_MAX};
+  for (int32_t k = 0; k < 4; ++k) {
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      if (k == 0) {
+        pList[i] = 20.0;
+      } else if (k == 1) {
+        pList[i] = 20.0 + (taosRandR(&seed) % 100) / 10.0;
+      } else if (k == 2) {
+        uint64_t v = ((uint64_t)taosRandR(&seed) << 32) | taosRandR(&seed);
+        memcpy(&pList[i], &v, sizeof(double));
+      } else {
+        pList[i] = special[i % (sizeof(special) / sizeof(special[0]))];
+      }
+    }
+
+    for (int32_t n : numOfRowsList) {
+      checkSameStream(tsCompressDouble, tsDecompressDouble, pList, n, n * sizeof(double));
+    }
+  }
+
+  taosMemoryFree(pList);
+}
+
+TEST(compressTest, integer) {
+  const int32_t numOfRows = 4096;
+  int64_t      *pBigint = static_cast<int64_t *>(taosMemoryMalloc(numOfRows * sizeof(int64_t)));
+  int32_t      *pInt = static_cast<int32_t *>(taosMemoryMalloc(numOfRows * sizeof(int32_t)));
+  int16_t      *pSmallint = static_cast<int16_t *>(taosMemoryMalloc(numOfRows * sizeof(int16_t)));
+  int8_t       *pTinyint = static_cast<int8_t *>(taosMemoryMalloc(numOfRows * sizeof(int8_t)));
+  uint32_t      seed = 100;
+
+  // constant values, small deltas, and deltas of all the bit widths of the selectors
+  for (int32_t k = 0; k < 3; ++k) {
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      int64_t v = 0;
+      if (k == 0) {
+        v = 7;
+      } else if (k == 1) {
+        v = taosRandR(&seed) % 100;
+      } else {
+        int32_t bits = (i / 16) % 60;
+        v = (int64_t)(((uint64_t)taosRandR(&seed) << 32) | taosRandR(&seed)) & ((1LL << bits) - 1);
+        v = (i % 2) ? -v : v;
+      }
+      pBigint[i] = v;
+      pInt[i] = (int32_t)v;
+      pSmallint[i] = (int16_t)v;
+      pTinyint[i] = (int8_t)v;
+    }
+
+    checkIntegers(tsCompressBigint, tsDecompressBigint, pBigint, numOfRows);
+    checkIntegers(tsCompressInt, tsDecompressInt, pInt, numOfRows);
+    checkIntegers(tsCompressSmallint, tsDecompressSmallint, pSmallint, numOfRows);
+    checkIntegers(tsCompressTinyint, tsDecompressTinyint, pTinyint, numOfRows);
+  }
+
+  taosMemoryFree(pBigint);
+  taosMemoryFree(pInt);
+  taosMemoryFree(pSmallint);
+  taosMemoryFree(pTinyint);
+}
+
+// values out of the range of the encoders are stored uncompressed by both of them
+TEST(compressTest, overflow) {
+  int64_t list[13] = {0, INT64_MAX, INT64_MIN, 1, -1, INT64_MIN, INT64_MAX, 7, 8, 9, 10, 11, 12};
+
+  checkSameStream(tsCompressBigint, tsDecompressBigint, list, 13, sizeof(list));
+  checkSameStream(tsCompressTimestamp, tsDecompressTimestamp, list, 13, sizeof(list));
+
+  // a delta of 2^60 does not fit the widest selector
+  int64_t wide[5] = {0, 1LL << 60, 0, -(1LL << 60), 0};
+  checkSameStream(tsCompressBigint, tsDecompressBigint, wide, 5, sizeof(wide));
+  checkSameStream(tsCompressTimestamp, tsDecompressTimestamp, wide, 5, sizeof(wide));
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 #include "taos.h"
 #include "tpagedbuf.h"
@@ -220,8 +221,92 @@ void testFlushAndReadBackBuffer() {
   taosMemoryFree(rowData);
 }
 
+void fillPage(SFilePage* pPg, int32_t pageSize, int32_t seed) {
+  pPg->num = pageSize;
+  for (int32_t i = 0; i < pageSize; ++i) {
+    pPg->data[i] = (char)((seed + i / 64) % 128);
+  }
+}
+
+bool checkPage(SFilePage* pPg, int32_t pageSize, int32_t seed) {
+  if (pPg->num != pageSize) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < pageSize; ++i) {
+    if (pPg->data[i] != (char)((seed + i / 64) % 128)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// pages are compressed when spilled, and read ahead before loaded again
+void compressAndPrefetchTest() {
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        pageSize = 4096;
+  int32_t        numOfPages = 16;
+  ASSERT_EQ(createDiskbasedBuf(&pBuf, pageSize, pageSize * 2, "1", TD_TMP_DIR_PATH), 0);
+
+  std::vector<int32_t> ids;
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    int32_t pageId = -1;
+    auto*   pPg = (SFilePage*)getNewBufPage(pBuf, &pageId);
+    ASSERT_TRUE(pPg != nullptr);
+    fillPage(pPg, pageSize, i);
+    setBufPageDirty(pPg, true);
+    releaseBufPage(pBuf, pPg);
+    ids.push_back(pageId);
+  }
+
+  SDiskbasedBufStatis st = getDBufStatis(pBuf);
+  ASSERT_GT(st.flushPages, 0);
+  ASSERT_LT(st.flushBytes, st.rawFlushBytes);
+
+  ASSERT_EQ(dBufPrefetchPages(pBuf, ids.data(), 4), 0);
+  st = getDBufStatis(pBuf);
+  ASSERT_EQ(st.prefetchPages, 4);
+
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    auto* pPg = (SFilePage*)getBufPage(pBuf, ids[i]);
+    ASSERT_TRUE(pPg != nullptr);
+    ASSERT_TRUE(checkPage(pPg, pageSize, i));
+    releaseBufPage(pBuf, pPg);
+  }
+
+  st = getDBufStatis(pBuf);
+  ASSERT_EQ(st.prefetchHits, 4);
+
+  // the space of recycled pages is reused by the following pages
+  for (int32_t i = 0; i < numOfPages / 2; ++i) {
+    auto* pPg = getBufPage(pBuf, ids[i]);
+    dBufSetBufPageRecycled(pBuf, pPg);
+  }
+
+  for (int32_t i = 0; i < numOfPages / 2; ++i) {
+    int32_t pageId = -1;
+    auto*   pPg = (SFilePage*)getNewBufPage(pBuf, &pageId);
+    ASSERT_TRUE(pPg != nullptr);
+    fillPage(pPg, pageSize, numOfPages + i);
+    setBufPageDirty(pPg, true);
+    releaseBufPage(pBuf, pPg);
+    ids[i] = pageId;
+  }
+
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    auto* pPg = (SFilePage*)getBufPage(pBuf, ids[i]);
+    ASSERT_TRUE(pPg != nullptr);
+    ASSERT_TRUE(checkPage(pPg, pageSize, (i < numOfPages / 2) ? numOfPages + i : i));
+    releaseBufPage(pBuf, pPg);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+}
+
 }  // namespace
 
+TEST(testCase, compressAndPrefetchTest) { compressAndPrefetchTest(); }
+
 TEST(testCase, resultBufferTest) {
   taosSeedRand(taosGetTimestampSec());
   simpleTest();